@@ -0,0 +1,557 @@
+// Microbenchmarks for DataPainter's hot paths (Google Benchmark)
+//
+// Build with -DBUILD_BENCHMARKS=ON, then run:
+//   ./datapainter_bench --benchmark_out=bench.json
+//   ./datapainter_bench --max_points=100000 --benchmark_filter=QueryViewport
+//
+// Results are printed as JSON unless --benchmark_format is given, so two
+// runs can be compared with Google Benchmark's tools/compare.py.
+// --max_points and --max_journal cap the largest fixture (defaults 10^7
+// points and 10^6 journal entries); fixtures are built once per size and
+// storage and reused across benchmarks. --max_threads caps the worker
+// counts BM_EditAreaRenderer_BinThreads tries (default: hardware threads).
+
+#include <benchmark/benchmark.h>
+#include "ansi_renderer.h"
+#include "data_table.h"
+#include "database.h"
+#include "edit_area_renderer.h"
+#include "kde_overlay.h"
+#include "kmeans_overlay.h"
+#include "knn_overlay.h"
+#include "logistic_overlay.h"
+#include "metadata.h"
+#include "point_editor.h"
+#include "save_manager.h"
+#include "stats_panel.h"
+#include "terminal.h"
+#include "thread_pool.h"
+#include "undo_manager.h"
+#include "unsaved_changes.h"
+#include "viewport.h"
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace datapainter;
+
+namespace {
+
+const char* const TABLE = "bench";
+constexpr double RANGE = 10.0;
+
+int64_t max_points = 10000000;
+int64_t max_journal = 1000000;
+int64_t max_threads = ThreadPool::hardware_threads();
+
+enum Storage { MEMORY = 0, DISK = 1 };
+
+std::filesystem::path bench_dir() {
+    static std::filesystem::path dir = [] {
+        auto path = std::filesystem::temp_directory_path() /
+                    ("datapainter_bench_" + std::to_string(::getpid()));
+        std::filesystem::create_directories(path);
+        return path;
+    }();
+    return dir;
+}
+
+// Fresh database with the system tables and an empty data table
+std::unique_ptr<Database> open_database(Storage storage, const std::string& name) {
+    std::string path = ":memory:";
+    if (storage == DISK) {
+        path = (bench_dir() / (name + ".db")).string();
+        std::filesystem::remove(path);
+    }
+    auto db = std::make_unique<Database>(path);
+    db->ensure_metadata_table();
+    db->ensure_unsaved_changes_table();
+
+    MetadataManager mgr(*db);
+    mgr.create_data_table(TABLE);
+    Metadata meta;
+    meta.table_name = TABLE;
+    meta.target_col_name = "target";
+    meta.x_axis_name = "x";
+    meta.y_axis_name = "y";
+    meta.x_meaning = "x";
+    meta.o_meaning = "o";
+    meta.valid_x_min = -RANGE;
+    meta.valid_x_max = RANGE;
+    meta.valid_y_min = -RANGE;
+    meta.valid_y_max = RANGE;
+    meta.show_zero_bars = false;
+    mgr.insert(meta);
+    return db;
+}
+
+// Insert count uniformly distributed points with a fixed seed
+void fill_points(Database& db, int64_t count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coord(-RANGE, RANGE);
+
+    db.execute("BEGIN TRANSACTION");
+    sqlite3_stmt* stmt = nullptr;
+    std::string sql = std::string("INSERT INTO ") + TABLE + " (x, y, target) VALUES (?, ?, ?)";
+    sqlite3_prepare_v2(db.connection(), sql.c_str(), -1, &stmt, nullptr);
+    for (int64_t i = 0; i < count; ++i) {
+        sqlite3_bind_double(stmt, 1, coord(rng));
+        sqlite3_bind_double(stmt, 2, coord(rng));
+        sqlite3_bind_text(stmt, 3, (i % 2 == 0) ? "x" : "o", -1, SQLITE_STATIC);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    db.execute("COMMIT");
+}
+
+// Append count active insert records to the journal
+void fill_journal(Database& db, int64_t count) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-RANGE, RANGE);
+
+    db.execute("BEGIN TRANSACTION");
+    sqlite3_stmt* stmt = nullptr;
+    const char* sql = "INSERT INTO unsaved_changes (table_name, action, x, y, new_target) "
+                      "VALUES (?, 'insert', ?, ?, ?)";
+    sqlite3_prepare_v2(db.connection(), sql, -1, &stmt, nullptr);
+    for (int64_t i = 0; i < count; ++i) {
+        sqlite3_bind_text(stmt, 1, TABLE, -1, SQLITE_STATIC);
+        sqlite3_bind_double(stmt, 2, coord(rng));
+        sqlite3_bind_double(stmt, 3, coord(rng));
+        sqlite3_bind_text(stmt, 4, (i % 2 == 0) ? "x" : "o", -1, SQLITE_STATIC);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    db.execute("COMMIT");
+}
+
+// Databases holding n points, built once per (n, storage)
+Database& points_fixture(int64_t n, Storage storage) {
+    static std::map<std::pair<int64_t, int>, std::unique_ptr<Database>> cache;
+    auto& db = cache[{n, storage}];
+    if (!db) {
+        db = open_database(storage, "points_" + std::to_string(n));
+        fill_points(*db, n);
+    }
+    return *db;
+}
+
+// Databases holding an empty data table and n journal entries
+Database& journal_fixture(int64_t n, Storage storage) {
+    static std::map<std::pair<int64_t, int>, std::unique_ptr<Database>> cache;
+    auto& db = cache[{n, storage}];
+    if (!db) {
+        db = open_database(storage, "journal_" + std::to_string(n));
+        fill_journal(*db, n);
+    }
+    return *db;
+}
+
+// Sizes 10^3 .. limit in powers of ten, for each storage kind
+void point_sizes(benchmark::internal::Benchmark* bench, int64_t first, int64_t limit) {
+    bench->ArgNames({"n", "disk"});
+    for (int storage : {MEMORY, DISK}) {
+        for (int64_t n = first; n <= limit; n *= 10) {
+            bench->Args({n, storage});
+        }
+    }
+}
+
+void PointSizes(benchmark::internal::Benchmark* bench) { point_sizes(bench, 1000, max_points); }
+void JournalSizes(benchmark::internal::Benchmark* bench) { point_sizes(bench, 100, max_journal); }
+
+// Viewport showing the whole valid range on an 80x24 screen
+Viewport full_viewport() {
+    return Viewport(-RANGE, RANGE, -RANGE, RANGE, -RANGE, RANGE, -RANGE, RANGE, 24 - 4 - 2, 80 - 2);
+}
+
+// Discards std::cout output while in scope (Terminal::render writes ANSI)
+class MuteStdout {
+public:
+    MuteStdout() : saved_(std::cout.rdbuf(sink_.rdbuf())) {}
+    ~MuteStdout() { std::cout.rdbuf(saved_); }
+
+private:
+    std::ostringstream sink_;
+    std::streambuf* saved_;
+};
+
+}  // namespace
+
+static void BM_DataTable_QueryViewport(benchmark::State& state) {
+    Database& db = points_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    DataTable table(db, TABLE);
+    // A 10% x 10% window, as after zooming in
+    for (auto _ : state) {
+        auto points = table.query_viewport(-1.0, 1.0, -1.0, 1.0);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_DataTable_QueryViewportFull(benchmark::State& state) {
+    Database& db = points_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    DataTable table(db, TABLE);
+    for (auto _ : state) {
+        auto points = table.query_viewport(-RANGE, RANGE, -RANGE, RANGE);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// render() is the public entry to render_points (binning and glyphs)
+static void render_edit_area(benchmark::State& state, EditAreaRenderer::Mode mode) {
+    Database& db = points_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    DataTable table(db, TABLE);
+    Terminal terminal;
+    terminal.set_dimensions(24, 80);
+    Viewport viewport = full_viewport();
+    EditAreaRenderer renderer;
+    renderer.set_mode(mode);
+    std::vector<ChangeRecord> no_changes;
+    for (auto _ : state) {
+        renderer.render(terminal, viewport, table, no_changes, 3, 20, 80, 12, 40, "x", "o");
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_EditAreaRenderer_Render(benchmark::State& state) {
+    render_edit_area(state, EditAreaRenderer::Mode::POINTS);
+}
+
+static void BM_EditAreaRenderer_RenderBraille(benchmark::State& state) {
+    render_edit_area(state, EditAreaRenderer::Mode::BRAILLE);
+}
+
+// Binning alone (no query) of the whole largest fixture with 1..N workers;
+// the points are fetched once and shared by every thread count
+static void BM_EditAreaRenderer_BinThreads(benchmark::State& state) {
+    static std::vector<DataPoint> points = [] {
+        DataTable table(points_fixture(max_points, MEMORY), TABLE);
+        return table.query_viewport(-RANGE, RANGE, -RANGE, RANGE);
+    }();
+    ThreadPool pool(static_cast<int>(state.range(0)));
+    Viewport viewport = full_viewport();
+    EditAreaRenderer renderer;
+    renderer.set_thread_pool(pool);
+    ClassPalette palette("x", "o");
+    std::vector<ChangeRecord> no_changes;
+    for (auto _ : state) {
+        const CellGrid& grid = renderer.bin_points(viewport, points, no_changes,
+                                                   viewport.screen_height(), viewport.screen_width(), palette);
+        benchmark::DoNotOptimize(grid.max_count());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(points.size()));
+}
+
+// One painted point per frame: a k-d tree insert or remove from the journal
+// sync, then k-NN prediction of every cell of an 80x24 edit area
+static void BM_KnnOverlay_EditFrame(benchmark::State& state) {
+    Database& db = points_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    DataTable table(db, TABLE);
+    Terminal terminal;
+    terminal.set_dimensions(24, 80);
+    Viewport viewport = full_viewport();
+    ClassPalette palette("x", "o");
+    KnnOverlay overlay;
+    ChangeRecord paint{};
+    paint.id = 1;
+    paint.action = "insert";
+    paint.x = 0.5;
+    paint.y = 0.5;
+    paint.new_target = "o";
+    std::vector<ChangeRecord> changes = {paint};
+    overlay.sync(table, changes, palette);  // Tree build, outside the timing
+    for (auto _ : state) {
+        changes[0].is_active = !changes[0].is_active;
+        overlay.sync(table, changes, palette);
+        overlay.render(terminal, viewport, palette, 3, 20, 80);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// One painted point per frame: the journal sync, a warm-started logistic
+// refit over every point and the line/band drawing
+static void BM_LogisticOverlay_EditFrame(benchmark::State& state) {
+    Database& db = points_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    DataTable table(db, TABLE);
+    Terminal terminal;
+    terminal.set_dimensions(24, 80);
+    Viewport viewport = full_viewport();
+    ClassPalette palette("x", "o");
+    LogisticOverlay overlay;
+    overlay.set_range(-RANGE, RANGE, -RANGE, RANGE);
+    ChangeRecord paint{};
+    paint.id = 1;
+    paint.action = "insert";
+    paint.x = 0.5;
+    paint.y = 0.5;
+    paint.new_target = "o";
+    std::vector<ChangeRecord> changes = {paint};
+    overlay.sync(table, changes, palette);  // Load and first fit, outside the timing
+    int64_t steps = 0;
+    for (auto _ : state) {
+        changes[0].is_active = !changes[0].is_active;
+        overlay.sync(table, changes, palette);
+        overlay.render(terminal, viewport, palette, 3, 20, 80);
+        steps += overlay.iterations();
+        benchmark::ClobberMemory();
+    }
+    state.counters["newton_steps"] =
+        benchmark::Counter(static_cast<double>(steps) / static_cast<double>(state.iterations()));
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_Viewport_DataToScreen(benchmark::State& state) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coord(-RANGE, RANGE);
+    std::vector<DataCoord> coords(static_cast<size_t>(state.range(0)));
+    for (auto& c : coords) {
+        c = {coord(rng), coord(rng)};
+    }
+    Viewport viewport = full_viewport();
+    for (auto _ : state) {
+        for (const auto& c : coords) {
+            benchmark::DoNotOptimize(viewport.data_to_screen(c));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_UnsavedChanges_GetChanges(benchmark::State& state) {
+    Database& db = journal_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    UnsavedChanges changes(db);
+    for (auto _ : state) {
+        auto records = changes.get_changes(TABLE);
+        benchmark::DoNotOptimize(records.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Applies n journalled inserts; the journal is rebuilt between iterations
+static void BM_SaveManager_Save(benchmark::State& state) {
+    auto db = open_database(static_cast<Storage>(state.range(1)), "save");
+    SaveManager saver(*db, TABLE);
+    for (auto _ : state) {
+        state.PauseTiming();
+        db->execute(std::string("DELETE FROM ") + TABLE);
+        fill_journal(*db, state.range(0));
+        state.ResumeTiming();
+
+        if (!saver.save()) {
+            state.SkipWithError("save failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Times undo() only; the matching redo() runs with the clock paused
+static void BM_UndoManager_Undo(benchmark::State& state) {
+    Database& db = journal_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    UndoManager undo(db, TABLE);
+    for (auto _ : state) {
+        if (!undo.undo()) {
+            state.SkipWithError("nothing to undo");
+            break;
+        }
+        state.PauseTiming();
+        undo.redo();
+        state.ResumeTiming();
+    }
+}
+
+static void BM_PointEditor_GetPointsAtCursor(benchmark::State& state) {
+    Database& db = points_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    PointEditor editor(db, TABLE);
+    // One cell of the full-range viewport
+    double cell_size = 2.0 * RANGE / 78.0;
+    for (auto _ : state) {
+        auto points = editor.get_points_at_cursor(0.0, 0.0, cell_size);
+        benchmark::DoNotOptimize(points.data());
+    }
+}
+
+// Screen sizes; output goes to a discarded buffer (ANSI fallback path)
+static void BM_Terminal_Render(benchmark::State& state) {
+    Terminal terminal;
+    terminal.set_dimensions(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    for (int row = 0; row < terminal.rows(); ++row) {
+        for (int col = 0; col < terminal.cols(); ++col) {
+            terminal.write_char(row, col, static_cast<char>('a' + (row + col) % 26));
+        }
+    }
+    MuteStdout mute;
+    for (auto _ : state) {
+        terminal.render();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+
+// Direct ANSI backend: encode a frame where one cursor step changed, as on
+// an arrow key; bytes per frame is what a slow link has to carry
+static void BM_AnsiRenderer_CursorMove(benchmark::State& state) {
+    Terminal terminal;
+    terminal.set_dimensions(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    for (int row = 0; row < terminal.rows(); ++row) {
+        for (int col = 0; col < terminal.cols(); ++col) {
+            terminal.write_char(row, col, static_cast<char>('a' + (row + col) % 26));
+        }
+    }
+    AnsiRenderer renderer;
+    renderer.compose(terminal, 0, 0);
+    int cursor = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        cursor = (cursor + 1) % terminal.cols();
+        bytes += renderer.compose(terminal, terminal.rows() / 2, cursor).size();
+    }
+    state.counters["bytes_per_frame"] =
+        benchmark::Counter(static_cast<double>(bytes) / static_cast<double>(state.iterations()));
+}
+
+// One painted point per frame: the journal sync, re-smoothing the painted
+// class's histogram and drawing its contours. Independent of the point count
+// once loaded.
+static void BM_KdeOverlay_EditFrame(benchmark::State& state) {
+    Database& db = points_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    DataTable table(db, TABLE);
+    Terminal terminal;
+    terminal.set_dimensions(24, 80);
+    Viewport viewport = full_viewport();
+    ClassPalette palette("x", "o");
+    KdeOverlay overlay;
+    overlay.ensure_loaded(table, palette, -RANGE, RANGE, -RANGE, RANGE);  // Outside the timing
+    overlay.update();
+    ChangeRecord paint{};
+    paint.id = 1;
+    paint.action = "insert";
+    paint.x = 0.5;
+    paint.y = 0.5;
+    paint.new_target = "o";
+    std::vector<ChangeRecord> changes = {paint};
+    for (auto _ : state) {
+        changes[0].is_active = !changes[0].is_active;
+        overlay.sync(table, changes, palette);
+        overlay.render(terminal, viewport, palette, 3, 20, 80);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// k-means++ seeding and Lloyd iterations over every point, k = 8; the
+// points are loaded by the first run, outside the timing
+static void BM_KmeansOverlay_Run(benchmark::State& state) {
+    Database& db = points_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    DataTable table(db, TABLE);
+    ClassPalette palette("x", "o");
+    KmeansOverlay overlay;
+    overlay.set_k(8);
+    std::vector<ChangeRecord> changes;
+    overlay.run(table, changes, palette, -RANGE, RANGE, -RANGE, RANGE);
+    int64_t iterations = 0;
+    for (auto _ : state) {
+        overlay.run(table, changes, palette, -RANGE, RANGE, -RANGE, RANGE);
+        iterations += overlay.iterations();
+    }
+    state.counters["iterations"] =
+        benchmark::Counter(static_cast<double>(iterations) / static_cast<double>(state.iterations()));
+}
+
+// Header counts and panel sums for a full-range viewport panned by one
+// column of an 80-column screen each frame: two strip queries instead of
+// fetching every point (compare BM_DataTable_QueryViewportFull)
+static void BM_StatsPanel_Pan(benchmark::State& state) {
+    Database& db = points_fixture(state.range(0), static_cast<Storage>(state.range(1)));
+    DataTable table(db, TABLE);
+    ClassPalette palette("x", "o");
+    StatsPanel panel;
+    const double step = 2.0 * RANGE / 80.0;
+    panel.set_viewport(table, palette, -RANGE, RANGE, -RANGE, RANGE);
+    int frame = 0;
+    for (auto _ : state) {
+        double offset = (++frame % 2) * step;
+        panel.set_viewport(table, palette, -RANGE + offset, RANGE + offset, -RANGE, RANGE);
+        benchmark::DoNotOptimize(panel.saved_viewport_count());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Registered after flag parsing so --max_points/--max_journal apply
+static void register_benchmarks() {
+    benchmark::RegisterBenchmark("BM_DataTable_QueryViewport", BM_DataTable_QueryViewport)->Apply(PointSizes)->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("BM_DataTable_QueryViewportFull", BM_DataTable_QueryViewportFull)->Apply(PointSizes)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("BM_EditAreaRenderer_Render", BM_EditAreaRenderer_Render)->Apply(PointSizes)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("BM_EditAreaRenderer_RenderBraille", BM_EditAreaRenderer_RenderBraille)->Apply(PointSizes)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("BM_EditAreaRenderer_BinThreads", BM_EditAreaRenderer_BinThreads)
+        ->ArgName("threads")->RangeMultiplier(2)->Range(1, max_threads)
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+    benchmark::RegisterBenchmark("BM_KnnOverlay_EditFrame", BM_KnnOverlay_EditFrame)->Apply(PointSizes)->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("BM_LogisticOverlay_EditFrame", BM_LogisticOverlay_EditFrame)->Apply(PointSizes)->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("BM_KdeOverlay_EditFrame", BM_KdeOverlay_EditFrame)->Apply(PointSizes)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("BM_KmeansOverlay_Run", BM_KmeansOverlay_Run)->Apply(PointSizes)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("BM_StatsPanel_Pan", BM_StatsPanel_Pan)->Apply(PointSizes)->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("BM_Viewport_DataToScreen", BM_Viewport_DataToScreen)->ArgName("n")->RangeMultiplier(10)->Range(1000, max_points);
+    benchmark::RegisterBenchmark("BM_UnsavedChanges_GetChanges", BM_UnsavedChanges_GetChanges)->Apply(JournalSizes)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("BM_SaveManager_Save", BM_SaveManager_Save)->Apply(JournalSizes)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("BM_UndoManager_Undo", BM_UndoManager_Undo)->Apply(JournalSizes)->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("BM_PointEditor_GetPointsAtCursor", BM_PointEditor_GetPointsAtCursor)->Apply(PointSizes)->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("BM_Terminal_Render", BM_Terminal_Render)
+        ->ArgNames({"rows", "cols"})
+        ->Args({24, 80})
+        ->Args({50, 200})
+        ->Args({100, 400})
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("BM_AnsiRenderer_CursorMove", BM_AnsiRenderer_CursorMove)
+        ->ArgNames({"rows", "cols"})
+        ->Args({24, 80})
+        ->Args({50, 200})
+        ->Args({100, 400})
+        ->Unit(benchmark::kMicrosecond);
+}
+
+int main(int argc, char** argv) {
+    // Strip our own size limits before Google Benchmark sees the flags
+    std::vector<char*> args;
+    bool has_format = false;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--max_points=", 13) == 0) {
+            max_points = std::atoll(argv[i] + 13);
+        } else if (std::strncmp(argv[i], "--max_journal=", 14) == 0) {
+            max_journal = std::atoll(argv[i] + 14);
+        } else if (std::strncmp(argv[i], "--max_threads=", 14) == 0) {
+            max_threads = std::atoll(argv[i] + 14);
+        } else {
+            has_format = has_format || std::strncmp(argv[i], "--benchmark_format=", 19) == 0;
+            args.push_back(argv[i]);
+        }
+    }
+    static char json_format[] = "--benchmark_format=json";
+    if (!has_format) {
+        args.push_back(json_format);
+    }
+
+    register_benchmarks();
+    int bench_argc = static_cast<int>(args.size());
+    benchmark::Initialize(&bench_argc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(bench_argc, args.data())) {
+        return 2;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    std::filesystem::remove_all(bench_dir());
+    return 0;
+}
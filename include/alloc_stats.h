@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace datapainter {
+
+// Heap allocation counters for one thread
+struct AllocCounters {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;  // Requested bytes
+};
+
+// Allocation accounting, available in builds configured with
+// -DDATAPAINTER_ALLOC_STATS=ON (which replaces global operator new/delete)
+//
+// Without that option every call here is a no-op and counts stay zero, so
+// instrumented code needs no #ifdefs.
+class AllocStats {
+public:
+    // Operations tracked in the report before further names are dropped
+    static constexpr size_t MAX_OPERATIONS = 64;
+
+    static constexpr bool available() {
+#ifdef DATAPAINTER_ALLOC_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Running totals for the calling thread
+    static AllocCounters current();
+
+    // Add one completed operation; name must be a string literal
+    static void record(const char* name, const AllocCounters& delta);
+
+    // Aggregate for one operation name (zero if never recorded)
+    struct Operation {
+        const char* name = nullptr;
+        uint64_t count = 0;
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t max_allocations = 0;
+    };
+    static Operation operation(const char* name);
+
+    // Forget all recorded operations
+    static void reset();
+
+    // Per-operation table: count, allocations (total, mean, max) and bytes
+    static void write_report(std::ostream& out);
+
+    // Write the report if DATAPAINTER_ALLOC_REPORT is set: "-" for stderr,
+    // anything else is a file path. Returns false if the file failed.
+    static bool write_report_from_env();
+};
+
+// Counts the calling thread's allocations over its lifetime and records them
+// under name when destroyed (nested scopes each record their own total)
+class AllocScope {
+public:
+    explicit AllocScope(const char* name) : name_(name) {
+        if (AllocStats::available()) {
+            start_ = AllocStats::current();
+        }
+    }
+
+    ~AllocScope() {
+        if (AllocStats::available()) {
+            AllocStats::record(name_, delta());
+        }
+    }
+
+    // Allocations so far in this scope
+    AllocCounters delta() const;
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    const char* name_;
+    AllocCounters start_;
+};
+
+}  // namespace datapainter
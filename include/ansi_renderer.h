@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace datapainter {
+
+class Terminal;
+
+// Frame composer for the direct ANSI terminal backend
+//
+// Each frame is diffed against the previous one and encoded into a single
+// output buffer: changed cells are emitted as cursor-addressed runs, SGR
+// (reverse video, foreground colour) and the DEC line-drawing charset are
+// only switched when they change, and the whole frame is wrapped in DEC mode 2026 synchronized
+// update markers so the terminal presents it atomically. The buffer is
+// reused across frames and written with one write(2).
+class AnsiRenderer {
+public:
+    AnsiRenderer();
+
+    // Encode the terminal buffer; cursor_row/cursor_col (-1 for none) is
+    // drawn in reverse video. Returns the bytes to send, which are empty
+    // when nothing changed since the previous frame.
+    const std::string& compose(const Terminal& terminal, int cursor_row, int cursor_col);
+
+    // Cells emitted by the last compose()
+    size_t cells_written() const { return cells_written_; }
+
+    // Forget the previous frame so the next compose() clears and repaints
+    // (after entering raw mode, a resize or output by someone else)
+    void invalidate() { valid_ = false; }
+
+    // write(2) the whole buffer, retrying on EINTR and short writes
+    static bool write_all(int fd, const std::string& bytes);
+
+    // Escape sequences, exposed for tests
+    static constexpr const char* SYNC_BEGIN = "\033[?2026h";
+    static constexpr const char* SYNC_END = "\033[?2026l";
+
+private:
+    struct Cell {
+        char ch;
+        uint8_t acs;      // Terminal::AcsChar, 0 for a plain character
+        uint8_t color;    // Terminal::Color, 0 for the default colour
+        bool reverse;
+        char32_t glyph;   // Unicode glyph sent as UTF-8, 0 for ch
+
+        bool operator==(const Cell& other) const {
+            return ch == other.ch && acs == other.acs && color == other.color &&
+                   reverse == other.reverse && glyph == other.glyph;
+        }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    // Longest unchanged gap rewritten in place rather than skipped with a
+    // cursor move ("\033[r;cH" is at least 6 bytes)
+    static constexpr int MAX_REWRITE_GAP = 4;
+
+    std::string out_;
+    std::vector<Cell> previous_;
+    std::vector<Cell> next_;
+    int rows_;
+    int cols_;
+    bool valid_;
+    size_t cells_written_;
+
+    // Output state while composing
+    int cursor_row_;  // -1 when the terminal cursor position is unknown
+    int cursor_col_;
+    bool reverse_;
+    uint8_t color_;
+    bool line_drawing_;
+
+    void move_to(int row, int col);
+    void emit_cell(const Cell& cell, int row, int col);
+};
+
+}  // namespace datapainter
@@ -32,6 +32,17 @@ struct Arguments {
     std::optional<int> override_screen_height;
     std::optional<int> override_screen_width;
     bool start_tabular = false;
+    bool show_minimap = false;  // --minimap
+    std::optional<std::string> terminal_backend;  // --backend <ncurses|ansi>
+    std::optional<std::string> render_mode;  // --render-mode <points|density|braille>
+    std::vector<std::string> class_styles;  // --class-style <target>=<glyph>[:<colour>] (repeatable)
+    std::optional<int> threads;  // --threads <n>: worker threads for binning, stats and export
+    bool show_logistic = false;  // --logistic
+    std::optional<int> knn;  // --knn <k>: start with the k-NN decision-region overlay shown
+    bool show_kde = false;  // --kde
+    std::optional<double> kde_bandwidth;  // --kde-bandwidth <h|scott>: unset uses Scott's rule
+    std::optional<int> kmeans;  // --kmeans <k>: start with k-means suggestions shown
+    bool show_stats = false;  // --stats
 
     // Non-interactive mode commands
     bool create_table = false;
@@ -43,6 +54,8 @@ struct Arguments {
     bool add_point = false;
     bool delete_point = false;
     bool to_csv = false;
+    std::optional<std::string> render_snapshot;  // --render-snapshot <width>x<height>
+    std::optional<std::string> snapshot_output;  // --snapshot-output <path>
 
     // Point operation arguments
     std::optional<double> point_x;
@@ -59,6 +72,11 @@ struct Arguments {
     bool list_x_axis_marks = false;
     bool list_y_axis_marks = false;
     std::optional<std::string> keystroke_file;
+    bool headless = false;  // Replay --keystroke-file without a TTY
+    bool fast_replay = false;  // Only draw frames at replay checkpoints
+    std::optional<std::string> profile_keystrokes;  // --profile-keystrokes <out>
+    std::optional<std::string> profile_sql;         // --profile-sql <out>
+    std::optional<std::string> trace_file;          // --trace <out>
 
     // Study mode
     bool study = false;
@@ -83,6 +101,10 @@ struct Arguments {
     bool commit_unsaved_changes = false;
     bool list_unsaved_changes = false;
 
+    // Daemon mode
+    std::optional<std::string> serve_socket;    // --serve <socket>
+    std::optional<std::string> connect_socket;  // --connect <socket>
+
     // Help and version
     bool show_help = false;
     bool show_version = false;
@@ -115,6 +137,7 @@ private:
 
     // Helper to get value after a flag
     static std::optional<std::string> get_value(int argc, char** argv, const std::string& flag);
+    static std::vector<std::string> get_values(int argc, char** argv, const std::string& flag);
 
     // Helper to parse double value
     static std::optional<double> parse_double(const std::string& str);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "text_buffer.h"
 #include <string>
 #include <vector>
 
@@ -28,6 +29,10 @@ public:
                                                        double data_max,
                                                        double tick_step);
 
+    // Same, reusing the storage of ticks (labels fit in small-string storage)
+    static void generate_major_ticks(double data_min, double data_max,
+                                     double tick_step, std::vector<TickMark>& ticks);
+
     // Generate minor tick marks (if spacing permits)
     static std::vector<double> generate_minor_ticks(double data_min,
                                                      double data_max,
@@ -41,6 +46,7 @@ public:
     // Format tick label with appropriate precision
     // Uses scientific notation for |exponent| >= 4
     static std::string format_label(double value);
+    static void append_label(TextBuffer& out, double value);
 
     // Calculate decimal place for major tick marks (log10 of range)
     static int calculate_decimal_places(double data_min, double data_max);
@@ -77,6 +83,22 @@ public:
 private:
     // Helper to find nearest "nice" number (1, 2, or 5 times power of 10)
     static double round_to_nice(double value);
+
+    // Last major tick set per axis, keyed by (min, max, step), so an
+    // unchanged viewport reuses its labels instead of reformatting them
+    struct TickCache {
+        double data_min = 0.0;
+        double data_max = 0.0;
+        double tick_step = 0.0;
+        bool valid = false;
+        std::vector<TickMark> ticks;
+    };
+
+    static const std::vector<TickMark>& cached_major_ticks(TickCache& cache, double data_min,
+                                                           double data_max, double tick_step);
+
+    TickCache x_ticks_;
+    TickCache y_ticks_;
 };
 
 } // namespace datapainter
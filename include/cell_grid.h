@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace datapainter {
+
+// Dense per-frame binning grid for the edit area
+//
+// Each cell holds a bitmask of the classes present, the number of points
+// and a majority-vote counter for the dominant class, so binning is one
+// array write per point whatever the number of classes. Storage is kept
+// across frames; reset() only clears the cells the last frame touched.
+class CellGrid {
+public:
+    struct Cell {
+        uint64_t classes = 0;  // Bit n set when class n is present
+        uint32_t count = 0;    // Points binned into the cell
+        uint32_t votes = 0;    // Boyer-Moore counter for dominant
+        uint8_t dominant = 0;  // Majority class (exact when one class has > half)
+        uint32_t binary[2] = {0, 0};  // Points of classes 0 and 1 (x/o meanings)
+
+        bool empty() const { return count == 0; }
+        bool mixed() const { return (classes & (classes - 1)) != 0; }
+    };
+
+    // Size the grid for a frame and clear it
+    void reset(int rows, int cols);
+
+    // Bin one point of class_index (0-63) into (row, col); out-of-range
+    // cells are ignored
+    void add(int row, int col, int class_index) {
+        if (row < 0 || row >= rows_ || col < 0 || col >= cols_) {
+            return;
+        }
+        size_t index = static_cast<size_t>(row) * static_cast<size_t>(cols_) + static_cast<size_t>(col);
+        Cell& cell = cells_[index];
+        if (cell.count == 0) {
+            occupied_.push_back(static_cast<uint32_t>(index));
+        }
+        ++cell.count;
+        if (cell.count > max_count_) {
+            max_count_ = cell.count;
+        }
+        cell.classes |= uint64_t{1} << class_index;
+        if (class_index < 2) {
+            ++cell.binary[class_index];
+        }
+        uint8_t klass = static_cast<uint8_t>(class_index);
+        if (cell.votes == 0) {
+            cell.dominant = klass;
+            cell.votes = 1;
+        } else if (cell.dominant == klass) {
+            ++cell.votes;
+        } else {
+            --cell.votes;
+        }
+    }
+
+    // Add another grid of the same size (a worker's private grid) into
+    // this one; dominant classes combine as Boyer-Moore counters do, so a
+    // class with more than half the points stays dominant
+    void merge(const CellGrid& other);
+
+    const Cell& at(int row, int col) const {
+        return cells_[static_cast<size_t>(row) * static_cast<size_t>(cols_) + static_cast<size_t>(col)];
+    }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+
+    // Visit each non-empty cell as f(row, col, cell), in first-touch order
+    template <typename F>
+    void for_each_occupied(F f) const {
+        for (uint32_t index : occupied_) {
+            int row = static_cast<int>(index / static_cast<uint32_t>(cols_));
+            int col = static_cast<int>(index % static_cast<uint32_t>(cols_));
+            f(row, col, cells_[index]);
+        }
+    }
+
+    size_t occupied_count() const { return occupied_.size(); }
+
+    // Largest point count of any cell this frame
+    uint32_t max_count() const { return max_count_; }
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    std::vector<Cell> cells_;
+    std::vector<uint32_t> occupied_;  // Indices of non-empty cells
+    uint32_t max_count_ = 0;
+};
+
+}  // namespace datapainter
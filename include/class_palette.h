@@ -0,0 +1,75 @@
+#pragma once
+
+#include "terminal.h"
+#include <string>
+#include <vector>
+
+namespace datapainter {
+
+// Maps target values to dense class indices (0-63) with a glyph and colour
+// for each class
+//
+// Class 0 is the table's x meaning ('x'/'X') and class 1 its o meaning
+// ('o'/'O'); other targets get the next free default glyph the first time
+// they are seen. Indices are what the renderer bins, so a cell's class set
+// fits in one 64-bit mask.
+class ClassPalette {
+public:
+    static constexpr int MAX_CLASSES = 64;
+    static constexpr int NO_CLASS = -1;
+
+    struct Style {
+        std::string target;
+        char glyph;        // One point of this class in the cell
+        char multi_glyph;  // Several points of this class
+        Terminal::Color color;
+    };
+
+    ClassPalette() = default;
+    ClassPalette(const std::string& x_target, const std::string& o_target);
+
+    // Class index of target, registering unseen targets while there is room;
+    // NO_CLASS once all 64 classes are taken
+    int classify(const std::string& target);
+
+    // Class index of target without registering it
+    int find(const std::string& target) const;
+
+    // find() with a caller-held last-hit cache, for lookups from worker
+    // threads that must not touch the palette's own cache
+    int find(const std::string& target, int& last_hit) const {
+        if (last_hit != NO_CLASS && styles_[static_cast<size_t>(last_hit)].target == target) {
+            return last_hit;
+        }
+        int index = find(target);
+        if (index != NO_CLASS) {
+            last_hit = index;
+        }
+        return index;
+    }
+
+    // Set the glyph and colour for target (registering it); false if full.
+    // The multi-point glyph is the upper-case glyph for letters.
+    bool set_style(const std::string& target, char glyph, Terminal::Color color);
+
+    // Apply a "target=glyph[:colour]" specification (--class-style)
+    bool apply_spec(const std::string& spec, std::string& error);
+
+    // Check a specification without applying it
+    static bool validate_spec(const std::string& spec, std::string& error);
+
+    int size() const { return static_cast<int>(styles_.size()); }
+    const Style& style(int index) const { return styles_[static_cast<size_t>(index)]; }
+
+private:
+    std::vector<Style> styles_;
+    int last_hit_ = NO_CLASS;  // Consecutive points usually share a target
+
+    int add(const std::string& target);
+    char next_default_glyph() const;
+
+    static bool parse_spec(const std::string& spec, std::string& target, char& glyph,
+                           Terminal::Color& color, std::string& error);
+};
+
+}  // namespace datapainter
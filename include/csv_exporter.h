@@ -0,0 +1,44 @@
+#pragma once
+
+#include "data_table.h"
+#include "database.h"
+#include "thread_pool.h"
+#include <ostream>
+#include <string>
+
+namespace datapainter {
+
+// Streams a data table as CSV (x,y,target) in id order
+// Used by --to-csv and by the RPC server's to_csv method
+class CsvExporter {
+public:
+    CsvExporter(Database& db, const std::string& table_name);
+
+    // Write the header and all rows to the stream
+    // Returns false on query or write failure (see last_error())
+    bool write(std::ostream& out);
+
+    // Description of the last failure
+    const std::string& last_error() const { return error_; }
+
+    // Pool that formats batches of rows (ThreadPool::shared() unless set);
+    // with more than one worker, rows are read in batches of BATCH_ROWS,
+    // formatted in slices across the workers and written in id order
+    void set_thread_pool(ThreadPool& pool) { pool_ = &pool; }
+
+    static constexpr size_t BATCH_ROWS = 16384;
+
+private:
+    Database& db_;
+    std::string table_name_;
+    std::string error_;
+    ThreadPool* pool_ = nullptr;  // nullptr: ThreadPool::shared()
+
+    // Write one "x,y,target" line
+    static void write_row(std::ostream& out, const DataPoint& point);
+
+    // Write a target value, quoting it if it contains special characters
+    static void write_target(std::ostream& out, const std::string& target);
+};
+
+}  // namespace datapainter
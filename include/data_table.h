@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <optional>
 #include <string>
 #include <vector>
@@ -17,6 +19,36 @@ struct DataPoint {
     std::string target;
 };
 
+// Point count of one cell of a coarse grid (see DataTable::count_in_bins)
+struct BinCount {
+    int row;
+    int col;
+    int count;
+};
+
+// Rectangle of data space; each bound is inclusive unless marked open
+struct DataRegion {
+    double x_min;
+    double x_max;
+    double y_min;
+    double y_max;
+    bool open_x_min = false;
+    bool open_x_max = false;
+    bool open_y_min = false;
+    bool open_y_max = false;
+};
+
+// Coordinate sums of one target's points (see DataTable::sum_by_target)
+struct TargetSums {
+    std::string target;
+    int64_t count;
+    double sum_x;   // Of x - origin x
+    double sum_y;
+    double sum_xx;
+    double sum_yy;
+    double sum_xy;
+};
+
 // Data table operations
 class DataTable {
 public:
@@ -31,10 +63,31 @@ public:
     // Update point's target value (returns false if not found)
     bool update_point_target(int id, const std::string& new_target);
 
+    // Look up one point by id
+    std::optional<DataPoint> get_point(int id);
+
     // Query points within viewport bounds (inclusive)
     std::vector<DataPoint> query_viewport(double x_min, double x_max,
                                           double y_min, double y_max);
 
+    // Visit every point in id order without materialising the whole table
+    // Returns false if the query could not be prepared
+    bool for_each_point(const std::function<void(const DataPoint&)>& visitor);
+
+    // Count points per cell of a rows x cols grid over the given bounds with
+    // one aggregate query; row 0 is the top (largest y). Only non-empty
+    // cells are returned. With a target, only points of that target count.
+    std::vector<BinCount> count_in_bins(double x_min, double x_max,
+                                        double y_min, double y_max,
+                                        int rows, int cols,
+                                        const std::optional<std::string>& target = std::nullopt);
+
+    // Per-target count and sums of dx, dy, dx^2, dy^2 and dx*dy, where
+    // (dx, dy) is a point's offset from the origin, with one aggregate query
+    // over the region or, without one, the whole table
+    std::vector<TargetSums> sum_by_target(double origin_x, double origin_y,
+                                          const std::optional<DataRegion>& region = std::nullopt);
+
     // Get all distinct target values from the table
     std::vector<std::string> get_distinct_targets();
 
@@ -49,6 +49,10 @@ public:
     // Validate table name (must match [A-Za-z0-9_]+)
     static bool is_valid_table_name(const std::string& name);
 
+    // Page-cache hits and misses since the connection opened or the last
+    // call with reset = true
+    bool page_cache_usage(int& hits, int& misses, bool reset);
+
     // Access to raw connection (for advanced operations)
     sqlite3* connection();
 
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "viewport.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace datapainter {
+
+// Bit-packed braille occupancy for the edit area
+//
+// Each terminal cell is split into a 2x4 dot matrix stored as one byte whose
+// bits follow the Unicode braille dot order, so a cell's glyph is
+// U+2800 + byte and binning a point is one OR into that byte. Dot
+// coordinates refine the viewport's cell mapping: dot (row, col) lies in
+// cell (row / 4, col / 2), the same cell Viewport::data_to_screen() picks.
+class DotGrid {
+public:
+    static constexpr int DOTS_PER_ROW = 4;  // Dot rows per cell
+    static constexpr int DOTS_PER_COL = 2;  // Dot columns per cell
+
+    // Size the grid for a frame, clear it and take the viewport's data to
+    // dot mapping
+    void reset(const Viewport& viewport, int rows, int cols);
+
+    // Map a data point to dot coordinates; false outside the data window
+    bool locate(double x, double y, int& dot_row, int& dot_col) const {
+        if (!(x >= x_min_ && x <= x_max_ && y >= y_min_ && y <= y_max_)) {
+            return false;
+        }
+        // round(f) == floor(f + 0.5) for f >= 0, so scaling the half-cell
+        // offset by the dot count subdivides exactly the viewport's cells
+        dot_col = static_cast<int>((x - x_min_) * x_scale_ + x_offset_);
+        dot_row = static_cast<int>((y_max_ - y) * y_scale_ + y_offset_);
+        dot_col = dot_col < max_dot_col_ ? dot_col : max_dot_col_;
+        dot_row = dot_row < max_dot_row_ ? dot_row : max_dot_row_;
+        return true;
+    }
+
+    // Set a dot; out-of-range dots are ignored
+    void set(int dot_row, int dot_col) {
+        int row = dot_row / DOTS_PER_ROW;
+        int col = dot_col / DOTS_PER_COL;
+        if (row < 0 || row >= rows_ || col < 0 || col >= cols_) {
+            return;
+        }
+        bits_[static_cast<size_t>(row) * static_cast<size_t>(cols_) + static_cast<size_t>(col)] |=
+            bit(dot_row % DOTS_PER_ROW, dot_col % DOTS_PER_COL);
+    }
+
+    // OR another grid of the same size (a worker's private grid) into this one
+    void merge(const DotGrid& other);
+
+    // Dots of cell (row, col) in braille bit order
+    uint8_t at(int row, int col) const {
+        return bits_[static_cast<size_t>(row) * static_cast<size_t>(cols_) + static_cast<size_t>(col)];
+    }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+
+    // Braille glyph for a cell's dots
+    static char32_t glyph(uint8_t dots) { return U'\u2800' + dots; }
+
+    // Bit of dot (row, col) within a cell's byte
+    static uint8_t bit(int dot_row, int dot_col) { return DOT_BITS[dot_row][dot_col]; }
+
+private:
+    // Braille dots 1-8 by (dot row, dot column) within a cell
+    static constexpr uint8_t DOT_BITS[DOTS_PER_ROW][DOTS_PER_COL] = {
+        {0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+
+    int rows_ = 0;
+    int cols_ = 0;
+    std::vector<uint8_t> bits_;
+
+    double x_min_ = 0.0;
+    double x_max_ = 0.0;
+    double y_min_ = 0.0;
+    double y_max_ = 0.0;
+    double x_scale_ = 0.0;   // Dots per data unit
+    double y_scale_ = 0.0;
+    double x_offset_ = 0.0;  // Half a cell, in dots
+    double y_offset_ = 0.0;
+    int max_dot_col_ = 0;
+    int max_dot_row_ = 0;
+};
+
+}  // namespace datapainter
@@ -1,9 +1,16 @@
 #pragma once
 
+#include "cell_grid.h"
+#include "class_palette.h"
+#include "dot_grid.h"
 #include "terminal.h"
+#include "thread_pool.h"
 #include "viewport.h"
 #include "data_table.h"
 #include "unsaved_changes.h"
+#include <map>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace datapainter {
@@ -13,6 +20,77 @@ class EditAreaRenderer {
 public:
     EditAreaRenderer() = default;
 
+    // How binned cells are drawn:
+    //   POINTS:  class glyph per cell ('#' where classes mix)
+    //   DENSITY: shade block by log point count relative to the busiest
+    //            cell, coloured from red (all x) through white to blue
+    //            (all o), or by the majority class when other classes are in
+    //            the cell
+    //   BRAILLE: 2x4 braille dots per cell placed at each point's sub-cell
+    //            position, coloured as in DENSITY
+    enum class Mode { POINTS, DENSITY, BRAILLE };
+    void set_mode(Mode mode) { mode_ = mode; }
+    Mode mode() const { return mode_; }
+
+    // Mode by name ("points", "density", "braille") and back
+    static std::optional<Mode> parse_mode(const std::string& name);
+    static const char* mode_name(Mode mode);
+
+    // Mode after mode in the 'm' key cycle
+    static Mode next_mode(Mode mode);
+
+    // Density shade ramp, lightest level first, and its ASCII fallbacks
+    static constexpr int DENSITY_LEVELS = 4;
+    static char32_t density_glyph(int level);
+    static char density_fallback(int level);
+
+    // Ramp level of a point count relative to the busiest cell:
+    // ceil(LEVELS * log(1 + count) / log(1 + max)) - 1, found by comparing
+    // with thresholds computed once per frame instead of a log per cell
+    class DensityScale {
+    public:
+        explicit DensityScale(uint32_t max_count);
+        int level(uint32_t count) const;
+
+    private:
+        double thresholds_[DENSITY_LEVELS - 1];
+    };
+
+    // Character for a binned cell: '#' when classes mix, otherwise the
+    // class glyph (multi-point glyph for more than one point)
+    static char cell_char(const CellGrid::Cell& cell, const ClassPalette& palette);
+
+    // Colour for a density or braille cell: x/o-only cells bucket their x
+    // share into a blue-white-red diverging palette, others take their
+    // majority class's colour
+    static Terminal::Color blend_color(const CellGrid::Cell& cell, const ClassPalette& palette);
+
+    // Bin the points inside viewport, with unsaved changes applied, into a
+    // rows x cols grid (viewport screen coordinates) without drawing; in
+    // braille mode dots() is filled too. Valid until the next bin() or
+    // render().
+    const CellGrid& bin(const Viewport& viewport, DataTable& table,
+                        const std::vector<ChangeRecord>& unsaved_changes,
+                        int rows, int cols, ClassPalette& palette);
+
+    // Same, for points already queried from the viewport
+    const CellGrid& bin_points(const Viewport& viewport, const std::vector<DataPoint>& points,
+                               const std::vector<ChangeRecord>& unsaved_changes,
+                               int rows, int cols, ClassPalette& palette);
+    const DotGrid& dots() const { return dots_; }
+
+    // Pool that splits binning of large point sets (ThreadPool::shared()
+    // unless set); each worker bins into a private grid and the grids are
+    // merged, so the result matches a single-threaded pass
+    void set_thread_pool(ThreadPool& pool) { pool_ = &pool; }
+
+    // Fewest points worth splitting across workers
+    static constexpr size_t PARALLEL_MIN_POINTS = 32768;
+
+    // Largest grid (cells) given a private copy per worker; bigger grids,
+    // such as large snapshots, are binned on one thread
+    static constexpr size_t PARALLEL_MAX_GRID_CELLS = 1 << 18;
+
     // Render the edit area to the terminal
     // Parameters:
     //   terminal: Terminal buffer to render to
@@ -26,21 +104,52 @@ public:
     //   cursor_col: Current cursor column position (in screen coordinates)
     //   x_target: Target value that represents 'x' points
     //   o_target: Target value that represents 'o' points
+    // Other targets are drawn with default glyphs (see ClassPalette)
     void render(Terminal& terminal, const Viewport& viewport, DataTable& table,
                 const std::vector<ChangeRecord>& unsaved_changes, int start_row,
                 int height, int width, int cursor_row, int cursor_col,
                 const std::string& x_target, const std::string& o_target);
 
+    // Same, with glyphs and colours from palette; targets not yet in the
+    // palette are registered as they are seen
+    void render(Terminal& terminal, const Viewport& viewport, DataTable& table,
+                const std::vector<ChangeRecord>& unsaved_changes, int start_row,
+                int height, int width, int cursor_row, int cursor_col,
+                ClassPalette& palette);
+
+    // Write a label into the border row `row` of an edit area `width`
+    // columns wide, two columns in; skipped when it would reach a corner
+    static void draw_border_label(Terminal& terminal, int row, int width, const std::string& label);
+
 private:
     void draw_border(Terminal& terminal, int start_row, int height, int width);
     void render_points(Terminal& terminal, const Viewport& viewport, DataTable& table,
                        const std::vector<ChangeRecord>& unsaved_changes,
-                       int start_row, int height, int width,
-                       const std::string& x_target, const std::string& o_target);
+                       int start_row, int height, int width, ClassPalette& palette);
     void draw_cursor(Terminal& terminal, int cursor_row, int cursor_col);
 
-    // Character to use for different point combinations
-    char get_point_char(int x_count, int o_count) const;
+    // Draw the binned grid as density shades
+    void draw_density(Terminal& terminal, int start_row, const ClassPalette& palette) const;
+
+    // Bin points across the pool's workers into grid_ (and dots_); false if
+    // the pool, point count or grid size make a single pass the better choice
+    bool bin_parallel(const Viewport& viewport, const std::vector<DataPoint>& points,
+                      const std::map<int, bool>& deleted_ids,
+                      const std::map<int, std::string>& updated_targets, ClassPalette& palette);
+
+    Mode mode_ = Mode::POINTS;
+    CellGrid grid_;                 // Reused across frames
+    DotGrid dots_;                  // Braille mode only
+    ThreadPool* pool_ = nullptr;    // nullptr: ThreadPool::shared()
+
+    // Per-worker scratch for bin_parallel(), reused across frames
+    struct WorkerBins {
+        CellGrid grid;
+        DotGrid dots;
+        std::vector<size_t> deferred;  // Points with targets not yet in the palette
+    };
+    std::vector<WorkerBins> workers_;
+    ClassPalette default_palette_;  // For the x/o target overload
 };
 
 }  // namespace datapainter
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace datapainter {
+
+// poll()-based reactor for the interactive session
+//
+// wait() sleeps in a single poll() on the caller's fd (stdin) and a
+// process-wide self-pipe fed by the SIGWINCH handler. The poll timeout is
+// the next timer deadline, so an idle session with no timers never wakes
+// up. Timers run on the thread calling wait().
+//
+// A pipe is used rather than signalfd/timerfd so the same code runs on
+// macOS and the BSDs.
+class EventLoop {
+public:
+    using Callback = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    // Why wait() returned
+    enum class Wake {
+        READABLE,  // The watched fd has input
+        RESIZE,    // SIGWINCH arrived
+        TASKS,     // Timers ran
+        ERROR      // poll() failed
+    };
+
+    EventLoop();
+
+    // Block until fd is readable (fd < 0 waits for the other sources only)
+    Wake wait(int fd);
+
+    // Run callback after delay, then every delay if repeat; returns an id
+    int add_timer(std::chrono::milliseconds delay, Callback callback, bool repeat = false);
+    bool cancel_timer(int id);
+    size_t timer_count() const { return timers_.size(); }
+
+    // Milliseconds until the next timer is due; -1 without timers
+    int next_timeout_ms() const;
+
+    // Route SIGWINCH into wait(). A previous handler (ncurses) is still
+    // called. Safe to call more than once.
+    static bool watch_resize();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+private:
+    struct Timer {
+        int id;
+        Clock::time_point due;
+        std::chrono::milliseconds interval;
+        bool repeat;
+        Callback callback;
+    };
+
+    std::vector<Timer> timers_;
+    int next_timer_id_;
+
+    // Run due timers; true if any ran
+    bool run_timers();
+};
+
+}  // namespace datapainter
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "terminal.h"
+#include "text_buffer.h"
 
 namespace datapainter {
 
@@ -30,13 +31,29 @@ public:
                 double vp_x_min, double vp_x_max, double vp_y_min, double vp_y_max,
                 int focused_button, int unsaved_changes_count = 0);
 
+    // Show a fitted model's training accuracy (0-1) and mean log-loss after
+    // the unsaved changes indicator, until clear_fit()
+    void set_fit(double accuracy, double loss) {
+        has_fit_ = true;
+        fit_accuracy_ = accuracy;
+        fit_loss_ = loss;
+    }
+    void clear_fit() { has_fit_ = false; }
+
 private:
     // Calculate appropriate precision for displaying coordinates
     // based on viewport size and screen dimensions
     int calculate_precision(double range, int screen_size) const;
 
-    // Format a coordinate value with specified precision
-    std::string format_coord(double value, int precision) const;
+    // Append a coordinate value with specified precision
+    void append_coord(TextBuffer& out, double value, int precision) const;
+
+    // Reused across frames so rendering does not allocate
+    TextBuffer footer_;
+
+    bool has_fit_ = false;
+    double fit_accuracy_ = 0.0;
+    double fit_loss_ = 0.0;
 };
 
 }  // namespace datapainter
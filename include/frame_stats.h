@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace datapainter {
+
+// Phases of handling a keystroke and drawing the resulting frame
+enum class Phase {
+    INPUT,      // Key handling (model updates, journal writes)
+    QUERY,      // SQLite viewport queries
+    JOURNAL,    // Loading unsaved changes
+    OVERLAY,    // Building delete/update maps from the journal
+    BIN,        // Binning points into screen cells
+    HEADER,     // Header renderer
+    EDIT_AREA,  // Edit area border, forbidden area and glyphs
+    AXES,       // Axis ticks, labels and zero bars
+    FOOTER,     // Footer renderer
+    TERMINAL,   // Presenting the buffer to the terminal
+    COUNT
+};
+
+constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::COUNT);
+
+// Short lowercase name for reports ("query", "edit_area", ...)
+const char* phase_name(Phase phase);
+
+// Per-frame timing and counters shared by the profilers and the HUD
+//
+// Collection is off by default; while disabled PhaseTimer does not read the
+// clock, so the instrumentation costs a single branch per scope.
+// Phase times are exclusive: a nested timer pauses the enclosing one.
+class FrameStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static FrameStats& instance();
+
+    static void set_enabled(bool enabled) { enabled_ = enabled; }
+    static bool enabled() { return enabled_; }
+
+    // Clear all phase times and counters
+    void reset();
+
+    // Milliseconds spent in a phase since the last reset
+    double phase_ms(Phase phase) const { return phase_ms_[static_cast<size_t>(phase)]; }
+    double total_ms() const;
+
+    // Counters (only maintained while enabled)
+    void add_points_fetched(size_t count) { points_fetched_ += count; }
+    size_t points_fetched() const { return points_fetched_; }
+
+    void add_cells_written(size_t count) { cells_written_ += count; }
+    size_t cells_written() const { return cells_written_; }
+
+    void set_journal_length(size_t length) { journal_length_ = length; }
+    size_t journal_length() const { return journal_length_; }
+
+    void add_cache_usage(int hits, int misses) {
+        cache_hits_ += hits;
+        cache_misses_ += misses;
+    }
+    // SQLite page-cache hit rate in [0, 1]; negative if no pages were read
+    double cache_hit_rate() const;
+
+    // Heap allocations made while drawing the frame (DATAPAINTER_ALLOC_STATS builds)
+    void set_allocations(size_t count, size_t bytes) {
+        allocations_ = count;
+        allocated_bytes_ = bytes;
+    }
+    size_t allocations() const { return allocations_; }
+    size_t allocated_bytes() const { return allocated_bytes_; }
+
+    // Used by PhaseTimer
+    Phase enter(Phase phase, Clock::time_point now);
+    void leave(Phase phase, Phase previous, Clock::time_point now);
+
+private:
+    FrameStats();
+
+    static bool enabled_;
+
+    std::array<double, PHASE_COUNT> phase_ms_;
+    size_t points_fetched_;
+    size_t cells_written_;
+    size_t journal_length_;
+    long cache_hits_;
+    long cache_misses_;
+    size_t allocations_;
+    size_t allocated_bytes_;
+    Phase current_;  // Phase::COUNT when no timer is running
+    Clock::time_point phase_start_;
+
+    void credit(Phase phase, Clock::time_point now);
+};
+
+// Scoped timer attributing its lifetime to one phase
+class PhaseTimer {
+public:
+    explicit PhaseTimer(Phase phase)
+        : phase_(phase), previous_(Phase::COUNT), active_(FrameStats::enabled()) {
+        if (active_) {
+            previous_ = FrameStats::instance().enter(phase_, FrameStats::Clock::now());
+        }
+    }
+
+    ~PhaseTimer() {
+        if (active_) {
+            FrameStats::instance().leave(phase_, previous_, FrameStats::Clock::now());
+        }
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    Phase phase_;
+    Phase previous_;
+    bool active_;
+};
+
+}  // namespace datapainter
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "data_table.h"
 #include "terminal.h"
+#include "text_buffer.h"
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace datapainter {
 
@@ -41,10 +45,17 @@ public:
 
 private:
     // Extract just the filename from a full path
-    std::string extract_filename(const std::string& path) const;
+    std::string_view extract_filename(const std::string& path) const;
 
-    // Format a double value with appropriate precision
-    std::string format_value(double value) const;
+    // Append a double value with appropriate precision
+    void append_value(TextBuffer& out, double value) const;
+
+    // Row buffers reused across frames so rendering does not allocate
+    TextBuffer row0_left_;
+    TextBuffer row0_right_;
+    TextBuffer row1_;
+    TextBuffer row2_left_;
+    TextBuffer row2_right_;
 };
 
 }  // namespace datapainter
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "data_table.h"
+#include "unsaved_changes.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace datapainter {
+
+// Tracks what the journal's point edits add to per-class aggregates
+//
+// Counts, histograms and sums over the saved table stay right under the
+// journal if each insert, delete and conversion adds its effect once and
+// takes it back when undone. sync() compares every change with its effect
+// as of the last call and reports only the differences, so an edit costs
+// one update however long the journal is. A change that leaves the journal
+// was saved: its effect is in the table now, and the owner hears of it once
+// so it can fold it into whatever it holds for the saved points.
+class JournalDiff {
+public:
+    // A change's effect: the point at (x, y) leaves class `removed` and
+    // joins class `added`; either may be ClassPalette::NO_CLASS
+    struct Effect {
+        double x;
+        double y;
+        int removed;
+        int added;
+    };
+
+    // The owner's class for a target; NO_CLASS for targets it ignores
+    using Classify = std::function<int(const std::string& target)>;
+
+    // Add (sign +1) or take back (sign -1) an effect
+    using Apply = std::function<void(const Effect& effect, int sign)>;
+
+    // Report changed effects to `apply` and those of changes that left the
+    // journal to `saved`, if given. Updates carry no coordinates: their
+    // point is looked up in the table the first time they have an effect.
+    void sync(DataTable& table, const std::vector<ChangeRecord>& changes, const Classify& classify,
+              const Apply& apply, const std::function<void(const Effect&)>& saved = nullptr);
+
+    // Call fn with each change's current effect
+    void for_each(const std::function<void(const Effect&)>& fn) const;
+
+    // Forget every change, as after a reload from a table that has none
+    void clear() { applied_.clear(); }
+
+private:
+    struct Applied {
+        Effect effect;
+        bool located;   // effect.x and effect.y are set
+        uint32_t seen;  // sync() generation that last saw the change
+    };
+
+    std::unordered_map<int, Applied> applied_;  // By change id
+    uint32_t generation_ = 0;
+};
+
+}  // namespace datapainter
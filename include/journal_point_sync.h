@@ -0,0 +1,94 @@
+#pragma once
+
+#include "class_palette.h"
+#include "data_table.h"
+#include "unsaved_changes.h"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace datapainter {
+
+// Keeps a point store equal to the table plus its unsaved journal
+//
+// The overlays that model the whole point set (k-NN regions, logistic
+// regression, ...) hold their own copy of the points. sync() loads the
+// saved points into the store once, then pushes only the journal entries
+// whose state changed since the last call: an insert, delete, conversion or
+// undo is one add/remove/relabel, however large the table. Changes that
+// leave the journal were saved and stay in the store as they are (a saved
+// conversion or delete becomes the point's table state); the table is
+// reloaded only when the journal names a point that was never loaded.
+class JournalPointSync {
+public:
+    // Receives the edits; labels are ClassPalette indices, never NO_CLASS
+    class Sink {
+    public:
+        virtual ~Sink() = default;
+
+        // Replace the contents; the points take slots 0 .. n - 1 in order
+        virtual void reset(const std::vector<double>& xs, const std::vector<double>& ys,
+                           const std::vector<uint8_t>& labels) = 0;
+
+        // Add a point and return its slot, stable until the next reset()
+        virtual uint32_t add(double x, double y, int label) = 0;
+        virtual void remove(uint32_t slot) = 0;
+        virtual void relabel(uint32_t slot, int label) = 0;
+    };
+
+    // Bring the sink up to date; true if it was edited at all
+    bool sync(DataTable& table, const std::vector<ChangeRecord>& changes, ClassPalette& palette,
+              Sink& sink);
+    bool loaded() const { return loaded_; }
+
+    // Call fn(slot, id) for each point in the sink whose row is known: id is
+    // the data id of a saved point, or minus the change id of an unsaved
+    // insert, as PointEditor reports them
+    void for_each_point(const std::function<void(uint32_t slot, int id)>& fn) const;
+
+    // Inserts saved since the load, which stay in the sink without an id
+    size_t unidentified() const { return unidentified_; }
+
+    // Reload from the table on the next sync()
+    void invalidate() { loaded_ = false; }
+
+private:
+    struct Applied {
+        bool active;     // Whether the change is reflected in the sink
+        bool inserted;   // An insert, which owns its slot
+        bool deleted;    // A delete
+        bool saves;      // Active in the journal, so a save writes it
+        int data_id;     // Update/delete: the saved point edited
+        uint32_t slot;   // Insert: the point's slot
+        int label;       // Insert/update: class applied
+        uint32_t seen;   // sync() generation that last saw the change
+    };
+
+    struct Saved {
+        uint32_t slot;  // Slot while in the sink
+        double x;
+        double y;
+        int label;      // Class in the table; NO_CLASS if the palette is full
+        bool live;      // In the sink (not deleted in the journal)
+    };
+
+    bool loaded_ = false;
+    std::unordered_map<int, Saved> saved_;      // By data id
+    std::unordered_map<int, Applied> applied_;  // By change id
+    uint32_t generation_ = 0;
+    bool edited_ = false;
+    size_t unidentified_ = 0;
+
+    void load(DataTable& table, ClassPalette& palette, Sink& sink);
+
+    // Apply the journal; false if it names a data id that was not loaded
+    bool apply(const std::vector<ChangeRecord>& changes, ClassPalette& palette, Sink& sink);
+
+    // Recompute a saved point's presence and class from its active journal
+    // deletes and updates
+    void settle(int data_id, Saved& saved, const std::vector<ChangeRecord>& changes,
+                ClassPalette& palette, Sink& sink);
+};
+
+}  // namespace datapainter
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace datapainter {
+
+// Minimal JSON document model used by the RPC protocol (--serve / --connect)
+// Objects keep their keys in insertion order so responses are deterministic
+class JsonValue {
+public:
+    enum class Type {
+        NUL,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    JsonValue();  // null
+    JsonValue(bool value);
+    JsonValue(int value);
+    JsonValue(double value);
+    JsonValue(const char* value);
+    JsonValue(std::string value);
+
+    // Create empty containers
+    static JsonValue array();
+    static JsonValue object();
+
+    Type type() const { return type_; }
+    bool is_null() const { return type_ == Type::NUL; }
+    bool is_bool() const { return type_ == Type::BOOLEAN; }
+    bool is_number() const { return type_ == Type::NUMBER; }
+    bool is_string() const { return type_ == Type::STRING; }
+    bool is_array() const { return type_ == Type::ARRAY; }
+    bool is_object() const { return type_ == Type::OBJECT; }
+
+    // Accessors (return a default value if the type does not match)
+    bool as_bool() const { return type_ == Type::BOOLEAN && bool_; }
+    double as_number() const { return type_ == Type::NUMBER ? number_ : 0.0; }
+    const std::string& as_string() const { return string_; }
+    const std::vector<JsonValue>& as_array() const { return array_; }
+    const std::vector<std::pair<std::string, JsonValue>>& as_object() const { return object_; }
+
+    // Array operations
+    void push_back(JsonValue value);
+    size_t size() const;
+
+    // Object operations (set replaces an existing key)
+    void set(const std::string& key, JsonValue value);
+    const JsonValue* find(const std::string& key) const;
+
+    // Typed lookups on objects (nullopt if missing or of the wrong type)
+    std::optional<double> get_number(const std::string& key) const;
+    std::optional<int> get_int(const std::string& key) const;
+    std::optional<std::string> get_string(const std::string& key) const;
+    std::optional<bool> get_bool(const std::string& key) const;
+
+    // Serialize to compact JSON text
+    std::string dump() const;
+
+    // Parse JSON text (returns nullopt and fills error on malformed input)
+    static std::optional<JsonValue> parse(const std::string& text, std::string* error = nullptr);
+
+private:
+    void dump_to(std::string& out) const;
+
+    Type type_;
+    bool bool_;
+    double number_;
+    std::string string_;
+    std::vector<JsonValue> array_;
+    std::vector<std::pair<std::string, JsonValue>> object_;
+};
+
+}  // namespace datapainter
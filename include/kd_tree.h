@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace datapainter {
+
+// 2-D k-d tree of labelled points that is edited in place
+//
+// build() sorts the initial points into a balanced tree with small leaf
+// buckets. insert() appends to the leaf whose region holds the point and
+// splits that leaf at its median once it overflows, so painting many points
+// in one spot refines only that part of the tree. remove() drops the point
+// from its leaf. Nothing is ever rebuilt wholesale after the first build.
+// Queries only read the tree, so any number of threads may run them
+// between edits.
+class KdTree {
+public:
+    static constexpr int LEAF_SIZE = 16;  // Points per leaf before it splits
+    static constexpr int MAX_K = 32;
+
+    struct Neighbour {
+        uint32_t slot;    // Point slot (see insert())
+        double distance2; // Squared distance to the query point
+    };
+
+    // Replace the contents with these points; slots are 0 .. n - 1 in order
+    void build(const std::vector<double>& xs, const std::vector<double>& ys,
+               const std::vector<uint8_t>& labels);
+
+    // Add a point and return its slot, stable until the next build()
+    uint32_t insert(double x, double y, uint8_t label);
+
+    // Remove the point in slot; false if it is not in the tree
+    bool remove(uint32_t slot);
+
+    // Change the label of the point in slot
+    void relabel(uint32_t slot, uint8_t label) { points_[slot].label = label; }
+
+    // Live points
+    size_t size() const { return live_; }
+
+    double x(uint32_t slot) const { return points_[slot].x; }
+    double y(uint32_t slot) const { return points_[slot].y; }
+    uint8_t label(uint32_t slot) const { return points_[slot].label; }
+
+    // Up to k (<= MAX_K) nearest live points to (x, y), nearest first;
+    // returns how many were written to out
+    int nearest(double x, double y, int k, Neighbour* out) const;
+
+private:
+    struct Point {
+        double x;
+        double y;
+        uint8_t label;
+        bool live;
+        uint32_t leaf;  // Node holding the point while live
+    };
+
+    struct Node {
+        int axis = -1;        // 0 splits on x, 1 on y, -1 for a leaf
+        double split = 0.0;   // Points < split go left
+        uint32_t left = 0;
+        uint32_t right = 0;
+        std::vector<uint32_t> slots;  // Leaf contents
+    };
+
+    std::vector<Point> points_;
+    std::vector<Node> nodes_;
+    size_t live_ = 0;
+
+    // Build a subtree over slots[begin, end) and return its node
+    uint32_t build_node(std::vector<uint32_t>& slots, size_t begin, size_t end);
+
+    // Turn an overflowing leaf into a split node with two leaves
+    void split_leaf(uint32_t node);
+
+    uint32_t new_leaf();
+
+    // Nearest-first search of a subtree into best[0 .. count)
+    void search(uint32_t node, double x, double y, int k, Neighbour* best, int& count) const;
+};
+
+}  // namespace datapainter
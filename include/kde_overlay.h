@@ -0,0 +1,111 @@
+#pragma once
+
+#include "class_palette.h"
+#include "data_table.h"
+#include "journal_diff.h"
+#include "terminal.h"
+#include "thread_pool.h"
+#include "unsaved_changes.h"
+#include "viewport.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace datapainter {
+
+// Per-class kernel density contours for the edit area, toggled with 'c'
+//
+// Points of the x and o classes are counted onto a GRID x GRID histogram
+// over the valid range by one aggregate query per class, then kept in step
+// with the journal by a JournalDiff. Each histogram is smoothed by
+// a separable Gaussian: a direct convolution along rows and columns when
+// the kernel is narrow, otherwise an FFT of each zero-padded line. So the
+// cost of a refresh depends on GRID and the bandwidth, not on how many
+// points the table holds. Contours are drawn at the densities enclosing
+// 25%, 50% and 75% of each class's mass, on blank cells only.
+class KdeOverlay {
+public:
+    static constexpr int GRID = 512;                 // Histogram bins per axis
+    static constexpr int MAX_DIRECT_RADIUS = 24;     // Wider kernels use the FFT
+    static constexpr double KERNEL_SIGMAS = 4.0;     // Kernel truncated at this many sigma
+    static constexpr double MASS_LEVELS[] = {0.25, 0.5, 0.75};
+    static constexpr int LEVELS = 3;
+
+    enum class Method { AUTO, DIRECT, FFT };
+
+    // Count the points over the valid range unless already loaded for
+    // exactly these bounds
+    void ensure_loaded(DataTable& table, const ClassPalette& palette,
+                       double x_min, double x_max, double y_min, double y_max);
+    bool loaded() const { return loaded_; }
+
+    // The table changed outside the journal: count again when next loaded
+    void invalidate() { loaded_ = false; }
+
+    // Apply journal changes not yet reflected in the counts. Changes that
+    // have left the journal are assumed saved, so their counts are kept.
+    void sync(DataTable& table, const std::vector<ChangeRecord>& changes, const ClassPalette& palette);
+
+    // Fixed bandwidth in data units on both axes; nullopt uses Scott's rule
+    // per class and axis. scale_bandwidth() multiplies either ('[' and ']').
+    void set_bandwidth(std::optional<double> bandwidth);
+    void scale_bandwidth(double factor);
+    double bandwidth_scale() const { return scale_; }
+
+    // Kernel standard deviation in data units for class 0 or 1 along axis
+    // 0 (x) or 1 (y), as of the last update()
+    double bandwidth(int cls, int axis) const;
+
+    // Smooth any histograms changed since the last call and find their
+    // contour levels; render() calls this
+    void update();
+
+    // Smoothed density of class 0 or 1 at a data point (bilinear between bin
+    // centres, in points per bin), and the density enclosing MASS_LEVELS[i]
+    double density(int cls, double x, double y) const;
+    double level(int cls, int i) const { return levels_[cls][i]; }
+
+    // Points counted for class 0 (x) or 1 (o)
+    int64_t count(int cls) const { return totals_[cls]; }
+
+    // Draw the contours on the blank cells of an edit area drawn at
+    // start_row, and the bandwidth on its top border
+    void render(Terminal& terminal, const Viewport& viewport, const ClassPalette& palette,
+                int start_row, int height, int width);
+
+    // Convolve a row-major rows x cols grid with a Gaussian of the given
+    // standard deviations (in bins) along each axis; zero outside the grid
+    static void blur(std::vector<float>& grid, int rows, int cols, double sigma_rows,
+                     double sigma_cols, Method method, ThreadPool& pool);
+
+    void set_thread_pool(ThreadPool& pool) { pool_ = &pool; }
+
+private:
+    bool loaded_ = false;
+    double x_min_ = 0.0;
+    double x_max_ = 0.0;
+    double y_min_ = 0.0;
+    double y_max_ = 0.0;
+    std::vector<float> counts_[2];
+    std::vector<float> density_[2];
+    int64_t totals_[2] = {0, 0};
+    double levels_[2][LEVELS] = {};
+    bool dirty_[2] = {true, true};
+    JournalDiff journal_;
+
+    double scott_[2][2] = {};  // Scott's rule by class and axis, data units
+    std::optional<double> fixed_bandwidth_;
+    double scale_ = 1.0;
+    ThreadPool* pool_ = nullptr;  // nullptr: ThreadPool::shared()
+
+    // Scratch for render(): density per cell and class
+    std::vector<float> cells_[2];
+
+    // Histogram bin of a data coordinate; -1 outside the valid range
+    int bin_of(double x, double y) const;
+    void add(int bin, int cls, float delta);
+    void scott_bandwidth(int cls);
+    void find_levels(int cls);
+};
+
+}  // namespace datapainter
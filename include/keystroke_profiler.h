@@ -0,0 +1,58 @@
+#pragma once
+
+#include "frame_stats.h"
+#include <array>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace datapainter {
+
+// Collects per-keystroke latency samples for --profile-keystrokes
+//
+// Each sample is the FrameStats phase breakdown accumulated between two
+// keystrokes: handling the key plus drawing the frame it caused.
+class KeystrokeProfiler {
+public:
+    // Record one keystroke using the phase times currently in stats
+    void record(int key, const FrameStats& stats);
+
+    size_t sample_count() const { return samples_.size(); }
+
+    // Write the report; JSON if path ends in ".json", otherwise a text table
+    // Returns false if the file could not be written
+    bool write_report(const std::string& path) const;
+
+    void write_table(std::ostream& out) const;
+    void write_json(std::ostream& out) const;
+
+    // Display name for a key code ("x", "<up>", "<dump>", ...)
+    static std::string key_label(int key);
+
+    // Nearest-rank percentile (p in [0, 100]) of unsorted values
+    static double percentile(std::vector<double> values, double p);
+
+private:
+    struct Sample {
+        std::string label;
+        double total_ms;
+        std::array<double, PHASE_COUNT> phase_ms;
+    };
+
+    struct Summary {
+        size_t count;
+        double p50;
+        double p95;
+        double p99;
+        double max;
+    };
+
+    std::vector<Sample> samples_;
+
+    static Summary summarize(const std::vector<double>& values);
+
+    // Labels in first-seen order
+    std::vector<std::string> labels() const;
+};
+
+}  // namespace datapainter
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "class_palette.h"
+#include "data_table.h"
+#include "database.h"
+#include "journal_point_sync.h"
+#include "terminal.h"
+#include "thread_pool.h"
+#include "unsaved_changes.h"
+#include "viewport.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace datapainter {
+
+// k-means clusters of the effective point set as suggestions, run with 'C'
+//
+// The points are kept in step with the table and its journal by a
+// JournalPointSync. run() scales them to [-1, 1] over the valid range,
+// seeds centres with k-means++ and runs Lloyd iterations until no point
+// changes cluster or no centre moves by more than TOLERANCE. Hamerly's
+// distance bounds skip points that cannot have changed cluster; the rest
+// are compared four at a time against every centre with SSE2 (a scalar
+// loop elsewhere), split over the thread pool. The result is shown as Voronoi
+// boundaries and numbered centres until the points change. apply() then
+// converts every point to its cluster's majority class, as one batch of
+// journal entries.
+class KmeansOverlay : private JournalPointSync::Sink {
+public:
+    static constexpr int DEFAULT_K = 4;
+    static constexpr int MAX_K = 16;
+    static constexpr int MAX_ITERATIONS = 100;
+    static constexpr double TOLERANCE = 1e-3;  // Centre shift (scaled) that ends the run
+
+    void set_k(int k);
+    int k() const { return k_; }
+
+    // Keep the points up to date; any change drops the last result
+    void sync(DataTable& table, const std::vector<ChangeRecord>& changes, ClassPalette& palette);
+
+    // The table changed outside the journal: reload on the next sync(),
+    // which drops the last result
+    void invalidate() { sync_.invalidate(); }
+
+    // Bring the points up to date and cluster them. Coordinates are scaled
+    // to [-1, 1] over the given range first.
+    void run(DataTable& table, const std::vector<ChangeRecord>& changes, ClassPalette& palette,
+             double x_min, double x_max, double y_min, double y_max);
+
+    // A result is shown until the points change or clear()
+    bool has_result() const { return has_result_; }
+    void clear() { has_result_ = false; }
+
+    // Result of the last run()
+    int clusters() const { return static_cast<int>(centres_x_.size()); }
+    double centre_x(int cluster) const;
+    double centre_y(int cluster) const;
+    int64_t cluster_size(int cluster) const { return sizes_[static_cast<size_t>(cluster)]; }
+    int majority(int cluster) const { return majority_[static_cast<size_t>(cluster)]; }
+    int cluster_of_slot(uint32_t slot) const { return slot_cluster_[slot]; }
+    int iterations() const { return iterations_; }
+    double inertia() const { return inertia_; }  // Mean squared scaled distance
+    double elapsed_ms() const { return elapsed_ms_; }
+
+    // Points whose class differs from their cluster's majority
+    int64_t suggested_changes() const { return suggested_changes_; }
+
+    // Convert those points to their cluster's majority class in one
+    // transaction. Returns the number of points converted, or nullopt if
+    // the journal could not be written (nothing is).
+    [[nodiscard]] std::optional<int> apply(Database& db, const std::string& table_name, const ClassPalette& palette);
+
+    // Draw the cluster boundaries on blank cells and the centres on top,
+    // with a summary on the bottom border
+    void render(Terminal& terminal, const Viewport& viewport, int start_row, int height, int width);
+
+    // Nearest of k centres for n points, written to cluster and distance2,
+    // and the squared distance to the second nearest to second2 unless null
+    static void nearest_centres(const float* xs, const float* ys, size_t n, const float* centres_x,
+                                const float* centres_y, int k, uint8_t* cluster, float* distance2,
+                                float* second2);
+
+    void set_thread_pool(ThreadPool& pool) { pool_ = &pool; }
+
+private:
+    static constexpr uint8_t UNUSED = 0xFF;  // Free slot
+
+    int k_ = DEFAULT_K;
+    JournalPointSync sync_;
+    std::vector<double> xs_;
+    std::vector<double> ys_;
+    std::vector<uint8_t> labels_;  // ClassPalette index, UNUSED
+    std::vector<uint32_t> free_slots_;
+
+    // Result
+    bool has_result_ = false;
+    double centre_[2] = {0.0, 0.0};  // Scaling: u = (x - centre) / half-width
+    double scale_[2] = {1.0, 1.0};
+    std::vector<float> centres_x_;   // Scaled
+    std::vector<float> centres_y_;
+    std::vector<int64_t> sizes_;
+    std::vector<int> majority_;
+    std::vector<uint8_t> slot_cluster_;  // By slot; UNUSED for free slots
+    int iterations_ = 0;
+    double inertia_ = 0.0;
+    double elapsed_ms_ = 0.0;
+    int64_t suggested_changes_ = 0;
+    ThreadPool* pool_ = nullptr;  // nullptr: ThreadPool::shared()
+
+    // Scratch for render(): nearest centre per cell
+    std::vector<uint8_t> cells_;
+
+    void reset(const std::vector<double>& xs, const std::vector<double>& ys,
+               const std::vector<uint8_t>& labels) override;
+    uint32_t add(double x, double y, int label) override;
+    void remove(uint32_t slot) override;
+    void relabel(uint32_t slot, int label) override;
+
+    // Nearest centre of a scaled position
+    int nearest(double u, double v) const;
+};
+
+}  // namespace datapainter
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "class_palette.h"
+#include "data_table.h"
+#include "journal_point_sync.h"
+#include "kd_tree.h"
+#include "terminal.h"
+#include "thread_pool.h"
+#include "unsaved_changes.h"
+#include "viewport.h"
+#include <cstdint>
+#include <vector>
+
+namespace datapainter {
+
+// k-nearest-neighbour decision regions for the edit area, toggled with 'n'
+//
+// A KdTree holds every effective point, kept in step with the table and its
+// journal by a JournalPointSync, so painting a point is one tree insert.
+// Each empty edit-area cell is then shaded with the majority class of the
+// k points nearest its centre: '.' inside a region and ':' on the boundary
+// between regions. Cells are predicted in parallel and only recomputed when
+// the tree or the viewport changes.
+class KnnOverlay : private JournalPointSync::Sink {
+public:
+    static constexpr int DEFAULT_K = 5;
+
+    void set_k(int k);
+    int k() const { return k_; }
+
+    // Bring the tree up to date with the table and its journal
+    void sync(DataTable& table, const std::vector<ChangeRecord>& changes, ClassPalette& palette);
+    bool loaded() const { return sync_.loaded(); }
+
+    // The table changed outside the journal: reload on the next sync()
+    void invalidate() { sync_.invalidate(); }
+
+    // Predicted class (ClassPalette index) at a data point; NO_CLASS when
+    // the tree is empty. Ties go to the class of the nearest tied point.
+    int predict(double x, double y) const;
+
+    // Shade the blank cells of an edit area drawn at start_row
+    void render(Terminal& terminal, const Viewport& viewport, const ClassPalette& palette,
+                int start_row, int height, int width);
+
+    // Prediction of content cell (row, col) from the last render()
+    int cell_class(int row, int col) const {
+        return predictions_[static_cast<size_t>(row) * static_cast<size_t>(cols_) + static_cast<size_t>(col)];
+    }
+
+    // Points in the tree
+    size_t size() const { return tree_.size(); }
+
+    void set_thread_pool(ThreadPool& pool) { pool_ = &pool; }
+
+private:
+    int k_ = DEFAULT_K;
+    KdTree tree_;
+    JournalPointSync sync_;
+    uint64_t tree_version_ = 0;  // Bumped on every edit
+
+    // Last render()'s predictions and what they were computed for
+    std::vector<int> predictions_;
+    int rows_ = 0;
+    int cols_ = 0;
+    double view_[4] = {0.0, 0.0, 0.0, 0.0};
+    uint64_t predicted_version_ = UINT64_MAX;
+    int predicted_k_ = 0;
+    ThreadPool* pool_ = nullptr;  // nullptr: ThreadPool::shared()
+
+    void reset(const std::vector<double>& xs, const std::vector<double>& ys,
+               const std::vector<uint8_t>& labels) override {
+        tree_.build(xs, ys, labels);
+    }
+    uint32_t add(double x, double y, int label) override {
+        return tree_.insert(x, y, static_cast<uint8_t>(label));
+    }
+    void remove(uint32_t slot) override { tree_.remove(slot); }
+    void relabel(uint32_t slot, int label) override { tree_.relabel(slot, static_cast<uint8_t>(label)); }
+
+    void predict_cells(const Viewport& viewport, int rows, int cols);
+    static Terminal::Color region_color(int label, const ClassPalette& palette);
+};
+
+}  // namespace datapainter
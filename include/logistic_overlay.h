@@ -0,0 +1,103 @@
+#pragma once
+
+#include "class_palette.h"
+#include "data_table.h"
+#include "journal_point_sync.h"
+#include "moments.h"
+#include "terminal.h"
+#include "thread_pool.h"
+#include "unsaved_changes.h"
+#include "viewport.h"
+#include <cstdint>
+#include <vector>
+
+namespace datapainter {
+
+// Logistic regression of o against x over the point coordinates, drawn as
+// its decision line and probability bands, toggled with 'l'
+//
+// The points are held in flat arrays kept in step with the table and its
+// journal by a JournalPointSync, alongside running per-class moments
+// (count, sums and sums of squares and products). A fit runs Newton (IRLS)
+// steps from the previous weights, so after one painted point it usually
+// converges in one pass; the moments give a discriminant-analysis
+// starting point for the first fit. Each step is one parallel pass over the
+// points. Targets other than the x/o meanings are left out of the model.
+class LogisticOverlay : private JournalPointSync::Sink {
+public:
+    static constexpr int MAX_ITERATIONS = 25;
+    static constexpr double RIDGE = 1.0;        // L2 penalty on the scaled slopes
+    static constexpr double TOLERANCE = 1e-3;   // Newton step taken as the last one
+
+    // Coordinates are scaled to [-1, 1] over this range before fitting
+    void set_range(double x_min, double x_max, double y_min, double y_max);
+
+    // Bring the points up to date and refit if any changed
+    void sync(DataTable& table, const std::vector<ChangeRecord>& changes, ClassPalette& palette);
+
+    // The table changed outside the journal: reload on the next sync()
+    void invalidate() { sync_.invalidate(); }
+
+    // Newton steps from the current weights until converged
+    void fit();
+
+    // Both classes have points, so there is a model to show
+    bool fitted() const { return fitted_; }
+
+    // P(o) at a data point; 0.5 before a fit
+    double probability(double x, double y) const;
+
+    // Log-odds of o at a data point
+    double logit(double x, double y) const;
+
+    // Training accuracy and mean log-loss, from the last pass over the
+    // points (before the final, smaller than TOLERANCE, Newton step)
+    double accuracy() const { return accuracy_; }
+    double loss() const { return loss_; }
+
+    // Newton steps taken by the last fit()
+    int iterations() const { return iterations_; }
+
+    // Points of class 0 (x) or 1 (o) in the model
+    size_t count(int cls) const { return static_cast<size_t>(moments_[cls].count); }
+
+    // Draw the decision line and bands on the blank cells of an edit area
+    // drawn at start_row
+    void render(Terminal& terminal, const Viewport& viewport, const ClassPalette& palette,
+                int start_row, int height, int width) const;
+
+    void set_thread_pool(ThreadPool& pool) { pool_ = &pool; }
+
+private:
+    static constexpr uint8_t UNUSED = 0xFF;  // Slot of another class or free
+
+    JournalPointSync sync_;
+    std::vector<double> xs_;
+    std::vector<double> ys_;
+    std::vector<uint8_t> classes_;    // 0 x, 1 o, UNUSED
+    std::vector<uint32_t> free_slots_;
+    Moments moments_[2];  // By class, offsets from (0, 0)
+
+    // Scaling: u = (x - centre) / half-width
+    double centre_[2] = {0.0, 0.0};
+    double scale_[2] = {1.0, 1.0};
+
+    double weights_[3] = {0.0, 0.0, 0.0};  // Bias, x and y slopes (scaled)
+    bool warm_ = false;    // weights_ come from an earlier fit
+    bool fitted_ = false;
+    double accuracy_ = 0.0;
+    double loss_ = 0.0;
+    int iterations_ = 0;
+    ThreadPool* pool_ = nullptr;  // nullptr: ThreadPool::shared()
+
+    void reset(const std::vector<double>& xs, const std::vector<double>& ys,
+               const std::vector<uint8_t>& labels) override;
+    uint32_t add(double x, double y, int label) override;
+    void remove(uint32_t slot) override;
+    void relabel(uint32_t slot, int label) override;
+
+    // Discriminant-analysis weights from the moments
+    void initial_weights();
+};
+
+}  // namespace datapainter
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "data_table.h"
+#include "journal_diff.h"
+#include "terminal.h"
+#include "unsaved_changes.h"
+#include "viewport.h"
+#include <cstdint>
+#include <vector>
+
+namespace datapainter {
+
+// Overview of the table's whole valid range, toggled with 'M'
+//
+// Point counts per minimap cell come from one aggregate query when the
+// minimap is loaded. After that only journal inserts and deletes that
+// become active or inactive adjust them, so redrawing after a cursor move
+// or zoom runs no query. The current viewport is outlined on top.
+class Minimap {
+public:
+    static constexpr int ROWS = 8;   // Interior cells
+    static constexpr int COLS = 24;
+    static constexpr int HEIGHT = ROWS + 2;  // With border
+    static constexpr int WIDTH = COLS + 2;
+
+    // Query the counts for the valid range unless they are already loaded
+    // for exactly these bounds
+    void ensure_loaded(DataTable& table, double x_min, double x_max, double y_min, double y_max);
+    bool loaded() const { return loaded_; }
+
+    // The table changed outside the journal: query again when next loaded
+    void invalidate() { loaded_ = false; }
+
+    // Apply journal changes not yet reflected in the counts. Changes that
+    // have left the journal are assumed saved, so their counts are kept.
+    void sync(DataTable& table, const std::vector<ChangeRecord>& changes);
+
+    // Draw the box with its top-left corner at (top_row, left_col)
+    void render(Terminal& terminal, const Viewport& viewport, int top_row, int left_col) const;
+
+    // Points counted in interior cell (row, col)
+    int count_at(int row, int col) const { return counts_[static_cast<size_t>(row) * COLS + col]; }
+
+private:
+    bool loaded_ = false;
+    double x_min_ = 0.0;
+    double x_max_ = 0.0;
+    double y_min_ = 0.0;
+    double y_max_ = 0.0;
+    std::vector<int> counts_ = std::vector<int>(ROWS * COLS, 0);
+    JournalDiff journal_;  // Every target is one class: only inserts and deletes count
+
+    // Minimap cell of a data coordinate; false outside the valid range
+    bool cell_of(double x, double y, int& row, int& col) const;
+};
+
+}  // namespace datapainter
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "data_table.h"
+#include <cstdint>
+
+namespace datapainter {
+
+// Running sums of a set of points' offsets from an origin, from which the
+// count, centroid and covariance follow without revisiting the points
+struct Moments {
+    int64_t count = 0;
+    double sum_x = 0.0;
+    double sum_y = 0.0;
+    double sum_xx = 0.0;
+    double sum_yy = 0.0;
+    double sum_xy = 0.0;
+
+    // Add (sign +1) or remove (sign -1) the point offset by (dx, dy)
+    void add(double dx, double dy, int sign);
+    void add(const TargetSums& sums, int sign);
+    void add(const Moments& other, int sign);
+
+    // Centroid offset from the origin; 0 when empty
+    double mean_x() const { return count > 0 ? sum_x / static_cast<double>(count) : 0.0; }
+    double mean_y() const { return count > 0 ? sum_y / static_cast<double>(count) : 0.0; }
+
+    // Sample covariance entries; 0 below two points
+    double var_x() const;
+    double var_y() const;
+    double cov_xy() const;
+};
+
+}  // namespace datapainter
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "frame_stats.h"
+#include "terminal.h"
+#include <string>
+#include <vector>
+
+namespace datapainter {
+
+// On-screen performance overlay toggled with 'p'
+//
+// Shows the phase breakdown and counters of the last completed frame so an
+// operator can tell whether a slow session is bound by data size (query,
+// bin) or terminal bandwidth (terminal, cells).
+class PerfHud {
+public:
+    static constexpr int WIDTH = 30;
+
+    // Draw the HUD into the top-right corner, starting at top_row.
+    // Lines that do not fit below top_row are dropped.
+    void render(Terminal& terminal, const FrameStats& stats, int top_row) const;
+
+    // Text lines of the HUD box, each exactly WIDTH characters
+    std::vector<std::string> get_lines(const FrameStats& stats) const;
+};
+
+}  // namespace datapainter
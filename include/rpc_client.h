@@ -0,0 +1,45 @@
+#pragma once
+
+#include "argument_parser.h"
+#include "json_value.h"
+#include <optional>
+#include <ostream>
+#include <string>
+
+namespace datapainter {
+
+// Client side of --connect <socket>
+// Forwards a non-interactive command to a running --serve daemon instead of
+// opening the database in this process
+class RpcClient {
+public:
+    explicit RpcClient(const std::string& socket_path);
+    ~RpcClient();
+
+    // No copying (owns a socket descriptor)
+    RpcClient(const RpcClient&) = delete;
+    RpcClient& operator=(const RpcClient&) = delete;
+
+    // Connect to the daemon socket
+    bool connect();
+
+    // Send one request payload and wait for its response payload
+    std::optional<std::string> call(const std::string& payload);
+
+    const std::string& last_error() const { return error_; }
+
+    // Translate parsed CLI arguments into an RPC request
+    // Returns nullopt (and fills error) if the command cannot be forwarded
+    static std::optional<JsonValue> build_request(const Arguments& args, std::string& error);
+
+    // Forward the command described by args and print the daemon's output
+    // Returns the process exit code the equivalent local command would use
+    static int run(const Arguments& args, std::ostream& out, std::ostream& err);
+
+private:
+    std::string socket_path_;
+    int fd_;
+    std::string error_;
+};
+
+}  // namespace datapainter
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "database.h"
+#include "json_value.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace datapainter {
+
+// Long-lived request server for --serve <socket>
+//
+// Owns nothing but borrows the process's Database connection, so the SQLite
+// page cache, schema and prepared metadata stay warm between requests.
+//
+// Wire format: each message is a 4-byte big-endian length followed by a JSON
+// payload. Requests look like {"id": 1, "method": "add_point", "params": {...}}
+// and responses are {"id": 1, "result": {...}} or
+// {"id": 1, "error": {"code": 66, "message": "..."}} where code mirrors the
+// exit code the equivalent CLI command would return.
+class RpcServer {
+public:
+    explicit RpcServer(Database& db);
+
+    // Handle a single request payload and return the response payload
+    std::string handle_request(const std::string& payload);
+
+    // Handle several request payloads that arrived together
+    // Consecutive batchable writes share one transaction
+    std::vector<std::string> handle_batch(const std::vector<std::string>& payloads);
+
+    // True for single-statement writes that can share a transaction
+    static bool is_batchable_write(const std::string& method);
+
+    // Listen on a Unix domain socket until a "shutdown" request arrives
+    // Returns false if the socket could not be set up (see last_error())
+    bool serve(const std::string& socket_path, std::ostream& log);
+
+    // Lower the to_csv limit below MAX_CSV_SIZE (whole MiB), for tests
+    void set_max_csv_size(size_t bytes) { max_csv_size_ = bytes; }
+
+    // True once a "shutdown" request has been handled
+    bool stop_requested() const { return stop_requested_; }
+
+    const std::string& last_error() const { return error_; }
+
+    // Frame encoding helpers shared with RpcClient
+    static std::string encode_frame(const std::string& payload);
+
+    // Extract one complete frame from the front of buffer (consumes it)
+    // Returns false if the buffer does not yet hold a complete frame
+    static bool extract_frame(std::string& buffer, std::string& payload);
+
+    // Largest accepted frame (guards against garbage length prefixes)
+    static constexpr size_t MAX_FRAME_SIZE = 256 * 1024 * 1024;
+
+    // Largest to_csv output, which is built in memory and sent as one
+    // frame; bigger tables are exported without --connect
+    static constexpr size_t MAX_CSV_SIZE = 64 * 1024 * 1024;
+
+private:
+    // Outcome of a single method call
+    struct CallResult {
+        bool ok = true;
+        JsonValue result = JsonValue::object();
+        int error_code = 0;
+        std::string error_message;
+    };
+
+    Database& db_;
+    bool stop_requested_;
+    std::string error_;
+    size_t max_csv_size_ = MAX_CSV_SIZE;
+
+    CallResult dispatch(const std::string& method, const JsonValue& params);
+    static CallResult make_error(int code, const std::string& message);
+
+    // Extract and validate the "table" parameter; errors name the CLI
+    // command, as the CLI's own messages do
+    static bool get_table_param(const JsonValue& params, const std::string& command, std::string& table,
+                                CallResult& error);
+
+    // Parse a payload into (id, method, params); returns an error response on failure
+    bool parse_request(const std::string& payload, JsonValue& id, std::string& method,
+                       JsonValue& params, std::string& error_response) const;
+    static std::string build_response(const JsonValue& id, const CallResult& call);
+
+    // Method handlers
+    CallResult list_tables();
+    CallResult show_metadata(const JsonValue& params);
+    CallResult create_table(const JsonValue& params);
+    CallResult delete_table(const JsonValue& params);
+    CallResult add_point(const JsonValue& params);
+    CallResult delete_point(const JsonValue& params);
+    CallResult query_viewport(const JsonValue& params);
+    CallResult to_csv(const JsonValue& params);
+    CallResult list_unsaved_changes(const JsonValue& params);
+    CallResult commit_unsaved_changes(const JsonValue& params);
+    CallResult clear_undo_log(const JsonValue& params);
+    CallResult clear_all_undo_log();
+};
+
+}  // namespace datapainter
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "class_palette.h"
+#include "data_table.h"
+#include "edit_area_renderer.h"
+#include "unsaved_changes.h"
+#include "viewport.h"
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace datapainter {
+
+// Renders the edit area into a virtual canvas of any size, without a
+// terminal, and writes it as text or a binary PPM image
+// Used by --render-snapshot
+class SnapshotWriter {
+public:
+    enum class Format {
+        TEXT,  // One line per cell row, UTF-8 for shade and braille glyphs
+        PPM    // P6 image, one pixel per cell (2x4 per cell in braille mode)
+    };
+
+    // Canvas limits: cells per side and in total (each binned cell takes
+    // about 32 bytes while rendering)
+    static constexpr int MAX_SIDE = 8192;
+    static constexpr long MAX_CELLS = 4L * 1024 * 1024;
+
+    struct Size {
+        int width = 0;   // Cell columns
+        int height = 0;  // Cell rows
+    };
+
+    // Parse "<width>x<height>"; nullopt if malformed or outside the limits
+    static std::optional<Size> parse_size(const std::string& spec);
+
+    // PPM for paths ending in ".ppm", text otherwise
+    static Format format_for_path(const std::string& path);
+
+    SnapshotWriter(DataTable& table, ClassPalette& palette);
+
+    void set_mode(EditAreaRenderer::Mode mode) { renderer_.set_mode(mode); }
+
+    // Render viewport, with unsaved changes applied, at its screen size
+    // (one cell per screen position) and write it to the stream
+    // Returns false on write failure (see last_error())
+    bool write(std::ostream& out, const Viewport& viewport,
+               const std::vector<ChangeRecord>& unsaved_changes, Format format);
+
+    // Description of the last failure
+    const std::string& last_error() const { return error_; }
+
+private:
+    DataTable& table_;
+    ClassPalette& palette_;
+    EditAreaRenderer renderer_;
+    std::string error_;
+
+    void write_text(std::ostream& out, const CellGrid& grid);
+    void write_ppm(std::ostream& out, const CellGrid& grid);
+};
+
+}  // namespace datapainter
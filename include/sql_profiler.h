@@ -0,0 +1,96 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace datapainter {
+
+class Database;
+
+// Aggregates per-statement SQLite timings for --profile-sql
+//
+// Registers SQLITE_TRACE_STMT, SQLITE_TRACE_ROW and SQLITE_TRACE_PROFILE on
+// the connection and groups executions by normalised SQL text (whitespace
+// collapsed, literals replaced by '?'). Each execution also collects the
+// sqlite3_stmt_status counters that reveal full scans, sorts and automatic
+// indexes. Durations are measured with steady_clock from the STMT event,
+// because the PROFILE time comes from the VFS clock (millisecond resolution).
+class SqlProfiler {
+public:
+    // Number of statements whose query plan is included in the report
+    static constexpr size_t PLAN_COUNT = 5;
+
+    explicit SqlProfiler(Database& db);
+
+    // Detaches; writes the report if set_report_path() was called
+    ~SqlProfiler();
+
+    SqlProfiler(const SqlProfiler&) = delete;
+    SqlProfiler& operator=(const SqlProfiler&) = delete;
+
+    // Start/stop tracing statements on the connection
+    bool attach();
+    void detach();
+
+    // Write the report to this path when the profiler is destroyed, so it
+    // is produced whichever way the program exits
+    void set_report_path(const std::string& path) { report_path_ = path; }
+
+    // Write the report; JSON if path ends in ".json", otherwise text
+    // Returns false if the file could not be written
+    bool write_report(const std::string& path);
+
+    void write_table(std::ostream& out);
+    void write_json(std::ostream& out);
+
+    // Number of distinct normalised statements seen
+    size_t statement_count() const { return entries_.size(); }
+
+    // Collapse whitespace and replace numeric and string literals with '?'
+    static std::string normalize(const std::string& sql);
+
+    struct Entry {
+        std::string sql;         // Normalised text
+        std::string sample_sql;  // First raw text seen, used for EXPLAIN
+        int64_t count = 0;
+        double total_ms = 0.0;
+        double max_ms = 0.0;
+        int64_t rows = 0;
+        int64_t fullscan_steps = 0;
+        int64_t sorts = 0;
+        int64_t autoindexes = 0;
+        int64_t vm_steps = 0;
+    };
+
+    // Entries ordered by total time, slowest first
+    std::vector<const Entry*> sorted_entries() const;
+
+    // EXPLAIN QUERY PLAN detail lines, indented by nesting depth
+    std::vector<std::string> query_plan(const std::string& sql);
+
+private:
+    Database& db_;
+    bool attached_;
+    std::string report_path_;
+    std::unordered_map<std::string, Entry> entries_;
+    // Executions that have started but not yet finished
+    struct Running {
+        std::chrono::steady_clock::time_point start;
+        int64_t rows = 0;
+    };
+    std::unordered_map<sqlite3_stmt*, Running> running_;
+
+    static int trace_callback(unsigned type, void* context, void* p, void* x);
+    void on_profile(sqlite3_stmt* stmt, uint64_t nanoseconds);
+
+    // Entries worth a query plan: ones with full scans, sorts or automatic
+    // indexes first, then the rest by total time
+    std::vector<const Entry*> plan_candidates() const;
+};
+
+}  // namespace datapainter
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "class_palette.h"
+#include "data_table.h"
+#include "journal_diff.h"
+#include "moments.h"
+#include "terminal.h"
+#include "unsaved_changes.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace datapainter {
+
+// Class balance, centroids and covariances for the viewport and the whole
+// table, toggled with 'i'
+//
+// Sums per class are kept for the saved points and for the journal's
+// effect on them. The viewport's saved sums come from one aggregate query
+// when first set; after that a move queries only the strips it gained and
+// lost (at most eight narrow regions), or the new rectangle when the two do
+// not overlap. Journal changes adjust the sums as they become active or
+// inactive, so neither an edit nor a redraw revisits the table's points.
+// The whole-table sums take one aggregate query, the first time they are
+// shown.
+class StatsPanel {
+public:
+    static constexpr int WIDTH = 74;
+    static constexpr int ROWS_PER_SECTION = 4;  // Classes listed per section
+    static constexpr int OTHER = ClassPalette::MAX_CLASSES;  // Targets the palette cannot hold
+
+    // Offsets are taken from this origin (normally the valid range's
+    // centre); changing it drops everything loaded
+    void set_origin(double x, double y);
+
+    // Bring the viewport's sums to this rectangle (inclusive bounds)
+    void set_viewport(DataTable& table, ClassPalette& palette,
+                      double x_min, double x_max, double y_min, double y_max);
+
+    // Query the whole-table sums unless already loaded
+    void ensure_table_loaded(DataTable& table, ClassPalette& palette);
+    bool table_loaded() const { return table_loaded_; }
+
+    // Apply journal changes not yet reflected in the sums. Changes that have
+    // left the journal are assumed saved and become part of the saved sums.
+    void sync(DataTable& table, const std::vector<ChangeRecord>& changes, ClassPalette& palette);
+
+    // The table changed outside the journal: query again when next needed
+    void invalidate();
+
+    // Sums by class (ClassPalette index, or OTHER), offsets from the origin.
+    // Saved sums exclude the journal; the others include it.
+    const Moments& viewport(int cls) const { return viewport_[static_cast<size_t>(cls)]; }
+    const Moments& saved_viewport(int cls) const { return saved_viewport_[static_cast<size_t>(cls)]; }
+    const Moments& table(int cls) const { return table_[static_cast<size_t>(cls)]; }
+    int64_t viewport_count() const;
+    int64_t saved_viewport_count() const;
+    int64_t table_count() const;
+    double origin_x() const { return origin_x_; }
+    double origin_y() const { return origin_y_; }
+
+    // Aggregate queries run so far, for tests and the benchmark
+    int queries() const { return queries_; }
+
+    // Text lines of the panel, each exactly WIDTH characters; the table
+    // section only once loaded
+    std::vector<std::string> get_lines(const ClassPalette& palette) const;
+
+    // Draw the panel with its top-left corner at (top_row, left_col)
+    void render(Terminal& terminal, const ClassPalette& palette, int top_row, int left_col) const;
+
+private:
+    static constexpr size_t SLOTS = ClassPalette::MAX_CLASSES + 1;
+
+    double origin_x_ = 0.0;
+    double origin_y_ = 0.0;
+
+    bool viewport_set_ = false;
+    DataRegion rect_{0.0, 0.0, 0.0, 0.0};
+    std::vector<Moments> saved_viewport_ = std::vector<Moments>(SLOTS);
+    std::vector<Moments> viewport_ = std::vector<Moments>(SLOTS);  // Saved plus journal
+
+    bool table_loaded_ = false;
+    std::vector<Moments> saved_table_ = std::vector<Moments>(SLOTS);
+    std::vector<Moments> table_ = std::vector<Moments>(SLOTS);
+
+    JournalDiff journal_;
+    int queries_ = 0;
+
+    // Class slot of a target: its palette index, or OTHER
+    static int slot_of(ClassPalette& palette, const std::string& target);
+
+    // Add the saved points of a region to (sign +1) or remove them from
+    // (sign -1) the given sums
+    void query(DataTable& table, ClassPalette& palette, const std::optional<DataRegion>& region,
+               int sign, std::vector<Moments>& sums);
+
+    // Apply (sign +1) or undo (sign -1) a journal change's effect on the
+    // given viewport and table sums (either may be null); the table's only
+    // once loaded
+    void apply(const JournalDiff::Effect& change, int sign, std::vector<Moments>* view, std::vector<Moments>* table);
+
+    bool in_viewport(double x, double y) const;
+
+    // Saved sums plus the journal's effect
+    void rebuild_viewport();
+    void rebuild_table();
+
+    // get_lines(), with the class shown on each line (NO_CLASS for others)
+    std::vector<std::string> build_lines(const ClassPalette& palette, std::vector<int>* classes) const;
+};
+
+}  // namespace datapainter
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace datapainter {
 
+class EventLoop;
+
 // Terminal screen management
 class Terminal {
 public:
@@ -22,6 +26,18 @@ public:
     // Override dimensions (for testing)
     void set_dimensions(int rows, int cols);
 
+    // Output backend shared by every Terminal: ncurses (default) or the
+    // direct ANSI writer (one diffed, synchronized write(2) per frame, with
+    // its own termios raw mode and key decoding). Select before raw mode.
+    enum class Backend { NCURSES, ANSI };
+    static void set_backend(Backend backend) { backend_ = backend; }
+    static Backend backend() { return backend_; }
+
+    // Headless mode: keep rendering into the in-memory buffer but never touch
+    // the TTY (no raw mode, no output, read_key() returns -1)
+    void set_headless(bool headless) { headless_ = headless; }
+    bool is_headless() const { return headless_; }
+
     // Detect actual terminal size
     bool detect_size();
 
@@ -43,11 +59,34 @@ public:
         VLINE       // Vertical line
     };
 
+    // Foreground colours; values match the ncurses COLOR_* constants and
+    // ANSI SGR 30+n
+    enum class Color : uint8_t {
+        DEFAULT = 0,
+        RED,
+        GREEN,
+        YELLOW,
+        BLUE,
+        MAGENTA,
+        CYAN,
+        WHITE
+    };
+
+    // Colour by name ("red", "default", ...)
+    static std::optional<Color> parse_color(const std::string& name);
+
     // Screen buffer operations
     void clear_buffer();
     void write_char(int row, int col, char ch);
+    void write_char(int row, int col, char ch, Color color);
     void write_acs(int row, int col, AcsChar acs_type);  // Write ACS box-drawing character
+    // Unicode glyph (shade block, braille) for backends that can draw it;
+    // read_char(), get_row() and narrow curses see the ASCII fallback
+    void write_glyph(int row, int col, char32_t glyph, char fallback, Color color);
     char read_char(int row, int col) const;
+    AcsChar read_acs(int row, int col) const;
+    Color read_color(int row, int col) const;
+    char32_t read_glyph(int row, int col) const;  // 0 for a plain character
     std::string get_row(int row) const;
 
     // Rendering
@@ -59,12 +98,18 @@ public:
     bool enter_raw_mode();
     // Restore normal terminal mode
     bool exit_raw_mode();
-    // Read a single character (non-blocking if possible)
+    // Read a single key, sleeping in the event loop's poll() until input,
+    // a resize or a timer
     // Returns: character code, or special values for arrow keys:
     //   KEY_UP_ARROW = 1000, KEY_DOWN_ARROW = 1001,
     //   KEY_LEFT_ARROW = 1002, KEY_RIGHT_ARROW = 1003
+    // KEY_RESIZE after SIGWINCH, KEY_WAKE when timers ran, -1 at EOF or on
+    // error
     int read_key();
 
+    // Event loop read_key() waits in (a private one if none is set)
+    void set_event_loop(EventLoop* loop) { event_loop_ = loop; }
+
     // Special key codes (to avoid conflicts with regular ASCII)
     static constexpr int KEY_UP_ARROW = 1000;
     static constexpr int KEY_DOWN_ARROW = 1001;
@@ -72,13 +117,26 @@ public:
     static constexpr int KEY_RIGHT_ARROW = 1003;
     static constexpr int KEY_RESIZE = 1004;  // Terminal window was resized
 
+    // Pseudo-keys produced by keystroke files (never by a real terminal)
+    static constexpr int KEY_DUMP_SCREEN = 1005;     // <dump> checkpoint
+    static constexpr int KEY_DUMP_EDIT_AREA = 1006;  // <dump-edit-area> checkpoint
+    static constexpr int KEY_RENDER = 1007;          // <render> checkpoint (--fast-replay)
+
+    static constexpr int KEY_WAKE = 1008;  // Event loop ran timers
+
 private:
+    static Backend backend_;
+
     int rows_;
     int cols_;
     int actual_rows_;   // Physical terminal dimensions
     int actual_cols_;
+    bool headless_;
+    EventLoop* event_loop_;
     std::vector<std::vector<char>> buffer_;
     std::vector<std::vector<AcsChar>> acs_buffer_;  // Parallel buffer for ACS characters
+    std::vector<std::vector<Color>> color_buffer_;  // Parallel buffer for foreground colours
+    std::vector<std::vector<char32_t>> glyph_buffer_;  // Parallel buffer for Unicode glyphs
 
     void resize_buffer();
 };
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace datapainter {
+
+// Fixed-capacity text buffer for composing one screen row without touching
+// the heap
+//
+// Renderers keep one per row and clear it each frame. Text past CAPACITY is
+// dropped, which only matters on terminals wider than CAPACITY columns where
+// the row would be clipped anyway. Numbers are formatted with std::to_chars
+// and match the iostream output they replace ("%.*f" / "%.*e").
+class TextBuffer {
+public:
+    static constexpr size_t CAPACITY = 512;
+    static constexpr size_t npos = std::string_view::npos;
+
+    TextBuffer() : size_(0) {}
+
+    void clear() { size_ = 0; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    char operator[](size_t pos) const { return data_[pos]; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+    TextBuffer& append(std::string_view text);
+    TextBuffer& append(char c);
+    TextBuffer& append_int(long long value);
+    // Fixed notation with the given number of decimals
+    TextBuffer& append_fixed(double value, int precision);
+    // Scientific notation with the given number of mantissa decimals
+    TextBuffer& append_scientific(double value, int precision);
+
+    // Strip trailing fraction zeros (and a bare '.') from the text appended
+    // since start, e.g. "2.500" -> "2.5", "3.0" -> "3"
+    void trim_fraction_zeros(size_t start);
+
+    // std::string-like editing used for truncating and patching rows
+    void resize(size_t count, char fill);
+    void erase(size_t pos, size_t count);
+    // Overwrite starting at pos, growing the buffer if needed
+    void overwrite(size_t pos, std::string_view text);
+    size_t find(std::string_view text) const { return view().find(text); }
+    size_t rfind(std::string_view text) const { return view().rfind(text); }
+
+private:
+    char data_[CAPACITY];
+    size_t size_;
+};
+
+}  // namespace datapainter
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace datapainter {
+
+// Fixed set of worker threads for data-parallel loops (binning, CSV
+// export)
+//
+// parallel_for() splits [0, count) into chunks dealt round-robin onto one
+// deque per worker. Each worker pops its own chunks from the back and,
+// once it runs dry, steals from the front of the others', so chunks that
+// take longer (dense clusters, long targets) balance out. The calling
+// thread works as worker 0, so a pool of one thread runs loops inline with
+// no synchronisation at all.
+class ThreadPool {
+public:
+    // fn(begin, end, worker): worker (0 .. size() - 1) indexes per-worker
+    // scratch; no two chunks run on the same worker at once
+    using Task = std::function<void(size_t begin, size_t end, int worker)>;
+
+    // threads <= 0 means one per hardware thread
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Workers including the calling thread
+    int size() const { return static_cast<int>(queues_.size()); }
+
+    // Run fn over [0, count) in chunks of at least min_chunk items and
+    // return when every chunk has finished. Calls from several threads are
+    // serialised; fn must not call parallel_for() itself.
+    void parallel_for(size_t count, size_t min_chunk, const Task& fn);
+
+    // Process-wide pool, created on first use with shared_threads() workers
+    static ThreadPool& shared();
+
+    // Size of the shared pool (--threads); takes effect if called before
+    // the first shared() call. <= 0 means one per hardware thread.
+    static void set_shared_threads(int threads);
+    static int shared_threads();
+
+    // Hardware threads, at least 1
+    static int hardware_threads();
+
+private:
+    struct Chunk {
+        size_t begin;
+        size_t end;
+        const Task* fn;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Chunk> chunks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex run_mutex_;   // One parallel_for at a time
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    size_t generation_ = 0;  // Bumped per parallel_for to wake workers
+    bool stopping_ = false;
+    std::atomic<size_t> pending_{0};  // Chunks not yet finished
+
+    void worker_loop(int worker);
+
+    // Run chunks until none are left anywhere
+    void drain(int worker);
+    bool take(int worker, Chunk& chunk);
+};
+
+}  // namespace datapainter
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace datapainter {
+
+// Collects scoped spans for --trace and writes them as Chrome trace-event
+// JSON (open in Perfetto or chrome://tracing)
+//
+// Every thread records into its own fixed-size ring buffer, so recording a
+// span takes no lock; when a buffer is full the oldest spans are dropped.
+// Buffers outlive their threads and are written out at the end of the run.
+// Only the owning thread writes a ring: readers on other threads may dump
+// or clear it while it records, and skip any slot it may be overwriting.
+class Tracer {
+public:
+    // Spans kept per thread before the oldest are overwritten
+    static constexpr size_t RING_CAPACITY = 1 << 16;
+
+    static Tracer& instance();
+
+    static void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Nanoseconds since the tracer was created
+    int64_t now_ns() const;
+
+    // Record a finished span on the calling thread; name must be a string
+    // literal (only the pointer is stored)
+    void record(const char* name, int64_t start_ns, int64_t end_ns);
+
+    // Label the calling thread in the trace viewer. A thread that has not
+    // recorded yet gets no buffer until it does.
+    void set_thread_name(const std::string& name);
+
+    // Drop all recorded spans (buffers of live threads are kept); safe while
+    // other threads record
+    void clear();
+
+    // Spans currently held across all threads
+    size_t span_count() const;
+
+    // Write {"traceEvents": [...]} with one complete ("X") event per span
+    void write_json(std::ostream& out) const;
+    bool write_json(const std::string& path) const;
+
+private:
+    struct Span {
+        const char* name;
+        int64_t start_ns;
+        int64_t end_ns;
+    };
+
+    // A ring entry; atomic so a reader racing the owner's overwrite gets a
+    // stale or new value, never undefined behaviour (the copy is then
+    // discarded)
+    struct Slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<int64_t> start_ns{0};
+        std::atomic<int64_t> end_ns{0};
+    };
+
+    // Single-writer ring: slots and `written` are stored only by the owning
+    // thread, which publishes each span with a release store of `written`
+    struct Ring {
+        int tid = 0;
+        std::string thread_name;          // Guarded by rings_mutex_
+        std::unique_ptr<Slot[]> spans;
+        std::atomic<uint64_t> written{0};
+        uint64_t cleared = 0;             // Spans before this were cleared; guarded by rings_mutex_
+    };
+
+    Tracer();
+
+    Ring& ring_for_this_thread();
+
+    // The calling thread's ring, null until it first records
+    static std::shared_ptr<Ring>& this_thread_ring();
+    static std::string& pending_thread_name();
+
+    // Spans of a ring from `cleared` on that its owner cannot be
+    // overwriting; the caller holds rings_mutex_
+    static std::vector<Span> snapshot(const Ring& ring);
+
+    static std::atomic<bool> enabled_;
+
+    std::chrono::steady_clock::time_point epoch_;
+    mutable std::mutex rings_mutex_;  // Guards registration, not recording
+    std::vector<std::shared_ptr<Ring>> rings_;
+};
+
+// Records its lifetime as a span while tracing is enabled
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : name_(name), start_ns_(Tracer::enabled() ? Tracer::instance().now_ns() : -1) {}
+
+    ~TraceSpan() {
+        if (start_ns_ >= 0) {
+            Tracer& tracer = Tracer::instance();
+            tracer.record(name_, start_ns_, tracer.now_ns());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    int64_t start_ns_;
+};
+
+// Enables tracing for its lifetime and writes the trace file when destroyed,
+// so --trace produces output whichever way main returns
+class TraceSession {
+public:
+    explicit TraceSession(const std::string& path);
+    ~TraceSession();
+
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
+
+private:
+    std::string path_;
+};
+
+}  // namespace datapainter
@@ -46,6 +46,10 @@ public:
     void zoom_out(const DataCoord& center);
     void zoom_to_fit_all();  // Fit all data with 10% padding
 
+    // Rescale the screen mapping after a terminal resize. The data window is
+    // kept, so points are only rebinned into the new cell grid.
+    void set_screen_size(int screen_height, int screen_width);
+
     // Pan operations
     void pan_right();
     void pan_left();
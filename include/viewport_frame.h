@@ -0,0 +1,61 @@
+#pragma once
+
+#include "class_palette.h"
+#include "data_table.h"
+#include "edit_area_renderer.h"
+#include "footer_renderer.h"
+#include "header_renderer.h"
+#include "metadata.h"
+#include "stats_panel.h"
+#include "terminal.h"
+#include "unsaved_changes.h"
+#include "viewport.h"
+#include <string>
+#include <vector>
+
+namespace datapainter {
+
+// Header, edit area and footer of the viewport screen
+//
+// Both the interactive loop and --dump-screen draw through this class, and
+// the perf budget tests time it, so the measured frame is the one users
+// see. Overlays, the minimap and the stats panel are drawn by the caller
+// between draw_top() and draw_footer(). The renderers and the stats panel
+// live as long as the frame so their buffers and running sums are reused.
+class ViewportFrame {
+public:
+    ViewportFrame(Terminal& terminal, DataTable& table, UnsavedChanges& journal, std::string db_path);
+
+    // Load this table's journal, bring the viewport counts up to date and
+    // draw the header and edit area. Clears the footer's fit figures.
+    void draw_top(const Metadata& meta, ClassPalette& palette, const Viewport& viewport,
+                  int edit_area_start_row, int edit_area_height,
+                  int cursor_row, int cursor_col, int focused_field);
+
+    // Draw the footer for the viewport drawn by the last draw_top()
+    void draw_footer(const Viewport& viewport, double cursor_x, double cursor_y, int focused_button);
+
+    // This table's journal as loaded by the last draw_top(), for overlays
+    const std::vector<ChangeRecord>& changes() const { return changes_; }
+
+    HeaderRenderer& header() { return header_; }
+    EditAreaRenderer& edit_area() { return edit_area_; }
+    FooterRenderer& footer() { return footer_; }
+    StatsPanel& stats() { return stats_; }
+
+private:
+    Terminal& terminal_;
+    DataTable& table_;
+    UnsavedChanges& journal_;
+    std::string db_path_;
+
+    HeaderRenderer header_;
+    EditAreaRenderer edit_area_;
+    FooterRenderer footer_;
+    StatsPanel stats_;
+
+    std::vector<ChangeRecord> changes_;
+    int table_active_changes_ = 0;
+};
+
+}  // namespace datapainter
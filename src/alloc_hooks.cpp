@@ -0,0 +1,91 @@
+// Global operator new/delete replacements for DATAPAINTER_ALLOC_STATS builds
+//
+// Only compiled when the option is on. Each hook bumps the calling thread's
+// counters (a thread_local POD, so no locking and no allocation) and then
+// forwards to malloc/free.
+
+#include "alloc_stats.h"
+#include <cstdlib>
+#include <new>
+
+namespace datapainter {
+extern thread_local AllocCounters g_thread_alloc_counters;
+}
+
+namespace {
+
+void* counted_alloc(std::size_t size) {
+    datapainter::g_thread_alloc_counters.allocations++;
+    datapainter::g_thread_alloc_counters.bytes += size;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* counted_aligned_alloc(std::size_t size, std::align_val_t alignment) {
+    datapainter::g_thread_alloc_counters.allocations++;
+    datapainter::g_thread_alloc_counters.bytes += size;
+    void* ptr = nullptr;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (align < sizeof(void*)) {
+        align = sizeof(void*);
+    }
+    if (posix_memalign(&ptr, align, size == 0 ? 1 : size) != 0) {
+        return nullptr;
+    }
+    return ptr;
+}
+
+void counted_free(void* ptr) {
+    if (ptr != nullptr) {
+        datapainter::g_thread_alloc_counters.frees++;
+        std::free(ptr);
+    }
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    if (void* ptr = counted_alloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* ptr = counted_alloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* ptr = counted_aligned_alloc(size, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* ptr = counted_aligned_alloc(size, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { counted_free(ptr); }
@@ -0,0 +1,121 @@
+#include "alloc_stats.h"
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+namespace datapainter {
+
+// Written by the operator new/delete replacements in alloc_hooks.cpp
+thread_local AllocCounters g_thread_alloc_counters;
+
+namespace {
+
+// Fixed table so recording never allocates (it runs inside counted scopes)
+std::array<AllocStats::Operation, AllocStats::MAX_OPERATIONS> g_operations;
+size_t g_operation_count = 0;
+std::mutex g_operations_mutex;
+
+AllocStats::Operation* find_operation(const char* name) {
+    for (size_t i = 0; i < g_operation_count; ++i) {
+        if (g_operations[i].name == name || std::strcmp(g_operations[i].name, name) == 0) {
+            return &g_operations[i];
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+AllocCounters AllocStats::current() {
+    return g_thread_alloc_counters;
+}
+
+void AllocStats::record(const char* name, const AllocCounters& delta) {
+    std::lock_guard<std::mutex> lock(g_operations_mutex);
+    Operation* op = find_operation(name);
+    if (op == nullptr) {
+        if (g_operation_count == MAX_OPERATIONS) {
+            return;
+        }
+        op = &g_operations[g_operation_count++];
+        *op = Operation();
+        op->name = name;
+    }
+    op->count++;
+    op->allocations += delta.allocations;
+    op->bytes += delta.bytes;
+    if (delta.allocations > op->max_allocations) {
+        op->max_allocations = delta.allocations;
+    }
+}
+
+AllocStats::Operation AllocStats::operation(const char* name) {
+    std::lock_guard<std::mutex> lock(g_operations_mutex);
+    Operation* op = find_operation(name);
+    return op ? *op : Operation();
+}
+
+void AllocStats::reset() {
+    std::lock_guard<std::mutex> lock(g_operations_mutex);
+    g_operation_count = 0;
+}
+
+void AllocStats::write_report(std::ostream& out) {
+    char line[160];
+    out << "Heap allocations per operation\n\n";
+    std::snprintf(line, sizeof(line), "%-32s %10s %12s %10s %10s %14s\n",
+                  "operation", "count", "allocs", "mean", "max", "bytes");
+    out << line;
+
+    std::lock_guard<std::mutex> lock(g_operations_mutex);
+    for (size_t i = 0; i < g_operation_count; ++i) {
+        const Operation& op = g_operations[i];
+        double mean = op.count ? static_cast<double>(op.allocations) / static_cast<double>(op.count) : 0.0;
+        std::snprintf(line, sizeof(line), "%-32s %10llu %12llu %10.1f %10llu %14llu\n", op.name,
+                      static_cast<unsigned long long>(op.count),
+                      static_cast<unsigned long long>(op.allocations), mean,
+                      static_cast<unsigned long long>(op.max_allocations),
+                      static_cast<unsigned long long>(op.bytes));
+        out << line;
+    }
+
+    AllocCounters total = current();
+    std::snprintf(line, sizeof(line), "\nthis thread: %llu allocations, %llu frees, %llu bytes\n",
+                  static_cast<unsigned long long>(total.allocations),
+                  static_cast<unsigned long long>(total.frees),
+                  static_cast<unsigned long long>(total.bytes));
+    out << line;
+}
+
+bool AllocStats::write_report_from_env() {
+    const char* target = std::getenv("DATAPAINTER_ALLOC_REPORT");
+    if (!available() || target == nullptr || *target == '\0') {
+        return true;
+    }
+    if (std::strcmp(target, "-") == 0) {
+        write_report(std::cerr);
+        return true;
+    }
+    std::ofstream out(target);
+    if (!out.is_open()) {
+        return false;
+    }
+    write_report(out);
+    out.flush();
+    return !out.fail();
+}
+
+AllocCounters AllocScope::delta() const {
+    AllocCounters now = AllocStats::current();
+    AllocCounters result;
+    result.allocations = now.allocations - start_.allocations;
+    result.frees = now.frees - start_.frees;
+    result.bytes = now.bytes - start_.bytes;
+    return result;
+}
+
+}  // namespace datapainter
@@ -0,0 +1,212 @@
+#include "ansi_renderer.h"
+#include "terminal.h"
+#include <cerrno>
+#include <charconv>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace datapainter {
+
+namespace {
+
+// DEC special graphics glyph for each Terminal::AcsChar
+char line_drawing_glyph(uint8_t acs) {
+    switch (static_cast<Terminal::AcsChar>(acs)) {
+        case Terminal::AcsChar::ULCORNER: return 'l';
+        case Terminal::AcsChar::URCORNER: return 'k';
+        case Terminal::AcsChar::LLCORNER: return 'm';
+        case Terminal::AcsChar::LRCORNER: return 'j';
+        case Terminal::AcsChar::HLINE:    return 'q';
+        case Terminal::AcsChar::VLINE:    return 'x';
+        case Terminal::AcsChar::NONE:     break;
+    }
+    return ' ';
+}
+
+void append_utf8(std::string& out, char32_t glyph) {
+    if (glyph < 0x80) {
+        out += static_cast<char>(glyph);
+    } else if (glyph < 0x800) {
+        out += static_cast<char>(0xC0 | (glyph >> 6));
+        out += static_cast<char>(0x80 | (glyph & 0x3F));
+    } else if (glyph < 0x10000) {
+        out += static_cast<char>(0xE0 | (glyph >> 12));
+        out += static_cast<char>(0x80 | ((glyph >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (glyph & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (glyph >> 18));
+        out += static_cast<char>(0x80 | ((glyph >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((glyph >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (glyph & 0x3F));
+    }
+}
+
+void append_int(std::string& out, int value) {
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+}  // namespace
+
+AnsiRenderer::AnsiRenderer()
+    : rows_(0), cols_(0), valid_(false), cells_written_(0),
+      cursor_row_(-1), cursor_col_(-1), reverse_(false), color_(0), line_drawing_(false) {}
+
+const std::string& AnsiRenderer::compose(const Terminal& terminal, int cursor_row, int cursor_col) {
+    out_.clear();
+    cells_written_ = 0;
+
+    int rows = terminal.rows();
+    int cols = terminal.cols();
+    size_t cell_count = static_cast<size_t>(rows > 0 ? rows : 0) * static_cast<size_t>(cols > 0 ? cols : 0);
+    next_.resize(cell_count);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            Cell& cell = next_[static_cast<size_t>(row) * cols + col];
+            cell.ch = terminal.read_char(row, col);
+            cell.acs = static_cast<uint8_t>(terminal.read_acs(row, col));
+            cell.color = static_cast<uint8_t>(terminal.read_color(row, col));
+            cell.reverse = (row == cursor_row && col == cursor_col);
+            cell.glyph = terminal.read_glyph(row, col);
+        }
+    }
+
+    out_ += SYNC_BEGIN;
+
+    // After a clear every cell is a blank, so the diff only emits the rest
+    bool cleared = false;
+    if (!valid_ || rows != rows_ || cols != cols_) {
+        out_ += "\033[0m\033(B\033[H\033[2J";
+        previous_.assign(cell_count, Cell{' ', 0, 0, false, U'\0'});
+        rows_ = rows;
+        cols_ = cols;
+        valid_ = true;
+        cleared = true;
+    }
+    cursor_row_ = -1;
+    cursor_col_ = -1;
+    reverse_ = false;
+    color_ = 0;
+    line_drawing_ = false;
+
+    for (int row = 0; row < rows; ++row) {
+        const Cell* prev = &previous_[static_cast<size_t>(row) * cols];
+        const Cell* next = &next_[static_cast<size_t>(row) * cols];
+        int col = 0;
+        while (col < cols) {
+            if (next[col] == prev[col]) {
+                ++col;
+                continue;
+            }
+
+            // Short unchanged gaps on the same row are cheaper to rewrite
+            if (cursor_row_ == row && cursor_col_ >= 0 && cursor_col_ < col &&
+                col - cursor_col_ <= MAX_REWRITE_GAP) {
+                for (int gap = cursor_col_; gap < col; ++gap) {
+                    emit_cell(next[gap], row, gap);
+                }
+            } else {
+                move_to(row, col);
+            }
+
+            // Emit the run of changed cells
+            while (col < cols && next[col] != prev[col]) {
+                emit_cell(next[col], row, col);
+                ++cells_written_;
+                ++col;
+            }
+        }
+    }
+
+    if (cells_written_ == 0 && !cleared) {
+        out_.clear();
+    } else {
+        if (reverse_) {
+            out_ += "\033[27m";
+        }
+        if (color_ != 0) {
+            out_ += "\033[39m";
+        }
+        if (line_drawing_) {
+            out_ += "\033(B";
+        }
+        out_ += SYNC_END;
+    }
+
+    previous_.swap(next_);
+    return out_;
+}
+
+void AnsiRenderer::move_to(int row, int col) {
+    out_ += "\033[";
+    append_int(out_, row + 1);
+    out_ += ';';
+    append_int(out_, col + 1);
+    out_ += 'H';
+    cursor_row_ = row;
+    cursor_col_ = col;
+}
+
+void AnsiRenderer::emit_cell(const Cell& cell, int row, int col) {
+    if (cell.reverse != reverse_) {
+        out_ += cell.reverse ? "\033[7m" : "\033[27m";
+        reverse_ = cell.reverse;
+    }
+    if (cell.color != color_) {
+        if (cell.color == 0) {
+            out_ += "\033[39m";
+        } else {
+            out_ += "\033[3";
+            append_int(out_, cell.color);
+            out_ += 'm';
+        }
+        color_ = cell.color;
+    }
+    bool line_drawing = cell.acs != 0;
+    if (line_drawing != line_drawing_) {
+        out_ += line_drawing ? "\033(0" : "\033(B";
+        line_drawing_ = line_drawing;
+    }
+    if (line_drawing) {
+        out_ += line_drawing_glyph(cell.acs);
+    } else if (cell.glyph != U'\0') {
+        append_utf8(out_, cell.glyph);
+    } else {
+        out_ += cell.ch;
+    }
+
+    // Writing the last column leaves the cursor in a pending-wrap state
+    if (col + 1 >= cols_) {
+        cursor_row_ = -1;
+        cursor_col_ = -1;
+    } else {
+        cursor_row_ = row;
+        cursor_col_ = col + 1;
+    }
+}
+
+bool AnsiRenderer::write_all(int fd, const std::string& bytes) {
+#ifdef _WIN32
+    (void)fd;
+    (void)bytes;
+    return false;
+#else
+    size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t n = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+#endif
+}
+
+}  // namespace datapainter
@@ -1,4 +1,9 @@
 #include "argument_parser.h"
+#include "class_palette.h"
+#include "database.h"
+#include "kd_tree.h"
+#include "kmeans_overlay.h"
+#include "snapshot_writer.h"
 #include "metadata.h"
 #include <algorithm>
 #include <iomanip>
@@ -64,6 +69,68 @@ Arguments ArgumentParser::parse(int argc, char** argv) {
     // UI options
     args.show_zero_bars = has_flag(argc, argv, "--show-zero-bars");
     args.start_tabular = has_flag(argc, argv, "--start-tabular");
+    args.show_minimap = has_flag(argc, argv, "--minimap");
+    args.show_logistic = has_flag(argc, argv, "--logistic");
+    args.show_kde = has_flag(argc, argv, "--kde");
+    args.show_stats = has_flag(argc, argv, "--stats");
+    args.terminal_backend = get_value(argc, argv, "--backend");
+    if (args.terminal_backend.has_value() && *args.terminal_backend != "ncurses" &&
+        *args.terminal_backend != "ansi") {
+        args.error_messages.push_back("Invalid value for --backend: " + *args.terminal_backend +
+                                      " (expected ncurses or ansi)");
+    }
+    args.render_mode = get_value(argc, argv, "--render-mode");
+    if (args.render_mode.has_value() && *args.render_mode != "points" &&
+        *args.render_mode != "density" && *args.render_mode != "braille") {
+        args.error_messages.push_back("Invalid value for --render-mode: " + *args.render_mode +
+                                      " (expected points, density or braille)");
+    }
+    args.class_styles = get_values(argc, argv, "--class-style");
+    for (const auto& spec : args.class_styles) {
+        std::string error;
+        if (!ClassPalette::validate_spec(spec, error)) {
+            args.error_messages.push_back("Invalid value for --class-style: " + spec + " (" + error + ")");
+        }
+    }
+
+    if (auto val = get_value(argc, argv, "--threads")) {
+        auto parsed = parse_int(*val);
+        if (parsed && *parsed >= 1 && *parsed <= 256) {
+            args.threads = *parsed;
+        } else {
+            args.error_messages.push_back("Invalid value for --threads: " + *val + " (expected 1-256)");
+        }
+    }
+
+    if (auto val = get_value(argc, argv, "--knn")) {
+        auto parsed = parse_int(*val);
+        if (parsed && *parsed >= 1 && *parsed <= KdTree::MAX_K) {
+            args.knn = *parsed;
+        } else {
+            args.error_messages.push_back("Invalid value for --knn: " + *val + " (expected 1-" +
+                                          std::to_string(KdTree::MAX_K) + ")");
+        }
+    }
+
+    if (auto val = get_value(argc, argv, "--kmeans")) {
+        auto parsed = parse_int(*val);
+        if (parsed && *parsed >= 1 && *parsed <= KmeansOverlay::MAX_K) {
+            args.kmeans = *parsed;
+        } else {
+            args.error_messages.push_back("Invalid value for --kmeans: " + *val + " (expected 1-" +
+                                          std::to_string(KmeansOverlay::MAX_K) + ")");
+        }
+    }
+
+    if (auto val = get_value(argc, argv, "--kde-bandwidth")) {
+        auto parsed = parse_double(*val);
+        if (parsed && *parsed > 0.0 && std::isfinite(*parsed)) {
+            args.kde_bandwidth = *parsed;
+        } else if (*val != "scott") {
+            args.error_messages.push_back("Invalid value for --kde-bandwidth: " + *val +
+                                          " (expected a positive number or scott)");
+        }
+    }
 
     if (auto val = get_value(argc, argv, "--override-screen-height")) {
         if (auto parsed = parse_int(*val)) {
@@ -91,6 +158,14 @@ Arguments ArgumentParser::parse(int argc, char** argv) {
     args.add_point = has_flag(argc, argv, "--add-point");
     args.delete_point = has_flag(argc, argv, "--delete-point");
     args.to_csv = has_flag(argc, argv, "--to-csv");
+    args.render_snapshot = get_value(argc, argv, "--render-snapshot");
+    if (args.render_snapshot.has_value() && !SnapshotWriter::parse_size(*args.render_snapshot)) {
+        args.error_messages.push_back("Invalid value for --render-snapshot: " + *args.render_snapshot +
+                                      " (expected <width>x<height>, at most " +
+                                      std::to_string(SnapshotWriter::MAX_SIDE) + " per side and " +
+                                      std::to_string(SnapshotWriter::MAX_CELLS) + " cells)");
+    }
+    args.snapshot_output = get_value(argc, argv, "--snapshot-output");
 
     // Point operation arguments
     if (auto val = get_value(argc, argv, "--x")) {
@@ -128,6 +203,11 @@ Arguments ArgumentParser::parse(int argc, char** argv) {
     args.list_x_axis_marks = has_flag(argc, argv, "--list-x-axis-marks");
     args.list_y_axis_marks = has_flag(argc, argv, "--list-y-axis-marks");
     args.keystroke_file = get_value(argc, argv, "--keystroke-file");
+    args.headless = has_flag(argc, argv, "--headless");
+    args.fast_replay = has_flag(argc, argv, "--fast-replay");
+    args.profile_keystrokes = get_value(argc, argv, "--profile-keystrokes");
+    args.profile_sql = get_value(argc, argv, "--profile-sql");
+    args.trace_file = get_value(argc, argv, "--trace");
 
     // Study mode
     args.study = has_flag(argc, argv, "--study");
@@ -202,12 +282,21 @@ Arguments ArgumentParser::parse(int argc, char** argv) {
     args.commit_unsaved_changes = has_flag(argc, argv, "--commit-unsaved-changes");
     args.list_unsaved_changes = has_flag(argc, argv, "--list-unsaved-changes");
 
+    // Daemon mode
+    args.serve_socket = get_value(argc, argv, "--serve");
+    args.connect_socket = get_value(argc, argv, "--connect");
+
     return args;
 }
 
 std::vector<std::string> ArgumentParser::validate(const Arguments& args) {
     std::vector<std::string> errors;
 
+    // Table names are concatenated into SQL
+    if (args.table.has_value() && !Database::is_valid_table_name(args.table.value())) {
+        errors.push_back("Invalid table name: " + args.table.value());
+    }
+
     // Validate min <= max for x range
     if (args.min_x.has_value() && args.max_x.has_value()) {
         if (args.min_x.value() > args.max_x.value()) {
@@ -234,6 +323,38 @@ std::vector<std::string> ArgumentParser::validate(const Arguments& args) {
         }
     }
 
+    // Validate --headless has a script to replay and a table to open
+    if (args.headless) {
+        if (!args.keystroke_file.has_value()) {
+            errors.push_back("--headless requires --keystroke-file to be specified");
+        }
+        if (!args.table.has_value()) {
+            errors.push_back("--headless requires --table to be specified");
+        }
+    }
+
+    // Validate --fast-replay has a script to replay
+    if (args.fast_replay && !args.keystroke_file.has_value()) {
+        errors.push_back("--fast-replay requires --keystroke-file to be specified");
+    }
+    if (args.profile_keystrokes.has_value() && !args.keystroke_file.has_value()) {
+        errors.push_back("--profile-keystrokes requires --keystroke-file to be specified");
+    }
+
+    if (args.snapshot_output.has_value() && !args.render_snapshot.has_value()) {
+        errors.push_back("--snapshot-output requires --render-snapshot to be specified");
+    }
+
+    // Validate --serve and --connect are not combined
+    if (args.serve_socket.has_value() && args.connect_socket.has_value()) {
+        errors.push_back("--serve and --connect cannot be used together");
+    }
+
+    // Validate --serve requires --database
+    if (args.serve_socket.has_value() && !args.database.has_value()) {
+        errors.push_back("--serve requires --database to be specified");
+    }
+
     return errors;
 }
 
@@ -342,6 +463,16 @@ std::optional<std::string> ArgumentParser::get_value(int argc, char** argv, cons
     return std::nullopt;
 }
 
+std::vector<std::string> ArgumentParser::get_values(int argc, char** argv, const std::string& flag) {
+    std::vector<std::string> values;
+    for (int i = 1; i < argc - 1; i++) {
+        if (argv[i] == flag) {
+            values.emplace_back(argv[++i]);
+        }
+    }
+    return values;
+}
+
 std::optional<double> ArgumentParser::parse_double(const std::string& str) {
     try {
         size_t pos;
@@ -411,7 +542,12 @@ void ArgumentParser::print_help(std::ostream& out) {
     out << "  --point-id <id>         ID of point to delete\n\n";
 
     out << "DATA EXPORT:\n";
-    out << "  --to-csv                Export table data to CSV format\n\n";
+    out << "  --to-csv                Export table data to CSV format\n";
+    out << "  --render-snapshot <W>x<H>  Render the whole valid range into a W x H cell\n";
+    out << "                          canvas without a terminal (honours --render-mode\n";
+    out << "                          and --class-style)\n";
+    out << "  --snapshot-output <path>  Write the snapshot to <path> instead of stdout;\n";
+    out << "                          a .ppm path writes a PPM image instead of text\n\n";
 
     out << "UNDO LOG MANAGEMENT:\n";
     out << "  --list-unsaved-changes  List all unsaved changes for a table\n";
@@ -419,10 +555,38 @@ void ArgumentParser::print_help(std::ostream& out) {
     out << "  --clear-undo-log        Clear undo log for a table\n";
     out << "  --clear-all-undo-log    Clear undo logs for all tables\n\n";
 
+    out << "DAEMON MODE:\n";
+    out << "  --serve <socket>        Keep the database open and serve requests on a Unix socket\n";
+    out << "  --connect <socket>      Send this command to a running --serve process\n";
+    out << "                          (supports the table, point, export and undo log commands)\n\n";
+
     out << "UI OPTIONS (for interactive mode):\n";
     out << "  --start-tabular         Start in tabular view mode\n";
+    out << "  --minimap               Start with the overview minimap shown ('M' toggles)\n";
     out << "  --override-screen-width <cols>   Override detected screen width\n";
-    out << "  --override-screen-height <rows>  Override detected screen height\n\n";
+    out << "  --override-screen-height <rows>  Override detected screen height\n";
+    out << "  --backend <ncurses|ansi>  Terminal output backend (default ncurses); ansi sends\n";
+    out << "                          one diffed, synchronized write per frame\n";
+    out << "  --render-mode <points|density|braille>  Edit-area drawing (default points);\n";
+    out << "                          density shades cells by log point count, braille\n";
+    out << "                          draws 2x4 dots per cell ('m' cycles modes)\n";
+    out << "  --threads <n>           Worker threads for binning, header counts and CSV\n";
+    out << "                          export (default: one per hardware thread)\n";
+    out << "  --logistic              Start with a logistic regression's decision line and\n";
+    out << "                          10/25/75/90% probability bands shown ('l' toggles)\n";
+    out << "  --knn <k>               Start with k-nearest-neighbour decision regions shaded\n";
+    out << "                          in empty cells (k 1-32, default 5; 'n' toggles)\n";
+    out << "  --kde                   Start with per-class density contours shown ('c'\n";
+    out << "                          toggles, '[' and ']' narrow and widen the kernel)\n";
+    out << "  --kde-bandwidth <h|scott>  Kernel width in data units (default scott: Scott's\n";
+    out << "                          rule per class and axis)\n";
+    out << "  --kmeans <k>            Start with k-means cluster suggestions shown (k 1-16,\n";
+    out << "                          default 4; 'C' reruns or hides, 'A' applies them)\n";
+    out << "  --stats                 Start with the class statistics panel shown ('i'\n";
+    out << "                          toggles): counts, shares, centroids, covariances\n";
+    out << "  --class-style <target>=<glyph>[:<colour>]  Glyph and colour for points with\n";
+    out << "                          this target (repeatable, up to 64 classes); colours:\n";
+    out << "                          default red green yellow blue magenta cyan white\n\n";
 
     out << "DEBUG OPTIONS:\n";
     out << "  --dump-screen           Dump screen buffer contents\n";
@@ -431,7 +595,17 @@ void ArgumentParser::print_help(std::ostream& out) {
     out << "  --list-y-axis-marks     List Y axis tick marks\n";
     out << "  --zoom-in               Zoom in\n";
     out << "  --zoom-out              Zoom out\n";
-    out << "  --keystroke-file <path> Replay keystrokes from file (for automated testing)\n\n";
+    out << "  --keystroke-file <path> Replay keystrokes from file (for automated testing)\n";
+    out << "  --headless              Replay --keystroke-file without a terminal; <dump> and\n";
+    out << "                          <dump-edit-area> lines in the file print frames to stdout\n";
+    out << "  --fast-replay           Skip drawing while replaying; frames are only drawn at\n";
+    out << "                          <render>/<dump> checkpoints, k/K and after the last key\n";
+    out << "  --profile-keystrokes <out>  Write p50/p95/p99 latency per key type and per phase\n";
+    out << "                          for the replayed keys (JSON if <out> ends in .json)\n";
+    out << "  --profile-sql <out>     Write per-statement SQLite timings, rows, full-scan/sort\n";
+    out << "                          counters and query plans at exit (JSON if .json)\n";
+    out << "  --trace <out>           Write Chrome trace-event JSON of internal spans (open in\n";
+    out << "                          Perfetto or chrome://tracing)\n\n";
 
     out << "EXAMPLES:\n";
     out << "  # Create a new table\n";
@@ -1,9 +1,9 @@
 #include "axis_renderer.h"
+#include "frame_stats.h"
 #include "terminal.h"
 #include "viewport.h"
+#include "tracer.h"
 #include <cmath>
-#include <sstream>
-#include <iomanip>
 
 namespace datapainter {
 
@@ -31,23 +31,46 @@ std::vector<TickMark> AxisRenderer::generate_major_ticks(double data_min,
                                                           double data_max,
                                                           double tick_step) {
     std::vector<TickMark> ticks;
+    generate_major_ticks(data_min, data_max, tick_step, ticks);
+    return ticks;
+}
 
-    if (tick_step <= 0.0) {
-        return ticks;
-    }
+void AxisRenderer::generate_major_ticks(double data_min, double data_max,
+                                        double tick_step, std::vector<TickMark>& ticks) {
+    size_t count = 0;
 
-    // Find first tick at or before data_min
-    double first_tick = std::floor(data_min / tick_step) * tick_step;
+    if (tick_step > 0.0) {
+        // Find first tick at or before data_min
+        double first_tick = std::floor(data_min / tick_step) * tick_step;
 
-    // Generate ticks from first to last
-    for (double value = first_tick; value <= data_max + tick_step * 0.5; value += tick_step) {
-        TickMark tick;
-        tick.value = value;
-        tick.label = format_label(value);
-        ticks.push_back(tick);
+        // Generate ticks from first to last, overwriting existing entries
+        TextBuffer label;
+        for (double value = first_tick; value <= data_max + tick_step * 0.5; value += tick_step) {
+            if (count == ticks.size()) {
+                ticks.emplace_back();
+            }
+            label.clear();
+            append_label(label, value);
+            ticks[count].value = value;
+            ticks[count].label.assign(label.view().data(), label.size());
+            ++count;
+        }
     }
 
-    return ticks;
+    ticks.resize(count);
+}
+
+const std::vector<TickMark>& AxisRenderer::cached_major_ticks(TickCache& cache, double data_min,
+                                                              double data_max, double tick_step) {
+    if (!cache.valid || cache.data_min != data_min || cache.data_max != data_max ||
+        cache.tick_step != tick_step) {
+        generate_major_ticks(data_min, data_max, tick_step, cache.ticks);
+        cache.data_min = data_min;
+        cache.data_max = data_max;
+        cache.tick_step = tick_step;
+        cache.valid = true;
+    }
+    return cache.ticks;
 }
 
 std::vector<double> AxisRenderer::generate_minor_ticks(double data_min,
@@ -110,9 +133,16 @@ std::vector<double> AxisRenderer::generate_tenth_ticks(double data_min,
 }
 
 std::string AxisRenderer::format_label(double value) {
+    TextBuffer label;
+    append_label(label, value);
+    return std::string(label.view());
+}
+
+void AxisRenderer::append_label(TextBuffer& out, double value) {
     // Handle zero specially
     if (std::abs(value) < 1e-10) {
-        return "0";
+        out.append('0');
+        return;
     }
 
     // Determine if we need scientific notation (|exponent| >= 4)
@@ -121,15 +151,10 @@ std::string AxisRenderer::format_label(double value) {
     int exponent = static_cast<int>(std::floor(log_value));
 
     if (std::abs(exponent) >= 4) {
-        // Use scientific notation
-        std::ostringstream oss;
-        oss << std::scientific << std::setprecision(1) << value;
-        return oss.str();
+        out.append_scientific(value, 1);
+        return;
     }
 
-    // Use fixed notation
-    std::ostringstream oss;
-
     // Determine precision based on magnitude
     int precision = 0;
     if (abs_value < 1.0) {
@@ -138,22 +163,10 @@ std::string AxisRenderer::format_label(double value) {
         precision = 1;
     }
 
-    oss << std::fixed << std::setprecision(precision) << value;
-    std::string result = oss.str();
-
-    // Remove trailing zeros after decimal point
-    if (result.find('.') != std::string::npos) {
-        size_t last_nonzero = result.find_last_not_of('0');
-        if (last_nonzero != std::string::npos) {
-            if (result[last_nonzero] == '.') {
-                result.erase(last_nonzero);
-            } else {
-                result.erase(last_nonzero + 1);
-            }
-        }
-    }
-
-    return result;
+    // Fixed notation, trailing zeros after the decimal point removed
+    size_t start = out.size();
+    out.append_fixed(value, precision);
+    out.trim_fraction_zeros(start);
 }
 
 int AxisRenderer::calculate_decimal_places(double data_min, double data_max) {
@@ -195,6 +208,8 @@ double AxisRenderer::round_to_nice(double value) {
 void AxisRenderer::render_x_axis(Terminal& terminal, const Viewport& viewport,
                                  int axis_row, int start_col, int width,
                                  const std::string& axis_name) {
+    TraceSpan span("AxisRenderer::render_x_axis");
+    PhaseTimer timer(Phase::AXES);
     // Suppress unused parameter warning
     (void)axis_name;
 
@@ -203,8 +218,8 @@ void AxisRenderer::render_x_axis(Terminal& terminal, const Viewport& viewport,
     double data_max = viewport.data_x_max();
     double tick_step = calculate_tick_step(data_min, data_max, width);
 
-    // Generate major ticks
-    auto major_ticks = generate_major_ticks(data_min, data_max, tick_step);
+    // Major ticks (reused while the viewport is unchanged)
+    const auto& major_ticks = cached_major_ticks(x_ticks_, data_min, data_max, tick_step);
 
     // Draw a horizontal line for the axis
     for (int col = start_col; col < start_col + width; ++col) {
@@ -246,6 +261,8 @@ void AxisRenderer::render_x_axis(Terminal& terminal, const Viewport& viewport,
 void AxisRenderer::render_y_axis(Terminal& terminal, const Viewport& viewport,
                                  int axis_col, int start_row, int height,
                                  const std::string& axis_name) {
+    TraceSpan span("AxisRenderer::render_y_axis");
+    PhaseTimer timer(Phase::AXES);
     // Suppress unused parameter warning
     (void)axis_name;
 
@@ -254,8 +271,8 @@ void AxisRenderer::render_y_axis(Terminal& terminal, const Viewport& viewport,
     double data_max = viewport.data_y_max();
     double tick_step = calculate_tick_step(data_min, data_max, height);
 
-    // Generate major ticks
-    auto major_ticks = generate_major_ticks(data_min, data_max, tick_step);
+    // Major ticks (reused while the viewport is unchanged)
+    const auto& major_ticks = cached_major_ticks(y_ticks_, data_min, data_max, tick_step);
 
     // Draw a vertical line for the axis
     for (int row = start_row; row < start_row + height; ++row) {
@@ -298,6 +315,8 @@ void AxisRenderer::render_y_axis(Terminal& terminal, const Viewport& viewport,
 void AxisRenderer::render_zero_bars(Terminal& terminal, const Viewport& viewport,
                                     int start_row, int start_col, int height, int width,
                                     bool show_zero_bars) {
+    TraceSpan span("AxisRenderer::render_zero_bars");
+    PhaseTimer timer(Phase::AXES);
     if (!show_zero_bars) {
         return;  // Zero bars disabled
     }
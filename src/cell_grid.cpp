@@ -0,0 +1,50 @@
+#include "cell_grid.h"
+
+namespace datapainter {
+
+void CellGrid::reset(int rows, int cols) {
+    rows = rows > 0 ? rows : 0;
+    cols = cols > 0 ? cols : 0;
+    if (rows != rows_ || cols != cols_) {
+        rows_ = rows;
+        cols_ = cols;
+        cells_.assign(static_cast<size_t>(rows) * static_cast<size_t>(cols), Cell{});
+    } else {
+        // Sparse clear: only the cells the previous frame wrote to
+        for (uint32_t index : occupied_) {
+            cells_[index] = Cell{};
+        }
+    }
+    occupied_.clear();
+    max_count_ = 0;
+}
+
+void CellGrid::merge(const CellGrid& other) {
+    for (uint32_t index : other.occupied_) {
+        const Cell& from = other.cells_[index];
+        Cell& cell = cells_[index];
+        if (cell.count == 0) {
+            occupied_.push_back(index);
+        }
+        cell.count += from.count;
+        if (cell.count > max_count_) {
+            max_count_ = cell.count;
+        }
+        cell.classes |= from.classes;
+        cell.binary[0] += from.binary[0];
+        cell.binary[1] += from.binary[1];
+        if (cell.votes == 0) {
+            cell.dominant = from.dominant;
+            cell.votes = from.votes;
+        } else if (cell.dominant == from.dominant) {
+            cell.votes += from.votes;
+        } else if (cell.votes >= from.votes) {
+            cell.votes -= from.votes;
+        } else {
+            cell.dominant = from.dominant;
+            cell.votes = from.votes - cell.votes;
+        }
+    }
+}
+
+}  // namespace datapainter
@@ -0,0 +1,154 @@
+#include "class_palette.h"
+#include <cctype>
+
+namespace datapainter {
+
+namespace {
+
+// Glyphs handed out to classes beyond x/o, in order. '#' (mixed cell), '!'
+// (outside the valid range) and ' ' are reserved by the edit area.
+constexpr const char* DEFAULT_GLYPHS =
+    "abcdefghijklmnpqrstuvwyz0123456789+*%&=~^$<>{}[]()/\\;:,'\"`|_-?@";
+
+char multi_glyph_for(char glyph) {
+    unsigned char ch = static_cast<unsigned char>(glyph);
+    return std::islower(ch) ? static_cast<char>(std::toupper(ch)) : glyph;
+}
+
+bool is_reserved_glyph(char glyph) {
+    return glyph == '#' || glyph == '!' || glyph == ' ';
+}
+
+}  // namespace
+
+ClassPalette::ClassPalette(const std::string& x_target, const std::string& o_target) {
+    styles_.push_back({x_target, 'x', 'X', Terminal::Color::DEFAULT});
+    if (o_target != x_target) {
+        styles_.push_back({o_target, 'o', 'O', Terminal::Color::DEFAULT});
+    }
+}
+
+int ClassPalette::classify(const std::string& target) {
+    if (last_hit_ != NO_CLASS && styles_[static_cast<size_t>(last_hit_)].target == target) {
+        return last_hit_;
+    }
+    int index = find(target);
+    if (index == NO_CLASS) {
+        index = add(target);
+    }
+    if (index != NO_CLASS) {
+        last_hit_ = index;
+    }
+    return index;
+}
+
+int ClassPalette::find(const std::string& target) const {
+    for (size_t i = 0; i < styles_.size(); ++i) {
+        if (styles_[i].target == target) {
+            return static_cast<int>(i);
+        }
+    }
+    return NO_CLASS;
+}
+
+bool ClassPalette::set_style(const std::string& target, char glyph, Terminal::Color color) {
+    int index = find(target);
+    if (index == NO_CLASS) {
+        index = add(target);
+        if (index == NO_CLASS) {
+            return false;
+        }
+    }
+    Style& style = styles_[static_cast<size_t>(index)];
+    style.glyph = glyph;
+    style.multi_glyph = multi_glyph_for(glyph);
+    style.color = color;
+    return true;
+}
+
+bool ClassPalette::apply_spec(const std::string& spec, std::string& error) {
+    std::string target;
+    char glyph = 0;
+    Terminal::Color color = Terminal::Color::DEFAULT;
+    if (!parse_spec(spec, target, glyph, color, error)) {
+        return false;
+    }
+    if (!set_style(target, glyph, color)) {
+        error = "too many classes (at most " + std::to_string(MAX_CLASSES) + ")";
+        return false;
+    }
+    return true;
+}
+
+bool ClassPalette::validate_spec(const std::string& spec, std::string& error) {
+    std::string target;
+    char glyph = 0;
+    Terminal::Color color = Terminal::Color::DEFAULT;
+    return parse_spec(spec, target, glyph, color, error);
+}
+
+int ClassPalette::add(const std::string& target) {
+    if (size() >= MAX_CLASSES) {
+        return NO_CLASS;
+    }
+    char glyph = next_default_glyph();
+    styles_.push_back({target, glyph, multi_glyph_for(glyph), Terminal::Color::DEFAULT});
+    return size() - 1;
+}
+
+char ClassPalette::next_default_glyph() const {
+    for (const char* candidate = DEFAULT_GLYPHS; *candidate != '\0'; ++candidate) {
+        bool used = false;
+        for (const auto& style : styles_) {
+            if (style.glyph == *candidate || style.multi_glyph == *candidate) {
+                used = true;
+                break;
+            }
+        }
+        if (!used) {
+            return *candidate;
+        }
+    }
+    return '?';
+}
+
+bool ClassPalette::parse_spec(const std::string& spec, std::string& target, char& glyph,
+                              Terminal::Color& color, std::string& error) {
+    // target=glyph[:colour]; split at the first '=' so '=' and ':' still
+    // work as glyphs
+    size_t equals = spec.find('=');
+    if (equals == std::string::npos || equals == 0) {
+        error = "expected <target>=<glyph>[:<colour>]";
+        return false;
+    }
+    target = spec.substr(0, equals);
+    std::string rest = spec.substr(equals + 1);
+
+    std::string color_name;
+    size_t colon = rest.find(':', 1);
+    if (colon != std::string::npos) {
+        color_name = rest.substr(colon + 1);
+        rest = rest.substr(0, colon);
+    }
+
+    if (rest.size() != 1 || !std::isgraph(static_cast<unsigned char>(rest[0])) ||
+        is_reserved_glyph(rest[0])) {
+        error = "glyph must be one printable character other than '#' or '!'";
+        return false;
+    }
+    glyph = rest[0];
+
+    color = Terminal::Color::DEFAULT;
+    if (!color_name.empty()) {
+        auto parsed = Terminal::parse_color(color_name);
+        if (!parsed.has_value()) {
+            error = "unknown colour '" + color_name +
+                    "' (default, red, green, yellow, blue, magenta, cyan, white)";
+            return false;
+        }
+        color = *parsed;
+    }
+    return true;
+}
+
+}  // namespace datapainter
@@ -0,0 +1,125 @@
+#include "csv_exporter.h"
+#include "data_table.h"
+#include "alloc_stats.h"
+#include <sstream>
+#include <vector>
+
+namespace datapainter {
+
+CsvExporter::CsvExporter(Database& db, const std::string& table_name)
+    : db_(db), table_name_(table_name) {}
+
+bool CsvExporter::write(std::ostream& out) {
+    AllocScope allocs("CsvExporter::write");
+    error_.clear();
+
+    // Output CSV header
+    out << "x,y,target\n";
+
+    // Check for write error after header
+    if (out.fail()) {
+        error_ = "Failed to write CSV header";
+        return false;
+    }
+
+    // Stream rows straight from SQLite so memory stays flat for large tables
+    DataTable dt(db_, table_name_);
+    ThreadPool& pool = pool_ != nullptr ? *pool_ : ThreadPool::shared();
+    bool write_failed = false;
+    bool query_ok = true;
+    if (pool.size() < 2) {
+        query_ok = dt.for_each_point([&](const DataPoint& point) {
+            if (write_failed) {
+                return;
+            }
+            write_row(out, point);
+
+            // Check for write error after each row
+            if (out.fail()) {
+                write_failed = true;
+            }
+        });
+    } else {
+        // Number formatting dominates once SQLite has the rows, so each
+        // batch is formatted in slices on the pool's workers, each into
+        // its own stream with out's formatting, and written in order
+        std::vector<DataPoint> batch(BATCH_ROWS);
+        size_t batch_size = 0;
+        std::vector<std::ostringstream> slices(static_cast<size_t>(pool.size()) * 4);
+        for (auto& slice : slices) {
+            slice.copyfmt(out);
+        }
+        auto flush = [&]() {
+            pool.parallel_for(slices.size(), 1, [&](size_t begin, size_t end, int) {
+                for (size_t s = begin; s < end; ++s) {
+                    slices[s].str(std::string());
+                    size_t first = batch_size * s / slices.size();
+                    size_t last = batch_size * (s + 1) / slices.size();
+                    for (size_t row = first; row < last; ++row) {
+                        write_row(slices[s], batch[row]);
+                    }
+                }
+            });
+            for (const auto& slice : slices) {
+                const std::string text = slice.str();
+                out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            }
+            batch_size = 0;
+            if (out.fail()) {
+                write_failed = true;
+            }
+        };
+        query_ok = dt.for_each_point([&](const DataPoint& point) {
+            if (write_failed) {
+                return;
+            }
+            batch[batch_size++] = point;  // Reuses each slot's target capacity
+            if (batch_size == BATCH_ROWS) {
+                flush();
+            }
+        });
+        if (!write_failed && batch_size > 0) {
+            flush();
+        }
+    }
+
+    if (write_failed) {
+        error_ = "Failed to write CSV data";
+        return false;
+    }
+    if (!query_ok) {
+        error_ = "Failed to read table: " + table_name_;
+        return false;
+    }
+    return true;
+}
+
+void CsvExporter::write_row(std::ostream& out, const DataPoint& point) {
+    out << point.x << "," << point.y << ",";
+    write_target(out, point.target);
+    out << "\n";
+}
+
+void CsvExporter::write_target(std::ostream& out, const std::string& target) {
+    // Escape target value if it contains special characters
+    bool needs_quotes = target.find(',') != std::string::npos ||
+                        target.find('"') != std::string::npos ||
+                        target.find('\n') != std::string::npos;
+
+    if (!needs_quotes) {
+        out << target;
+        return;
+    }
+
+    out << "\"";
+    for (char c : target) {
+        if (c == '"') {
+            out << "\"\"";  // Escape quotes by doubling them
+        } else {
+            out << c;
+        }
+    }
+    out << "\"";
+}
+
+}  // namespace datapainter
@@ -1,5 +1,7 @@
 #include "data_table.h"
 #include "database.h"
+#include "frame_stats.h"
+#include "tracer.h"
 #include <sqlite3.h>
 
 namespace datapainter {
@@ -8,6 +10,7 @@ DataTable::DataTable(Database& db, const std::string& table_name)
     : db_(db), table_name_(table_name) {}
 
 std::optional<int> DataTable::insert_point(double x, double y, const std::string& target) {
+    TraceSpan span("DataTable::insert_point");
     sqlite3_stmt* stmt = nullptr;
     std::string sql = "INSERT INTO " + table_name_ + " (x, y, target) VALUES (?, ?, ?)";
 
@@ -31,6 +34,7 @@ std::optional<int> DataTable::insert_point(double x, double y, const std::string
 }
 
 bool DataTable::delete_point(int id) {
+    TraceSpan span("DataTable::delete_point");
     sqlite3_stmt* stmt = nullptr;
     std::string sql = "DELETE FROM " + table_name_ + " WHERE id = ?";
 
@@ -48,7 +52,30 @@ bool DataTable::delete_point(int id) {
     return rc == SQLITE_DONE && changes > 0;
 }
 
+std::optional<DataPoint> DataTable::get_point(int id) {
+    TraceSpan span("DataTable::get_point");
+    sqlite3_stmt* stmt = nullptr;
+    std::string sql = "SELECT id, x, y, target FROM " + table_name_ + " WHERE id = ?";
+
+    int rc = sqlite3_prepare_v2(db_.connection(), sql.c_str(), -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        return std::nullopt;
+    }
+
+    sqlite3_bind_int(stmt, 1, id);
+
+    std::optional<DataPoint> point;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        point = DataPoint{sqlite3_column_int(stmt, 0), sqlite3_column_double(stmt, 1),
+                          sqlite3_column_double(stmt, 2),
+                          reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3))};
+    }
+    sqlite3_finalize(stmt);
+    return point;
+}
+
 bool DataTable::update_point_target(int id, const std::string& new_target) {
+    TraceSpan span("DataTable::update_point_target");
     sqlite3_stmt* stmt = nullptr;
     std::string sql = "UPDATE " + table_name_ + " SET target = ? WHERE id = ?";
 
@@ -69,6 +96,8 @@ bool DataTable::update_point_target(int id, const std::string& new_target) {
 
 std::vector<DataPoint> DataTable::query_viewport(double x_min, double x_max,
                                                   double y_min, double y_max) {
+    TraceSpan span("DataTable::query_viewport");
+    PhaseTimer timer(Phase::QUERY);
     std::vector<DataPoint> points;
 
     sqlite3_stmt* stmt = nullptr;
@@ -95,10 +124,128 @@ std::vector<DataPoint> DataTable::query_viewport(double x_min, double x_max,
     }
 
     sqlite3_finalize(stmt);
+    if (FrameStats::enabled()) {
+        FrameStats::instance().add_points_fetched(points.size());
+    }
     return points;
 }
 
+bool DataTable::for_each_point(const std::function<void(const DataPoint&)>& visitor) {
+    TraceSpan span("DataTable::for_each_point");
+    sqlite3_stmt* stmt = nullptr;
+    std::string sql = "SELECT id, x, y, target FROM " + table_name_ + " ORDER BY id";
+
+    int rc = sqlite3_prepare_v2(db_.connection(), sql.c_str(), -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        return false;
+    }
+
+    // Reuse one DataPoint so the target string keeps its capacity between rows
+    DataPoint point;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        point.id = sqlite3_column_int(stmt, 0);
+        point.x = sqlite3_column_double(stmt, 1);
+        point.y = sqlite3_column_double(stmt, 2);
+        point.target.assign(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
+        visitor(point);
+    }
+
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+std::vector<BinCount> DataTable::count_in_bins(double x_min, double x_max,
+                                               double y_min, double y_max,
+                                               int rows, int cols,
+                                               const std::optional<std::string>& target) {
+    TraceSpan span("DataTable::count_in_bins");
+    PhaseTimer timer(Phase::QUERY);
+    std::vector<BinCount> bins;
+    if (rows <= 0 || cols <= 0 || x_max <= x_min || y_max <= y_min) {
+        return bins;
+    }
+
+    // Points on the max edges would land one past the last cell, so clamp
+    sqlite3_stmt* stmt = nullptr;
+    std::string sql = "SELECT MIN(CAST((? - y) * ? AS INTEGER), ?) AS r, "
+                      "MIN(CAST((x - ?) * ? AS INTEGER), ?) AS c, COUNT(*) FROM " + table_name_ +
+                      " WHERE x >= ? AND x <= ? AND y >= ? AND y <= ?" +
+                      (target.has_value() ? " AND target = ?" : "") + " GROUP BY r, c";
+
+    int rc = sqlite3_prepare_v2(db_.connection(), sql.c_str(), -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        return bins;
+    }
+
+    sqlite3_bind_double(stmt, 1, y_max);
+    sqlite3_bind_double(stmt, 2, rows / (y_max - y_min));
+    sqlite3_bind_int(stmt, 3, rows - 1);
+    sqlite3_bind_double(stmt, 4, x_min);
+    sqlite3_bind_double(stmt, 5, cols / (x_max - x_min));
+    sqlite3_bind_int(stmt, 6, cols - 1);
+    sqlite3_bind_double(stmt, 7, x_min);
+    sqlite3_bind_double(stmt, 8, x_max);
+    sqlite3_bind_double(stmt, 9, y_min);
+    sqlite3_bind_double(stmt, 10, y_max);
+    if (target.has_value()) {
+        sqlite3_bind_text(stmt, 11, target->c_str(), -1, SQLITE_TRANSIENT);
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        bins.push_back({sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1),
+                        sqlite3_column_int(stmt, 2)});
+    }
+
+    sqlite3_finalize(stmt);
+    return bins;
+}
+
+std::vector<TargetSums> DataTable::sum_by_target(double origin_x, double origin_y,
+                                                 const std::optional<DataRegion>& region) {
+    TraceSpan span("DataTable::sum_by_target");
+    PhaseTimer timer(Phase::QUERY);
+    std::vector<TargetSums> sums;
+
+    // Offsets from the origin keep the squares small, so the covariances
+    // derived from them do not cancel away their precision
+    sqlite3_stmt* stmt = nullptr;
+    std::string sql = "SELECT target, COUNT(*), SUM(dx), SUM(dy), SUM(dx * dx), SUM(dy * dy), SUM(dx * dy) "
+                      "FROM (SELECT target, x - ? AS dx, y - ? AS dy FROM " + table_name_;
+    if (region.has_value()) {
+        sql += std::string(" WHERE x ") + (region->open_x_min ? ">" : ">=") + " ? AND x " +
+               (region->open_x_max ? "<" : "<=") + " ? AND y " + (region->open_y_min ? ">" : ">=") +
+               " ? AND y " + (region->open_y_max ? "<" : "<=") + " ?";
+    }
+    sql += ") GROUP BY target";
+
+    int rc = sqlite3_prepare_v2(db_.connection(), sql.c_str(), -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        return sums;
+    }
+
+    sqlite3_bind_double(stmt, 1, origin_x);
+    sqlite3_bind_double(stmt, 2, origin_y);
+    if (region.has_value()) {
+        sqlite3_bind_double(stmt, 3, region->x_min);
+        sqlite3_bind_double(stmt, 4, region->x_max);
+        sqlite3_bind_double(stmt, 5, region->y_min);
+        sqlite3_bind_double(stmt, 6, region->y_max);
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const unsigned char* target = sqlite3_column_text(stmt, 0);
+        sums.push_back({target != nullptr ? reinterpret_cast<const char*>(target) : "",
+                        sqlite3_column_int64(stmt, 1), sqlite3_column_double(stmt, 2),
+                        sqlite3_column_double(stmt, 3), sqlite3_column_double(stmt, 4),
+                        sqlite3_column_double(stmt, 5), sqlite3_column_double(stmt, 6)});
+    }
+
+    sqlite3_finalize(stmt);
+    return sums;
+}
+
 std::vector<std::string> DataTable::get_distinct_targets() {
+    TraceSpan span("DataTable::get_distinct_targets");
     std::vector<std::string> targets;
 
     sqlite3_stmt* stmt = nullptr;
@@ -119,6 +266,7 @@ std::vector<std::string> DataTable::get_distinct_targets() {
 }
 
 int DataTable::count_by_target(const std::string& target) {
+    TraceSpan span("DataTable::count_by_target");
     sqlite3_stmt* stmt = nullptr;
     std::string sql = "SELECT COUNT(*) FROM " + table_name_ + " WHERE target = ?";
 
@@ -82,6 +82,17 @@ sqlite3* Database::connection() {
     return db_;
 }
 
+bool Database::page_cache_usage(int& hits, int& misses, bool reset) {
+    if (!db_) {
+        return false;
+    }
+    int highwater = 0;
+    if (sqlite3_db_status(db_, SQLITE_DBSTATUS_CACHE_HIT, &hits, &highwater, reset ? 1 : 0) != SQLITE_OK) {
+        return false;
+    }
+    return sqlite3_db_status(db_, SQLITE_DBSTATUS_CACHE_MISS, &misses, &highwater, reset ? 1 : 0) == SQLITE_OK;
+}
+
 bool Database::ensure_metadata_table() {
     if (!db_) {
         return false;
@@ -0,0 +1,39 @@
+#include "dot_grid.h"
+#include <algorithm>
+
+namespace datapainter {
+
+void DotGrid::reset(const Viewport& viewport, int rows, int cols) {
+    rows = rows > 0 ? rows : 0;
+    cols = cols > 0 ? cols : 0;
+    size_t cell_count = static_cast<size_t>(rows) * static_cast<size_t>(cols);
+    if (rows != rows_ || cols != cols_) {
+        rows_ = rows;
+        cols_ = cols;
+        bits_.assign(cell_count, 0);
+    } else {
+        std::fill(bits_.begin(), bits_.end(), 0);
+    }
+
+    // Same cell mapping as Viewport::data_to_screen(), DOTS_PER_* times finer
+    x_min_ = viewport.data_x_min();
+    x_max_ = viewport.data_x_max();
+    y_min_ = viewport.data_y_min();
+    y_max_ = viewport.data_y_max();
+    double data_width = x_max_ - x_min_;
+    double data_height = y_max_ - y_min_;
+    x_scale_ = data_width > 0 ? DOTS_PER_COL * (viewport.screen_width() - 1) / data_width : 0.0;
+    y_scale_ = data_height > 0 ? DOTS_PER_ROW * (viewport.screen_height() - 1) / data_height : 0.0;
+    x_offset_ = DOTS_PER_COL * 0.5;
+    y_offset_ = DOTS_PER_ROW * 0.5;
+    max_dot_col_ = std::max(0, viewport.screen_width() * DOTS_PER_COL - 1);
+    max_dot_row_ = std::max(0, viewport.screen_height() * DOTS_PER_ROW - 1);
+}
+
+void DotGrid::merge(const DotGrid& other) {
+    for (size_t i = 0; i < bits_.size(); ++i) {
+        bits_[i] |= other.bits_[i];
+    }
+}
+
+}  // namespace datapainter
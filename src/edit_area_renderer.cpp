@@ -1,22 +1,117 @@
 #include "edit_area_renderer.h"
+#include "frame_stats.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cmath>
 #include <map>
-#include <iostream>
 
 namespace datapainter {
 
+namespace {
+
+// Density ramp, lightest first: shade blocks and their ASCII fallbacks
+constexpr int DENSITY_LEVELS = EditAreaRenderer::DENSITY_LEVELS;
+constexpr char32_t DENSITY_GLYPHS[DENSITY_LEVELS] = {U'\u2591', U'\u2592', U'\u2593', U'\u2588'};
+constexpr char DENSITY_FALLBACKS[DENSITY_LEVELS] = {'.', ':', '%', '@'};
+
+// Diverging x/o palette by share of x points, all-o first
+constexpr Terminal::Color DIVERGING[5] = {
+    Terminal::Color::BLUE, Terminal::Color::CYAN, Terminal::Color::WHITE,
+    Terminal::Color::MAGENTA, Terminal::Color::RED};
+
+}  // namespace
+
+EditAreaRenderer::DensityScale::DensityScale(uint32_t max_count) {
+    double top = 1.0 + static_cast<double>(max_count);
+    for (int k = 1; k < DENSITY_LEVELS; ++k) {
+        thresholds_[k - 1] = std::pow(top, static_cast<double>(k) / DENSITY_LEVELS);
+    }
+}
+
+int EditAreaRenderer::DensityScale::level(uint32_t count) const {
+    double weight = 1.0 + static_cast<double>(count);
+    int level = 0;
+    while (level < DENSITY_LEVELS - 1 && weight > thresholds_[level]) {
+        ++level;
+    }
+    return level;
+}
+
+Terminal::Color EditAreaRenderer::blend_color(const CellGrid::Cell& cell, const ClassPalette& palette) {
+    if ((cell.classes & ~uint64_t{3}) == 0) {
+        int bucket = static_cast<int>((uint64_t{cell.binary[0]} * 5) / cell.count);
+        return DIVERGING[bucket < 5 ? bucket : 4];
+    }
+    return palette.style(cell.dominant).color;
+}
+
+char32_t EditAreaRenderer::density_glyph(int level) {
+    return DENSITY_GLYPHS[level < 0 ? 0 : (level < DENSITY_LEVELS ? level : DENSITY_LEVELS - 1)];
+}
+
+char EditAreaRenderer::density_fallback(int level) {
+    return DENSITY_FALLBACKS[level < 0 ? 0 : (level < DENSITY_LEVELS ? level : DENSITY_LEVELS - 1)];
+}
+
+EditAreaRenderer::Mode EditAreaRenderer::next_mode(Mode mode) {
+    switch (mode) {
+        case Mode::POINTS:  return Mode::DENSITY;
+        case Mode::DENSITY: return Mode::BRAILLE;
+        case Mode::BRAILLE: return Mode::POINTS;
+    }
+    return Mode::POINTS;
+}
+
+std::optional<EditAreaRenderer::Mode> EditAreaRenderer::parse_mode(const std::string& name) {
+    if (name == "points") {
+        return Mode::POINTS;
+    }
+    if (name == "density") {
+        return Mode::DENSITY;
+    }
+    if (name == "braille") {
+        return Mode::BRAILLE;
+    }
+    return std::nullopt;
+}
+
+const char* EditAreaRenderer::mode_name(Mode mode) {
+    switch (mode) {
+        case Mode::POINTS:  return "points";
+        case Mode::DENSITY: return "density";
+        case Mode::BRAILLE: return "braille";
+    }
+    return "points";
+}
+
 void EditAreaRenderer::render(Terminal& terminal, const Viewport& viewport, DataTable& table,
                               const std::vector<ChangeRecord>& unsaved_changes, int start_row,
                               int height, int width, int cursor_row, int cursor_col,
                               const std::string& x_target, const std::string& o_target) {
+    if (default_palette_.size() < 2 || default_palette_.style(0).target != x_target ||
+        default_palette_.style(1).target != o_target) {
+        default_palette_ = ClassPalette(x_target, o_target);
+    }
+    render(terminal, viewport, table, unsaved_changes, start_row, height, width,
+           cursor_row, cursor_col, default_palette_);
+}
+
+void EditAreaRenderer::render(Terminal& terminal, const Viewport& viewport, DataTable& table,
+                              const std::vector<ChangeRecord>& unsaved_changes, int start_row,
+                              int height, int width, int cursor_row, int cursor_col,
+                              ClassPalette& palette) {
+    TraceSpan span("EditAreaRenderer::render");
     // Suppress unused parameter warnings for cursor (not yet implemented)
     (void)cursor_row;
     (void)cursor_col;
 
+    PhaseTimer timer(Phase::EDIT_AREA);
+
     // Draw the border for the edit area
     draw_border(terminal, start_row, height, width);
 
     // Render all points in the viewport with unsaved changes applied
-    render_points(terminal, viewport, table, unsaved_changes, start_row, height, width, x_target, o_target);
+    render_points(terminal, viewport, table, unsaved_changes, start_row, height, width, palette);
 
     // Draw cursor (optional - for now we'll just verify it doesn't crash)
     // draw_cursor(terminal, cursor_row, cursor_col);
@@ -48,10 +143,20 @@ void EditAreaRenderer::draw_border(Terminal& terminal, int start_row, int height
     }
 }
 
+void EditAreaRenderer::draw_border_label(Terminal& terminal, int row, int width, const std::string& label) {
+    int length = static_cast<int>(label.size());
+    if (length + 4 > width) {
+        return;
+    }
+    for (int i = 0; i < length; ++i) {
+        terminal.write_char(row, 2 + i, label[static_cast<size_t>(i)]);
+    }
+}
+
 void EditAreaRenderer::render_points(Terminal& terminal, const Viewport& viewport,
                                      DataTable& table, const std::vector<ChangeRecord>& unsaved_changes,
-                                     int start_row, int height, int width,
-                                     const std::string& x_target, const std::string& o_target) {
+                                     int start_row, int height, int width, ClassPalette& palette) {
+    TraceSpan span("EditAreaRenderer::render_points");
     // Calculate content area (inside border)
     int content_height = height - 2;  // Exclude top and bottom border
     int content_width = width - 2;    // Exclude left and right border
@@ -93,57 +198,124 @@ void EditAreaRenderer::render_points(Terminal& terminal, const Viewport& viewpor
         }
     }
 
+    bin(viewport, table, unsaved_changes, content_height, content_width, palette);
+
+    // Second pass: Render points (will override '!' if points exist in forbidden areas)
+    PhaseTimer draw_timer(Phase::EDIT_AREA);  // Ends the binning phase
+    if (mode_ == Mode::DENSITY) {
+        draw_density(terminal, start_row, palette);
+        return;
+    }
+    if (mode_ == Mode::BRAILLE) {
+        grid_.for_each_occupied([&](int screen_row, int screen_col, const CellGrid::Cell& cell) {
+            terminal.write_glyph(start_row + 1 + screen_row, 1 + screen_col,
+                                 DotGrid::glyph(dots_.at(screen_row, screen_col)),
+                                 cell_char(cell, palette), blend_color(cell, palette));
+        });
+        return;
+    }
+    grid_.for_each_occupied([&](int screen_row, int screen_col, const CellGrid::Cell& cell) {
+        // Adjust for border and start_row offset
+        // Border is 1 char wide, so content starts at start_row+1, col 1
+        terminal.write_char(start_row + 1 + screen_row, 1 + screen_col, cell_char(cell, palette),
+                            palette.style(cell.dominant).color);
+    });
+}
+
+const CellGrid& EditAreaRenderer::bin(const Viewport& viewport, DataTable& table,
+                                      const std::vector<ChangeRecord>& unsaved_changes,
+                                      int rows, int cols, ClassPalette& palette) {
     // Query all points within the viewport bounds
     auto points = table.query_viewport(viewport.data_x_min(), viewport.data_x_max(),
                                        viewport.data_y_min(), viewport.data_y_max());
+    return bin_points(viewport, points, unsaved_changes, rows, cols, palette);
+}
 
+const CellGrid& EditAreaRenderer::bin_points(const Viewport& viewport, const std::vector<DataPoint>& points,
+                                             const std::vector<ChangeRecord>& unsaved_changes,
+                                             int rows, int cols, ClassPalette& palette) {
     // Build maps to track unsaved changes
     std::map<int, bool> deleted_ids;  // data_id -> true if deleted
     std::map<int, std::string> updated_targets;  // data_id -> new target value
 
     // Process active unsaved changes to build modification maps
-    for (const auto& change : unsaved_changes) {
-        if (!change.is_active) continue;  // Skip inactive (undone) changes
-
-        if (change.action == "delete" && change.data_id.has_value()) {
-            deleted_ids[change.data_id.value()] = true;
-        } else if (change.action == "update" && change.data_id.has_value() && change.new_target.has_value()) {
-            updated_targets[change.data_id.value()] = change.new_target.value();
+    {
+        PhaseTimer overlay_timer(Phase::OVERLAY);
+        for (const auto& change : unsaved_changes) {
+            if (!change.is_active) continue;  // Skip inactive (undone) changes
+
+            if (change.action == "delete" && change.data_id.has_value()) {
+                deleted_ids[change.data_id.value()] = true;
+            } else if (change.action == "update" && change.data_id.has_value() && change.new_target.has_value()) {
+                updated_targets[change.data_id.value()] = change.new_target.value();
+            }
         }
     }
 
-    // Map from screen coordinates to counts of x and o points
-    std::map<std::pair<int, int>, std::pair<int, int>> cell_counts;
-
-    // Count points at each screen cell, applying deletions and updates
-    for (const auto& point : points) {
-        // Skip if this point has been deleted by an unsaved change
-        if (deleted_ids.count(point.id) > 0) {
-            continue;
-        }
-
-        // Apply any target update from unsaved changes
-        std::string effective_target = point.target;
-        if (updated_targets.count(point.id) > 0) {
-            effective_target = updated_targets[point.id];
+    // Bin every point into the dense grid as a class index. Braille mode
+    // also sets the point's dot; its cell comes from the dot so both grids
+    // agree.
+    grid_.reset(rows, cols);
+    bool braille = mode_ == Mode::BRAILLE;
+    if (braille) {
+        dots_.reset(viewport, rows, cols);
+    }
+    auto bin = [&](const DataCoord& data, const std::string& target) {
+        if (braille) {
+            int dot_row = 0;
+            int dot_col = 0;
+            if (!dots_.locate(data.x, data.y, dot_row, dot_col)) {
+                return;
+            }
+            int class_index = palette.classify(target);
+            if (class_index != ClassPalette::NO_CLASS) {
+                dots_.set(dot_row, dot_col);
+                grid_.add(dot_row / DotGrid::DOTS_PER_ROW, dot_col / DotGrid::DOTS_PER_COL, class_index);
+            }
+            return;
         }
-
-        DataCoord data{point.x, point.y};
         auto screen_opt = viewport.data_to_screen(data);
-
-        // Check if point maps to valid screen coordinates
         if (screen_opt.has_value()) {
-            auto screen = screen_opt.value();
-            // Ensure point is within content area bounds (viewport coordinates are 0-based)
-            if (screen.row >= 0 && screen.row < content_height &&
-                screen.col >= 0 && screen.col < content_width) {
-                auto key = std::make_pair(screen.row, screen.col);
-                if (effective_target == x_target) {
-                    cell_counts[key].first++;  // x count
-                } else if (effective_target == o_target) {
-                    cell_counts[key].second++;  // o count
+            int class_index = palette.classify(target);
+            if (class_index != ClassPalette::NO_CLASS) {
+                grid_.add(screen_opt->row, screen_opt->col, class_index);
+            }
+        }
+    };
+    PhaseTimer bin_timer(Phase::BIN);
+
+    if (!bin_parallel(viewport, points, deleted_ids, updated_targets, palette)) {
+        for (const auto& point : points) {
+            // Skip if this point has been deleted by an unsaved change
+            if (!deleted_ids.empty() && deleted_ids.count(point.id) > 0) {
+                continue;
+            }
+
+            // Apply any target update from unsaved changes
+            const std::string* effective_target = &point.target;
+            if (!updated_targets.empty()) {
+                auto updated = updated_targets.find(point.id);
+                if (updated != updated_targets.end()) {
+                    effective_target = &updated->second;
                 }
             }
+
+            bin(DataCoord{point.x, point.y}, *effective_target);
+        }
+    } else {
+        // Points whose targets the workers could not classify without
+        // registering them, in point order so new classes are numbered as
+        // a single pass would number them
+        std::vector<size_t> deferred;
+        for (const auto& worker : workers_) {
+            deferred.insert(deferred.end(), worker.deferred.begin(), worker.deferred.end());
+        }
+        std::sort(deferred.begin(), deferred.end());
+        for (size_t index : deferred) {
+            const DataPoint& point = points[index];
+            auto updated = updated_targets.find(point.id);
+            bin(DataCoord{point.x, point.y},
+                updated != updated_targets.end() ? updated->second : point.target);
         }
     }
 
@@ -157,35 +329,102 @@ void EditAreaRenderer::render_points(Terminal& terminal, const Viewport& viewpor
             // Check if inserted point is within viewport bounds
             if (data.x >= viewport.data_x_min() && data.x <= viewport.data_x_max() &&
                 data.y >= viewport.data_y_min() && data.y <= viewport.data_y_max()) {
-
-                auto screen_opt = viewport.data_to_screen(data);
-                if (screen_opt.has_value()) {
-                    auto screen = screen_opt.value();
-                    if (screen.row >= 0 && screen.row < content_height &&
-                        screen.col >= 0 && screen.col < content_width) {
-                        auto key = std::make_pair(screen.row, screen.col);
-                        std::string target = change.new_target.value();
-                        if (target == x_target) {
-                            cell_counts[key].first++;  // x count
-                        } else if (target == o_target) {
-                            cell_counts[key].second++;  // o count
-                        }
-                    }
-                }
+                bin(data, change.new_target.value());
             }
         }
     }
+    return grid_;
+}
 
-    // Second pass: Render points (will override '!' if points exist in forbidden areas)
-    for (const auto& [coord, counts] : cell_counts) {
-        auto [screen_row, screen_col] = coord;
-        auto [x_count, o_count] = counts;
+bool EditAreaRenderer::bin_parallel(const Viewport& viewport, const std::vector<DataPoint>& points,
+                                    const std::map<int, bool>& deleted_ids,
+                                    const std::map<int, std::string>& updated_targets,
+                                    ClassPalette& palette) {
+    ThreadPool& pool = pool_ != nullptr ? *pool_ : ThreadPool::shared();
+    size_t cells = static_cast<size_t>(grid_.rows()) * static_cast<size_t>(grid_.cols());
+    if (pool.size() < 2 || points.size() < PARALLEL_MIN_POINTS || cells > PARALLEL_MAX_GRID_CELLS) {
+        return false;
+    }
 
-        // Adjust for border and start_row offset
-        // Border is 1 char wide, so content starts at start_row+1, col 1
-        char ch = get_point_char(x_count, o_count);
-        terminal.write_char(start_row + 1 + screen_row, 1 + screen_col, ch);
+    bool braille = mode_ == Mode::BRAILLE;
+    if (workers_.size() != static_cast<size_t>(pool.size())) {
+        workers_.resize(static_cast<size_t>(pool.size()));
+    }
+    for (auto& worker : workers_) {
+        worker.grid.reset(grid_.rows(), grid_.cols());
+        if (braille) {
+            worker.dots.reset(viewport, grid_.rows(), grid_.cols());
+        }
+        worker.deferred.clear();
     }
+
+    // Workers only read the palette and the change maps; targets the
+    // palette has not seen yet are deferred to the calling thread
+    const ClassPalette& classes = palette;
+    pool.parallel_for(points.size(), PARALLEL_MIN_POINTS / 4, [&](size_t begin, size_t end, int worker_index) {
+        WorkerBins& worker = workers_[static_cast<size_t>(worker_index)];
+        int last_hit = ClassPalette::NO_CLASS;
+        for (size_t i = begin; i < end; ++i) {
+            const DataPoint& point = points[i];
+            if (!deleted_ids.empty() && deleted_ids.count(point.id) > 0) {
+                continue;
+            }
+            const std::string* target = &point.target;
+            if (!updated_targets.empty()) {
+                auto updated = updated_targets.find(point.id);
+                if (updated != updated_targets.end()) {
+                    target = &updated->second;
+                }
+            }
+
+            int row = 0;
+            int col = 0;
+            int dot_row = 0;
+            int dot_col = 0;
+            if (braille) {
+                if (!worker.dots.locate(point.x, point.y, dot_row, dot_col)) {
+                    continue;
+                }
+                row = dot_row / DotGrid::DOTS_PER_ROW;
+                col = dot_col / DotGrid::DOTS_PER_COL;
+            } else {
+                auto screen_opt = viewport.data_to_screen(DataCoord{point.x, point.y});
+                if (!screen_opt.has_value()) {
+                    continue;
+                }
+                row = screen_opt->row;
+                col = screen_opt->col;
+            }
+
+            int class_index = classes.find(*target, last_hit);
+            if (class_index == ClassPalette::NO_CLASS) {
+                worker.deferred.push_back(i);
+                continue;
+            }
+            if (braille) {
+                worker.dots.set(dot_row, dot_col);
+            }
+            worker.grid.add(row, col, class_index);
+        }
+    });
+
+    for (const auto& worker : workers_) {
+        grid_.merge(worker.grid);
+        if (braille) {
+            dots_.merge(worker.dots);
+        }
+    }
+    return true;
+}
+
+void EditAreaRenderer::draw_density(Terminal& terminal, int start_row,
+                                    const ClassPalette& palette) const {
+    DensityScale scale(grid_.max_count());
+    grid_.for_each_occupied([&](int screen_row, int screen_col, const CellGrid::Cell& cell) {
+        int level = scale.level(cell.count);
+        terminal.write_glyph(start_row + 1 + screen_row, 1 + screen_col, DENSITY_GLYPHS[level],
+                             DENSITY_FALLBACKS[level], blend_color(cell, palette));
+    });
 }
 
 void EditAreaRenderer::draw_cursor(Terminal& terminal, int cursor_row, int cursor_col) {
@@ -197,19 +436,15 @@ void EditAreaRenderer::draw_cursor(Terminal& terminal, int cursor_row, int curso
     // For now, this is a placeholder
 }
 
-char EditAreaRenderer::get_point_char(int x_count, int o_count) const {
-    if (x_count > 0 && o_count > 0) {
+char EditAreaRenderer::cell_char(const CellGrid::Cell& cell, const ClassPalette& palette) {
+    if (cell.empty()) {
+        return ' ';
+    }
+    if (cell.mixed()) {
         return '#';  // Mixed
-    } else if (x_count > 1) {
-        return 'X';  // Multiple x's
-    } else if (o_count > 1) {
-        return 'O';  // Multiple o's
-    } else if (x_count == 1) {
-        return 'x';  // Single x
-    } else if (o_count == 1) {
-        return 'o';  // Single o
-    }
-    return ' ';  // Empty
+    }
+    const ClassPalette::Style& style = palette.style(cell.dominant);
+    return cell.count > 1 ? style.multi_glyph : style.glyph;
 }
 
 }  // namespace datapainter
@@ -0,0 +1,193 @@
+#include "event_loop.h"
+#include <algorithm>
+#include <utility>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace datapainter {
+
+#ifndef _WIN32
+namespace {
+
+// SIGWINCH self-pipe, shared by every EventLoop for the life of the process
+int g_resize_pipe[2] = {-1, -1};
+struct sigaction g_previous_sigwinch;
+
+bool make_pipe(int fds[2]) {
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    for (int i = 0; i < 2; ++i) {
+        fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    return true;
+}
+
+void drain(int fd) {
+    char buffer[64];
+    while (read(fd, buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+void on_sigwinch(int signo, siginfo_t* info, void* context) {
+    int saved_errno = errno;
+    char byte = 'w';
+    [[maybe_unused]] ssize_t ignored = write(g_resize_pipe[1], &byte, 1);
+    errno = saved_errno;
+
+    // Keep ncurses' own resize handling working
+    if (g_previous_sigwinch.sa_flags & SA_SIGINFO) {
+        if (g_previous_sigwinch.sa_sigaction != nullptr) {
+            g_previous_sigwinch.sa_sigaction(signo, info, context);
+        }
+    } else if (g_previous_sigwinch.sa_handler != SIG_DFL && g_previous_sigwinch.sa_handler != SIG_IGN) {
+        g_previous_sigwinch.sa_handler(signo);
+    }
+}
+
+}  // namespace
+#endif
+
+EventLoop::EventLoop() : next_timer_id_(1) {}
+
+EventLoop::Wake EventLoop::wait(int fd) {
+#ifdef _WIN32
+    (void)fd;
+    return Wake::ERROR;
+#else
+    for (;;) {
+        // Timers due before we got here
+        if (run_timers()) {
+            return Wake::TASKS;
+        }
+
+        struct pollfd fds[2];
+        nfds_t count = 0;
+        int fd_index = -1;
+        int resize_index = -1;
+        if (fd >= 0) {
+            fd_index = static_cast<int>(count);
+            fds[count++] = {fd, POLLIN, 0};
+        }
+        if (g_resize_pipe[0] >= 0) {
+            resize_index = static_cast<int>(count);
+            fds[count++] = {g_resize_pipe[0], POLLIN, 0};
+        }
+
+        int ready = poll(fds, count, next_timeout_ms());
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;  // A handled signal; the self-pipe reports SIGWINCH
+            }
+            return Wake::ERROR;
+        }
+
+        if (resize_index >= 0 && (fds[resize_index].revents & POLLIN)) {
+            drain(g_resize_pipe[0]);
+            return Wake::RESIZE;
+        }
+        if (fd_index >= 0 && (fds[fd_index].revents & (POLLIN | POLLHUP | POLLERR))) {
+            // Still run timers that became due, but input comes first
+            run_timers();
+            return Wake::READABLE;
+        }
+    }
+#endif
+}
+
+int EventLoop::add_timer(std::chrono::milliseconds delay, Callback callback, bool repeat) {
+    Timer timer;
+    timer.id = next_timer_id_++;
+    timer.due = Clock::now() + delay;
+    timer.interval = delay;
+    timer.repeat = repeat;
+    timer.callback = std::move(callback);
+    timers_.push_back(std::move(timer));
+    return timers_.back().id;
+}
+
+bool EventLoop::cancel_timer(int id) {
+    auto it = std::find_if(timers_.begin(), timers_.end(),
+                           [id](const Timer& timer) { return timer.id == id; });
+    if (it == timers_.end()) {
+        return false;
+    }
+    timers_.erase(it);
+    return true;
+}
+
+int EventLoop::next_timeout_ms() const {
+    if (timers_.empty()) {
+        return -1;
+    }
+    Clock::time_point due = timers_.front().due;
+    for (const auto& timer : timers_) {
+        due = std::min(due, timer.due);
+    }
+    auto remaining = std::chrono::ceil<std::chrono::milliseconds>(due - Clock::now()).count();
+    return remaining > 0 ? static_cast<int>(remaining) : 0;
+}
+
+bool EventLoop::run_timers() {
+    Clock::time_point now = Clock::now();
+    // Collect the due timers first, in deadline order: callbacks may add or
+    // cancel timers, which moves the others within timers_
+    std::vector<std::pair<Clock::time_point, int>> due;
+    for (const auto& timer : timers_) {
+        if (timer.due <= now) {
+            due.emplace_back(timer.due, timer.id);
+        }
+    }
+    std::sort(due.begin(), due.end());
+
+    bool ran = false;
+    for (const auto& entry : due) {
+        int id = entry.second;
+        auto it = std::find_if(timers_.begin(), timers_.end(),
+                               [id](const Timer& timer) { return timer.id == id; });
+        if (it == timers_.end()) {
+            continue;  // Cancelled by an earlier callback
+        }
+        ran = true;
+        Callback callback = it->callback;
+        if (it->repeat) {
+            it->due = now + it->interval;
+        } else {
+            timers_.erase(it);
+        }
+        callback();
+    }
+    return ran;
+}
+
+bool EventLoop::watch_resize() {
+#ifdef _WIN32
+    return false;
+#else
+    if (g_resize_pipe[0] < 0 && !make_pipe(g_resize_pipe)) {
+        return false;
+    }
+
+    // Already installed (possibly under another handler that chains to us)
+    struct sigaction current;
+    sigaction(SIGWINCH, nullptr, &current);
+    if ((current.sa_flags & SA_SIGINFO) && current.sa_sigaction == on_sigwinch) {
+        return true;
+    }
+
+    struct sigaction action = {};
+    action.sa_sigaction = on_sigwinch;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    return sigaction(SIGWINCH, &action, &g_previous_sigwinch) == 0;
+#endif
+}
+
+}  // namespace datapainter
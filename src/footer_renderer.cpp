@@ -1,8 +1,9 @@
 #include "footer_renderer.h"
+#include "frame_stats.h"
+#include "tracer.h"
 #include <algorithm>
 #include <cmath>
-#include <iomanip>
-#include <sstream>
+#include <string_view>
 
 namespace datapainter {
 
@@ -10,6 +11,8 @@ void FooterRenderer::render(Terminal& terminal, double cursor_x, double cursor_y
                            double x_min, double x_max, double y_min, double y_max,
                            double vp_x_min, double vp_x_max, double vp_y_min, double vp_y_max,
                            int focused_button, int unsaved_changes_count) {
+    TraceSpan span("FooterRenderer::render");
+    PhaseTimer timer(Phase::FOOTER);
     int rows = terminal.rows();
     int cols = terminal.cols();
     int footer_row = rows - 1;
@@ -26,71 +29,69 @@ void FooterRenderer::render(Terminal& terminal, double cursor_x, double cursor_y
     int cursor_precision = std::max(x_precision, y_precision);
 
     // Build footer string
-    std::ostringstream footer;
+    TextBuffer& footer = footer_;
+    footer.clear();
 
     // Unsaved changes indicator (if any)
     if (unsaved_changes_count > 0) {
-        footer << "[Unsaved: " << unsaved_changes_count << "] ";
+        footer.append("[Unsaved: ").append_int(unsaved_changes_count).append("] ");
+    }
+    if (has_fit_) {
+        footer.append("[LR acc ").append_fixed(fit_accuracy_ * 100.0, 1).append("% loss ");
+        footer.append_fixed(fit_loss_, 3).append("] ");
     }
 
     // Cursor position with dynamic precision
-    footer << "(" << format_coord(cursor_x, cursor_precision)
-           << ", " << format_coord(cursor_y, cursor_precision) << ")";
+    footer.append('(');
+    append_coord(footer, cursor_x, cursor_precision);
+    footer.append(", ");
+    append_coord(footer, cursor_y, cursor_precision);
+    footer.append(')');
 
     // Zoom controls
-    footer << " | Zoom: ";
-    footer << "+ - =";
+    footer.append(" | Zoom: ");
+    footer.append("+ - =");
 
     // Valid ranges (use fixed precision of 1 for ranges)
-    footer << " | X:[" << format_coord(x_min, 1) << "," << format_coord(x_max, 1) << "]";
-    footer << " Y:[" << format_coord(y_min, 1) << "," << format_coord(y_max, 1) << "]";
+    footer.append(" | X:[");
+    append_coord(footer, x_min, 1);
+    footer.append(',');
+    append_coord(footer, x_max, 1);
+    footer.append("] Y:[");
+    append_coord(footer, y_min, 1);
+    footer.append(',');
+    append_coord(footer, y_max, 1);
+    footer.append(']');
 
     // Action buttons
-    footer << " | ";
-    if (focused_button == 1) {
-        footer << "[#:Tabular]";
-    } else {
-        footer << "#:Tabular";
-    }
-    footer << " ";
-    if (focused_button == 2) {
-        footer << "[u:Undo]";
-    } else {
-        footer << "u:Undo";
-    }
-    footer << " ";
-    if (focused_button == 3) {
-        footer << "[s:Save]";
-    } else {
-        footer << "s:Save";
-    }
-    footer << " ";
-    if (focused_button == 4) {
-        footer << "[q:Quit]";
-    } else {
-        footer << "q:Quit";
-    }
-    footer << " ?:Help";
-
-    std::string footer_str = footer.str();
+    footer.append(" | ");
+    footer.append(focused_button == 1 ? "[#:Tabular]" : "#:Tabular");
+    footer.append(' ');
+    footer.append(focused_button == 2 ? "[u:Undo]" : "u:Undo");
+    footer.append(' ');
+    footer.append(focused_button == 3 ? "[s:Save]" : "s:Save");
+    footer.append(' ');
+    footer.append(focused_button == 4 ? "[q:Quit]" : "q:Quit");
+    footer.append(" ?:Help");
 
     // Truncate if too long
-    if (static_cast<int>(footer_str.length()) > cols) {
-        const std::string help_segment = " ?:Help";
-        auto help_pos = footer_str.rfind(help_segment);
-        if (help_pos != std::string::npos) {
-            footer_str.erase(help_pos, help_segment.length());
+    size_t width = static_cast<size_t>(std::max(cols, 0));
+    if (footer.size() > width) {
+        constexpr std::string_view help_segment = " ?:Help";
+        size_t help_pos = footer.rfind(help_segment);
+        if (help_pos != TextBuffer::npos) {
+            footer.erase(help_pos, help_segment.size());
         }
-        footer_str = footer_str.substr(0, cols);
+        footer.resize(std::min(footer.size(), width), ' ');
     }
 
-    auto ensure_visible = [&](int button_index, const std::string& label) {
-        if (focused_button == button_index && footer_str.find(label) == std::string::npos) {
-            if (static_cast<int>(footer_str.length()) < cols) {
-                footer_str.resize(cols, ' ');
+    auto ensure_visible = [&](int button_index, std::string_view label) {
+        if (focused_button == button_index && footer.find(label) == TextBuffer::npos) {
+            if (footer.size() < width) {
+                footer.resize(width, ' ');
             }
-            int start = std::max(0, cols - static_cast<int>(label.length()));
-            footer_str.replace(start, std::min<int>(static_cast<int>(label.length()), cols - start), label);
+            int start = std::max(0, cols - static_cast<int>(label.size()));
+            footer.overwrite(start, label.substr(0, std::min<int>(static_cast<int>(label.size()), cols - start)));
         }
     };
 
@@ -104,8 +105,8 @@ void FooterRenderer::render(Terminal& terminal, double cursor_x, double cursor_y
         terminal.write_char(footer_row, col, ' ');
     }
 
-    for (size_t i = 0; i < footer_str.length(); ++i) {
-        terminal.write_char(footer_row, static_cast<int>(i), footer_str[i]);
+    for (size_t i = 0; i < footer.size(); ++i) {
+        terminal.write_char(footer_row, static_cast<int>(i), footer[i]);
     }
 }
 
@@ -131,29 +132,18 @@ int FooterRenderer::calculate_precision(double range, int screen_size) const {
     return precision;
 }
 
-std::string FooterRenderer::format_coord(double value, int precision) const {
-    std::ostringstream oss;
-
+void FooterRenderer::append_coord(TextBuffer& out, double value, int precision) const {
     // Use scientific notation for very large or very small numbers
     if (std::abs(value) >= 10000.0 || (std::abs(value) < 0.0001 && value != 0.0)) {
         // For scientific notation, use precision-1 (since one digit before decimal)
-        oss << std::scientific << std::setprecision(std::max(0, precision - 1)) << value;
-    } else {
-        // Use fixed notation with calculated precision
-        oss << std::fixed << std::setprecision(precision) << value;
-        std::string result = oss.str();
-
-        // Remove trailing zeros after decimal point
-        if (result.find('.') != std::string::npos) {
-            result.erase(result.find_last_not_of('0') + 1, std::string::npos);
-            if (result.back() == '.') {
-                result.pop_back();
-            }
-        }
-        return result;
+        out.append_scientific(value, std::max(0, precision - 1));
+        return;
     }
 
-    return oss.str();
+    // Fixed notation with calculated precision, trailing zeros removed
+    size_t start = out.size();
+    out.append_fixed(value, precision);
+    out.trim_fraction_zeros(start);
 }
 
 }  // namespace datapainter
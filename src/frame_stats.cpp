@@ -0,0 +1,84 @@
+#include "frame_stats.h"
+
+namespace datapainter {
+
+bool FrameStats::enabled_ = false;
+
+const char* phase_name(Phase phase) {
+    switch (phase) {
+        case Phase::INPUT:     return "input";
+        case Phase::QUERY:     return "query";
+        case Phase::JOURNAL:   return "journal";
+        case Phase::OVERLAY:   return "overlay";
+        case Phase::BIN:       return "bin";
+        case Phase::HEADER:    return "header";
+        case Phase::EDIT_AREA: return "edit_area";
+        case Phase::AXES:      return "axes";
+        case Phase::FOOTER:    return "footer";
+        case Phase::TERMINAL:  return "terminal";
+        case Phase::COUNT:     break;
+    }
+    return "unknown";
+}
+
+FrameStats& FrameStats::instance() {
+    static FrameStats stats;
+    return stats;
+}
+
+FrameStats::FrameStats()
+    : phase_ms_{}, points_fetched_(0), cells_written_(0), journal_length_(0),
+      cache_hits_(0), cache_misses_(0), allocations_(0),
+      allocated_bytes_(0), current_(Phase::COUNT) {}
+
+void FrameStats::reset() {
+    phase_ms_.fill(0.0);
+    points_fetched_ = 0;
+    cells_written_ = 0;
+    journal_length_ = 0;
+    cache_hits_ = 0;
+    cache_misses_ = 0;
+    allocations_ = 0;
+    allocated_bytes_ = 0;
+    // A running timer keeps running, but only its time from now on counts
+    phase_start_ = Clock::now();
+}
+
+double FrameStats::total_ms() const {
+    double total = 0.0;
+    for (double ms : phase_ms_) {
+        total += ms;
+    }
+    return total;
+}
+
+double FrameStats::cache_hit_rate() const {
+    long lookups = cache_hits_ + cache_misses_;
+    if (lookups == 0) {
+        return -1.0;
+    }
+    return static_cast<double>(cache_hits_) / static_cast<double>(lookups);
+}
+
+void FrameStats::credit(Phase phase, Clock::time_point now) {
+    if (phase != Phase::COUNT) {
+        phase_ms_[static_cast<size_t>(phase)] +=
+            std::chrono::duration<double, std::milli>(now - phase_start_).count();
+    }
+    phase_start_ = now;
+}
+
+Phase FrameStats::enter(Phase phase, Clock::time_point now) {
+    // Pause the enclosing phase so nested time is not counted twice
+    credit(current_, now);
+    Phase previous = current_;
+    current_ = phase;
+    return previous;
+}
+
+void FrameStats::leave(Phase phase, Phase previous, Clock::time_point now) {
+    credit(phase, now);
+    current_ = previous;
+}
+
+}  // namespace datapainter
@@ -1,7 +1,8 @@
 #include "header_renderer.h"
-#include <sstream>
-#include <iomanip>
+#include "frame_stats.h"
+#include "tracer.h"
 #include <algorithm>
+#include <cmath>
 
 namespace datapainter {
 
@@ -12,86 +13,92 @@ void HeaderRenderer::render(Terminal& terminal, const std::string& db_path,
                            double x_min, double x_max, double y_min, double y_max,
                            double vp_x_min, double vp_x_max, double vp_y_min, double vp_y_max,
                            int focused_field, int unsaved_changes_count) {
+    TraceSpan span("HeaderRenderer::render");
+    PhaseTimer timer(Phase::HEADER);
     int cols = terminal.cols();
 
     // Extract filename from database path
-    std::string db_filename = extract_filename(db_path);
+    std::string_view db_filename = extract_filename(db_path);
 
     // Row 0: Database and table name, with unsaved changes indicator
-    std::ostringstream row0_left;
+    TextBuffer& row0_left = row0_left_;
+    row0_left.clear();
     if (focused_field == 0) {
-        row0_left << "[" << db_filename << "]";
+        row0_left.append('[').append(db_filename).append(']');
     } else {
-        row0_left << db_filename;
+        row0_left.append(db_filename);
     }
-    row0_left << " | ";
+    row0_left.append(" | ");
     if (focused_field == 1) {
-        row0_left << "[" << table_name << "]";
+        row0_left.append('[').append(table_name).append(']');
     } else {
-        row0_left << table_name;
+        row0_left.append(table_name);
     }
 
-    std::string row0_left_str = row0_left.str();
-
     // Add unsaved changes indicator on the right side if there are unsaved changes
-    std::string row0_right_str;
+    TextBuffer& row0_right = row0_right_;
+    row0_right.clear();
     if (unsaved_changes_count > 0) {
-        std::ostringstream row0_right;
-        row0_right << "[Unsaved: " << unsaved_changes_count << "]";
-        row0_right_str = row0_right.str();
+        row0_right.append("[Unsaved: ").append_int(unsaved_changes_count).append(']');
     }
 
     // Write left side
-    int left_len = std::min(static_cast<int>(row0_left_str.length()),
-                            cols - static_cast<int>(row0_right_str.length()) - 1);
+    int left_len = std::min(static_cast<int>(row0_left.size()),
+                            cols - static_cast<int>(row0_right.size()) - 1);
     for (int i = 0; i < left_len; ++i) {
-        terminal.write_char(0, i, row0_left_str[i]);
+        terminal.write_char(0, i, row0_left[i]);
     }
 
     // Write right side (right-aligned) if there are unsaved changes
-    if (!row0_right_str.empty()) {
-        int right_start = cols - static_cast<int>(row0_right_str.length());
+    if (!row0_right.empty()) {
+        int right_start = cols - static_cast<int>(row0_right.size());
         if (right_start > left_len) {
-            for (size_t i = 0; i < row0_right_str.length(); ++i) {
-                terminal.write_char(0, right_start + static_cast<int>(i), row0_right_str[i]);
+            for (size_t i = 0; i < row0_right.size(); ++i) {
+                terminal.write_char(0, right_start + static_cast<int>(i), row0_right[i]);
             }
         }
     }
 
     // Row 1: Target column and meanings
-    std::ostringstream row1;
+    TextBuffer& row1 = row1_;
+    row1.clear();
     if (focused_field == 2) {
-        row1 << "[" << target_col << "]";
+        row1.append('[').append(target_col).append(']');
     } else {
-        row1 << target_col;
+        row1.append(target_col);
     }
-    row1 << ": ";
+    row1.append(": ");
     if (focused_field == 3) {
-        row1 << "x=[" << x_meaning << "]";
+        row1.append("x=[").append(x_meaning).append(']');
     } else {
-        row1 << "x=" << x_meaning;
+        row1.append("x=").append(x_meaning);
     }
-    row1 << " ";
+    row1.append(' ');
     if (focused_field == 4) {
-        row1 << "o=[" << o_meaning << "]";
+        row1.append("o=[").append(o_meaning).append(']');
     } else {
-        row1 << "o=" << o_meaning;
+        row1.append("o=").append(o_meaning);
     }
 
-    std::string row1_str = row1.str();
-    if (static_cast<int>(row1_str.length()) > cols) {
-        row1_str = row1_str.substr(0, cols);
-    }
-    for (size_t i = 0; i < row1_str.length(); ++i) {
-        terminal.write_char(1, static_cast<int>(i), row1_str[i]);
+    size_t row1_len = std::min(row1.size(), static_cast<size_t>(std::max(cols, 0)));
+    for (size_t i = 0; i < row1_len; ++i) {
+        terminal.write_char(1, static_cast<int>(i), row1[i]);
     }
 
     // Row 2: Counts on left, viewport range and zoom on right
-    std::ostringstream row2_left;
-    row2_left << "Total: " << total_count;
-    row2_left << " (x: " << x_count << ", o: " << o_count << ")";
-    row2_left << " Valid X: [" << format_value(x_min) << ", " << format_value(x_max) << "]";
-    row2_left << " Y: [" << format_value(y_min) << ", " << format_value(y_max) << "]";
+    TextBuffer& left_str = row2_left_;
+    left_str.clear();
+    left_str.append("Total: ").append_int(total_count);
+    left_str.append(" (x: ").append_int(x_count).append(", o: ").append_int(o_count).append(')');
+    left_str.append(" Valid X: [");
+    append_value(left_str, x_min);
+    left_str.append(", ");
+    append_value(left_str, x_max);
+    left_str.append("] Y: [");
+    append_value(left_str, y_min);
+    left_str.append(", ");
+    append_value(left_str, y_max);
+    left_str.append(']');
 
     // Calculate zoom percentage based on viewport size vs valid range size
     double valid_x_range = x_max - x_min;
@@ -104,61 +111,54 @@ void HeaderRenderer::render(Terminal& terminal, const std::string& db_path,
     double y_pct = (valid_y_range > 0) ? (vp_y_range / valid_y_range * 100.0) : 100.0;
     double zoom_pct = std::min(x_pct, y_pct);
 
-    std::ostringstream row2_right;
-    row2_right << "View X: [" << format_value(vp_x_min) << ", " << format_value(vp_x_max) << "]";
-    row2_right << " Y: [" << format_value(vp_y_min) << ", " << format_value(vp_y_max) << "]";
-    row2_right << " Zoom: " << std::fixed << std::setprecision(0) << zoom_pct << "%";
-
-    std::string left_str = row2_left.str();
-    std::string right_str = row2_right.str();
+    TextBuffer& right_str = row2_right_;
+    right_str.clear();
+    right_str.append("View X: [");
+    append_value(right_str, vp_x_min);
+    right_str.append(", ");
+    append_value(right_str, vp_x_max);
+    right_str.append("] Y: [");
+    append_value(right_str, vp_y_min);
+    right_str.append(", ");
+    append_value(right_str, vp_y_max);
+    right_str.append("] Zoom: ").append_fixed(zoom_pct, 0).append('%');
 
     // Write left side
-    int row2_left_len = std::min(static_cast<int>(left_str.length()), cols - static_cast<int>(right_str.length()) - 2);
+    int row2_left_len = std::min(static_cast<int>(left_str.size()), cols - static_cast<int>(right_str.size()) - 2);
     for (int i = 0; i < row2_left_len; ++i) {
         terminal.write_char(2, i, left_str[i]);
     }
 
     // Write right side (right-aligned)
-    int right_start = cols - static_cast<int>(right_str.length());
+    int right_start = cols - static_cast<int>(right_str.size());
     if (right_start > row2_left_len) {
-        for (size_t i = 0; i < right_str.length(); ++i) {
+        for (size_t i = 0; i < right_str.size(); ++i) {
             terminal.write_char(2, right_start + static_cast<int>(i), right_str[i]);
         }
     }
 }
 
-std::string HeaderRenderer::extract_filename(const std::string& path) const {
+std::string_view HeaderRenderer::extract_filename(const std::string& path) const {
     // Find the last path separator
-    size_t pos = path.find_last_of("/\\");
-    if (pos != std::string::npos) {
-        return path.substr(pos + 1);
+    std::string_view view(path);
+    size_t pos = view.find_last_of("/\\");
+    if (pos != std::string_view::npos) {
+        return view.substr(pos + 1);
     }
-    return path;
+    return view;
 }
 
-std::string HeaderRenderer::format_value(double value) const {
-    std::ostringstream oss;
-
+void HeaderRenderer::append_value(TextBuffer& out, double value) const {
     // Use scientific notation for very large or very small numbers
     if (std::abs(value) >= 10000.0 || (std::abs(value) < 0.001 && value != 0.0)) {
-        oss << std::scientific << std::setprecision(2) << value;
-    } else {
-        // Use fixed notation with appropriate precision
-        // Remove trailing zeros
-        oss << std::fixed << std::setprecision(1) << value;
-        std::string result = oss.str();
-
-        // Remove trailing zeros after decimal point
-        if (result.find('.') != std::string::npos) {
-            result.erase(result.find_last_not_of('0') + 1, std::string::npos);
-            if (result.back() == '.') {
-                result.pop_back();
-            }
-        }
-        return result;
+        out.append_scientific(value, 2);
+        return;
     }
 
-    return oss.str();
+    // Fixed notation with one decimal, trailing zeros removed
+    size_t start = out.size();
+    out.append_fixed(value, 1);
+    out.trim_fraction_zeros(start);
 }
 
 }  // namespace datapainter
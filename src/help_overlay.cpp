@@ -74,6 +74,15 @@ std::vector<std::string> HelpOverlay::get_help_lines(double zoom_percent, double
         "|    -         - Zoom out                              |",
         "|    =         - Full viewport (fit all data)          |",
         "|    #         - Toggle tabular view                   |",
+        "|    m         - Cycle points/density/braille modes    |",
+        "|    Shift+M   - Toggle overview minimap               |",
+        "|    n         - Toggle k-NN decision regions          |",
+        "|    l         - Toggle logistic regression line       |",
+        "|    c         - Toggle class density contours         |",
+        "|    [ / ]     - Narrow / widen density contours       |",
+        "|    Shift+C   - Run/hide k-means cluster suggestions  |",
+        "|    Shift+A   - Relabel points by k-means clusters    |",
+        "|    i         - Toggle class statistics panel         |",
         "|                                                      |",
         "|  UNDO/SAVE/QUIT:                                     |",
         "|    u         - Undo last action                      |",
@@ -83,6 +92,7 @@ std::vector<std::string> HelpOverlay::get_help_lines(double zoom_percent, double
         "|  OTHER:                                              |",
         "|    r         - Generate random points                |",
         "|    ?         - Show this help                        |",
+        "|    p         - Toggle performance HUD                |",
         "|    k         - Dump full screen to stdout            |",
         "|    Shift+K   - Dump edit area to stdout              |",
         "|                                                      |",
@@ -107,6 +107,12 @@ std::optional<int> FileInputSource::parse_keystroke(const std::string& line) {
             return '\n';
         } else if (key_name == "esc") {
             return 27;  // ESC
+        } else if (key_name == "dump") {
+            return Terminal::KEY_DUMP_SCREEN;  // Checkpoint: dump the full screen
+        } else if (key_name == "dump-edit-area") {
+            return Terminal::KEY_DUMP_EDIT_AREA;  // Checkpoint: dump the edit area
+        } else if (key_name == "render") {
+            return Terminal::KEY_RENDER;  // Checkpoint: draw a frame under --fast-replay
         } else {
             return std::nullopt;  // Unknown special key
         }
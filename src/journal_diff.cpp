@@ -0,0 +1,80 @@
+#include "journal_diff.h"
+#include "class_palette.h"
+
+namespace datapainter {
+
+void JournalDiff::sync(DataTable& table, const std::vector<ChangeRecord>& changes, const Classify& classify,
+                       const Apply& apply, const std::function<void(const Effect&)>& saved) {
+    ++generation_;
+    size_t seen = 0;
+    for (const auto& change : changes) {
+        bool insert = change.action == "insert";
+        bool remove = change.action == "delete";
+        if (!insert && !remove && change.action != "update") {
+            continue;  // Metadata changes move no points
+        }
+        int removed = ClassPalette::NO_CLASS;
+        int added = ClassPalette::NO_CLASS;
+        if (change.is_active) {
+            if (!insert && change.old_target.has_value()) {
+                removed = classify(*change.old_target);
+            }
+            if (!remove && change.new_target.has_value()) {
+                added = classify(*change.new_target);
+            }
+            if (removed == added) {
+                removed = added = ClassPalette::NO_CLASS;  // Converted within one class
+            }
+        }
+
+        auto it = applied_.find(change.id);
+        if (it == applied_.end()) {
+            Effect none{0.0, 0.0, ClassPalette::NO_CLASS, ClassPalette::NO_CLASS};
+            it = applied_.emplace(change.id, Applied{none, false, 0}).first;
+        }
+        Applied& applied = it->second;
+        applied.seen = generation_;
+        ++seen;
+        if (removed == applied.effect.removed && added == applied.effect.added) {
+            continue;
+        }
+        if (!applied.located) {
+            if (change.x.has_value() && change.y.has_value()) {
+                applied.effect.x = *change.x;
+                applied.effect.y = *change.y;
+            } else if (auto point = table.get_point(change.data_id.value_or(-1))) {
+                applied.effect.x = point->x;
+                applied.effect.y = point->y;
+            } else {
+                continue;  // No point to count
+            }
+            applied.located = true;
+        }
+        apply(applied.effect, -1);
+        applied.effect.removed = removed;
+        applied.effect.added = added;
+        apply(applied.effect, +1);
+    }
+
+    // Changes gone from the journal were saved
+    if (seen < applied_.size()) {
+        for (auto it = applied_.begin(); it != applied_.end();) {
+            if (it->second.seen == generation_) {
+                ++it;
+                continue;
+            }
+            if (saved) {
+                saved(it->second.effect);
+            }
+            it = applied_.erase(it);
+        }
+    }
+}
+
+void JournalDiff::for_each(const std::function<void(const Effect&)>& fn) const {
+    for (const auto& entry : applied_) {
+        fn(entry.second.effect);
+    }
+}
+
+}  // namespace datapainter
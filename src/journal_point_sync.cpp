@@ -0,0 +1,176 @@
+#include "journal_point_sync.h"
+#include "tracer.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace datapainter {
+
+bool JournalPointSync::sync(DataTable& table, const std::vector<ChangeRecord>& changes,
+                            ClassPalette& palette, Sink& sink) {
+    edited_ = false;
+    if (!loaded_) {
+        load(table, palette, sink);
+    }
+    if (!apply(changes, palette, sink)) {
+        // A point saved since the load is being edited: start over from the
+        // table, which now holds it
+        load(table, palette, sink);
+        apply(changes, palette, sink);
+    }
+    return edited_;
+}
+
+void JournalPointSync::load(DataTable& table, ClassPalette& palette, Sink& sink) {
+    TraceSpan span("JournalPointSync::load");
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<uint8_t> labels;
+    saved_.clear();
+    table.for_each_point([&](const DataPoint& point) {
+        int label = palette.classify(point.target);
+        Saved saved{0, point.x, point.y, label, false};
+        if (label != ClassPalette::NO_CLASS) {
+            saved.slot = static_cast<uint32_t>(xs.size());
+            saved.live = true;
+            xs.push_back(point.x);
+            ys.push_back(point.y);
+            labels.push_back(static_cast<uint8_t>(label));
+        }
+        saved_[point.id] = saved;
+    });
+    sink.reset(xs, ys, labels);
+    // The table holds no journal changes, so every one applies anew
+    applied_.clear();
+    unidentified_ = 0;
+    loaded_ = true;
+    edited_ = true;
+}
+
+bool JournalPointSync::apply(const std::vector<ChangeRecord>& changes, ClassPalette& palette,
+                             Sink& sink) {
+    ++generation_;
+    size_t seen = 0;
+    std::unordered_set<int> touched;  // Saved points whose deletes/updates changed
+    for (const auto& change : changes) {
+        bool is_insert = change.action == "insert";
+        bool is_edit = change.action == "delete" || change.action == "update";
+        if (!is_insert && !is_edit) {
+            continue;  // Metadata never moves points
+        }
+        if (is_edit && (!change.data_id.has_value() || saved_.count(*change.data_id) == 0)) {
+            return false;
+        }
+
+        const auto& target = is_insert || change.action == "update" ? change.new_target : change.old_target;
+        int label = change.is_active && target.has_value() ? palette.classify(*target) : ClassPalette::NO_CLASS;
+        bool active = change.is_active && label != ClassPalette::NO_CLASS &&
+                      (!is_insert || (change.x.has_value() && change.y.has_value()));
+
+        auto it = applied_.find(change.id);
+        if (it == applied_.end()) {
+            it = applied_.emplace(change.id, Applied{false, is_insert, change.action == "delete", false, 0, 0, ClassPalette::NO_CLASS, 0}).first;
+        }
+        Applied& applied = it->second;
+        applied.seen = generation_;
+        applied.saves = change.is_active;
+        applied.data_id = is_edit ? *change.data_id : 0;
+        ++seen;
+        if (active == applied.active && (!active || label == applied.label)) {
+            continue;
+        }
+
+        if (is_edit) {
+            touched.insert(*change.data_id);
+        } else if (active && !applied.active) {
+            applied.slot = sink.add(*change.x, *change.y, label);
+        } else if (active) {
+            sink.relabel(applied.slot, label);  // Converted in place
+        } else {
+            sink.remove(applied.slot);
+        }
+        applied.active = active;
+        applied.label = label;
+        edited_ = true;
+    }
+
+    for (int data_id : touched) {
+        settle(data_id, saved_[data_id], changes, palette, sink);
+    }
+
+    // Changes gone from the journal were saved: the sink already holds
+    // them, so just stop tracking them. Saved updates and deletes are now
+    // the point's table state, which settle() starts from; they are folded
+    // in by change id, the order the save wrote them.
+    if (seen < applied_.size()) {
+        std::vector<std::pair<int, Applied>> edits;
+        for (auto it = applied_.begin(); it != applied_.end();) {
+            if (it->second.seen == generation_) {
+                ++it;
+                continue;
+            }
+            if (it->second.inserted && it->second.active) {
+                ++unidentified_;  // Now a table row, under an id not yet known
+            } else if (!it->second.inserted && it->second.saves) {
+                edits.emplace_back(it->first, it->second);
+            }
+            it = applied_.erase(it);
+        }
+        std::sort(edits.begin(), edits.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (const auto& [change_id, edit] : edits) {
+            auto saved = saved_.find(edit.data_id);
+            if (saved == saved_.end()) {
+                continue;
+            }
+            if (edit.deleted) {
+                // The row is gone and settle() already took it out of the sink
+                saved_.erase(saved);
+            } else {
+                saved->second.label = edit.label;
+            }
+        }
+    }
+    return true;
+}
+
+void JournalPointSync::for_each_point(const std::function<void(uint32_t slot, int id)>& fn) const {
+    for (const auto& [data_id, saved] : saved_) {
+        if (saved.live) {
+            fn(saved.slot, data_id);
+        }
+    }
+    for (const auto& [change_id, applied] : applied_) {
+        if (applied.active && applied.inserted) {
+            fn(applied.slot, -change_id);
+        }
+    }
+}
+
+void JournalPointSync::settle(int data_id, Saved& saved, const std::vector<ChangeRecord>& changes,
+                              ClassPalette& palette, Sink& sink) {
+    // Later updates win, as when the journal is saved in order
+    bool deleted = false;
+    int label = saved.label;
+    for (const auto& change : changes) {
+        if (!change.is_active || change.data_id != data_id) {
+            continue;
+        }
+        if (change.action == "delete") {
+            deleted = true;
+        } else if (change.action == "update" && change.new_target.has_value()) {
+            label = palette.classify(*change.new_target);
+        }
+    }
+
+    bool live = !deleted && label != ClassPalette::NO_CLASS;
+    if (live && !saved.live) {
+        saved.slot = sink.add(saved.x, saved.y, label);
+    } else if (live) {
+        sink.relabel(saved.slot, label);
+    } else if (saved.live) {
+        sink.remove(saved.slot);
+    }
+    saved.live = live;
+}
+
+}  // namespace datapainter
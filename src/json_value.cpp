@@ -0,0 +1,493 @@
+#include "json_value.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace datapainter {
+
+namespace {
+
+// Recursive-descent parser over a string buffer
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text), pos_(0) {}
+
+    std::optional<JsonValue> parse_document() {
+        auto value = parse_value(0);
+        if (!value.has_value()) {
+            return std::nullopt;
+        }
+        skip_whitespace();
+        if (pos_ != text_.size()) {
+            fail("Unexpected trailing characters");
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    const std::string& error() const { return error_; }
+
+private:
+    // Guard against stack exhaustion on hostile input
+    static constexpr int MAX_DEPTH = 64;
+
+    const std::string& text_;
+    size_t pos_;
+    std::string error_;
+
+    void fail(const std::string& message) {
+        if (error_.empty()) {
+            error_ = message + " at offset " + std::to_string(pos_);
+        }
+    }
+
+    void skip_whitespace() {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\t' ||
+                text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+
+    bool consume_literal(const char* literal) {
+        size_t len = std::char_traits<char>::length(literal);
+        if (text_.compare(pos_, len, literal) == 0) {
+            pos_ += len;
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<JsonValue> parse_value(int depth) {
+        if (depth > MAX_DEPTH) {
+            fail("Nesting too deep");
+            return std::nullopt;
+        }
+
+        skip_whitespace();
+        if (pos_ >= text_.size()) {
+            fail("Unexpected end of input");
+            return std::nullopt;
+        }
+
+        char ch = text_[pos_];
+        if (ch == '{') {
+            return parse_object(depth);
+        } else if (ch == '[') {
+            return parse_array(depth);
+        } else if (ch == '"') {
+            auto str = parse_string();
+            if (!str.has_value()) {
+                return std::nullopt;
+            }
+            return JsonValue(std::move(*str));
+        } else if (consume_literal("true")) {
+            return JsonValue(true);
+        } else if (consume_literal("false")) {
+            return JsonValue(false);
+        } else if (consume_literal("null")) {
+            return JsonValue();
+        } else if (ch == '-' || (ch >= '0' && ch <= '9')) {
+            return parse_number();
+        }
+
+        fail("Unexpected character");
+        return std::nullopt;
+    }
+
+    std::optional<JsonValue> parse_object(int depth) {
+        ++pos_;  // '{'
+        JsonValue obj = JsonValue::object();
+
+        skip_whitespace();
+        if (pos_ < text_.size() && text_[pos_] == '}') {
+            ++pos_;
+            return obj;
+        }
+
+        while (true) {
+            skip_whitespace();
+            if (pos_ >= text_.size() || text_[pos_] != '"') {
+                fail("Expected object key");
+                return std::nullopt;
+            }
+            auto key = parse_string();
+            if (!key.has_value()) {
+                return std::nullopt;
+            }
+
+            skip_whitespace();
+            if (pos_ >= text_.size() || text_[pos_] != ':') {
+                fail("Expected ':'");
+                return std::nullopt;
+            }
+            ++pos_;
+
+            auto value = parse_value(depth + 1);
+            if (!value.has_value()) {
+                return std::nullopt;
+            }
+            obj.set(*key, std::move(*value));
+
+            skip_whitespace();
+            if (pos_ < text_.size() && text_[pos_] == ',') {
+                ++pos_;
+                continue;
+            }
+            if (pos_ < text_.size() && text_[pos_] == '}') {
+                ++pos_;
+                return obj;
+            }
+            fail("Expected ',' or '}'");
+            return std::nullopt;
+        }
+    }
+
+    std::optional<JsonValue> parse_array(int depth) {
+        ++pos_;  // '['
+        JsonValue arr = JsonValue::array();
+
+        skip_whitespace();
+        if (pos_ < text_.size() && text_[pos_] == ']') {
+            ++pos_;
+            return arr;
+        }
+
+        while (true) {
+            auto value = parse_value(depth + 1);
+            if (!value.has_value()) {
+                return std::nullopt;
+            }
+            arr.push_back(std::move(*value));
+
+            skip_whitespace();
+            if (pos_ < text_.size() && text_[pos_] == ',') {
+                ++pos_;
+                continue;
+            }
+            if (pos_ < text_.size() && text_[pos_] == ']') {
+                ++pos_;
+                return arr;
+            }
+            fail("Expected ',' or ']'");
+            return std::nullopt;
+        }
+    }
+
+    std::optional<unsigned> parse_hex4() {
+        if (pos_ + 4 > text_.size()) {
+            fail("Truncated unicode escape");
+            return std::nullopt;
+        }
+        unsigned code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = text_[pos_++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= static_cast<unsigned>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                code |= static_cast<unsigned>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                code |= static_cast<unsigned>(c - 'A' + 10);
+            } else {
+                fail("Invalid unicode escape");
+                return std::nullopt;
+            }
+        }
+        return code;
+    }
+
+    static void append_utf8(std::string& out, unsigned code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    std::optional<std::string> parse_string() {
+        ++pos_;  // opening quote
+        std::string out;
+
+        while (pos_ < text_.size()) {
+            char ch = text_[pos_++];
+            if (ch == '"') {
+                return out;
+            }
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                fail("Control character in string");
+                return std::nullopt;
+            }
+            if (ch != '\\') {
+                out += ch;
+                continue;
+            }
+
+            if (pos_ >= text_.size()) {
+                break;
+            }
+            char esc = text_[pos_++];
+            switch (esc) {
+                case '"':  out += '"';  break;
+                case '\\': out += '\\'; break;
+                case '/':  out += '/';  break;
+                case 'b':  out += '\b'; break;
+                case 'f':  out += '\f'; break;
+                case 'n':  out += '\n'; break;
+                case 'r':  out += '\r'; break;
+                case 't':  out += '\t'; break;
+                case 'u': {
+                    auto code = parse_hex4();
+                    if (!code.has_value()) {
+                        return std::nullopt;
+                    }
+                    unsigned cp = *code;
+                    // Combine UTF-16 surrogate pairs
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        if (!consume_literal("\\u")) {
+                            fail("Unpaired surrogate");
+                            return std::nullopt;
+                        }
+                        auto low = parse_hex4();
+                        if (!low.has_value() || *low < 0xDC00 || *low > 0xDFFF) {
+                            fail("Invalid surrogate pair");
+                            return std::nullopt;
+                        }
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (*low - 0xDC00);
+                    }
+                    append_utf8(out, cp);
+                    break;
+                }
+                default:
+                    fail("Invalid escape sequence");
+                    return std::nullopt;
+            }
+        }
+
+        fail("Unterminated string");
+        return std::nullopt;
+    }
+
+    std::optional<JsonValue> parse_number() {
+        size_t start = pos_;
+        if (text_[pos_] == '-') {
+            ++pos_;
+        }
+        while (pos_ < text_.size() &&
+               ((text_[pos_] >= '0' && text_[pos_] <= '9') || text_[pos_] == '.' ||
+                text_[pos_] == 'e' || text_[pos_] == 'E' ||
+                text_[pos_] == '+' || text_[pos_] == '-')) {
+            ++pos_;
+        }
+
+        std::string number_text = text_.substr(start, pos_ - start);
+        char* end = nullptr;
+        double value = std::strtod(number_text.c_str(), &end);
+        if (end == nullptr || *end != '\0' || number_text == "-") {
+            pos_ = start;
+            fail("Invalid number");
+            return std::nullopt;
+        }
+        return JsonValue(value);
+    }
+};
+
+void append_escaped(std::string& out, const std::string& str) {
+    out += '"';
+    for (char ch : str) {
+        switch (ch) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            case '\b': out += "\\b";  break;
+            case '\f': out += "\\f";  break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(ch));
+                    out += buf;
+                } else {
+                    out += ch;
+                }
+        }
+    }
+    out += '"';
+}
+
+}  // namespace
+
+JsonValue::JsonValue() : type_(Type::NUL), bool_(false), number_(0.0) {}
+
+JsonValue::JsonValue(bool value) : type_(Type::BOOLEAN), bool_(value), number_(0.0) {}
+
+JsonValue::JsonValue(int value)
+    : type_(Type::NUMBER), bool_(false), number_(static_cast<double>(value)) {}
+
+JsonValue::JsonValue(double value) : type_(Type::NUMBER), bool_(false), number_(value) {}
+
+JsonValue::JsonValue(const char* value)
+    : type_(Type::STRING), bool_(false), number_(0.0), string_(value) {}
+
+JsonValue::JsonValue(std::string value)
+    : type_(Type::STRING), bool_(false), number_(0.0), string_(std::move(value)) {}
+
+JsonValue JsonValue::array() {
+    JsonValue value;
+    value.type_ = Type::ARRAY;
+    return value;
+}
+
+JsonValue JsonValue::object() {
+    JsonValue value;
+    value.type_ = Type::OBJECT;
+    return value;
+}
+
+void JsonValue::push_back(JsonValue value) {
+    array_.push_back(std::move(value));
+}
+
+size_t JsonValue::size() const {
+    if (type_ == Type::ARRAY) {
+        return array_.size();
+    }
+    if (type_ == Type::OBJECT) {
+        return object_.size();
+    }
+    return 0;
+}
+
+void JsonValue::set(const std::string& key, JsonValue value) {
+    for (auto& entry : object_) {
+        if (entry.first == key) {
+            entry.second = std::move(value);
+            return;
+        }
+    }
+    object_.emplace_back(key, std::move(value));
+}
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    for (const auto& entry : object_) {
+        if (entry.first == key) {
+            return &entry.second;
+        }
+    }
+    return nullptr;
+}
+
+std::optional<double> JsonValue::get_number(const std::string& key) const {
+    const JsonValue* value = find(key);
+    if (value == nullptr || !value->is_number()) {
+        return std::nullopt;
+    }
+    return value->as_number();
+}
+
+std::optional<int> JsonValue::get_int(const std::string& key) const {
+    auto number = get_number(key);
+    if (!number.has_value() || std::floor(*number) != *number ||
+        *number < -2147483648.0 || *number > 2147483647.0) {
+        return std::nullopt;
+    }
+    return static_cast<int>(*number);
+}
+
+std::optional<std::string> JsonValue::get_string(const std::string& key) const {
+    const JsonValue* value = find(key);
+    if (value == nullptr || !value->is_string()) {
+        return std::nullopt;
+    }
+    return value->as_string();
+}
+
+std::optional<bool> JsonValue::get_bool(const std::string& key) const {
+    const JsonValue* value = find(key);
+    if (value == nullptr || !value->is_bool()) {
+        return std::nullopt;
+    }
+    return value->as_bool();
+}
+
+std::string JsonValue::dump() const {
+    std::string out;
+    dump_to(out);
+    return out;
+}
+
+void JsonValue::dump_to(std::string& out) const {
+    switch (type_) {
+        case Type::NUL:
+            out += "null";
+            break;
+        case Type::BOOLEAN:
+            out += bool_ ? "true" : "false";
+            break;
+        case Type::NUMBER: {
+            if (!std::isfinite(number_)) {
+                out += "null";  // JSON has no representation for inf/nan
+                break;
+            }
+            char buf[32];
+            if (std::floor(number_) == number_ && std::abs(number_) < 1e15) {
+                std::snprintf(buf, sizeof(buf), "%.0f", number_);
+            } else {
+                // Prefer the short form when it round-trips exactly
+                std::snprintf(buf, sizeof(buf), "%.15g", number_);
+                if (std::strtod(buf, nullptr) != number_) {
+                    std::snprintf(buf, sizeof(buf), "%.17g", number_);
+                }
+            }
+            out += buf;
+            break;
+        }
+        case Type::STRING:
+            append_escaped(out, string_);
+            break;
+        case Type::ARRAY:
+            out += '[';
+            for (size_t i = 0; i < array_.size(); ++i) {
+                if (i > 0) {
+                    out += ',';
+                }
+                array_[i].dump_to(out);
+            }
+            out += ']';
+            break;
+        case Type::OBJECT:
+            out += '{';
+            for (size_t i = 0; i < object_.size(); ++i) {
+                if (i > 0) {
+                    out += ',';
+                }
+                append_escaped(out, object_[i].first);
+                out += ':';
+                object_[i].second.dump_to(out);
+            }
+            out += '}';
+            break;
+    }
+}
+
+std::optional<JsonValue> JsonValue::parse(const std::string& text, std::string* error) {
+    JsonParser parser(text);
+    auto result = parser.parse_document();
+    if (!result.has_value() && error != nullptr) {
+        *error = parser.error();
+    }
+    return result;
+}
+
+}  // namespace datapainter
@@ -0,0 +1,189 @@
+#include "kd_tree.h"
+#include <algorithm>
+
+namespace datapainter {
+
+void KdTree::build(const std::vector<double>& xs, const std::vector<double>& ys,
+                   const std::vector<uint8_t>& labels) {
+    points_.clear();
+    nodes_.clear();
+    size_t count = std::min({xs.size(), ys.size(), labels.size()});
+    points_.reserve(count);
+    std::vector<uint32_t> slots(count);
+    for (size_t i = 0; i < count; ++i) {
+        points_.push_back(Point{xs[i], ys[i], labels[i], true, 0});
+        slots[i] = static_cast<uint32_t>(i);
+    }
+    live_ = count;
+    nodes_.reserve(2 * (count / LEAF_SIZE + 1));
+    build_node(slots, 0, count);
+}
+
+uint32_t KdTree::build_node(std::vector<uint32_t>& slots, size_t begin, size_t end) {
+    if (end - begin <= static_cast<size_t>(LEAF_SIZE)) {
+        uint32_t leaf = new_leaf();
+        nodes_[leaf].slots.assign(slots.begin() + static_cast<std::ptrdiff_t>(begin),
+                                  slots.begin() + static_cast<std::ptrdiff_t>(end));
+        for (uint32_t slot : nodes_[leaf].slots) {
+            points_[slot].leaf = leaf;
+        }
+        return leaf;
+    }
+
+    // Split the wider side of the points' bounding box at the median
+    double x_lo = points_[slots[begin]].x;
+    double x_hi = x_lo;
+    double y_lo = points_[slots[begin]].y;
+    double y_hi = y_lo;
+    for (size_t i = begin + 1; i < end; ++i) {
+        const Point& point = points_[slots[i]];
+        x_lo = std::min(x_lo, point.x);
+        x_hi = std::max(x_hi, point.x);
+        y_lo = std::min(y_lo, point.y);
+        y_hi = std::max(y_hi, point.y);
+    }
+    int axis = (x_hi - x_lo) >= (y_hi - y_lo) ? 0 : 1;
+    auto coord = [this, axis](uint32_t slot) { return axis == 0 ? points_[slot].x : points_[slot].y; };
+    size_t mid = begin + (end - begin) / 2;
+    std::nth_element(slots.begin() + static_cast<std::ptrdiff_t>(begin),
+                     slots.begin() + static_cast<std::ptrdiff_t>(mid),
+                     slots.begin() + static_cast<std::ptrdiff_t>(end),
+                     [&](uint32_t a, uint32_t b) { return coord(a) < coord(b); });
+
+    uint32_t node = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+    nodes_[node].axis = axis;
+    nodes_[node].split = coord(slots[mid]);
+    uint32_t left = build_node(slots, begin, mid);
+    uint32_t right = build_node(slots, mid, end);
+    nodes_[node].left = left;
+    nodes_[node].right = right;
+    return node;
+}
+
+uint32_t KdTree::new_leaf() {
+    nodes_.emplace_back();
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+uint32_t KdTree::insert(double x, double y, uint8_t label) {
+    if (nodes_.empty()) {
+        new_leaf();
+    }
+    uint32_t node = 0;
+    while (nodes_[node].axis >= 0) {
+        const Node& inner = nodes_[node];
+        double value = inner.axis == 0 ? x : y;
+        node = value < inner.split ? inner.left : inner.right;
+    }
+
+    uint32_t slot = static_cast<uint32_t>(points_.size());
+    points_.push_back(Point{x, y, label, true, node});
+    nodes_[node].slots.push_back(slot);
+    ++live_;
+    if (nodes_[node].slots.size() > static_cast<size_t>(LEAF_SIZE)) {
+        split_leaf(node);
+    }
+    return slot;
+}
+
+void KdTree::split_leaf(uint32_t node) {
+    std::vector<uint32_t> slots = std::move(nodes_[node].slots);
+    nodes_[node].slots.clear();
+
+    double x_lo = points_[slots[0]].x;
+    double x_hi = x_lo;
+    double y_lo = points_[slots[0]].y;
+    double y_hi = y_lo;
+    for (uint32_t slot : slots) {
+        x_lo = std::min(x_lo, points_[slot].x);
+        x_hi = std::max(x_hi, points_[slot].x);
+        y_lo = std::min(y_lo, points_[slot].y);
+        y_hi = std::max(y_hi, points_[slot].y);
+    }
+    if (x_hi == x_lo && y_hi == y_lo) {
+        // Points stacked on one spot cannot be separated; keep one leaf
+        nodes_[node].slots = std::move(slots);
+        return;
+    }
+
+    // Points left of the split must be <= it and right ones >= it, which
+    // the median partition guarantees; new points equal to it go right
+    int axis = (x_hi - x_lo) >= (y_hi - y_lo) ? 0 : 1;
+    auto coord = [this, axis](uint32_t slot) { return axis == 0 ? points_[slot].x : points_[slot].y; };
+    size_t mid = slots.size() / 2;
+    std::nth_element(slots.begin(), slots.begin() + static_cast<std::ptrdiff_t>(mid), slots.end(),
+                     [&](uint32_t a, uint32_t b) { return coord(a) < coord(b); });
+
+    uint32_t left = new_leaf();
+    uint32_t right = new_leaf();
+    nodes_[left].slots.assign(slots.begin(), slots.begin() + static_cast<std::ptrdiff_t>(mid));
+    nodes_[right].slots.assign(slots.begin() + static_cast<std::ptrdiff_t>(mid), slots.end());
+    for (uint32_t slot : nodes_[left].slots) {
+        points_[slot].leaf = left;
+    }
+    for (uint32_t slot : nodes_[right].slots) {
+        points_[slot].leaf = right;
+    }
+    nodes_[node].axis = axis;
+    nodes_[node].split = coord(slots[mid]);
+    nodes_[node].left = left;
+    nodes_[node].right = right;
+}
+
+bool KdTree::remove(uint32_t slot) {
+    if (slot >= points_.size() || !points_[slot].live) {
+        return false;
+    }
+    auto& slots = nodes_[points_[slot].leaf].slots;
+    auto it = std::find(slots.begin(), slots.end(), slot);
+    if (it != slots.end()) {
+        *it = slots.back();
+        slots.pop_back();
+    }
+    points_[slot].live = false;
+    --live_;
+    return true;
+}
+
+int KdTree::nearest(double x, double y, int k, Neighbour* out) const {
+    k = std::min(k, MAX_K);
+    if (k <= 0 || nodes_.empty()) {
+        return 0;
+    }
+    int count = 0;
+    search(0, x, y, k, out, count);
+    return count;
+}
+
+void KdTree::search(uint32_t node, double x, double y, int k, Neighbour* best, int& count) const {
+    const Node& current = nodes_[node];
+    if (current.axis < 0) {
+        for (uint32_t slot : current.slots) {
+            double dx = points_[slot].x - x;
+            double dy = points_[slot].y - y;
+            double d2 = dx * dx + dy * dy;
+            if (count == k && d2 >= best[k - 1].distance2) {
+                continue;
+            }
+            // Insertion into the sorted best list, dropping the farthest
+            int pos = count < k ? count++ : k - 1;
+            while (pos > 0 && best[pos - 1].distance2 > d2) {
+                best[pos] = best[pos - 1];
+                --pos;
+            }
+            best[pos] = Neighbour{slot, d2};
+        }
+        return;
+    }
+
+    double diff = (current.axis == 0 ? x : y) - current.split;
+    uint32_t near = diff < 0 ? current.left : current.right;
+    uint32_t far = diff < 0 ? current.right : current.left;
+    search(near, x, y, k, best, count);
+    if (count < k || diff * diff < best[count - 1].distance2) {
+        search(far, x, y, k, best, count);
+    }
+}
+
+}  // namespace datapainter
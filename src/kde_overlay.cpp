@@ -0,0 +1,474 @@
+#include "kde_overlay.h"
+#include "edit_area_renderer.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <limits>
+
+namespace datapainter {
+
+namespace {
+
+// Lines per parallel chunk of a blur pass
+constexpr size_t MIN_LINES_PER_CHUNK = 8;
+
+// Buckets of the density histogram that places the contour levels
+constexpr int LEVEL_BUCKETS = 4096;
+
+// Kernel widths in bins are kept within these
+constexpr double MIN_SIGMA_BINS = 0.5;
+constexpr double MAX_SIGMA_BINS = KdeOverlay::GRID / 4.0;
+
+// Limits of the '[' / ']' bandwidth multiplier
+constexpr double MIN_SCALE = 1.0 / 64.0;
+constexpr double MAX_SCALE = 64.0;
+
+// Normalised Gaussian weights for offsets -radius .. radius
+std::vector<double> gaussian_kernel(double sigma) {
+    int radius = std::max(1, static_cast<int>(std::ceil(KdeOverlay::KERNEL_SIGMAS * sigma)));
+    std::vector<double> kernel(static_cast<size_t>(2 * radius + 1));
+    double sum = 0.0;
+    for (int t = -radius; t <= radius; ++t) {
+        double w = std::exp(-0.5 * t * t / (sigma * sigma));
+        kernel[static_cast<size_t>(t + radius)] = w;
+        sum += w;
+    }
+    for (double& w : kernel) {
+        w /= sum;
+    }
+    return kernel;
+}
+
+// Iterative radix-2 FFT of one power-of-two size. The inverse is left
+// unscaled; callers fold the 1/size into their spectra.
+class Fft {
+public:
+    explicit Fft(size_t size) : size_(size), twiddles_(size / 2), reversed_(size) {
+        const double pi = std::acos(-1.0);
+        for (size_t k = 0; k < size / 2; ++k) {
+            twiddles_[k] = std::polar(1.0, -2.0 * pi * static_cast<double>(k) / static_cast<double>(size));
+        }
+        int bits = 0;
+        while ((size_t{1} << bits) < size) {
+            ++bits;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            size_t r = 0;
+            for (int b = 0; b < bits; ++b) {
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            }
+            reversed_[i] = static_cast<uint32_t>(r);
+        }
+    }
+
+    size_t size() const { return size_; }
+
+    void transform(std::complex<double>* data, bool inverse) const {
+        for (size_t i = 0; i < size_; ++i) {
+            if (i < reversed_[i]) {
+                std::swap(data[i], data[reversed_[i]]);
+            }
+        }
+        for (size_t len = 2; len <= size_; len <<= 1) {
+            size_t half = len / 2;
+            size_t step = size_ / len;
+            for (size_t start = 0; start < size_; start += len) {
+                for (size_t j = 0; j < half; ++j) {
+                    std::complex<double> w = twiddles_[j * step];
+                    if (inverse) {
+                        w = std::conj(w);
+                    }
+                    std::complex<double> u = data[start + j];
+                    std::complex<double> v = data[start + j + half] * w;
+                    data[start + j] = u + v;
+                    data[start + j + half] = u - v;
+                }
+            }
+        }
+    }
+
+private:
+    size_t size_;
+    std::vector<std::complex<double>> twiddles_;  // e^(-2 pi i k / size), k < size / 2
+    std::vector<uint32_t> reversed_;              // Bit-reversal permutation
+};
+
+// Convolve `lines` lines of `length` floats with a Gaussian, in place.
+// Element i of line l is at grid[l * line_stride + i * step].
+void blur_lines(float* grid, int lines, int length, size_t line_stride, size_t step, double sigma,
+                KdeOverlay::Method method, ThreadPool& pool) {
+    std::vector<double> kernel = gaussian_kernel(sigma);
+    int radius = static_cast<int>(kernel.size() / 2);
+    bool use_fft = method == KdeOverlay::Method::FFT ||
+                   (method == KdeOverlay::Method::AUTO && radius > KdeOverlay::MAX_DIRECT_RADIUS);
+
+    if (!use_fft) {
+        pool.parallel_for(static_cast<size_t>(lines), MIN_LINES_PER_CHUNK, [&](size_t begin, size_t end, int) {
+            std::vector<float> in(static_cast<size_t>(length));
+            for (size_t l = begin; l < end; ++l) {
+                float* line = grid + l * line_stride;
+                for (int i = 0; i < length; ++i) {
+                    in[static_cast<size_t>(i)] = line[static_cast<size_t>(i) * step];
+                }
+                for (int i = 0; i < length; ++i) {
+                    int lo = std::max(-radius, -i);
+                    int hi = std::min(radius, length - 1 - i);
+                    double sum = 0.0;
+                    for (int t = lo; t <= hi; ++t) {
+                        sum += kernel[static_cast<size_t>(t + radius)] * in[static_cast<size_t>(i + t)];
+                    }
+                    line[static_cast<size_t>(i) * step] = static_cast<float>(sum);
+                }
+            }
+        });
+        return;
+    }
+
+    // Zero padding to length + radius keeps the circular convolution from
+    // wrapping one end of a line onto the other
+    size_t padded = 1;
+    while (padded < static_cast<size_t>(length + radius)) {
+        padded <<= 1;
+    }
+    Fft fft(padded);
+
+    // The kernel is symmetric, so its spectrum is real
+    std::vector<std::complex<double>> buffer(padded);
+    for (int t = -radius; t <= radius; ++t) {
+        size_t at = t >= 0 ? static_cast<size_t>(t) : padded - static_cast<size_t>(-t);
+        buffer[at] = kernel[static_cast<size_t>(t + radius)];
+    }
+    fft.transform(buffer.data(), false);
+    std::vector<double> spectrum(padded);
+    for (size_t k = 0; k < padded; ++k) {
+        spectrum[k] = buffer[k].real() / static_cast<double>(padded);
+    }
+
+    // Two real lines per transform: one as the real part, one as the
+    // imaginary part. A real spectrum keeps them apart.
+    size_t pairs = (static_cast<size_t>(lines) + 1) / 2;
+    pool.parallel_for(pairs, MIN_LINES_PER_CHUNK / 2, [&](size_t begin, size_t end, int) {
+        std::vector<std::complex<double>> data(padded);
+        for (size_t pair = begin; pair < end; ++pair) {
+            float* first = grid + 2 * pair * line_stride;
+            float* second = 2 * pair + 1 < static_cast<size_t>(lines) ? first + line_stride : nullptr;
+            std::fill(data.begin(), data.end(), std::complex<double>());
+            for (int i = 0; i < length; ++i) {
+                size_t at = static_cast<size_t>(i) * step;
+                data[static_cast<size_t>(i)] = {first[at], second != nullptr ? second[at] : 0.0f};
+            }
+            fft.transform(data.data(), false);
+            for (size_t k = 0; k < padded; ++k) {
+                data[k] *= spectrum[k];
+            }
+            fft.transform(data.data(), true);
+            // Rounding can leave tiny negatives where the density is zero
+            for (int i = 0; i < length; ++i) {
+                size_t at = static_cast<size_t>(i) * step;
+                first[at] = static_cast<float>(std::max(0.0, data[static_cast<size_t>(i)].real()));
+                if (second != nullptr) {
+                    second[at] = static_cast<float>(std::max(0.0, data[static_cast<size_t>(i)].imag()));
+                }
+            }
+        }
+    });
+}
+
+// Class 0 or 1 of a target; NO_CLASS for any other class
+int kde_class(const ClassPalette& palette, const std::string& target) {
+    int cls = palette.find(target);
+    return cls == 0 || cls == 1 ? cls : ClassPalette::NO_CLASS;
+}
+
+// x red and o blue, unless the class has its own colour
+Terminal::Color contour_color(int cls, const ClassPalette& palette) {
+    Terminal::Color color = palette.style(cls).color;
+    if (color != Terminal::Color::DEFAULT) {
+        return color;
+    }
+    return cls == 0 ? Terminal::Color::RED : Terminal::Color::BLUE;
+}
+
+}  // namespace
+
+void KdeOverlay::ensure_loaded(DataTable& table, const ClassPalette& palette,
+                               double x_min, double x_max, double y_min, double y_max) {
+    if (loaded_ && x_min == x_min_ && x_max == x_max_ && y_min == y_min_ && y_max == y_max_) {
+        return;
+    }
+    TraceSpan span("KdeOverlay::load");
+    x_min_ = x_min;
+    x_max_ = x_max;
+    y_min_ = y_min;
+    y_max_ = y_max;
+    for (int cls = 0; cls < 2; ++cls) {
+        counts_[cls].assign(static_cast<size_t>(GRID) * GRID, 0.0f);
+        totals_[cls] = 0;
+        for (const auto& bin : table.count_in_bins(x_min, x_max, y_min, y_max, GRID, GRID,
+                                                   palette.style(cls).target)) {
+            counts_[cls][static_cast<size_t>(bin.row) * GRID + static_cast<size_t>(bin.col)] +=
+                static_cast<float>(bin.count);
+            totals_[cls] += bin.count;
+        }
+        dirty_[cls] = true;
+    }
+    // The queries saw only saved points, so every journal change applies anew
+    journal_.clear();
+    loaded_ = true;
+}
+
+void KdeOverlay::sync(DataTable& table, const std::vector<ChangeRecord>& changes,
+                      const ClassPalette& palette) {
+    if (!loaded_) {
+        return;
+    }
+    journal_.sync(
+        table, changes, [&](const std::string& target) { return kde_class(palette, target); },
+        [&](const JournalDiff::Effect& effect, int sign) {
+            int bin = bin_of(effect.x, effect.y);
+            add(bin, effect.added, static_cast<float>(sign));
+            add(bin, effect.removed, static_cast<float>(-sign));
+        });
+}
+
+int KdeOverlay::bin_of(double x, double y) const {
+    if (!(x >= x_min_ && x <= x_max_ && y >= y_min_ && y <= y_max_) ||
+        x_max_ <= x_min_ || y_max_ <= y_min_) {
+        return -1;
+    }
+    int col = std::min(static_cast<int>((x - x_min_) * GRID / (x_max_ - x_min_)), GRID - 1);
+    int row = std::min(static_cast<int>((y_max_ - y) * GRID / (y_max_ - y_min_)), GRID - 1);
+    return row * GRID + col;
+}
+
+void KdeOverlay::add(int bin, int cls, float delta) {
+    if (bin < 0 || cls < 0) {
+        return;
+    }
+    counts_[cls][static_cast<size_t>(bin)] += delta;
+    totals_[cls] += delta > 0.0f ? 1 : -1;
+    dirty_[cls] = true;
+}
+
+void KdeOverlay::set_bandwidth(std::optional<double> bandwidth) {
+    fixed_bandwidth_ = bandwidth;
+    dirty_[0] = dirty_[1] = true;
+}
+
+void KdeOverlay::scale_bandwidth(double factor) {
+    scale_ = std::max(MIN_SCALE, std::min(scale_ * factor, MAX_SCALE));
+    dirty_[0] = dirty_[1] = true;
+}
+
+double KdeOverlay::bandwidth(int cls, int axis) const {
+    return (fixed_bandwidth_.has_value() ? *fixed_bandwidth_ : scott_[cls][axis]) * scale_;
+}
+
+void KdeOverlay::scott_bandwidth(int cls) {
+    // Moments of the binned points, at bin centres
+    double n = 0.0;
+    double sum[2] = {0.0, 0.0};
+    double squares[2] = {0.0, 0.0};
+    const std::vector<float>& counts = counts_[cls];
+    for (int row = 0; row < GRID; ++row) {
+        for (int col = 0; col < GRID; ++col) {
+            double c = counts[static_cast<size_t>(row) * GRID + static_cast<size_t>(col)];
+            if (c == 0.0) {
+                continue;
+            }
+            n += c;
+            sum[0] += c * (col + 0.5);
+            squares[0] += c * (col + 0.5) * (col + 0.5);
+            sum[1] += c * (row + 0.5);
+            squares[1] += c * (row + 0.5) * (row + 0.5);
+        }
+    }
+    double bin_size[2] = {(x_max_ - x_min_) / GRID, (y_max_ - y_min_) / GRID};
+    for (int axis = 0; axis < 2; ++axis) {
+        // sigma * n^(-1/6), in bins; one bin when there is no spread
+        double h = 1.0;
+        if (n >= 2.0) {
+            double mean = sum[axis] / n;
+            double variance = std::max(0.0, squares[axis] / n - mean * mean);
+            if (variance > 0.0) {
+                h = std::sqrt(variance) * std::pow(n, -1.0 / 6.0);
+            }
+        }
+        scott_[cls][axis] = h * bin_size[axis];
+    }
+}
+
+void KdeOverlay::update() {
+    if (!loaded_) {
+        return;
+    }
+    ThreadPool& pool = pool_ != nullptr ? *pool_ : ThreadPool::shared();
+    double bin_size[2] = {(x_max_ - x_min_) / GRID, (y_max_ - y_min_) / GRID};
+    for (int cls = 0; cls < 2; ++cls) {
+        if (!dirty_[cls]) {
+            continue;
+        }
+        TraceSpan span("KdeOverlay::update");
+        scott_bandwidth(cls);
+        density_[cls] = counts_[cls];
+        if (totals_[cls] > 0 && bin_size[0] > 0.0 && bin_size[1] > 0.0) {
+            double sigma[2];
+            for (int axis = 0; axis < 2; ++axis) {
+                sigma[axis] = std::max(MIN_SIGMA_BINS, std::min(bandwidth(cls, axis) / bin_size[axis], MAX_SIGMA_BINS));
+            }
+            blur(density_[cls], GRID, GRID, sigma[1], sigma[0], Method::AUTO, pool);
+        }
+        find_levels(cls);
+        dirty_[cls] = false;
+    }
+}
+
+void KdeOverlay::blur(std::vector<float>& grid, int rows, int cols, double sigma_rows,
+                      double sigma_cols, Method method, ThreadPool& pool) {
+    // Along each row, then down each column
+    blur_lines(grid.data(), rows, cols, static_cast<size_t>(cols), 1, sigma_cols, method, pool);
+    blur_lines(grid.data(), cols, rows, 1, static_cast<size_t>(cols), sigma_rows, method, pool);
+}
+
+void KdeOverlay::find_levels(int cls) {
+    const std::vector<float>& density = density_[cls];
+    double total = 0.0;
+    float peak = 0.0f;
+    for (float d : density) {
+        total += d;
+        peak = std::max(peak, d);
+    }
+    for (int i = 0; i < LEVELS; ++i) {
+        levels_[cls][i] = std::numeric_limits<double>::infinity();
+    }
+    if (total <= 0.0 || peak <= 0.0f) {
+        return;  // No points: no contours
+    }
+
+    // Mass per density bucket, then walk down from the densest bucket until
+    // each level's share of the mass is enclosed
+    std::vector<double> mass(LEVEL_BUCKETS, 0.0);
+    double width = static_cast<double>(peak) / LEVEL_BUCKETS;
+    for (float d : density) {
+        int bucket = std::min(static_cast<int>(d / width), LEVEL_BUCKETS - 1);
+        mass[static_cast<size_t>(bucket)] += d;
+    }
+    double enclosed = 0.0;
+    int level = 0;
+    for (int bucket = LEVEL_BUCKETS - 1; bucket >= 0 && level < LEVELS; --bucket) {
+        double next = enclosed + mass[static_cast<size_t>(bucket)];
+        while (level < LEVELS && next >= MASS_LEVELS[level] * total) {
+            double fraction = (MASS_LEVELS[level] * total - enclosed) / mass[static_cast<size_t>(bucket)];
+            levels_[cls][level] = width * (bucket + 1 - fraction);
+            ++level;
+        }
+        enclosed = next;
+    }
+}
+
+double KdeOverlay::density(int cls, double x, double y) const {
+    if (!loaded_ || density_[cls].empty() || !(x >= x_min_ && x <= x_max_ && y >= y_min_ && y <= y_max_) ||
+        x_max_ <= x_min_ || y_max_ <= y_min_) {
+        return 0.0;
+    }
+    // Bilinear between bin centres, held flat beyond the outer centres
+    double gx = std::max(0.0, std::min((x - x_min_) * GRID / (x_max_ - x_min_) - 0.5, GRID - 1.0));
+    double gy = std::max(0.0, std::min((y_max_ - y) * GRID / (y_max_ - y_min_) - 0.5, GRID - 1.0));
+    int col = std::min(static_cast<int>(gx), GRID - 2);
+    int row = std::min(static_cast<int>(gy), GRID - 2);
+    double fx = gx - col;
+    double fy = gy - row;
+    const float* at = density_[cls].data() + static_cast<size_t>(row) * GRID + static_cast<size_t>(col);
+    double top = at[0] + fx * (at[1] - at[0]);
+    double bottom = at[GRID] + fx * (at[GRID + 1] - at[GRID]);
+    return top + fy * (bottom - top);
+}
+
+void KdeOverlay::render(Terminal& terminal, const Viewport& viewport, const ClassPalette& palette,
+                        int start_row, int height, int width) {
+    int rows = height - 2;  // Inside the edit area border
+    int cols = width - 2;
+    if (!loaded_ || rows <= 0 || cols <= 0) {
+        return;
+    }
+    update();
+    TraceSpan span("KdeOverlay::render");
+
+    size_t cells = static_cast<size_t>(rows) * static_cast<size_t>(cols);
+    for (int cls = 0; cls < 2; ++cls) {
+        cells_[cls].resize(cells);
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                DataCoord data = viewport.screen_to_data({row, col});
+                cells_[cls][static_cast<size_t>(row) * cols + col] =
+                    static_cast<float>(density(cls, data.x, data.y));
+            }
+        }
+    }
+
+    auto value = [&](int cls, int row, int col) {
+        row = std::max(0, std::min(row, rows - 1));
+        col = std::max(0, std::min(col, cols - 1));
+        return static_cast<double>(cells_[cls][static_cast<size_t>(row) * cols + col]);
+    };
+    // On a contour: inside some level with a neighbour outside it
+    auto on_contour = [&](int cls, int row, int col) {
+        double here = value(cls, row, col);
+        for (int i = 0; i < LEVELS; ++i) {
+            double level = levels_[cls][i];
+            if (here >= level && (value(cls, row - 1, col) < level || value(cls, row + 1, col) < level ||
+                                  value(cls, row, col - 1) < level || value(cls, row, col + 1) < level)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int screen_row = start_row + 1 + row;
+            int screen_col = 1 + col;
+            if (terminal.read_char(screen_row, screen_col) != ' ') {
+                continue;
+            }
+            bool x_contour = on_contour(0, row, col);
+            bool o_contour = on_contour(1, row, col);
+            if (x_contour && o_contour) {
+                terminal.write_char(screen_row, screen_col, '+', Terminal::Color::MAGENTA);
+                continue;
+            }
+            if (!x_contour && !o_contour) {
+                continue;
+            }
+            // The contour runs across the gradient; a row is about two
+            // columns tall
+            int cls = x_contour ? 0 : 1;
+            double dx = (value(cls, row, col + 1) - value(cls, row, col - 1)) / 2.0;
+            double dy = (value(cls, row + 1, col) - value(cls, row - 1, col)) / 4.0;
+            char glyph;
+            if (std::abs(dx) > 2.414 * std::abs(dy)) {
+                glyph = '|';
+            } else if (std::abs(dy) > 2.414 * std::abs(dx)) {
+                glyph = '-';
+            } else {
+                glyph = dx * dy > 0.0 ? '/' : '\\';
+            }
+            terminal.write_char(screen_row, screen_col, glyph, contour_color(cls, palette));
+        }
+    }
+
+    // Bandwidth on the top border
+    char label[48];
+    if (fixed_bandwidth_.has_value()) {
+        std::snprintf(label, sizeof(label), " kde h=%.3g ", *fixed_bandwidth_ * scale_);
+    } else if (scale_ != 1.0) {
+        std::snprintf(label, sizeof(label), " kde scott x%.3g ", scale_);
+    } else {
+        std::snprintf(label, sizeof(label), " kde scott ");
+    }
+    EditAreaRenderer::draw_border_label(terminal, start_row, width, label);
+}
+
+}  // namespace datapainter
@@ -0,0 +1,191 @@
+#include "keystroke_profiler.h"
+#include "json_value.h"
+#include "terminal.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace datapainter {
+
+void KeystrokeProfiler::record(int key, const FrameStats& stats) {
+    Sample sample;
+    sample.label = key_label(key);
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        sample.phase_ms[i] = stats.phase_ms(static_cast<Phase>(i));
+    }
+    sample.total_ms = stats.total_ms();
+    samples_.push_back(std::move(sample));
+}
+
+std::string KeystrokeProfiler::key_label(int key) {
+    switch (key) {
+        case Terminal::KEY_UP_ARROW:       return "<up>";
+        case Terminal::KEY_DOWN_ARROW:     return "<down>";
+        case Terminal::KEY_LEFT_ARROW:     return "<left>";
+        case Terminal::KEY_RIGHT_ARROW:    return "<right>";
+        case Terminal::KEY_RESIZE:         return "<resize>";
+        case Terminal::KEY_DUMP_SCREEN:    return "<dump>";
+        case Terminal::KEY_DUMP_EDIT_AREA: return "<dump-edit-area>";
+        case Terminal::KEY_RENDER:         return "<render>";
+        case Terminal::KEY_WAKE:           return "<wake>";
+        case -1:                           return "<end>";
+        case ' ':                          return "<space>";
+        case '\t':                         return "<tab>";
+        case '\n':                         return "<enter>";
+        case 27:                           return "<esc>";
+        case 8:
+        case 127:                          return "<delete>";
+        default:                           break;
+    }
+    if (key > 32 && key < 127) {
+        return std::string(1, static_cast<char>(key));
+    }
+    return "<key-" + std::to_string(key) + ">";
+}
+
+double KeystrokeProfiler::percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    double rank = std::ceil(p / 100.0 * static_cast<double>(values.size()));
+    size_t index = rank < 1.0 ? 0 : static_cast<size_t>(rank) - 1;
+    return values[std::min(index, values.size() - 1)];
+}
+
+KeystrokeProfiler::Summary KeystrokeProfiler::summarize(const std::vector<double>& values) {
+    Summary summary;
+    summary.count = values.size();
+    summary.p50 = percentile(values, 50.0);
+    summary.p95 = percentile(values, 95.0);
+    summary.p99 = percentile(values, 99.0);
+    summary.max = values.empty() ? 0.0 : *std::max_element(values.begin(), values.end());
+    return summary;
+}
+
+std::vector<std::string> KeystrokeProfiler::labels() const {
+    std::vector<std::string> result;
+    for (const auto& sample : samples_) {
+        if (std::find(result.begin(), result.end(), sample.label) == result.end()) {
+            result.push_back(sample.label);
+        }
+    }
+    return result;
+}
+
+bool KeystrokeProfiler::write_report(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json) {
+        write_json(out);
+    } else {
+        write_table(out);
+    }
+    out.flush();
+    return !out.fail();
+}
+
+void KeystrokeProfiler::write_table(std::ostream& out) const {
+    char line[160];
+
+    out << "Keystroke latency (ms) over " << samples_.size() << " keys\n\n";
+    std::snprintf(line, sizeof(line), "%-18s %8s %10s %10s %10s %10s\n",
+                  "key", "count", "p50", "p95", "p99", "max");
+    out << line;
+
+    auto write_row = [&](const std::string& name, const Summary& s) {
+        std::snprintf(line, sizeof(line), "%-18s %8zu %10.3f %10.3f %10.3f %10.3f\n",
+                      name.c_str(), s.count, s.p50, s.p95, s.p99, s.max);
+        out << line;
+    };
+
+    std::vector<double> all_totals;
+    for (const auto& label : labels()) {
+        std::vector<double> totals;
+        for (const auto& sample : samples_) {
+            if (sample.label == label) {
+                totals.push_back(sample.total_ms);
+            }
+        }
+        write_row(label, summarize(totals));
+    }
+    for (const auto& sample : samples_) {
+        all_totals.push_back(sample.total_ms);
+    }
+    write_row("all", summarize(all_totals));
+
+    out << "\nPer-phase time per key (ms)\n\n";
+    std::snprintf(line, sizeof(line), "%-18s %8s %10s %10s %10s %10s\n",
+                  "phase", "count", "p50", "p95", "p99", "max");
+    out << line;
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        std::vector<double> values;
+        for (const auto& sample : samples_) {
+            values.push_back(sample.phase_ms[i]);
+        }
+        write_row(phase_name(static_cast<Phase>(i)), summarize(values));
+    }
+}
+
+void KeystrokeProfiler::write_json(std::ostream& out) const {
+    auto summary_json = [](const Summary& s) {
+        JsonValue obj = JsonValue::object();
+        obj.set("count", static_cast<double>(s.count));
+        obj.set("p50_ms", s.p50);
+        obj.set("p95_ms", s.p95);
+        obj.set("p99_ms", s.p99);
+        obj.set("max_ms", s.max);
+        return obj;
+    };
+
+    JsonValue by_key = JsonValue::object();
+    for (const auto& label : labels()) {
+        std::vector<double> totals;
+        std::array<std::vector<double>, PHASE_COUNT> phases;
+        for (const auto& sample : samples_) {
+            if (sample.label == label) {
+                totals.push_back(sample.total_ms);
+                for (size_t i = 0; i < PHASE_COUNT; ++i) {
+                    phases[i].push_back(sample.phase_ms[i]);
+                }
+            }
+        }
+
+        JsonValue phase_summaries = JsonValue::object();
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            phase_summaries.set(phase_name(static_cast<Phase>(i)), summary_json(summarize(phases[i])));
+        }
+        JsonValue entry = JsonValue::object();
+        entry.set("total", summary_json(summarize(totals)));
+        entry.set("phases", phase_summaries);
+        by_key.set(label, entry);
+    }
+
+    std::vector<double> all_totals;
+    for (const auto& sample : samples_) {
+        all_totals.push_back(sample.total_ms);
+    }
+
+    JsonValue by_phase = JsonValue::object();
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        std::vector<double> values;
+        for (const auto& sample : samples_) {
+            values.push_back(sample.phase_ms[i]);
+        }
+        by_phase.set(phase_name(static_cast<Phase>(i)), summary_json(summarize(values)));
+    }
+
+    JsonValue report = JsonValue::object();
+    report.set("keys", static_cast<double>(samples_.size()));
+    report.set("by_key", by_key);
+    report.set("total", summary_json(summarize(all_totals)));
+    report.set("by_phase", by_phase);
+    out << report.dump() << "\n";
+}
+
+}  // namespace datapainter
@@ -0,0 +1,547 @@
+#include "kmeans_overlay.h"
+#include "edit_area_renderer.h"
+#include "tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace datapainter {
+
+namespace {
+
+// Points per parallel chunk of an assignment pass
+constexpr size_t MIN_POINTS_PER_CHUNK = 16384;
+
+// Points per call of the distance kernel within a chunk
+constexpr size_t BLOCK = 256;
+
+// Fixed seed, so the same points give the same suggestions
+constexpr unsigned SEED = 1;
+
+constexpr char CENTRE_GLYPHS[] = "123456789abcdefg";
+constexpr char BOUNDARY_CHAR = ':';
+
+const Terminal::Color CLUSTER_COLORS[] = {
+    Terminal::Color::RED,     Terminal::Color::BLUE, Terminal::Color::GREEN,  Terminal::Color::MAGENTA,
+    Terminal::Color::CYAN,    Terminal::Color::YELLOW, Terminal::Color::WHITE,
+};
+
+Terminal::Color cluster_color(int cluster) {
+    return CLUSTER_COLORS[static_cast<size_t>(cluster) % (sizeof(CLUSTER_COLORS) / sizeof(CLUSTER_COLORS[0]))];
+}
+
+// One worker's share of an assignment pass, padded so workers do not share
+// cache lines
+struct alignas(64) Partial {
+    double sum_x[KmeansOverlay::MAX_K];
+    double sum_y[KmeansOverlay::MAX_K];
+    int64_t count[KmeansOverlay::MAX_K];
+    double distance2;
+    int64_t moved;
+};
+
+}  // namespace
+
+void KmeansOverlay::set_k(int k) {
+    k_ = std::max(1, std::min(k, MAX_K));
+}
+
+void KmeansOverlay::reset(const std::vector<double>& xs, const std::vector<double>& ys,
+                          const std::vector<uint8_t>& labels) {
+    xs_ = xs;
+    ys_ = ys;
+    labels_ = labels;
+    free_slots_.clear();
+}
+
+uint32_t KmeansOverlay::add(double x, double y, int label) {
+    if (!free_slots_.empty()) {
+        uint32_t slot = free_slots_.back();
+        free_slots_.pop_back();
+        xs_[slot] = x;
+        ys_[slot] = y;
+        labels_[slot] = static_cast<uint8_t>(label);
+        return slot;
+    }
+    xs_.push_back(x);
+    ys_.push_back(y);
+    labels_.push_back(static_cast<uint8_t>(label));
+    return static_cast<uint32_t>(xs_.size() - 1);
+}
+
+void KmeansOverlay::remove(uint32_t slot) {
+    labels_[slot] = UNUSED;
+    free_slots_.push_back(slot);
+}
+
+void KmeansOverlay::relabel(uint32_t slot, int label) {
+    labels_[slot] = static_cast<uint8_t>(label);
+}
+
+void KmeansOverlay::sync(DataTable& table, const std::vector<ChangeRecord>& changes, ClassPalette& palette) {
+    if (sync_.sync(table, changes, palette, *this)) {
+        has_result_ = false;  // The suggestions no longer match the points
+    }
+}
+
+void KmeansOverlay::nearest_centres(const float* xs, const float* ys, size_t n, const float* centres_x,
+                                    const float* centres_y, int k, uint8_t* cluster, float* distance2,
+                                    float* second2) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Four points against one centre per step; a lane takes the centre's
+    // index where it is strictly nearer, so ties go to the lower index
+    const __m128 infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    for (; i + 4 <= n; i += 4) {
+        __m128 px = _mm_loadu_ps(xs + i);
+        __m128 py = _mm_loadu_ps(ys + i);
+        __m128 best = infinity;
+        __m128 runner_up = infinity;
+        __m128i best_index = _mm_setzero_si128();
+        for (int c = 0; c < k; ++c) {
+            __m128 dx = _mm_sub_ps(px, _mm_set1_ps(centres_x[c]));
+            __m128 dy = _mm_sub_ps(py, _mm_set1_ps(centres_y[c]));
+            __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128i nearer = _mm_castps_si128(_mm_cmplt_ps(d, best));
+            runner_up = _mm_min_ps(runner_up, _mm_max_ps(d, best));
+            best = _mm_min_ps(d, best);
+            best_index = _mm_or_si128(_mm_and_si128(nearer, _mm_set1_epi32(c)),
+                                      _mm_andnot_si128(nearer, best_index));
+        }
+        alignas(16) int32_t index[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(index), best_index);
+        _mm_storeu_ps(distance2 + i, best);
+        if (second2 != nullptr) {
+            _mm_storeu_ps(second2 + i, runner_up);
+        }
+        for (int lane = 0; lane < 4; ++lane) {
+            cluster[i + static_cast<size_t>(lane)] = static_cast<uint8_t>(index[lane]);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        float best = std::numeric_limits<float>::infinity();
+        float runner_up = std::numeric_limits<float>::infinity();
+        int best_index = 0;
+        for (int c = 0; c < k; ++c) {
+            float dx = xs[i] - centres_x[c];
+            float dy = ys[i] - centres_y[c];
+            float d = dx * dx + dy * dy;
+            if (d < best) {
+                runner_up = best;
+                best = d;
+                best_index = c;
+            } else {
+                runner_up = std::min(runner_up, d);
+            }
+        }
+        cluster[i] = static_cast<uint8_t>(best_index);
+        distance2[i] = best;
+        if (second2 != nullptr) {
+            second2[i] = runner_up;
+        }
+    }
+}
+
+void KmeansOverlay::run(DataTable& table, const std::vector<ChangeRecord>& changes, ClassPalette& palette,
+                        double x_min, double x_max, double y_min, double y_max) {
+    TraceSpan span("KmeansOverlay::run");
+    auto start = std::chrono::steady_clock::now();
+    // apply() needs the row of every point, which points saved since the
+    // load lack
+    if (sync_.unidentified() > 0) {
+        sync_.invalidate();
+    }
+    sync_.sync(table, changes, palette, *this);
+    has_result_ = false;
+
+    centre_[0] = 0.5 * (x_min + x_max);
+    centre_[1] = 0.5 * (y_min + y_max);
+    scale_[0] = x_max > x_min ? 0.5 * (x_max - x_min) : 1.0;
+    scale_[1] = y_max > y_min ? 0.5 * (y_max - y_min) : 1.0;
+
+    // Scaled single-precision copies of the live points, packed
+    std::vector<float> us;
+    std::vector<float> vs;
+    std::vector<uint32_t> slots;
+    us.reserve(xs_.size());
+    vs.reserve(xs_.size());
+    slots.reserve(xs_.size());
+    for (size_t slot = 0; slot < xs_.size(); ++slot) {
+        if (labels_[slot] != UNUSED) {
+            us.push_back(static_cast<float>((xs_[slot] - centre_[0]) / scale_[0]));
+            vs.push_back(static_cast<float>((ys_[slot] - centre_[1]) / scale_[1]));
+            slots.push_back(static_cast<uint32_t>(slot));
+        }
+    }
+    size_t n = us.size();
+    int k = static_cast<int>(std::min(static_cast<size_t>(k_), n));
+    centres_x_.clear();
+    centres_y_.clear();
+    if (k == 0) {
+        return;
+    }
+
+    ThreadPool& pool = pool_ != nullptr ? *pool_ : ThreadPool::shared();
+    std::vector<uint8_t> assignment(n, UNUSED);
+    std::vector<float> distance2(n);
+
+    // k-means++: each further centre is a point drawn with probability
+    // proportional to its squared distance from the nearest centre so far
+    std::mt19937 rng(SEED);
+    size_t first = std::uniform_int_distribution<size_t>(0, n - 1)(rng);
+    centres_x_.push_back(us[first]);
+    centres_y_.push_back(vs[first]);
+    std::vector<uint8_t> unused_cluster(n);
+    nearest_centres(us.data(), vs.data(), n, centres_x_.data(), centres_y_.data(), 1,
+                    unused_cluster.data(), distance2.data(), nullptr);
+    for (int c = 1; c < k; ++c) {
+        double total = 0.0;
+        for (float d : distance2) {
+            total += d;
+        }
+        size_t pick = 0;
+        if (total > 0.0) {
+            double target = std::uniform_real_distribution<double>(0.0, total)(rng);
+            double sum = 0.0;
+            for (pick = 0; pick + 1 < n; ++pick) {
+                sum += distance2[pick];
+                if (sum > target) {
+                    break;
+                }
+            }
+        } else {
+            pick = std::uniform_int_distribution<size_t>(0, n - 1)(rng);  // All coincide
+        }
+        float cx = us[pick];
+        float cy = vs[pick];
+        centres_x_.push_back(cx);
+        centres_y_.push_back(cy);
+        pool.parallel_for(n, MIN_POINTS_PER_CHUNK, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; ++i) {
+                float dx = us[i] - cx;
+                float dy = vs[i] - cy;
+                distance2[i] = std::min(distance2[i], dx * dx + dy * dy);
+            }
+        });
+    }
+
+    // Lloyd iterations with Hamerly's lower bound: each point keeps a bound
+    // on its distance to any centre but its own, loosened by how far the
+    // centres move. A point still nearer its own centre than that bound, or
+    // than half-way to the nearest other centre, cannot have changed
+    // cluster; only the rest are measured against every centre. Cluster
+    // sums follow the points that move.
+    std::vector<float> lower(n);
+    std::vector<Partial> partials(static_cast<size_t>(pool.size()));
+    for (Partial& partial : partials) {
+        partial = Partial{};
+    }
+    pool.parallel_for(n, MIN_POINTS_PER_CHUNK, [&](size_t begin, size_t end, int worker) {
+        Partial& out = partials[static_cast<size_t>(worker)];
+        float best[BLOCK];
+        float second[BLOCK];
+        for (size_t at = begin; at < end; at += BLOCK) {
+            size_t count = std::min(BLOCK, end - at);
+            nearest_centres(us.data() + at, vs.data() + at, count, centres_x_.data(), centres_y_.data(), k,
+                            assignment.data() + at, best, second);
+            for (size_t j = 0; j < count; ++j) {
+                uint8_t c = assignment[at + j];
+                lower[at + j] = std::sqrt(second[j]);
+                out.sum_x[c] += us[at + j];
+                out.sum_y[c] += vs[at + j];
+                ++out.count[c];
+            }
+        }
+    });
+    Partial sums{};
+    auto merge = [&]() {
+        int64_t moved = 0;
+        for (const Partial& partial : partials) {
+            for (int c = 0; c < k; ++c) {
+                sums.sum_x[c] += partial.sum_x[c];
+                sums.sum_y[c] += partial.sum_y[c];
+                sums.count[c] += partial.count[c];
+            }
+            moved += partial.moved;
+        }
+        return moved;
+    };
+    merge();
+
+    iterations_ = 1;
+    float shift[MAX_K];
+    float drop[MAX_K];      // Loosening of the lower bound of each cluster's points
+    float half_gap[MAX_K];
+    while (iterations_ < MAX_ITERATIONS) {
+        // Move each centre to the mean of its points
+        float max_shift = 0.0f;
+        float next_shift = 0.0f;  // Largest shift of any other centre
+        int fastest = 0;
+        for (int c = 0; c < k; ++c) {
+            shift[c] = 0.0f;
+            if (sums.count[c] > 0) {  // An emptied cluster keeps its centre
+                float x = static_cast<float>(sums.sum_x[c] / static_cast<double>(sums.count[c]));
+                float y = static_cast<float>(sums.sum_y[c] / static_cast<double>(sums.count[c]));
+                shift[c] = std::hypot(x - centres_x_[static_cast<size_t>(c)], y - centres_y_[static_cast<size_t>(c)]);
+                centres_x_[static_cast<size_t>(c)] = x;
+                centres_y_[static_cast<size_t>(c)] = y;
+            }
+            if (shift[c] > max_shift) {
+                next_shift = max_shift;
+                max_shift = shift[c];
+                fastest = c;
+            } else {
+                next_shift = std::max(next_shift, shift[c]);
+            }
+        }
+        if (max_shift < TOLERANCE) {
+            break;  // Centres have settled well below a cell
+        }
+        for (int c = 0; c < k; ++c) {
+            drop[c] = c == fastest ? next_shift : max_shift;
+            half_gap[c] = std::numeric_limits<float>::infinity();
+            for (int other = 0; other < k; ++other) {
+                if (other != c) {
+                    half_gap[c] = std::min(half_gap[c], 0.5f * std::hypot(centres_x_[static_cast<size_t>(c)] - centres_x_[static_cast<size_t>(other)],
+                                                                          centres_y_[static_cast<size_t>(c)] - centres_y_[static_cast<size_t>(other)]));
+                }
+            }
+        }
+
+        ++iterations_;
+        for (Partial& partial : partials) {
+            partial = Partial{};
+        }
+        pool.parallel_for(n, MIN_POINTS_PER_CHUNK, [&](size_t begin, size_t end, int worker) {
+            Partial& out = partials[static_cast<size_t>(worker)];
+            uint32_t pending[BLOCK];
+            float px[BLOCK];
+            float py[BLOCK];
+            uint8_t nearest[BLOCK];
+            float best[BLOCK];
+            float second[BLOCK];
+            size_t waiting = 0;
+            // Measure the waiting points against every centre
+            auto measure = [&]() {
+                for (size_t j = 0; j < waiting; ++j) {
+                    px[j] = us[pending[j]];
+                    py[j] = vs[pending[j]];
+                }
+                nearest_centres(px, py, waiting, centres_x_.data(), centres_y_.data(), k, nearest, best, second);
+                for (size_t j = 0; j < waiting; ++j) {
+                    uint32_t i = pending[j];
+                    lower[i] = std::sqrt(second[j]);
+                    uint8_t from = assignment[i];
+                    uint8_t to = nearest[j];
+                    if (from != to) {
+                        assignment[i] = to;
+                        ++out.moved;
+                        out.sum_x[from] -= us[i];
+                        out.sum_y[from] -= vs[i];
+                        --out.count[from];
+                        out.sum_x[to] += us[i];
+                        out.sum_y[to] += vs[i];
+                        ++out.count[to];
+                    }
+                }
+                waiting = 0;
+            };
+            // The distance to the own centre is cheap enough to take exactly,
+            // which leaves one rarely taken branch per point. Everything the
+            // loop reads is local, so the stores to the bounds cannot force
+            // reloads.
+            const uint8_t* point_cluster = assignment.data();
+            const float* point_u = us.data();
+            const float* point_v = vs.data();
+            const float* cx = centres_x_.data();
+            const float* cy = centres_y_.data();
+            float* bounds = lower.data();
+            float drops[MAX_K];
+            float gaps[MAX_K];
+            std::copy(drop, drop + k, drops);
+            std::copy(half_gap, half_gap + k, gaps);
+            for (size_t i = begin; i < end; ++i) {
+                uint8_t a = point_cluster[i];
+                float bound = bounds[i] - drops[a];
+                bounds[i] = bound;
+                bound = std::max(std::max(gaps[a], bound), 0.0f);
+                float dx = point_u[i] - cx[a];
+                float dy = point_v[i] - cy[a];
+                if (dx * dx + dy * dy <= bound * bound) {
+                    continue;
+                }
+                pending[waiting++] = static_cast<uint32_t>(i);
+                if (waiting == BLOCK) {
+                    measure();
+                }
+            }
+            measure();
+        });
+        if (merge() == 0) {
+            break;  // Centres are already the means of their points
+        }
+    }
+
+    // Exact distances for the inertia, and the final assignment
+    for (Partial& partial : partials) {
+        partial = Partial{};
+    }
+    pool.parallel_for(n, MIN_POINTS_PER_CHUNK, [&](size_t begin, size_t end, int worker) {
+        Partial& out = partials[static_cast<size_t>(worker)];
+        float best[BLOCK];
+        for (size_t at = begin; at < end; at += BLOCK) {
+            size_t count = std::min(BLOCK, end - at);
+            nearest_centres(us.data() + at, vs.data() + at, count, centres_x_.data(), centres_y_.data(), k,
+                            assignment.data() + at, best, nullptr);
+            for (size_t j = 0; j < count; ++j) {
+                ++out.count[assignment[at + j]];
+                out.distance2 += best[j];
+            }
+        }
+    });
+    sizes_.assign(static_cast<size_t>(k), 0);
+    double distance_sum = 0.0;
+    for (const Partial& partial : partials) {
+        for (int c = 0; c < k; ++c) {
+            sizes_[static_cast<size_t>(c)] += partial.count[c];
+        }
+        distance_sum += partial.distance2;
+    }
+    inertia_ = distance_sum / static_cast<double>(n);
+
+    // Each cluster suggests its most common class
+    std::vector<int64_t> votes(static_cast<size_t>(k) * ClassPalette::MAX_CLASSES, 0);
+    slot_cluster_.assign(xs_.size(), UNUSED);
+    for (size_t i = 0; i < n; ++i) {
+        slot_cluster_[slots[i]] = assignment[i];
+        ++votes[static_cast<size_t>(assignment[i]) * ClassPalette::MAX_CLASSES + labels_[slots[i]]];
+    }
+    majority_.assign(static_cast<size_t>(k), ClassPalette::NO_CLASS);
+    suggested_changes_ = 0;
+    for (int c = 0; c < k; ++c) {
+        const int64_t* row = votes.data() + static_cast<size_t>(c) * ClassPalette::MAX_CLASSES;
+        const int64_t* top = std::max_element(row, row + ClassPalette::MAX_CLASSES);
+        if (*top > 0) {
+            majority_[static_cast<size_t>(c)] = static_cast<int>(top - row);
+            suggested_changes_ += sizes_[static_cast<size_t>(c)] - *top;
+        }
+    }
+
+    has_result_ = true;
+    elapsed_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+double KmeansOverlay::centre_x(int cluster) const {
+    return centre_[0] + centres_x_[static_cast<size_t>(cluster)] * scale_[0];
+}
+
+double KmeansOverlay::centre_y(int cluster) const {
+    return centre_[1] + centres_y_[static_cast<size_t>(cluster)] * scale_[1];
+}
+
+int KmeansOverlay::nearest(double u, double v) const {
+    float x = static_cast<float>(u);
+    float y = static_cast<float>(v);
+    uint8_t cluster = 0;
+    float distance2 = 0.0f;
+    nearest_centres(&x, &y, 1, centres_x_.data(), centres_y_.data(), clusters(), &cluster, &distance2, nullptr);
+    return cluster;
+}
+
+std::optional<int> KmeansOverlay::apply(Database& db, const std::string& table_name,
+                                        const ClassPalette& palette) {
+    if (!has_result_) {
+        return 0;
+    }
+    TraceSpan span("KmeansOverlay::apply");
+    if (!db.execute("BEGIN TRANSACTION")) {
+        return std::nullopt;
+    }
+    UnsavedChanges journal(db);
+    int converted = 0;
+    bool ok = true;
+    sync_.for_each_point([&](uint32_t slot, int id) {
+        int suggestion = majority_[slot_cluster_[slot]];
+        if (!ok || suggestion == ClassPalette::NO_CLASS || suggestion == labels_[slot]) {
+            return;
+        }
+        const std::string& target = palette.style(suggestion).target;
+        if (id < 0) {
+            // An unsaved insert: retarget it in place, as a conversion does
+            ok = journal.update_insert_target(-id, target);
+        } else {
+            ok = journal.record_update(table_name, id, palette.style(labels_[slot]).target, target).has_value();
+        }
+        ++converted;
+    });
+    if (!ok) {
+        db.execute("ROLLBACK");
+        return std::nullopt;
+    }
+    if (!db.execute("COMMIT")) {
+        return std::nullopt;
+    }
+    has_result_ = false;
+    return converted;
+}
+
+void KmeansOverlay::render(Terminal& terminal, const Viewport& viewport, int start_row, int height, int width) {
+    int rows = height - 2;  // Inside the edit area border
+    int cols = width - 2;
+    if (!has_result_ || rows <= 0 || cols <= 0) {
+        return;
+    }
+
+    cells_.resize(static_cast<size_t>(rows) * static_cast<size_t>(cols));
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            DataCoord data = viewport.screen_to_data({row, col});
+            cells_[static_cast<size_t>(row) * cols + col] = static_cast<uint8_t>(
+                nearest((data.x - centre_[0]) / scale_[0], (data.y - centre_[1]) / scale_[1]));
+        }
+    }
+    auto cell = [&](int row, int col) { return cells_[static_cast<size_t>(row) * cols + col]; };
+
+    // Boundaries between the clusters' Voronoi cells
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int screen_row = start_row + 1 + row;
+            int screen_col = 1 + col;
+            if (terminal.read_char(screen_row, screen_col) != ' ') {
+                continue;  // Points and forbidden cells show through
+            }
+            uint8_t here = cell(row, col);
+            bool boundary = (row + 1 < rows && cell(row + 1, col) != here) ||
+                            (col + 1 < cols && cell(row, col + 1) != here) ||
+                            (row > 0 && cell(row - 1, col) != here) || (col > 0 && cell(row, col - 1) != here);
+            if (boundary) {
+                terminal.write_char(screen_row, screen_col, BOUNDARY_CHAR, cluster_color(here));
+            }
+        }
+    }
+
+    // Centres on top of everything
+    for (int c = 0; c < clusters(); ++c) {
+        if (auto screen = viewport.data_to_screen({centre_x(c), centre_y(c)})) {
+            if (screen->row >= 0 && screen->row < rows && screen->col >= 0 && screen->col < cols) {
+                terminal.write_char(start_row + 1 + screen->row, 1 + screen->col, CENTRE_GLYPHS[c],
+                                    cluster_color(c));
+            }
+        }
+    }
+
+    // Summary on the bottom border
+    char label[96];
+    std::snprintf(label, sizeof(label), " k-means k=%d: %d iterations, %.0f ms; A converts %lld ",
+                  clusters(), iterations_, elapsed_ms_, static_cast<long long>(suggested_changes_));
+    EditAreaRenderer::draw_border_label(terminal, start_row + height - 1, width, label);
+}
+
+}  // namespace datapainter
@@ -0,0 +1,121 @@
+#include "knn_overlay.h"
+#include "tracer.h"
+#include <algorithm>
+
+namespace datapainter {
+
+namespace {
+
+// Cells per parallel chunk: one k-NN query each, so chunks can be small
+constexpr size_t MIN_CELLS_PER_CHUNK = 256;
+
+constexpr char32_t REGION_GLYPH = U'·';  // Middle dot
+constexpr char REGION_FALLBACK = '.';
+constexpr char BOUNDARY_CHAR = ':';
+
+}  // namespace
+
+void KnnOverlay::set_k(int k) {
+    k_ = std::max(1, std::min(k, KdTree::MAX_K));
+}
+
+void KnnOverlay::sync(DataTable& table, const std::vector<ChangeRecord>& changes,
+                      ClassPalette& palette) {
+    if (sync_.sync(table, changes, palette, *this)) {
+        ++tree_version_;
+    }
+}
+
+int KnnOverlay::predict(double x, double y) const {
+    KdTree::Neighbour neighbours[KdTree::MAX_K];
+    int found = tree_.nearest(x, y, k_, neighbours);
+    if (found == 0) {
+        return ClassPalette::NO_CLASS;
+    }
+    int votes[ClassPalette::MAX_CLASSES] = {};
+    int top = 0;
+    for (int i = 0; i < found; ++i) {
+        top = std::max(top, ++votes[tree_.label(neighbours[i].slot)]);
+    }
+    // Nearest first, so the first class with the top vote is the tie-break
+    for (int i = 0; i < found; ++i) {
+        int label = tree_.label(neighbours[i].slot);
+        if (votes[label] == top) {
+            return label;
+        }
+    }
+    return ClassPalette::NO_CLASS;
+}
+
+void KnnOverlay::predict_cells(const Viewport& viewport, int rows, int cols) {
+    if (rows == rows_ && cols == cols_ && predicted_version_ == tree_version_ && predicted_k_ == k_ &&
+        view_[0] == viewport.data_x_min() && view_[1] == viewport.data_x_max() &&
+        view_[2] == viewport.data_y_min() && view_[3] == viewport.data_y_max()) {
+        return;  // Nothing moved since the last frame
+    }
+    TraceSpan span("KnnOverlay::predict_cells");
+    rows_ = rows;
+    cols_ = cols;
+    predicted_version_ = tree_version_;
+    predicted_k_ = k_;
+    view_[0] = viewport.data_x_min();
+    view_[1] = viewport.data_x_max();
+    view_[2] = viewport.data_y_min();
+    view_[3] = viewport.data_y_max();
+    predictions_.assign(static_cast<size_t>(rows) * static_cast<size_t>(cols), ClassPalette::NO_CLASS);
+
+    ThreadPool& pool = pool_ != nullptr ? *pool_ : ThreadPool::shared();
+    pool.parallel_for(predictions_.size(), MIN_CELLS_PER_CHUNK, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            ScreenCoord screen{static_cast<int>(i / static_cast<size_t>(cols)),
+                               static_cast<int>(i % static_cast<size_t>(cols))};
+            DataCoord data = viewport.screen_to_data(screen);
+            predictions_[i] = predict(data.x, data.y);
+        }
+    });
+}
+
+Terminal::Color KnnOverlay::region_color(int label, const ClassPalette& palette) {
+    Terminal::Color color = palette.style(label).color;
+    if (color != Terminal::Color::DEFAULT) {
+        return color;
+    }
+    // The edit area's diverging scale: x regions red, o regions blue
+    if (label == 0) {
+        return Terminal::Color::RED;
+    }
+    return label == 1 ? Terminal::Color::BLUE : Terminal::Color::DEFAULT;
+}
+
+void KnnOverlay::render(Terminal& terminal, const Viewport& viewport, const ClassPalette& palette,
+                        int start_row, int height, int width) {
+    int rows = height - 2;  // Inside the edit area border
+    int cols = width - 2;
+    if (rows <= 0 || cols <= 0) {
+        return;
+    }
+    predict_cells(viewport, rows, cols);
+
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int label = cell_class(row, col);
+            int screen_row = start_row + 1 + row;
+            int screen_col = 1 + col;
+            if (label == ClassPalette::NO_CLASS || terminal.read_char(screen_row, screen_col) != ' ') {
+                continue;  // Points, forbidden cells and empty trees show through
+            }
+            bool boundary = (row > 0 && cell_class(row - 1, col) != label) ||
+                            (row + 1 < rows && cell_class(row + 1, col) != label) ||
+                            (col > 0 && cell_class(row, col - 1) != label) ||
+                            (col + 1 < cols && cell_class(row, col + 1) != label);
+            Terminal::Color color = region_color(label, palette);
+            if (boundary) {
+                terminal.write_char(screen_row, screen_col, BOUNDARY_CHAR, color);
+            } else {
+                terminal.write_glyph(screen_row, screen_col, REGION_GLYPH, REGION_FALLBACK, color);
+            }
+        }
+    }
+}
+
+}  // namespace datapainter
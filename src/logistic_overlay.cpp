@@ -0,0 +1,372 @@
+#include "logistic_overlay.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace datapainter {
+
+namespace {
+
+// Points per parallel chunk of a Newton pass
+constexpr size_t MIN_POINTS_PER_CHUNK = 16384;
+
+// Halvings of a Newton step that raised the objective before giving up
+constexpr int MAX_HALVINGS = 30;
+
+// Band edges as log-odds: P(o) of 0.25/0.75 and 0.1/0.9
+const double INNER_BAND = std::log(3.0);
+const double OUTER_BAND = std::log(9.0);
+
+// Gradient, Hessian (upper triangle) and loss of one worker's points,
+// padded so workers do not share cache lines
+struct alignas(64) Pass {
+    double gradient[3];
+    double hessian[6];  // 00 01 02 11 12 22
+    double loss;
+    size_t correct;
+};
+
+// Add the loss, gradient and Hessian terms of points [begin, end) to out.
+// Sums stay in locals: stores through out could alias the coordinates.
+void accumulate(const double* xs, const double* ys, const uint8_t* classes, size_t begin, size_t end,
+                const double centre[2], const double inv_scale[2], const double w[3], Pass& out) {
+    const double cx = centre[0];
+    const double cy = centre[1];
+    const double sx = inv_scale[0];
+    const double sy = inv_scale[1];
+    const double w0 = w[0];
+    const double w1 = w[1];
+    const double w2 = w[2];
+    double g0 = 0.0, g1 = 0.0, g2 = 0.0;
+    double h00 = 0.0, h01 = 0.0, h02 = 0.0, h11 = 0.0, h12 = 0.0, h22 = 0.0;
+    double loss = 0.0;
+    size_t correct = 0;
+    for (size_t i = begin; i < end; ++i) {
+        uint8_t cls = classes[i];
+        if (cls > 1) {
+            continue;  // Another class or a free slot
+        }
+        double u = (xs[i] - cx) * sx;
+        double v = (ys[i] - cy) * sy;
+        double z = w0 + w1 * u + w2 * v;
+        // Single precision is plenty for per-point terms summed in double
+        float e = std::exp(-std::abs(static_cast<float>(z)));
+        double p = z >= 0.0 ? 1.0 / (1.0 + e) : e / (1.0 + e);
+        double y = cls;
+        loss += std::max(z, 0.0) - y * z + std::log(1.0f + e);
+        correct += (z > 0.0) == (cls == 1) ? 1 : 0;
+        double r = p - y;
+        g0 += r;
+        g1 += r * u;
+        g2 += r * v;
+        double h = p * (1.0 - p);
+        h00 += h;
+        h01 += h * u;
+        h02 += h * v;
+        h11 += h * u * u;
+        h12 += h * u * v;
+        h22 += h * v * v;
+    }
+    out.gradient[0] += g0;
+    out.gradient[1] += g1;
+    out.gradient[2] += g2;
+    out.hessian[0] += h00;
+    out.hessian[1] += h01;
+    out.hessian[2] += h02;
+    out.hessian[3] += h11;
+    out.hessian[4] += h12;
+    out.hessian[5] += h22;
+    out.loss += loss;
+    out.correct += correct;
+}
+
+// Solve the symmetric 3x3 system h * x = b; false if h is singular
+bool solve3(const double h[6], const double b[3], double x[3]) {
+    double a00 = h[0], a01 = h[1], a02 = h[2], a11 = h[3], a12 = h[4], a22 = h[5];
+    double c00 = a11 * a22 - a12 * a12;
+    double c01 = a02 * a12 - a01 * a22;
+    double c02 = a01 * a12 - a02 * a11;
+    double det = a00 * c00 + a01 * c01 + a02 * c02;
+    if (!(std::abs(det) > 0.0) || !std::isfinite(det)) {
+        return false;
+    }
+    double c11 = a00 * a22 - a02 * a02;
+    double c12 = a01 * a02 - a00 * a12;
+    double c22 = a00 * a11 - a01 * a01;
+    x[0] = (c00 * b[0] + c01 * b[1] + c02 * b[2]) / det;
+    x[1] = (c01 * b[0] + c11 * b[1] + c12 * b[2]) / det;
+    x[2] = (c02 * b[0] + c12 * b[1] + c22 * b[2]) / det;
+    return true;
+}
+
+Terminal::Color side_color(int cls, const ClassPalette& palette) {
+    Terminal::Color color = palette.size() > cls ? palette.style(cls).color : Terminal::Color::DEFAULT;
+    if (color != Terminal::Color::DEFAULT) {
+        return color;
+    }
+    // The edit area's diverging scale: x red, o blue
+    return cls == 0 ? Terminal::Color::RED : Terminal::Color::BLUE;
+}
+
+}  // namespace
+
+void LogisticOverlay::set_range(double x_min, double x_max, double y_min, double y_max) {
+    double centre_x = (x_min + x_max) / 2.0;
+    double centre_y = (y_min + y_max) / 2.0;
+    double scale_x = x_max > x_min ? (x_max - x_min) / 2.0 : 1.0;
+    double scale_y = y_max > y_min ? (y_max - y_min) / 2.0 : 1.0;
+    if (centre_x == centre_[0] && centre_y == centre_[1] && scale_x == scale_[0] && scale_y == scale_[1]) {
+        return;
+    }
+    centre_[0] = centre_x;
+    centre_[1] = centre_y;
+    scale_[0] = scale_x;
+    scale_[1] = scale_y;
+    // Weights are in scaled units, so start again from the moments
+    warm_ = false;
+    fit();
+}
+
+void LogisticOverlay::sync(DataTable& table, const std::vector<ChangeRecord>& changes,
+                           ClassPalette& palette) {
+    if (sync_.sync(table, changes, palette, *this)) {
+        fit();
+    }
+}
+
+void LogisticOverlay::reset(const std::vector<double>& xs, const std::vector<double>& ys,
+                            const std::vector<uint8_t>& labels) {
+    xs_ = xs;
+    ys_ = ys;
+    classes_.assign(labels.size(), UNUSED);
+    free_slots_.clear();
+    moments_[0] = Moments{};
+    moments_[1] = Moments{};
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (labels[i] <= 1) {
+            classes_[i] = labels[i];
+            moments_[labels[i]].add(xs[i], ys[i], +1);
+        }
+    }
+    warm_ = false;
+}
+
+uint32_t LogisticOverlay::add(double x, double y, int label) {
+    uint32_t slot = 0;
+    if (!free_slots_.empty()) {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+        xs_[slot] = x;
+        ys_[slot] = y;
+    } else {
+        slot = static_cast<uint32_t>(xs_.size());
+        xs_.push_back(x);
+        ys_.push_back(y);
+        classes_.push_back(UNUSED);
+    }
+    relabel(slot, label);
+    return slot;
+}
+
+void LogisticOverlay::remove(uint32_t slot) {
+    relabel(slot, ClassPalette::NO_CLASS);
+    free_slots_.push_back(slot);
+}
+
+void LogisticOverlay::relabel(uint32_t slot, int label) {
+    uint8_t& cls = classes_[slot];
+    if (cls != UNUSED) {
+        moments_[cls].add(xs_[slot], ys_[slot], -1);
+    }
+    cls = label == 0 || label == 1 ? static_cast<uint8_t>(label) : UNUSED;
+    if (cls != UNUSED) {
+        moments_[cls].add(xs_[slot], ys_[slot], +1);
+    }
+}
+
+void LogisticOverlay::initial_weights() {
+    // Linear discriminant: shared covariance from the within-class scatter,
+    // all in scaled coordinates
+    const Moments& a = moments_[0];
+    const Moments& b = moments_[1];
+    double mean[2][2];
+    double wxx = 0.0;
+    double wxy = 0.0;
+    double wyy = 0.0;
+    for (int cls = 0; cls < 2; ++cls) {
+        const Moments& m = moments_[cls];
+        mean[cls][0] = m.mean_x();
+        mean[cls][1] = m.mean_y();
+        wxx += m.sum_xx - m.sum_x * mean[cls][0];
+        wxy += m.sum_xy - m.sum_x * mean[cls][1];
+        wyy += m.sum_yy - m.sum_y * mean[cls][1];
+    }
+    double n = static_cast<double>(a.count + b.count);
+    double uu = wxx / n / (scale_[0] * scale_[0]) + 1e-6;
+    double uv = wxy / n / (scale_[0] * scale_[1]);
+    double vv = wyy / n / (scale_[1] * scale_[1]) + 1e-6;
+    double du = (mean[1][0] - mean[0][0]) / scale_[0];
+    double dv = (mean[1][1] - mean[0][1]) / scale_[1];
+    double det = uu * vv - uv * uv;
+    double w1 = (vv * du - uv * dv) / det;
+    double w2 = (uu * dv - uv * du) / det;
+    if (!std::isfinite(w1) || !std::isfinite(w2)) {
+        w1 = 0.0;
+        w2 = 0.0;
+    }
+    double mid_u = ((mean[0][0] + mean[1][0]) / 2.0 - centre_[0]) / scale_[0];
+    double mid_v = ((mean[0][1] + mean[1][1]) / 2.0 - centre_[1]) / scale_[1];
+    weights_[0] = std::log(static_cast<double>(b.count) / static_cast<double>(a.count)) - w1 * mid_u - w2 * mid_v;
+    weights_[1] = w1;
+    weights_[2] = w2;
+}
+
+void LogisticOverlay::fit() {
+    TraceSpan span("LogisticOverlay::fit");
+    iterations_ = 0;
+    fitted_ = moments_[0].count > 0 && moments_[1].count > 0;
+    if (!fitted_) {
+        warm_ = false;
+        return;
+    }
+    if (!warm_) {
+        initial_weights();
+    }
+
+    ThreadPool& pool = pool_ != nullptr ? *pool_ : ThreadPool::shared();
+    std::vector<Pass> passes(static_cast<size_t>(pool.size()));
+    const double inv_scale[2] = {1.0 / scale_[0], 1.0 / scale_[1]};
+
+    // Damped Newton: a step that raises the penalised loss is halved
+    double accepted[3] = {weights_[0], weights_[1], weights_[2]};
+    double accepted_objective = std::numeric_limits<double>::infinity();
+    double step[3] = {0.0, 0.0, 0.0};
+    int halvings = 0;
+    while (iterations_ < MAX_ITERATIONS) {
+        ++iterations_;
+        std::fill(passes.begin(), passes.end(), Pass{});
+        const double weights[3] = {weights_[0], weights_[1], weights_[2]};
+        pool.parallel_for(xs_.size(), MIN_POINTS_PER_CHUNK, [&](size_t begin, size_t end, int worker) {
+            accumulate(xs_.data(), ys_.data(), classes_.data(), begin, end, centre_, inv_scale, weights,
+                       passes[static_cast<size_t>(worker)]);
+        });
+
+        Pass total{};
+        for (const Pass& pass : passes) {
+            for (int j = 0; j < 3; ++j) {
+                total.gradient[j] += pass.gradient[j];
+            }
+            for (int j = 0; j < 6; ++j) {
+                total.hessian[j] += pass.hessian[j];
+            }
+            total.loss += pass.loss;
+            total.correct += pass.correct;
+        }
+        double w1 = weights_[1];
+        double w2 = weights_[2];
+        double objective = total.loss + 0.5 * RIDGE * (w1 * w1 + w2 * w2);
+        if (objective > accepted_objective && halvings < MAX_HALVINGS) {
+            ++halvings;
+            for (int j = 0; j < 3; ++j) {
+                step[j] /= 2.0;
+                weights_[j] = accepted[j] - step[j];
+            }
+            continue;
+        }
+
+        halvings = 0;
+        accepted_objective = objective;
+        std::copy(weights_, weights_ + 3, accepted);
+        double n = static_cast<double>(moments_[0].count + moments_[1].count);
+        loss_ = total.loss / n;
+        accuracy_ = static_cast<double>(total.correct) / n;
+
+        total.gradient[1] += RIDGE * w1;
+        total.gradient[2] += RIDGE * w2;
+        total.hessian[3] += RIDGE;
+        total.hessian[5] += RIDGE;
+        if (!solve3(total.hessian, total.gradient, step)) {
+            break;
+        }
+        double largest = std::max({std::abs(step[0]), std::abs(step[1]), std::abs(step[2])});
+        if (!std::isfinite(largest)) {
+            break;
+        }
+        if (largest < TOLERANCE) {
+            // Newton converges quadratically, so taking this last step
+            // without another pass leaves an error of about its square.
+            // After one painted point this is the only pass.
+            for (int j = 0; j < 3; ++j) {
+                accepted[j] -= step[j];
+            }
+            break;
+        }
+        for (int j = 0; j < 3; ++j) {
+            weights_[j] = accepted[j] - step[j];
+        }
+    }
+    std::copy(accepted, accepted + 3, weights_);
+    warm_ = true;
+}
+
+double LogisticOverlay::logit(double x, double y) const {
+    return weights_[0] + weights_[1] * (x - centre_[0]) / scale_[0] +
+           weights_[2] * (y - centre_[1]) / scale_[1];
+}
+
+double LogisticOverlay::probability(double x, double y) const {
+    if (!fitted_) {
+        return 0.5;
+    }
+    return 1.0 / (1.0 + std::exp(-logit(x, y)));
+}
+
+void LogisticOverlay::render(Terminal& terminal, const Viewport& viewport, const ClassPalette& palette,
+                             int start_row, int height, int width) const {
+    int rows = height - 2;  // Inside the edit area border
+    int cols = width - 2;
+    if (!fitted_ || rows <= 0 || cols <= 0) {
+        return;
+    }
+
+    // The log-odds are linear in the cell position
+    DataCoord origin = viewport.screen_to_data(ScreenCoord{0, 0});
+    DataCoord corner = viewport.screen_to_data(ScreenCoord{1, 1});
+    double z0 = logit(origin.x, origin.y);
+    double per_col = logit(corner.x, origin.y) - z0;
+    double per_row = logit(origin.x, corner.y) - z0;
+
+    // Line glyph from the line's direction (per_row, -per_col) in cells,
+    // counting a row as about two columns tall
+    double along_x = std::abs(per_row);
+    double along_y = 2.0 * std::abs(per_col);
+    char line = (per_col > 0.0) == (per_row > 0.0) ? '/' : '\\';
+    if (along_y < 0.414 * along_x) {
+        line = '-';
+    } else if (along_x < 0.414 * along_y) {
+        line = '|';
+    }
+    // Half a cell along the steeper axis: one connected cell per row or column
+    double line_width = std::max(std::abs(per_col), std::abs(per_row)) / 2.0;
+
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int screen_row = start_row + 1 + row;
+            int screen_col = 1 + col;
+            if (terminal.read_char(screen_row, screen_col) != ' ') {
+                continue;  // Points and forbidden cells show through
+            }
+            double z = z0 + per_col * col + per_row * row;
+            if (std::abs(z) <= line_width) {
+                terminal.write_char(screen_row, screen_col, line, Terminal::Color::YELLOW);
+            } else if (std::abs(z) < INNER_BAND) {
+                terminal.write_char(screen_row, screen_col, ':', side_color(z > 0.0 ? 1 : 0, palette));
+            } else if (std::abs(z) < OUTER_BAND) {
+                terminal.write_char(screen_row, screen_col, '.', side_color(z > 0.0 ? 1 : 0, palette));
+            }
+        }
+    }
+}
+
+}  // namespace datapainter
@@ -9,23 +9,44 @@
 #include "header_renderer.h"
 #include "footer_renderer.h"
 #include "edit_area_renderer.h"
+#include "class_palette.h"
+#include "viewport_frame.h"
 #include "table_selection_menu.h"
 #include "table_creation_dialog.h"
 #include "point_editor.h"
 #include "unsaved_changes.h"
 #include "save_manager.h"
+#include "stats_panel.h"
 #include "help_overlay.h"
 #include "cursor_utils.h"
 #include "random_dialog.h"
 #include "random_initializer.h"
 #include "table_view.h"
+#include "event_loop.h"
 #include "input_source.h"
+#include "csv_exporter.h"
+#include "rpc_client.h"
+#include "rpc_server.h"
+#include "frame_stats.h"
+#include "keystroke_profiler.h"
+#include "alloc_stats.h"
+#include "perf_hud.h"
+#include "kde_overlay.h"
+#include "kmeans_overlay.h"
+#include "knn_overlay.h"
+#include "logistic_overlay.h"
+#include "minimap.h"
+#include "snapshot_writer.h"
+#include "thread_pool.h"
+#include "sql_profiler.h"
+#include "tracer.h"
 #include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <thread>
 #include <chrono>
+#include <cstdlib>
 #include <limits>
 #include <memory>
 
@@ -37,6 +58,26 @@ enum class ViewMode {
     TABLE      // Tabular data editing mode
 };
 
+// Edit-area classes: the table's x/o meanings plus --class-style overrides
+ClassPalette make_class_palette(const Metadata& meta, const Arguments& args) {
+    ClassPalette palette(meta.x_meaning, meta.o_meaning);
+    for (const auto& spec : args.class_styles) {
+        std::string error;
+        palette.apply_spec(spec, error);  // Already validated by ArgumentParser
+    }
+    return palette;
+}
+
+// Edit-area drawing mode from --render-mode (already validated)
+EditAreaRenderer::Mode initial_render_mode(const Arguments& args) {
+    if (args.render_mode.has_value()) {
+        if (auto mode = EditAreaRenderer::parse_mode(*args.render_mode)) {
+            return *mode;
+        }
+    }
+    return EditAreaRenderer::Mode::POINTS;
+}
+
 // Render table view to terminal buffer
 void render_table_view(Terminal& term, const TableView& table_view,
                        int height) {
@@ -103,6 +144,11 @@ void render_table_view(Terminal& term, const TableView& table_view,
 }
 
 int main(int argc, char** argv) {
+    // DATAPAINTER_ALLOC_STATS builds: per-operation allocation table at exit
+    if (AllocStats::available()) {
+        std::atexit([]() { AllocStats::write_report_from_env(); });
+    }
+
     // Parse arguments
     Arguments args = ArgumentParser::parse(argc, argv);
 
@@ -135,10 +181,32 @@ int main(int argc, char** argv) {
         return 2;
     }
 
+    // --trace: record spans until main returns, then write the trace file
+    std::unique_ptr<TraceSession> trace_session;
+    if (args.trace_file.has_value()) {
+        trace_session = std::make_unique<TraceSession>(args.trace_file.value());
+    }
+
+    // --threads: size of the shared worker pool, before anything uses it
+    if (args.threads.has_value()) {
+        ThreadPool::set_shared_threads(args.threads.value());
+    }
+
+    // --backend ansi: bypass ncurses for every terminal opened below
+    if (args.terminal_backend.value_or("ncurses") == "ansi") {
+        Terminal::set_backend(Terminal::Backend::ANSI);
+    }
+
+    // --connect: forward the command to a running --serve daemon
+    if (args.connect_socket.has_value()) {
+        return RpcClient::run(args, std::cout, std::cerr);
+    }
+
     // Check if database is required
-    bool needs_database = args.create_table || args.rename_table || args.copy_table ||
+    bool needs_database = args.serve_socket.has_value() || args.create_table || args.rename_table || args.copy_table ||
                           args.delete_table || args.list_tables || args.show_metadata ||
                           args.add_point || args.delete_point || args.to_csv ||
+                          args.render_snapshot.has_value() ||
                           args.clear_undo_log || args.clear_all_undo_log ||
                           args.commit_unsaved_changes || args.list_unsaved_changes;
 
@@ -165,12 +233,34 @@ int main(int argc, char** argv) {
         return 65;
     }
 
+    // --profile-sql: trace every statement on this connection; the report
+    // is written when main returns, whichever path it takes
+    std::unique_ptr<SqlProfiler> sql_profiler;
+    if (args.profile_sql.has_value()) {
+        sql_profiler = std::make_unique<SqlProfiler>(db);
+        if (!sql_profiler->attach()) {
+            std::cerr << "Error: Failed to enable SQL profiling" << std::endl;
+            return 66;
+        }
+        sql_profiler->set_report_path(args.profile_sql.value());
+    }
+
     // Ensure system tables exist
     if (!db.ensure_metadata_table() || !db.ensure_unsaved_changes_table()) {
         std::cerr << "Error: Failed to create system tables" << std::endl;
         return 66;
     }
 
+    // --serve: keep the database open and answer requests until shutdown
+    if (args.serve_socket.has_value()) {
+        RpcServer server(db);
+        if (!server.serve(args.serve_socket.value(), std::cerr)) {
+            std::cerr << "Error: " << server.last_error() << std::endl;
+            return 66;
+        }
+        return 0;
+    }
+
     // Handle non-interactive commands
     TableManager table_mgr(db);
     UndoLogManager undo_mgr(db);
@@ -401,58 +491,62 @@ int main(int argc, char** argv) {
             return 2;
         }
 
-        // Query all points from the table
-        DataTable dt(db, args.table.value());
-        // Use a very large viewport to get all points
-        auto points = dt.query_viewport(-1e308, 1e308, -1e308, 1e308);
-
-        // Sort by id to ensure consistent order
-        std::sort(points.begin(), points.end(), [](const DataPoint& a, const DataPoint& b) {
-            return a.id < b.id;
-        });
-
-        // Output CSV header
-        std::cout << "x,y,target\n";
-
-        // Check for write error after header
-        if (std::cout.fail()) {
-            std::cerr << "Error: Failed to write CSV header" << std::endl;
-            return 67;
+        CsvExporter exporter(db, args.table.value());
+        if (!exporter.write(std::cout)) {
+            std::cerr << "Error: " << exporter.last_error() << std::endl;
+            return std::cout.fail() ? 67 : 66;
         }
 
-        // Output data rows
-        for (const auto& point : points) {
-            std::cout << point.x << "," << point.y << ",";
+        return 0;
+    }
 
-            // Escape target value if it contains special characters
-            std::string target = point.target;
-            bool needs_quotes = target.find(',') != std::string::npos ||
-                                target.find('"') != std::string::npos ||
-                                target.find('\n') != std::string::npos;
+    // --render-snapshot: whole valid range into a virtual canvas, no terminal
+    if (args.render_snapshot.has_value()) {
+        if (!args.table.has_value()) {
+            std::cerr << "Error: --table is required for --render-snapshot" << std::endl;
+            return 2;
+        }
 
-            if (needs_quotes) {
-                std::cout << "\"";
-                for (char c : target) {
-                    if (c == '"') {
-                        std::cout << "\"\"";  // Escape quotes by doubling them
-                    } else {
-                        std::cout << c;
-                    }
-                }
-                std::cout << "\"";
-            } else {
-                std::cout << target;
-            }
+        MetadataManager metadata_mgr(db);
+        auto meta_opt = metadata_mgr.read(args.table.value());
+        if (!meta_opt.has_value()) {
+            std::cerr << "Error: Table not found: " << args.table.value() << std::endl;
+            return 66;
+        }
+        Metadata meta = meta_opt.value();
 
-            std::cout << "\n";
+        double x_min = meta.valid_x_min.value_or(-10.0);
+        double x_max = meta.valid_x_max.value_or(10.0);
+        double y_min = meta.valid_y_min.value_or(-10.0);
+        double y_max = meta.valid_y_max.value_or(10.0);
+        auto size = SnapshotWriter::parse_size(*args.render_snapshot);  // Already validated
+        Viewport viewport(x_min, x_max, y_min, y_max,
+                          x_min, x_max, y_min, y_max,
+                          size->height, size->width);
 
-            // Check for write error after each row
-            if (std::cout.fail()) {
-                std::cerr << "Error: Failed to write CSV data" << std::endl;
+        DataTable data_table(db, args.table.value());
+        UnsavedChanges unsaved_changes_tracker(db);
+        std::vector<ChangeRecord> unsaved_changes = unsaved_changes_tracker.get_changes(args.table.value());
+        ClassPalette class_palette = make_class_palette(meta, args);
+
+        SnapshotWriter writer(data_table, class_palette);
+        writer.set_mode(initial_render_mode(args));
+        SnapshotWriter::Format format = SnapshotWriter::Format::TEXT;
+        std::ofstream file;
+        std::ostream* out = &std::cout;
+        if (args.snapshot_output.has_value()) {
+            format = SnapshotWriter::format_for_path(*args.snapshot_output);
+            file.open(*args.snapshot_output, std::ios::binary);
+            if (!file) {
+                std::cerr << "Error: Cannot open " << *args.snapshot_output << " for writing" << std::endl;
                 return 67;
             }
+            out = &file;
+        }
+        if (!writer.write(*out, viewport, unsaved_changes, format)) {
+            std::cerr << "Error: " << writer.last_error() << std::endl;
+            return 67;
         }
-
         return 0;
     }
 
@@ -537,71 +631,57 @@ int main(int argc, char** argv) {
         // Clear buffer
         terminal.clear_buffer();
 
-        // Query all data points
-        auto all_points = data_table.query_viewport(
-            viewport.data_x_min(), viewport.data_x_max(),
-            viewport.data_y_min(), viewport.data_y_max()
-        );
-
-        // Count points
-        int total_count = static_cast<int>(all_points.size());
-        int x_count = 0;
-        int o_count = 0;
-        for (const auto& pt : all_points) {
-            if (pt.target == meta.x_meaning) {
-                x_count++;
-            } else if (pt.target == meta.o_meaning) {
-                o_count++;
-            }
-        }
-
-        // Create renderers
-        HeaderRenderer header_renderer;
-        FooterRenderer footer_renderer;
-        EditAreaRenderer edit_area_renderer;
+        // Header and edit area, drawn as the interactive session draws them
+        ViewportFrame frame(terminal, data_table, unsaved_changes_tracker, args.database.value());
+        frame.edit_area().set_mode(initial_render_mode(args));
+        FooterRenderer& footer_renderer = frame.footer();
+        StatsPanel& stats_panel = frame.stats();
+        ClassPalette class_palette = make_class_palette(meta, args);
+        frame.draw_top(meta, class_palette, viewport, edit_area_start_row, edit_area_height,
+                       cursor_row, cursor_col, 0);
+        const std::vector<ChangeRecord>& unsaved_changes = frame.changes();
 
         // Get current cursor position in data coordinates
         ScreenCoord cursor_content{cursor_row - edit_area_start_row - 1, cursor_col - 1};
         DataCoord cursor_data = viewport.screen_to_data(cursor_content);
-
-        // Load unsaved changes for this table
-        std::vector<ChangeRecord> unsaved_changes = unsaved_changes_tracker.get_changes(args.table.value());
-
-        // Count active unsaved changes across all tables (for header display)
-        auto all_changes = unsaved_changes_tracker.get_all_changes();
-        int total_active_changes = 0;
-        for (const auto& change : all_changes) {
-            if (change.is_active) {
-                total_active_changes++;
+        if (args.show_kde) {
+            KdeOverlay kde_overlay;
+            kde_overlay.set_bandwidth(args.kde_bandwidth);
+            kde_overlay.ensure_loaded(data_table, class_palette, x_min, x_max, y_min, y_max);
+            kde_overlay.sync(data_table, unsaved_changes, class_palette);
+            kde_overlay.render(terminal, viewport, class_palette, edit_area_start_row,
+                               edit_area_height, screen_width);
+        }
+        if (args.show_logistic) {
+            LogisticOverlay logistic_overlay;
+            logistic_overlay.set_range(x_min, x_max, y_min, y_max);
+            logistic_overlay.sync(data_table, unsaved_changes, class_palette);
+            logistic_overlay.render(terminal, viewport, class_palette, edit_area_start_row,
+                                    edit_area_height, screen_width);
+            if (logistic_overlay.fitted()) {
+                footer_renderer.set_fit(logistic_overlay.accuracy(), logistic_overlay.loss());
             }
         }
-
-        // Count active unsaved changes for this table only (for footer display)
-        int table_active_changes = 0;
-        for (const auto& change : unsaved_changes) {
-            if (change.is_active) {
-                table_active_changes++;
-            }
+        if (args.knn.has_value()) {
+            KnnOverlay knn_overlay;
+            knn_overlay.set_k(*args.knn);
+            knn_overlay.sync(data_table, unsaved_changes, class_palette);
+            knn_overlay.render(terminal, viewport, class_palette, edit_area_start_row,
+                               edit_area_height, screen_width);
+        }
+        if (args.kmeans.has_value()) {
+            KmeansOverlay kmeans_overlay;
+            kmeans_overlay.set_k(*args.kmeans);
+            kmeans_overlay.run(data_table, unsaved_changes, class_palette, x_min, x_max, y_min, y_max);
+            kmeans_overlay.render(terminal, viewport, edit_area_start_row, edit_area_height, screen_width);
+        }
+        if (args.show_stats) {
+            stats_panel.ensure_table_loaded(data_table, class_palette);
+            stats_panel.render(terminal, class_palette, edit_area_start_row + 1, 1);
         }
-
-        // Render header
-        header_renderer.render(terminal, args.database.value(), meta.table_name,
-                              meta.target_col_name, meta.x_meaning, meta.o_meaning,
-                              total_count, x_count, o_count,
-                              x_min, x_max, y_min, y_max,
-                              viewport.data_x_min(), viewport.data_x_max(),
-                              viewport.data_y_min(), viewport.data_y_max(), 0, total_active_changes);
-
-        // Render edit area
-        edit_area_renderer.render(terminal, viewport, data_table, unsaved_changes,
-                                 edit_area_start_row, edit_area_height, screen_width,
-                                 cursor_row, cursor_col, meta.x_meaning, meta.o_meaning);
 
         // Render footer
-        footer_renderer.render(terminal, cursor_data.x, cursor_data.y,
-                              x_min, x_max, y_min, y_max,
-                              viewport.data_x_min(), viewport.data_x_max(),
-                              viewport.data_y_min(), viewport.data_y_max(), 0, table_active_changes);
+        frame.draw_footer(viewport, cursor_data.x, cursor_data.y, 0);
 
         // Output the buffer to stdout
         if (args.dump_screen) {
@@ -906,8 +986,10 @@ int main(int argc, char** argv) {
     }
 
     // Initialize terminal
+    // Headless sessions never look at the TTY: the screen is 24x80 unless overridden
     Terminal terminal;
-    if (!terminal.detect_size()) {
+    terminal.set_headless(args.headless);
+    if (!args.headless && !terminal.detect_size()) {
         std::cerr << "Warning: Could not detect terminal size, using defaults" << std::endl;
     }
     if (!terminal.is_size_adequate()) {
@@ -921,7 +1003,7 @@ int main(int argc, char** argv) {
         int override_width = args.override_screen_width.value();
 
         // Validate that overrides don't exceed actual terminal size
-        if (!terminal.validate_override_dimensions(override_height, override_width)) {
+        if (!args.headless && !terminal.validate_override_dimensions(override_height, override_width)) {
             std::cerr << "Error: Override dimensions (" << override_height << "x" << override_width
                       << ") exceed actual terminal size (" << terminal.actual_rows() << "x" << terminal.actual_cols() << ")"
                       << std::endl;
@@ -967,9 +1049,12 @@ int main(int argc, char** argv) {
         }
         input_source = std::move(file_source);
     } else {
-        // Use terminal input source for interactive mode
+        // Use terminal input source for interactive mode; read_key() sleeps
+        // in the event loop until a key, a resize or a timer
         input_source = std::make_unique<TerminalInputSource>(terminal);
     }
+    EventLoop event_loop;
+    terminal.set_event_loop(&event_loop);
 
     // Enter raw mode
     if (!terminal.enter_raw_mode()) {
@@ -980,7 +1065,7 @@ int main(int argc, char** argv) {
     // Calculate screen layout
     const int HEADER_ROWS = 3;  // Header takes 3 rows
     const int FOOTER_ROWS = 1;  // Footer takes 1 row
-    const int edit_area_height = screen_height - HEADER_ROWS - FOOTER_ROWS;
+    int edit_area_height = screen_height - HEADER_ROWS - FOOTER_ROWS;  // Changes on resize
     const int edit_area_start_row = HEADER_ROWS;
 
     // Helper lambda to convert cursor position from screen coordinates to edit area content coordinates
@@ -1010,102 +1095,268 @@ int main(int argc, char** argv) {
     ViewMode view_mode = ViewMode::VIEWPORT;
     TableView* table_view = nullptr;  // Lazy initialize when needed
 
-    while (running) {
-        if (needs_redraw) {
-            // Clear buffer
-            terminal.clear_buffer();
-
-            if (view_mode == ViewMode::VIEWPORT) {
-                // Viewport mode - render the normal UI
-                // Query all data points
-                auto all_points = data_table.query_viewport(
-                    viewport.data_x_min(), viewport.data_x_max(),
-                    viewport.data_y_min(), viewport.data_y_max()
-                );
-
-                // Count points
-                int total_count = static_cast<int>(all_points.size());
-                int x_count = 0;
-                int o_count = 0;
-                for (const auto& pt : all_points) {
-                    if (pt.target == meta.x_meaning) {
-                        x_count++;
-                    } else if (pt.target == meta.o_meaning) {
-                        o_count++;
-                    }
-                }
+    // Performance HUD ('p'): shows the stats of the last completed frame
+    bool show_perf_hud = false;
+    PerfHud perf_hud;
+
+    // Overview minimap ('M'): loaded on first show, then kept in step with
+    // the journal
+    bool show_minimap = args.show_minimap;
+    Minimap minimap;
+
+    // Header, edit area and footer. The renderers live across frames so
+    // their row buffers are reused.
+    ViewportFrame frame(terminal, data_table, unsaved_changes_tracker, args.database.value());
+    FooterRenderer& footer_renderer = frame.footer();
+    EditAreaRenderer& edit_area_renderer = frame.edit_area();
+    edit_area_renderer.set_mode(initial_render_mode(args));
+
+    // Class statistics panel ('i'). Its viewport sums also give the header
+    // its counts, so they follow the viewport and journal even when hidden;
+    // the whole-table sums are queried on first show.
+    bool show_stats = args.show_stats;
+    StatsPanel& stats_panel = frame.stats();
+
+    // k-NN decision regions ('n'): the tree is built on first show and then
+    // follows the journal, so an edit costs one tree update
+    bool show_knn = args.knn.has_value();
+    KnnOverlay knn_overlay;
+    knn_overlay.set_k(args.knn.value_or(KnnOverlay::DEFAULT_K));
+
+    // Logistic regression line and bands ('l'), refitted from the previous
+    // weights after each edit
+    bool show_logistic = args.show_logistic;
+    LogisticOverlay logistic_overlay;
+
+    // Class density contours ('c'): counts are loaded on first show and then
+    // follow the journal; '[' and ']' scale the kernel width
+    bool show_kde = args.show_kde;
+    KdeOverlay kde_overlay;
+    kde_overlay.set_bandwidth(args.kde_bandwidth);
+
+    // k-means suggestions ('C' runs and hides, 'A' applies): shown until the
+    // points change
+    KmeansOverlay kmeans_overlay;
+    kmeans_overlay.set_k(args.kmeans.value_or(KmeansOverlay::DEFAULT_K));
+    // Outcome of 'A', on the bottom border until the next key or for a few
+    // seconds, whichever comes first
+    std::string kmeans_notice;
+    int kmeans_notice_timer = 0;
+    FrameStats hud_stats = FrameStats::instance();
+
+    ClassPalette class_palette = make_class_palette(meta, args);
+    if (args.kmeans.has_value()) {
+        kmeans_overlay.run(data_table, unsaved_changes_tracker.get_changes(table_name), class_palette,
+                           x_min, x_max, y_min, y_max);
+    }
 
-                // Create renderers
-                HeaderRenderer header_renderer;
-                FooterRenderer footer_renderer;
-                EditAreaRenderer edit_area_renderer;
+    // Terminal resized: reallocate only the frame buffers and rescale the
+    // viewport's screen mapping. The data window, renderers (with their tick
+    // caches), table view and journal are kept, so the next frame just
+    // rebins the same points into the new grid.
+    auto apply_resize = [&]() {
+        TraceSpan resize_span("EventLoop::resize");
+        DataCoord cursor_data = viewport.screen_to_data(cursor_to_content_coords(cursor_row, cursor_col));
+
+        terminal.detect_size();
+        if (args.override_screen_height.has_value() && args.override_screen_width.has_value() &&
+            terminal.validate_override_dimensions(args.override_screen_height.value(),
+                                                  args.override_screen_width.value())) {
+            terminal.set_dimensions(args.override_screen_height.value(), args.override_screen_width.value());
+        }
+        if (terminal.rows() == screen_height && terminal.cols() == screen_width) {
+            return;
+        }
+
+        screen_height = terminal.rows();
+        screen_width = terminal.cols();
+        edit_area_height = screen_height - HEADER_ROWS - FOOTER_ROWS;
+        viewport.set_screen_size(screen_height, screen_width);
+
+        // Keep the cursor on the same data point, inside the new edit area
+        int content_row = (edit_area_height - 2) / 2;
+        int content_col = (screen_width - 2) / 2;
+        if (auto screen = viewport.data_to_screen(cursor_data)) {
+            content_row = screen->row;
+            content_col = screen->col;
+        }
+        cursor_row = edit_area_start_row + 1 + std::max(0, std::min(content_row, edit_area_height - 3));
+        cursor_col = 1 + std::max(0, std::min(content_col, screen_width - 3));
+    };
 
-                // Get current cursor position in data coordinates
-                ScreenCoord cursor_content = cursor_to_content_coords(cursor_row, cursor_col);
-                DataCoord cursor_data = viewport.screen_to_data(cursor_content);
+    // Draw the current state into the terminal buffer and present it
+    auto draw_frame = [&]() {
+        TraceSpan frame_span("EventLoop::draw_frame");
+        AllocScope frame_allocs("EventLoop::draw_frame");
 
-                // Load unsaved changes for this table
-                std::vector<ChangeRecord> unsaved_changes = unsaved_changes_tracker.get_changes(table_name);
+        // Clear buffer
+        terminal.clear_buffer();
 
-                // Count active unsaved changes across all tables (for header display)
-                auto all_changes = unsaved_changes_tracker.get_all_changes();
-                int total_active_changes = 0;
-                for (const auto& change : all_changes) {
-                    if (change.is_active) {
-                        total_active_changes++;
-                    }
-                }
+        if (!terminal.is_size_adequate()) {
+            // Shrunk below the minimum layout; wait for the next resize
+            const char* message = "Terminal too small";
+            for (int col = 0; message[col] != '\0'; ++col) {
+                terminal.write_char(0, col, message[col]);
+            }
+            terminal.render();
+            return;
+        }
 
-                // Count active unsaved changes for this table only (for footer display)
-                int table_active_changes = 0;
-                for (const auto& change : unsaved_changes) {
-                    if (change.is_active) {
-                        table_active_changes++;
-                    }
+        if (view_mode == ViewMode::VIEWPORT) {
+            // Viewport mode - render the normal UI
+            // Get current cursor position in data coordinates
+            ScreenCoord cursor_content = cursor_to_content_coords(cursor_row, cursor_col);
+            DataCoord cursor_data = viewport.screen_to_data(cursor_content);
+
+            frame.draw_top(meta, class_palette, viewport, edit_area_start_row, edit_area_height,
+                           cursor_row, cursor_col, focused_field);
+            const std::vector<ChangeRecord>& unsaved_changes = frame.changes();
+
+            if (show_kde) {
+                kde_overlay.ensure_loaded(data_table, class_palette, x_min, x_max, y_min, y_max);
+                kde_overlay.sync(data_table, unsaved_changes, class_palette);
+                kde_overlay.render(terminal, viewport, class_palette, edit_area_start_row,
+                                   edit_area_height, screen_width);
+            }
+            if (show_logistic) {
+                logistic_overlay.set_range(x_min, x_max, y_min, y_max);
+                logistic_overlay.sync(data_table, unsaved_changes, class_palette);
+                logistic_overlay.render(terminal, viewport, class_palette, edit_area_start_row,
+                                        edit_area_height, screen_width);
+                if (logistic_overlay.fitted()) {
+                    footer_renderer.set_fit(logistic_overlay.accuracy(), logistic_overlay.loss());
                 }
+            }
+            if (show_knn) {
+                knn_overlay.sync(data_table, unsaved_changes, class_palette);
+                knn_overlay.render(terminal, viewport, class_palette, edit_area_start_row,
+                                   edit_area_height, screen_width);
+            }
+            if (kmeans_overlay.has_result()) {
+                kmeans_overlay.sync(data_table, unsaved_changes, class_palette);
+                kmeans_overlay.render(terminal, viewport, edit_area_start_row, edit_area_height, screen_width);
+            }
+            if (!kmeans_notice.empty()) {
+                EditAreaRenderer::draw_border_label(terminal, edit_area_start_row + edit_area_height - 1,
+                                                    screen_width, kmeans_notice);
+            }
 
-                // Render header
-                header_renderer.render(terminal, args.database.value(), meta.table_name,
-                                      meta.target_col_name, meta.x_meaning, meta.o_meaning,
-                                      total_count, x_count, o_count,
-                                      x_min, x_max, y_min, y_max,
-                                      viewport.data_x_min(), viewport.data_x_max(),
-                                      viewport.data_y_min(), viewport.data_y_max(), focused_field, total_active_changes);
-
-                // Render edit area
-                edit_area_renderer.render(terminal, viewport, data_table, unsaved_changes,
-                                         edit_area_start_row, edit_area_height, screen_width,
-                                         cursor_row, cursor_col, meta.x_meaning, meta.o_meaning);
-
-                // Render footer
-                footer_renderer.render(terminal, cursor_data.x, cursor_data.y,
-                                      x_min, x_max, y_min, y_max,
-                                      viewport.data_x_min(), viewport.data_x_max(),
-                                      viewport.data_y_min(), viewport.data_y_max(), focused_button, table_active_changes);
-
-                // Display to screen with cursor
-                terminal.render_with_cursor(cursor_row, cursor_col);
-            } else {
-                // Table view mode - render table view
-                if (table_view != nullptr) {
+            // Render footer
+            frame.draw_footer(viewport, cursor_data.x, cursor_data.y, focused_button);
+
+            // Minimap in the bottom-right corner of the edit area, if it fits
+            if (show_minimap && edit_area_height >= Minimap::HEIGHT + 2 &&
+                screen_width >= Minimap::WIDTH + 2) {
+                minimap.ensure_loaded(data_table, x_min, x_max, y_min, y_max);
+                minimap.sync(data_table, unsaved_changes);
+                minimap.render(terminal, viewport,
+                               edit_area_start_row + edit_area_height - 1 - Minimap::HEIGHT,
+                               screen_width - 1 - Minimap::WIDTH);
+            }
+
+            // Statistics panel in the top-left corner of the edit area, if
+            // it fits across
+            if (show_stats && screen_width >= StatsPanel::WIDTH + 2) {
+                stats_panel.ensure_table_loaded(data_table, class_palette);
+                stats_panel.render(terminal, class_palette, edit_area_start_row + 1, 1);
+            }
+
+            if (show_perf_hud) {
+                perf_hud.render(terminal, hud_stats, edit_area_start_row + 1);
+            }
+
+            // Display to screen with cursor
+            terminal.render_with_cursor(cursor_row, cursor_col);
+        } else {
+            // Table view mode - render table view
+            if (table_view != nullptr) {
+                {
+                    PhaseTimer table_timer(Phase::EDIT_AREA);
                     render_table_view(terminal, *table_view, screen_height);
-                    terminal.render_with_cursor(cursor_row, cursor_col);
                 }
+                if (show_perf_hud) {
+                    perf_hud.render(terminal, hud_stats, 1);
+                }
+                terminal.render_with_cursor(cursor_row, cursor_col);
+            }
+        }
+
+        if (show_perf_hud) {
+            int cache_hits = 0;
+            int cache_misses = 0;
+            if (db.page_cache_usage(cache_hits, cache_misses, true)) {
+                FrameStats::instance().add_cache_usage(cache_hits, cache_misses);
             }
+            AllocCounters allocs = frame_allocs.delta();
+            FrameStats::instance().set_allocations(allocs.allocations, allocs.bytes);
+            hud_stats = FrameStats::instance();
+        }
+    };
+
+    // --fast-replay applies keystrokes without drawing; frames are only
+    // produced at checkpoints (<render>, <dump>, k/K) and after the last key
+    auto is_render_checkpoint = [](int key) {
+        return key == 'k' || key == 'K' || key == Terminal::KEY_DUMP_SCREEN ||
+               key == Terminal::KEY_DUMP_EDIT_AREA || key == Terminal::KEY_RENDER ||
+               key == -1;
+    };
 
+    // --profile-keystrokes: each sample covers handling one key plus the
+    // frame drawn for it, so it is recorded just before the next key is read
+    std::unique_ptr<KeystrokeProfiler> keystroke_profiler;
+    int profiled_key = -1;
+    if (args.profile_keystrokes.has_value()) {
+        keystroke_profiler = std::make_unique<KeystrokeProfiler>();
+        FrameStats::set_enabled(true);
+    }
+
+    while (running) {
+        if (needs_redraw && !args.fast_replay) {
+            draw_frame();
             needs_redraw = false;
         }
 
+        if (FrameStats::enabled()) {
+            if (keystroke_profiler && profiled_key != -1) {
+                keystroke_profiler->record(profiled_key, FrameStats::instance());
+            }
+            FrameStats::instance().reset();
+        }
+
         // Read keyboard input
         int key = input_source->read_key();
+        profiled_key = key;
+        if (needs_redraw && args.fast_replay && is_render_checkpoint(key)) {
+            draw_frame();
+            needs_redraw = false;
+        }
         if (key == -1) {
             // EOF from file source - exit gracefully
             running = false;
             continue;
         }
         if (key >= 0) {
+            TraceSpan key_span("EventLoop::handle_key");
+            AllocScope key_allocs("EventLoop::handle_key");
+            PhaseTimer input_timer(Phase::INPUT);
+            if (!kmeans_notice.empty()) {
+                kmeans_notice.clear();
+                event_loop.cancel_timer(kmeans_notice_timer);
+                needs_redraw = true;
+            }
+
+            if (key == Terminal::KEY_RESIZE) {
+                if (!args.headless) {
+                    apply_resize();
+                }
+                needs_redraw = true;
+            }
+            // Timers ran in the event loop
+            else if (key == Terminal::KEY_WAKE) {
+                needs_redraw = true;
+            }
             // Handle arrow keys (from ncurses or our own codes)
-            if (key == Terminal::KEY_UP_ARROW) {
+            else if (key == Terminal::KEY_UP_ARROW) {
                 if (view_mode == ViewMode::TABLE && table_view != nullptr) {
                     // Table mode - navigate up
                     table_view->move_up();
@@ -1217,6 +1468,22 @@ int main(int argc, char** argv) {
                     running = false;
                 } else {
                     // Unsaved changes exist, show confirmation dialog
+                    // Headless sessions take the answer from the script
+                    if (args.headless) {
+                        int choice = input_source->read_key();
+                        if (choice == 'y' || choice == 'Y') {
+                            SaveManager save_manager(db, table_name);
+                            running = !save_manager.save();
+                        } else if (choice == 'n' || choice == 'N') {
+                            unsaved_changes_tracker.clear_all_changes();
+                            running = false;
+                        } else if (choice == -1) {
+                            running = false;  // Script ended; leave changes in the journal
+                        }
+                        needs_redraw = true;
+                        continue;
+                    }
+
                     // Exit raw mode temporarily to show dialog
                     terminal.exit_raw_mode();
 
@@ -1415,6 +1682,77 @@ int main(int argc, char** argv) {
                     needs_redraw = true;
                 }
             }
+            else if (key == 'p') {
+                // Toggle performance HUD; stats are only collected while it
+                // is shown (or while profiling keystrokes)
+                show_perf_hud = !show_perf_hud;
+                FrameStats::set_enabled(show_perf_hud || keystroke_profiler != nullptr);
+                if (show_perf_hud) {
+                    int cache_hits = 0;
+                    int cache_misses = 0;
+                    db.page_cache_usage(cache_hits, cache_misses, true);
+                    FrameStats::instance().reset();
+                    hud_stats = FrameStats::instance();
+                }
+                needs_redraw = true;
+            }
+            else if (key == 'm') {
+                // Cycle edit-area drawing mode
+                edit_area_renderer.set_mode(EditAreaRenderer::next_mode(edit_area_renderer.mode()));
+                needs_redraw = true;
+            }
+            else if (key == 'M') {
+                show_minimap = !show_minimap;
+                needs_redraw = true;
+            }
+            else if (key == 'i') {
+                show_stats = !show_stats;
+                needs_redraw = true;
+            }
+            else if (key == 'n') {
+                show_knn = !show_knn;
+                needs_redraw = true;
+            }
+            else if (key == 'l') {
+                show_logistic = !show_logistic;
+                needs_redraw = true;
+            }
+            else if (key == 'c') {
+                show_kde = !show_kde;
+                needs_redraw = true;
+            }
+            else if ((key == '[' || key == ']') && show_kde) {
+                kde_overlay.scale_bandwidth(key == '[' ? 1.0 / 1.5 : 1.5);
+                needs_redraw = true;
+            }
+            else if (key == 'C') {
+                if (kmeans_overlay.has_result()) {
+                    kmeans_overlay.clear();
+                } else {
+                    kmeans_overlay.run(data_table, unsaved_changes_tracker.get_changes(table_name),
+                                       class_palette, x_min, x_max, y_min, y_max);
+                }
+                needs_redraw = true;
+            }
+            else if (key == 'A' && kmeans_overlay.has_result()) {
+                // Convert each point to its cluster's majority class
+                std::optional<int> converted = kmeans_overlay.apply(db, table_name, class_palette);
+                if (converted.has_value()) {
+                    kmeans_notice = " k-means converted " + std::to_string(*converted) +
+                                    (*converted == 1 ? " point " : " points ");
+                    kmeans_notice_timer = event_loop.add_timer(std::chrono::seconds(4),
+                                                               [&] { kmeans_notice.clear(); });
+                } else if (args.headless) {
+                    std::cerr << "Error: Failed to record the k-means conversions" << std::endl;
+                } else {
+                    terminal.exit_raw_mode();
+                    std::cerr << "Error: Failed to record the k-means conversions" << std::endl;
+                    std::cerr << "Press Enter to continue..." << std::endl;
+                    std::cin.get();
+                    terminal.enter_raw_mode();
+                }
+                needs_redraw = true;
+            }
             else if (key == '?') {
                 // Show help overlay
                 HelpOverlay help;
@@ -1436,12 +1774,12 @@ int main(int argc, char** argv) {
                 terminal.render_with_cursor(cursor_row, cursor_col);
 
                 // Wait for any key press to dismiss
-                terminal.read_key();
+                input_source->read_key();
 
                 // Redraw the main UI after dismissing help
                 needs_redraw = true;
             }
-            else if (key == 'k') {
+            else if (key == 'k' || key == Terminal::KEY_DUMP_SCREEN) {
                 // Dump full screen to stdout
                 // Exit raw mode to output cleanly
                 terminal.exit_raw_mode();
@@ -1456,7 +1794,7 @@ int main(int argc, char** argv) {
                 terminal.enter_raw_mode();
                 needs_redraw = true;
             }
-            else if (key == 'K') {
+            else if (key == 'K' || key == Terminal::KEY_DUMP_EDIT_AREA) {
                 // Dump edit area only to stdout
                 // Exit raw mode to output cleanly
                 terminal.exit_raw_mode();
@@ -1480,6 +1818,8 @@ int main(int argc, char** argv) {
                 if (save_success) {
                     // Save successful, redraw to update unsaved count
                     needs_redraw = true;
+                } else if (args.headless) {
+                    std::cerr << "Error: Failed to save changes to database" << std::endl;
                 } else {
                     // Save failed - show error message
                     terminal.exit_raw_mode();
@@ -1490,8 +1830,8 @@ int main(int argc, char** argv) {
                     needs_redraw = true;
                 }
             }
-            else if (key == 'r' || key == 'R') {
-                // Random point generation
+            else if ((key == 'r' || key == 'R') && !args.headless) {
+                // Random point generation (the dialog prompts on stdin, so not headless)
                 terminal.exit_raw_mode();
 
                 // Get metadata for meanings
@@ -1531,6 +1871,14 @@ int main(int argc, char** argv) {
                     }
 
                     bool success = ri.generate(config);
+                    // Written straight to the table, so no journal change
+                    // tells the cached views about the new points
+                    stats_panel.invalidate();
+                    minimap.invalidate();
+                    kde_overlay.invalidate();
+                    knn_overlay.invalidate();
+                    logistic_overlay.invalidate();
+                    kmeans_overlay.invalidate();
                     if (success) {
                         std::cout << "Successfully generated " << config.count << " points." << std::endl;
                     } else {
@@ -1557,8 +1905,10 @@ int main(int argc, char** argv) {
             }
         }
 
-        // Small delay to prevent busy-waiting
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        // Terminal input blocks in poll(); only pace visible keystroke-file replays
+        if (args.keystroke_file.has_value() && !args.headless && !args.fast_replay) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
     }
 
     // Exit raw mode
@@ -1567,6 +1917,24 @@ int main(int argc, char** argv) {
     // Cleanup
     delete table_view;
 
+    if (keystroke_profiler) {
+        // The last key (usually 'q') ends the loop before it is recorded;
+        // at EOF the final fast-replay frame is reported as "<end>"
+        if (profiled_key != -1 || FrameStats::instance().total_ms() > 0.0) {
+            keystroke_profiler->record(profiled_key, FrameStats::instance());
+        }
+        if (!keystroke_profiler->write_report(args.profile_keystrokes.value())) {
+            std::cerr << "Error: Failed to write keystroke profile: "
+                      << args.profile_keystrokes.value() << std::endl;
+            return 67;
+        }
+    }
+
+    // Headless output is just the requested frame dumps
+    if (args.headless) {
+        return 0;
+    }
+
     // Clear screen and show exit message
     std::cout << "\033[2J\033[H";  // Clear screen
     std::cout << "DataPainter exited successfully." << std::endl;
@@ -0,0 +1,116 @@
+#include "minimap.h"
+#include "class_palette.h"
+#include "edit_area_renderer.h"
+#include "tracer.h"
+#include <algorithm>
+
+namespace datapainter {
+
+void Minimap::ensure_loaded(DataTable& table, double x_min, double x_max, double y_min, double y_max) {
+    if (loaded_ && x_min == x_min_ && x_max == x_max_ && y_min == y_min_ && y_max == y_max_) {
+        return;
+    }
+    TraceSpan span("Minimap::load");
+    x_min_ = x_min;
+    x_max_ = x_max;
+    y_min_ = y_min;
+    y_max_ = y_max;
+    std::fill(counts_.begin(), counts_.end(), 0);
+    for (const auto& bin : table.count_in_bins(x_min, x_max, y_min, y_max, ROWS, COLS)) {
+        counts_[static_cast<size_t>(bin.row) * COLS + bin.col] += bin.count;
+    }
+    // The query saw only saved points, so every journal change applies anew
+    journal_.clear();
+    loaded_ = true;
+}
+
+void Minimap::sync(DataTable& table, const std::vector<ChangeRecord>& changes) {
+    if (!loaded_) {
+        return;
+    }
+    journal_.sync(
+        table, changes, [](const std::string&) { return 0; },
+        [&](const JournalDiff::Effect& effect, int sign) {
+            int row = 0;
+            int col = 0;
+            if (cell_of(effect.x, effect.y, row, col)) {
+                int delta = (effect.added != ClassPalette::NO_CLASS) - (effect.removed != ClassPalette::NO_CLASS);
+                counts_[static_cast<size_t>(row) * COLS + col] += sign * delta;
+            }
+        });
+}
+
+bool Minimap::cell_of(double x, double y, int& row, int& col) const {
+    if (!(x >= x_min_ && x <= x_max_ && y >= y_min_ && y <= y_max_) ||
+        x_max_ <= x_min_ || y_max_ <= y_min_) {
+        return false;
+    }
+    col = std::min(static_cast<int>((x - x_min_) * COLS / (x_max_ - x_min_)), COLS - 1);
+    row = std::min(static_cast<int>((y_max_ - y) * ROWS / (y_max_ - y_min_)), ROWS - 1);
+    return true;
+}
+
+void Minimap::render(Terminal& terminal, const Viewport& viewport, int top_row, int left_col) const {
+    // Border, titled like the perf HUD
+    std::string top = "+- map " + std::string(WIDTH - 8, '-') + "+";
+    for (int col = 0; col < WIDTH; ++col) {
+        terminal.write_char(top_row, left_col + col, top[static_cast<size_t>(col)]);
+        terminal.write_char(top_row + HEIGHT - 1, left_col + col, col == 0 || col == WIDTH - 1 ? '+' : '-');
+    }
+    for (int row = 1; row < HEIGHT - 1; ++row) {
+        terminal.write_char(top_row + row, left_col, '|');
+        terminal.write_char(top_row + row, left_col + WIDTH - 1, '|');
+    }
+
+    // Density on the same log ramp as the edit area's density mode
+    int max_count = *std::max_element(counts_.begin(), counts_.end());
+    EditAreaRenderer::DensityScale scale(static_cast<uint32_t>(std::max(max_count, 0)));
+    for (int row = 0; row < ROWS; ++row) {
+        for (int col = 0; col < COLS; ++col) {
+            int count = count_at(row, col);
+            int screen_row = top_row + 1 + row;
+            int screen_col = left_col + 1 + col;
+            if (count <= 0) {
+                terminal.write_char(screen_row, screen_col, ' ');
+                continue;
+            }
+            int level = scale.level(static_cast<uint32_t>(count));
+            terminal.write_glyph(screen_row, screen_col, EditAreaRenderer::density_glyph(level),
+                                 EditAreaRenderer::density_fallback(level), Terminal::Color::DEFAULT);
+        }
+    }
+
+    // Viewport outline in yellow, clipped to the valid range
+    double x_lo = std::max(viewport.data_x_min(), x_min_);
+    double x_hi = std::min(viewport.data_x_max(), x_max_);
+    double y_lo = std::max(viewport.data_y_min(), y_min_);
+    double y_hi = std::min(viewport.data_y_max(), y_max_);
+    int r0 = 0;
+    int c0 = 0;
+    int r1 = 0;
+    int c1 = 0;
+    if (x_lo > x_hi || y_lo > y_hi || !cell_of(x_lo, y_hi, r0, c0) || !cell_of(x_hi, y_lo, r1, c1)) {
+        return;
+    }
+    for (int row = r0; row <= r1; ++row) {
+        for (int col = c0; col <= c1; ++col) {
+            bool edge_row = row == r0 || row == r1;
+            bool edge_col = col == c0 || col == c1;
+            if (!edge_row && !edge_col) {
+                continue;
+            }
+            // Occupied cells keep their shade and only take the outline colour
+            int screen_row = top_row + 1 + row;
+            int screen_col = left_col + 1 + col;
+            if (count_at(row, col) > 0) {
+                terminal.write_glyph(screen_row, screen_col, terminal.read_glyph(screen_row, screen_col),
+                                     terminal.read_char(screen_row, screen_col), Terminal::Color::YELLOW);
+                continue;
+            }
+            char ch = edge_row && edge_col ? '+' : (edge_row ? '-' : '|');
+            terminal.write_char(screen_row, screen_col, ch, Terminal::Color::YELLOW);
+        }
+    }
+}
+
+}  // namespace datapainter
@@ -0,0 +1,57 @@
+#include "moments.h"
+#include <algorithm>
+
+namespace datapainter {
+
+void Moments::add(double dx, double dy, int sign) {
+    count += sign;
+    sum_x += sign * dx;
+    sum_y += sign * dy;
+    sum_xx += sign * dx * dx;
+    sum_yy += sign * dy * dy;
+    sum_xy += sign * dx * dy;
+}
+
+void Moments::add(const TargetSums& sums, int sign) {
+    count += sign * sums.count;
+    sum_x += sign * sums.sum_x;
+    sum_y += sign * sums.sum_y;
+    sum_xx += sign * sums.sum_xx;
+    sum_yy += sign * sums.sum_yy;
+    sum_xy += sign * sums.sum_xy;
+}
+
+void Moments::add(const Moments& other, int sign) {
+    count += sign * other.count;
+    sum_x += sign * other.sum_x;
+    sum_y += sign * other.sum_y;
+    sum_xx += sign * other.sum_xx;
+    sum_yy += sign * other.sum_yy;
+    sum_xy += sign * other.sum_xy;
+}
+
+double Moments::var_x() const {
+    if (count < 2) {
+        return 0.0;
+    }
+    double n = static_cast<double>(count);
+    return std::max(0.0, (sum_xx - sum_x * sum_x / n) / (n - 1.0));
+}
+
+double Moments::var_y() const {
+    if (count < 2) {
+        return 0.0;
+    }
+    double n = static_cast<double>(count);
+    return std::max(0.0, (sum_yy - sum_y * sum_y / n) / (n - 1.0));
+}
+
+double Moments::cov_xy() const {
+    if (count < 2) {
+        return 0.0;
+    }
+    double n = static_cast<double>(count);
+    return (sum_xy - sum_x * sum_y / n) / (n - 1.0);
+}
+
+}  // namespace datapainter
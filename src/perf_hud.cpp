@@ -0,0 +1,66 @@
+#include "perf_hud.h"
+#include "alloc_stats.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace datapainter {
+
+std::vector<std::string> PerfHud::get_lines(const FrameStats& stats) const {
+    std::vector<std::string> lines;
+    char line[WIDTH + 8];
+
+    auto add = [&](const char* text) {
+        std::string padded = std::string("| ") + text;
+        padded.resize(WIDTH - 1, ' ');
+        padded += '|';
+        lines.push_back(padded);
+    };
+    std::string border = "+" + std::string(WIDTH - 2, '-') + "+";
+
+    lines.push_back("+- perf (last frame) " + std::string(WIDTH - 22, '-') + "+");
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        Phase phase = static_cast<Phase>(i);
+        std::snprintf(line, sizeof(line), "%-10s %10.3f ms", phase_name(phase), stats.phase_ms(phase));
+        add(line);
+    }
+    std::snprintf(line, sizeof(line), "%-10s %10.3f ms", "total", stats.total_ms());
+    add(line);
+    lines.push_back(border);
+
+    std::snprintf(line, sizeof(line), "%-10s %10zu", "points", stats.points_fetched());
+    add(line);
+    std::snprintf(line, sizeof(line), "%-10s %10zu", "cells", stats.cells_written());
+    add(line);
+    std::snprintf(line, sizeof(line), "%-10s %10zu", "journal", stats.journal_length());
+    add(line);
+    double hit_rate = stats.cache_hit_rate();
+    if (hit_rate < 0.0) {
+        std::snprintf(line, sizeof(line), "%-10s %10s", "cache hit", "n/a");
+    } else {
+        std::snprintf(line, sizeof(line), "%-10s %9.1f%%", "cache hit", hit_rate * 100.0);
+    }
+    add(line);
+    if (AllocStats::available()) {
+        std::snprintf(line, sizeof(line), "%-10s %10zu", "allocs", stats.allocations());
+        add(line);
+    }
+    lines.push_back(border);
+    return lines;
+}
+
+void PerfHud::render(Terminal& terminal, const FrameStats& stats, int top_row) const {
+    auto lines = get_lines(stats);
+    int left = std::max(0, terminal.cols() - WIDTH);
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        int row = top_row + static_cast<int>(i);
+        if (row >= terminal.rows()) {
+            break;
+        }
+        for (int col = 0; col < WIDTH && left + col < terminal.cols(); ++col) {
+            terminal.write_char(row, left + col, lines[i][col]);
+        }
+    }
+}
+
+}  // namespace datapainter
@@ -0,0 +1,210 @@
+#include "rpc_client.h"
+#include "rpc_server.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace datapainter {
+
+RpcClient::RpcClient(const std::string& socket_path)
+    : socket_path_(socket_path), fd_(-1) {}
+
+RpcClient::~RpcClient() {
+#ifndef _WIN32
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+#endif
+}
+
+#ifdef _WIN32
+
+bool RpcClient::connect() {
+    error_ = "--connect is not supported on this platform";
+    return false;
+}
+
+std::optional<std::string> RpcClient::call(const std::string& payload) {
+    (void)payload;
+    error_ = "--connect is not supported on this platform";
+    return std::nullopt;
+}
+
+#else
+
+bool RpcClient::connect() {
+    sockaddr_un addr{};
+    if (socket_path_.empty() || socket_path_.size() >= sizeof(addr.sun_path)) {
+        error_ = "Socket path is empty or too long: " + socket_path_;
+        return false;
+    }
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        error_ = std::string("socket() failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    // A server that goes away mid-request must be an error, not a kill
+    signal(SIGPIPE, SIG_IGN);
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+    if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        error_ = "Failed to connect to " + socket_path_ + ": " + std::strerror(errno);
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::string> RpcClient::call(const std::string& payload) {
+    if (fd_ < 0) {
+        error_ = "Not connected";
+        return std::nullopt;
+    }
+
+    std::string frame = RpcServer::encode_frame(payload);
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t n = write(fd_, frame.data() + sent, frame.size() - sent);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            error_ = std::string("Failed to send request: ") + std::strerror(errno);
+            return std::nullopt;
+        }
+        sent += static_cast<size_t>(n);
+    }
+
+    std::string buffer;
+    std::string response;
+    char buf[65536];
+    while (!RpcServer::extract_frame(buffer, response)) {
+        ssize_t n = read(fd_, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            error_ = "Connection closed before a response was received";
+            return std::nullopt;
+        }
+        buffer.append(buf, static_cast<size_t>(n));
+    }
+    return response;
+}
+
+#endif
+
+std::optional<JsonValue> RpcClient::build_request(const Arguments& args, std::string& error) {
+    std::string method;
+    JsonValue params = JsonValue::object();
+
+    if (args.list_tables) {
+        method = "list_tables";
+    } else if (args.create_table) {
+        method = "create_table";
+        if (args.target_column_name) params.set("target_column_name", *args.target_column_name);
+        if (args.x_axis_name) params.set("x_axis_name", *args.x_axis_name);
+        if (args.y_axis_name) params.set("y_axis_name", *args.y_axis_name);
+        if (args.x_meaning) params.set("x_meaning", *args.x_meaning);
+        if (args.o_meaning) params.set("o_meaning", *args.o_meaning);
+        if (args.min_x) params.set("min_x", *args.min_x);
+        if (args.max_x) params.set("max_x", *args.max_x);
+        if (args.min_y) params.set("min_y", *args.min_y);
+        if (args.max_y) params.set("max_y", *args.max_y);
+        params.set("show_zero_bars", args.show_zero_bars);
+    } else if (args.show_metadata) {
+        method = "show_metadata";
+    } else if (args.list_unsaved_changes) {
+        method = "list_unsaved_changes";
+    } else if (args.delete_table) {
+        method = "delete_table";
+    } else if (args.add_point) {
+        method = "add_point";
+        if (args.point_x) params.set("x", *args.point_x);
+        if (args.point_y) params.set("y", *args.point_y);
+        if (args.point_target) params.set("target", *args.point_target);
+    } else if (args.delete_point) {
+        method = "delete_point";
+        if (args.point_id) params.set("point_id", *args.point_id);
+    } else if (args.clear_undo_log) {
+        method = "clear_undo_log";
+    } else if (args.clear_all_undo_log) {
+        method = "clear_all_undo_log";
+    } else if (args.commit_unsaved_changes) {
+        method = "commit_unsaved_changes";
+    } else if (args.to_csv) {
+        method = "to_csv";
+    } else if (args.rename_table || args.copy_table) {
+        // Not implemented locally either: fail with the same message
+        error = args.rename_table ? "--rename-table not yet implemented" : "--copy-table not yet implemented";
+        return std::nullopt;
+    } else {
+        error = "--connect requires a non-interactive command (e.g. --list-tables, --add-point)";
+        return std::nullopt;
+    }
+
+    if (args.table.has_value()) {
+        params.set("table", *args.table);
+    }
+
+    JsonValue request = JsonValue::object();
+    request.set("id", 1);
+    request.set("method", method);
+    request.set("params", params);
+    return request;
+}
+
+int RpcClient::run(const Arguments& args, std::ostream& out, std::ostream& err) {
+    std::string error;
+    auto request = build_request(args, error);
+    if (!request.has_value()) {
+        err << "Error: " << error << std::endl;
+        return 2;
+    }
+
+    RpcClient client(*args.connect_socket);
+    if (!client.connect()) {
+        err << "Error: " << client.last_error() << std::endl;
+        return 65;
+    }
+
+    auto payload = client.call(request->dump());
+    if (!payload.has_value()) {
+        err << "Error: " << client.last_error() << std::endl;
+        return 65;
+    }
+
+    auto response = JsonValue::parse(*payload);
+    if (!response.has_value() || !response->is_object()) {
+        err << "Error: Malformed response from server" << std::endl;
+        return 65;
+    }
+
+    if (const JsonValue* failure = response->find("error")) {
+        err << "Error: " << failure->get_string("message").value_or("Unknown error") << std::endl;
+        return failure->get_int("code").value_or(1);
+    }
+
+    const JsonValue* result = response->find("result");
+    if (result != nullptr) {
+        out << result->get_string("output").value_or("");
+    }
+    out.flush();
+    if (out.fail()) {
+        err << "Error: Failed to write output" << std::endl;
+        return 67;
+    }
+    return 0;
+}
+
+}  // namespace datapainter
@@ -0,0 +1,729 @@
+#include "rpc_server.h"
+#include "argument_parser.h"
+#include "csv_exporter.h"
+#include "data_table.h"
+#include "table_manager.h"
+#include "alloc_stats.h"
+#include "tracer.h"
+#include "undo_log_manager.h"
+#include <sstream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace datapainter {
+
+namespace {
+
+// Decode the 4-byte big-endian length prefix at the front of buffer
+size_t frame_length(const std::string& buffer) {
+    return (static_cast<size_t>(static_cast<unsigned char>(buffer[0])) << 24) |
+           (static_cast<size_t>(static_cast<unsigned char>(buffer[1])) << 16) |
+           (static_cast<size_t>(static_cast<unsigned char>(buffer[2])) << 8) |
+           static_cast<size_t>(static_cast<unsigned char>(buffer[3]));
+}
+
+// Output buffer that refuses to grow past a limit, so a stream writing to
+// it fails instead of holding an unbounded export in memory
+class CappedBuffer : public std::streambuf {
+public:
+    explicit CappedBuffer(size_t limit) : limit_(limit) {}
+
+    const std::string& str() const { return text_; }
+    bool exceeded() const { return exceeded_; }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) {
+            return traits_type::not_eof(ch);
+        }
+        char c = traits_type::to_char_type(ch);
+        return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        if (text_.size() + static_cast<size_t>(n) > limit_) {
+            exceeded_ = true;
+            return 0;
+        }
+        text_.append(s, static_cast<size_t>(n));
+        return n;
+    }
+
+private:
+    size_t limit_;
+    std::string text_;
+    bool exceeded_ = false;
+};
+
+}  // namespace
+
+RpcServer::RpcServer(Database& db) : db_(db), stop_requested_(false) {}
+
+bool RpcServer::is_batchable_write(const std::string& method) {
+    // Single-statement writes; anything that opens its own transaction
+    // (commit_unsaved_changes via SaveManager) or touches several tables
+    // (create/delete table) runs on its own
+    return method == "add_point" || method == "delete_point" ||
+           method == "clear_undo_log" || method == "clear_all_undo_log";
+}
+
+std::string RpcServer::encode_frame(const std::string& payload) {
+    std::string frame;
+    frame.reserve(payload.size() + 4);
+    uint32_t len = static_cast<uint32_t>(payload.size());
+    frame += static_cast<char>((len >> 24) & 0xFF);
+    frame += static_cast<char>((len >> 16) & 0xFF);
+    frame += static_cast<char>((len >> 8) & 0xFF);
+    frame += static_cast<char>(len & 0xFF);
+    frame += payload;
+    return frame;
+}
+
+bool RpcServer::extract_frame(std::string& buffer, std::string& payload) {
+    if (buffer.size() < 4) {
+        return false;
+    }
+    size_t len = frame_length(buffer);
+    if (buffer.size() < len + 4) {
+        return false;
+    }
+    payload.assign(buffer, 4, len);
+    buffer.erase(0, len + 4);
+    return true;
+}
+
+std::string RpcServer::handle_request(const std::string& payload) {
+    JsonValue id;
+    std::string method;
+    JsonValue params;
+    std::string error_response;
+    if (!parse_request(payload, id, method, params, error_response)) {
+        return error_response;
+    }
+    return build_response(id, dispatch(method, params));
+}
+
+std::vector<std::string> RpcServer::handle_batch(const std::vector<std::string>& payloads) {
+    struct ParsedRequest {
+        bool valid;
+        JsonValue id;
+        std::string method;
+        JsonValue params;
+    };
+
+    std::vector<std::string> responses(payloads.size());
+    std::vector<ParsedRequest> requests(payloads.size());
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        requests[i].valid = parse_request(payloads[i], requests[i].id, requests[i].method,
+                                          requests[i].params, responses[i]);
+    }
+
+    size_t i = 0;
+    while (i < requests.size()) {
+        if (!requests[i].valid || !is_batchable_write(requests[i].method)) {
+            if (requests[i].valid) {
+                responses[i] = build_response(requests[i].id,
+                                              dispatch(requests[i].method, requests[i].params));
+            }
+            ++i;
+            continue;
+        }
+
+        // Find the run of consecutive batchable writes starting here
+        size_t end = i + 1;
+        while (end < requests.size() && requests[end].valid &&
+               is_batchable_write(requests[end].method)) {
+            ++end;
+        }
+
+        // Share one transaction (and one fsync) across the whole run
+        bool in_transaction = (end - i > 1) && db_.execute("BEGIN TRANSACTION");
+        for (size_t j = i; j < end; ++j) {
+            responses[j] = build_response(requests[j].id,
+                                          dispatch(requests[j].method, requests[j].params));
+        }
+        if (in_transaction && !db_.execute("COMMIT")) {
+            db_.execute("ROLLBACK");
+            for (size_t j = i; j < end; ++j) {
+                responses[j] = build_response(requests[j].id, make_error(66, "Failed to commit batch"));
+            }
+        }
+        i = end;
+    }
+
+    return responses;
+}
+
+bool RpcServer::parse_request(const std::string& payload, JsonValue& id, std::string& method,
+                              JsonValue& params, std::string& error_response) const {
+    std::string parse_error;
+    auto request = JsonValue::parse(payload, &parse_error);
+    if (!request.has_value() || !request->is_object()) {
+        error_response = build_response(JsonValue(), make_error(2, "Invalid request: " +
+                                        (parse_error.empty() ? "expected an object" : parse_error)));
+        return false;
+    }
+
+    if (const JsonValue* request_id = request->find("id")) {
+        id = *request_id;
+    }
+
+    auto method_name = request->get_string("method");
+    if (!method_name.has_value()) {
+        error_response = build_response(id, make_error(2, "Invalid request: missing method"));
+        return false;
+    }
+    method = *method_name;
+
+    const JsonValue* request_params = request->find("params");
+    params = (request_params != nullptr && request_params->is_object()) ? *request_params
+                                                                         : JsonValue::object();
+    return true;
+}
+
+std::string RpcServer::build_response(const JsonValue& id, const CallResult& call) {
+    JsonValue response = JsonValue::object();
+    response.set("id", id);
+    if (call.ok) {
+        response.set("result", call.result);
+    } else {
+        JsonValue error = JsonValue::object();
+        error.set("code", call.error_code);
+        error.set("message", call.error_message);
+        response.set("error", error);
+    }
+    return response.dump();
+}
+
+RpcServer::CallResult RpcServer::make_error(int code, const std::string& message) {
+    CallResult call;
+    call.ok = false;
+    call.error_code = code;
+    call.error_message = message;
+    return call;
+}
+
+bool RpcServer::get_table_param(const JsonValue& params, const std::string& command, std::string& table,
+                                CallResult& error) {
+    auto value = params.get_string("table");
+    if (!value.has_value()) {
+        error = make_error(2, "--table is required for " + command);
+        return false;
+    }
+    // Table names are concatenated into SQL: check them as the CLI does
+    Arguments args;
+    args.table = *value;
+    auto errors = ArgumentParser::validate(args);
+    if (!errors.empty()) {
+        error = make_error(2, errors.front());
+        return false;
+    }
+    table = *value;
+    return true;
+}
+
+RpcServer::CallResult RpcServer::dispatch(const std::string& method, const JsonValue& params) {
+    TraceSpan span("RpcServer::dispatch");
+    AllocScope allocs("RpcServer::dispatch");
+    if (method == "ping") {
+        CallResult call;
+        call.result.set("database", db_.path());
+        return call;
+    } else if (method == "shutdown") {
+        stop_requested_ = true;
+        return CallResult();
+    } else if (method == "list_tables") {
+        return list_tables();
+    } else if (method == "show_metadata") {
+        return show_metadata(params);
+    } else if (method == "create_table") {
+        return create_table(params);
+    } else if (method == "delete_table") {
+        return delete_table(params);
+    } else if (method == "add_point") {
+        return add_point(params);
+    } else if (method == "delete_point") {
+        return delete_point(params);
+    } else if (method == "query_viewport") {
+        return query_viewport(params);
+    } else if (method == "to_csv") {
+        return to_csv(params);
+    } else if (method == "list_unsaved_changes") {
+        return list_unsaved_changes(params);
+    } else if (method == "commit_unsaved_changes") {
+        return commit_unsaved_changes(params);
+    } else if (method == "clear_undo_log") {
+        return clear_undo_log(params);
+    } else if (method == "clear_all_undo_log") {
+        return clear_all_undo_log();
+    }
+    return make_error(2, "Unknown method: " + method);
+}
+
+RpcServer::CallResult RpcServer::list_tables() {
+    TableManager table_mgr(db_);
+    auto tables = table_mgr.list_tables();
+
+    CallResult call;
+    JsonValue names = JsonValue::array();
+    std::ostringstream output;
+    if (tables.empty()) {
+        output << "No tables found in database\n";
+    } else {
+        output << "Tables:\n";
+        for (const auto& table : tables) {
+            output << "  " << table << "\n";
+            names.push_back(table);
+        }
+    }
+    call.result.set("tables", names);
+    call.result.set("output", output.str());
+    return call;
+}
+
+RpcServer::CallResult RpcServer::show_metadata(const JsonValue& params) {
+    CallResult call;
+    std::string table;
+    if (!get_table_param(params, "--show-metadata", table, call)) {
+        return call;
+    }
+
+    TableManager table_mgr(db_);
+    std::ostringstream output;
+    if (!table_mgr.show_metadata(table, output)) {
+        return make_error(66, "Table not found: " + table);
+    }
+    call.result.set("output", output.str());
+    return call;
+}
+
+RpcServer::CallResult RpcServer::create_table(const JsonValue& params) {
+    CallResult call;
+    std::string table;
+    if (!get_table_param(params, "--create-table", table, call)) {
+        return call;
+    }
+
+    const char* required[] = {"target_column_name", "x_axis_name", "y_axis_name",
+                              "x_meaning", "o_meaning"};
+    for (const char* name : required) {
+        if (!params.get_string(name).has_value()) {
+            std::string flag = name;
+            for (auto& ch : flag) {
+                if (ch == '_') ch = '-';
+            }
+            return make_error(2, "--" + flag + " is required for --create-table");
+        }
+    }
+
+    double min_x = params.get_number("min_x").value_or(-10.0);
+    double max_x = params.get_number("max_x").value_or(10.0);
+    double min_y = params.get_number("min_y").value_or(-10.0);
+    double max_y = params.get_number("max_y").value_or(10.0);
+    Arguments range;
+    range.min_x = min_x;
+    range.max_x = max_x;
+    range.min_y = min_y;
+    range.max_y = max_y;
+    auto errors = ArgumentParser::validate(range);
+    if (!errors.empty()) {
+        return make_error(2, errors.front());
+    }
+
+    TableManager table_mgr(db_);
+    bool success = table_mgr.create_table(table,
+                                          *params.get_string("target_column_name"),
+                                          *params.get_string("x_axis_name"),
+                                          *params.get_string("y_axis_name"),
+                                          *params.get_string("x_meaning"),
+                                          *params.get_string("o_meaning"),
+                                          min_x, max_x, min_y, max_y,
+                                          params.get_bool("show_zero_bars").value_or(false));
+    if (!success) {
+        return make_error(66, "Failed to create table");
+    }
+    call.result.set("output", "Table '" + table + "' created successfully\n");
+    return call;
+}
+
+RpcServer::CallResult RpcServer::delete_table(const JsonValue& params) {
+    CallResult call;
+    std::string table;
+    if (!get_table_param(params, "--delete-table", table, call)) {
+        return call;
+    }
+
+    TableManager table_mgr(db_);
+    if (!table_mgr.delete_table(table)) {
+        return make_error(66, "Failed to delete table");
+    }
+    call.result.set("output", "Table '" + table + "' deleted successfully\n");
+    return call;
+}
+
+RpcServer::CallResult RpcServer::add_point(const JsonValue& params) {
+    CallResult call;
+    std::string table;
+    if (!get_table_param(params, "--add-point", table, call)) {
+        return call;
+    }
+
+    auto x = params.get_number("x");
+    auto y = params.get_number("y");
+    auto target = params.get_string("target");
+    if (!x.has_value()) {
+        return make_error(2, "--x is required for --add-point");
+    }
+    if (!y.has_value()) {
+        return make_error(2, "--y is required for --add-point");
+    }
+    if (!target.has_value()) {
+        return make_error(2, "--target is required for --add-point");
+    }
+
+    DataTable dt(db_, table);
+    auto id = dt.insert_point(*x, *y, *target);
+    if (!id.has_value()) {
+        return make_error(66, "Failed to add point");
+    }
+    call.result.set("id", *id);
+    call.result.set("output", "Point added with ID " + std::to_string(*id) + "\n");
+    return call;
+}
+
+RpcServer::CallResult RpcServer::delete_point(const JsonValue& params) {
+    CallResult call;
+    std::string table;
+    if (!get_table_param(params, "--delete-point", table, call)) {
+        return call;
+    }
+
+    auto point_id = params.get_int("point_id");
+    if (!point_id.has_value()) {
+        return make_error(2, "--point-id is required for --delete-point");
+    }
+
+    DataTable dt(db_, table);
+    if (!dt.delete_point(*point_id)) {
+        return make_error(66, "Point not found: " + std::to_string(*point_id));
+    }
+    call.result.set("output", "Point " + std::to_string(*point_id) + " deleted successfully\n");
+    return call;
+}
+
+RpcServer::CallResult RpcServer::query_viewport(const JsonValue& params) {
+    CallResult call;
+    std::string table;
+    if (!get_table_param(params, "query_viewport", table, call)) {
+        return call;
+    }
+
+    auto x_min = params.get_number("x_min");
+    auto x_max = params.get_number("x_max");
+    auto y_min = params.get_number("y_min");
+    auto y_max = params.get_number("y_max");
+    if (!x_min.has_value() || !x_max.has_value() || !y_min.has_value() || !y_max.has_value()) {
+        return make_error(2, "query_viewport requires x_min, x_max, y_min and y_max");
+    }
+
+    DataTable dt(db_, table);
+    auto points = dt.query_viewport(*x_min, *x_max, *y_min, *y_max);
+
+    // Compact [id, x, y, target] rows keep large viewports cheap to encode
+    JsonValue rows = JsonValue::array();
+    for (const auto& point : points) {
+        JsonValue row = JsonValue::array();
+        row.push_back(point.id);
+        row.push_back(point.x);
+        row.push_back(point.y);
+        row.push_back(point.target);
+        rows.push_back(std::move(row));
+    }
+    call.result.set("count", static_cast<int>(points.size()));
+    call.result.set("points", rows);
+    return call;
+}
+
+RpcServer::CallResult RpcServer::to_csv(const JsonValue& params) {
+    CallResult call;
+    std::string table;
+    if (!get_table_param(params, "--to-csv", table, call)) {
+        return call;
+    }
+
+    CappedBuffer buffer(max_csv_size_);
+    std::ostream output(&buffer);
+    CsvExporter exporter(db_, table);
+    if (!exporter.write(output)) {
+        if (buffer.exceeded()) {
+            return make_error(66, "CSV output exceeds " + std::to_string(max_csv_size_ >> 20) +
+                                      " MiB; run --to-csv without --connect");
+        }
+        return make_error(66, exporter.last_error());
+    }
+    call.result.set("output", buffer.str());
+    return call;
+}
+
+RpcServer::CallResult RpcServer::list_unsaved_changes(const JsonValue& params) {
+    CallResult call;
+    std::string table;
+    if (!get_table_param(params, "--list-unsaved-changes", table, call)) {
+        return call;
+    }
+
+    UndoLogManager undo_mgr(db_);
+    std::ostringstream output;
+    if (!undo_mgr.list_unsaved_changes(table, output)) {
+        return make_error(66, "Failed to list unsaved changes");
+    }
+    call.result.set("output", output.str());
+    return call;
+}
+
+RpcServer::CallResult RpcServer::commit_unsaved_changes(const JsonValue& params) {
+    CallResult call;
+    std::string table;
+    if (!get_table_param(params, "--commit-unsaved-changes", table, call)) {
+        return call;
+    }
+
+    UndoLogManager undo_mgr(db_);
+    if (!undo_mgr.commit_unsaved_changes(table)) {
+        return make_error(66, "Failed to commit unsaved changes");
+    }
+    call.result.set("output", "Unsaved changes committed for table '" + table + "'\n");
+    return call;
+}
+
+RpcServer::CallResult RpcServer::clear_undo_log(const JsonValue& params) {
+    CallResult call;
+    std::string table;
+    if (!get_table_param(params, "--clear-undo-log", table, call)) {
+        return call;
+    }
+
+    UndoLogManager undo_mgr(db_);
+    if (!undo_mgr.clear_undo_log(table)) {
+        return make_error(66, "Failed to clear undo log");
+    }
+    call.result.set("output", "Undo log cleared for table '" + table + "'\n");
+    return call;
+}
+
+RpcServer::CallResult RpcServer::clear_all_undo_log() {
+    UndoLogManager undo_mgr(db_);
+    if (!undo_mgr.clear_all_undo_logs()) {
+        return make_error(66, "Failed to clear all undo logs");
+    }
+    CallResult call;
+    call.result.set("output", "All undo logs cleared\n");
+    return call;
+}
+
+#ifdef _WIN32
+
+bool RpcServer::serve(const std::string& socket_path, std::ostream& log) {
+    (void)socket_path;
+    (void)log;
+    error_ = "--serve is not supported on this platform";
+    return false;
+}
+
+#else
+
+namespace {
+
+struct ClientConnection {
+    int fd;
+    std::string in;
+    std::string out;
+    bool eof;     // The client sent everything it will; answer, then close
+    bool closed;  // Broken: drop without answering
+};
+
+bool set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Write as much pending output as the socket will take without blocking
+void flush_output(ClientConnection& client) {
+    while (!client.out.empty()) {
+        ssize_t written = write(client.fd, client.out.data(), client.out.size());
+        if (written > 0) {
+            client.out.erase(0, static_cast<size_t>(written));
+        } else if (written < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                client.closed = true;
+                client.out.clear();
+            }
+            return;
+        }
+    }
+}
+
+}  // namespace
+
+bool RpcServer::serve(const std::string& socket_path, std::ostream& log) {
+    sockaddr_un addr{};
+    if (socket_path.empty() || socket_path.size() >= sizeof(addr.sun_path)) {
+        error_ = "Socket path is empty or too long: " + socket_path;
+        return false;
+    }
+
+    // Remove a stale socket from a previous run, but never clobber a regular file
+    struct stat st;
+    if (lstat(socket_path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            error_ = "Refusing to replace non-socket file: " + socket_path;
+            return false;
+        }
+        unlink(socket_path.c_str());
+    }
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        error_ = std::string("socket() failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0 || !set_nonblocking(listen_fd)) {
+        error_ = std::string("Could not listen on ") + socket_path + ": " + std::strerror(errno);
+        close(listen_fd);
+        return false;
+    }
+
+    // A client that disconnects mid-response must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    log << "Serving " << db_.path() << " on " << socket_path << std::endl;
+
+    std::vector<ClientConnection> clients;
+    std::vector<pollfd> poll_fds;
+
+    while (!stop_requested_) {
+        poll_fds.clear();
+        poll_fds.push_back({listen_fd, POLLIN, 0});
+        for (const auto& client : clients) {
+            short events = client.eof ? 0 : POLLIN;
+            if (!client.out.empty()) {
+                events |= POLLOUT;
+            }
+            poll_fds.push_back({client.fd, events, 0});
+        }
+
+        if (poll(poll_fds.data(), static_cast<nfds_t>(poll_fds.size()), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error_ = std::string("poll() failed: ") + std::strerror(errno);
+            break;
+        }
+
+        // Read everything that is available from existing clients
+        for (size_t i = 0; i < clients.size(); ++i) {
+            short revents = poll_fds[i + 1].revents;
+            if (!clients[i].eof && (revents & (POLLIN | POLLHUP | POLLERR))) {
+                char buf[65536];
+                while (true) {
+                    ssize_t n = read(clients[i].fd, buf, sizeof(buf));
+                    if (n > 0) {
+                        clients[i].in.append(buf, static_cast<size_t>(n));
+                    } else if (n < 0 && errno == EINTR) {
+                        continue;
+                    } else {
+                        if (n == 0) {
+                            clients[i].eof = true;
+                        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                            clients[i].closed = true;
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Accept new connections
+        if (poll_fds[0].revents & POLLIN) {
+            while (true) {
+                int fd = accept(listen_fd, nullptr, nullptr);
+                if (fd < 0) {
+                    break;
+                }
+                set_nonblocking(fd);
+                clients.push_back({fd, std::string(), std::string(), false, false});
+            }
+        }
+
+        // Gather every complete request that arrived in this wakeup so
+        // concurrent writers can share a transaction
+        std::vector<std::string> payloads;
+        std::vector<size_t> owners;
+        for (size_t i = 0; i < clients.size(); ++i) {
+            std::string payload;
+            while (extract_frame(clients[i].in, payload)) {
+                payloads.push_back(payload);
+                owners.push_back(i);
+            }
+            if (clients[i].in.size() >= 4 && frame_length(clients[i].in) > MAX_FRAME_SIZE) {
+                clients[i].closed = true;
+            }
+        }
+
+        if (!payloads.empty()) {
+            auto responses = handle_batch(payloads);
+            for (size_t i = 0; i < responses.size(); ++i) {
+                clients[owners[i]].out += encode_frame(responses[i]);
+            }
+        }
+
+        for (auto& client : clients) {
+            if (!client.closed) {
+                flush_output(client);
+            }
+        }
+
+        // Drop broken connections, and finished ones once their responses
+        // have gone out
+        for (size_t i = clients.size(); i-- > 0;) {
+            if (clients[i].closed || (clients[i].eof && clients[i].out.empty())) {
+                close(clients[i].fd);
+                clients.erase(clients.begin() + static_cast<long>(i));
+            }
+        }
+    }
+
+    // Give pending responses (e.g. the shutdown acknowledgement) a chance to go out
+    for (auto& client : clients) {
+        int flags = fcntl(client.fd, F_GETFL, 0);
+        if (flags >= 0) {
+            fcntl(client.fd, F_SETFL, flags & ~O_NONBLOCK);
+        }
+        flush_output(client);
+        close(client.fd);
+    }
+    close(listen_fd);
+    unlink(socket_path.c_str());
+
+    return error_.empty();
+}
+
+#endif
+
+}  // namespace datapainter
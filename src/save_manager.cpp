@@ -2,6 +2,8 @@
 #include "data_table.h"
 #include "metadata.h"
 #include "unsaved_changes.h"
+#include "alloc_stats.h"
+#include "tracer.h"
 #include <sqlite3.h>
 #include <iostream>
 
@@ -11,6 +13,8 @@ SaveManager::SaveManager(Database& db, const std::string& table_name)
     : db_(db), table_name_(table_name) {}
 
 bool SaveManager::save() {
+    TraceSpan span("SaveManager::save");
+    AllocScope allocs("SaveManager::save");
     // Begin transaction
     if (!db_.execute("BEGIN TRANSACTION")) {
         return false;
@@ -0,0 +1,198 @@
+#include "snapshot_writer.h"
+#include "alloc_stats.h"
+#include "tracer.h"
+#include <cctype>
+#include <charconv>
+
+namespace datapainter {
+
+namespace {
+
+struct Rgb {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+};
+
+constexpr Rgb BACKGROUND = {255, 255, 255};
+
+// Terminal colours on a white page; white itself becomes grey so it stays
+// visible, and the default colour is black
+Rgb to_rgb(Terminal::Color color) {
+    switch (color) {
+        case Terminal::Color::RED:     return {215, 48, 39};
+        case Terminal::Color::GREEN:   return {26, 152, 80};
+        case Terminal::Color::YELLOW:  return {230, 171, 2};
+        case Terminal::Color::BLUE:    return {49, 54, 149};
+        case Terminal::Color::MAGENTA: return {197, 27, 125};
+        case Terminal::Color::CYAN:    return {69, 117, 180};
+        case Terminal::Color::WHITE:   return {160, 160, 160};
+        case Terminal::Color::DEFAULT: break;
+    }
+    return {0, 0, 0};
+}
+
+// Mix colour over the background at (level + 1) / DENSITY_LEVELS opacity:
+// a quarter for the lightest of the four levels, full for the densest
+Rgb shade(Rgb color, int level) {
+    int alpha = (level + 1) * 256 / EditAreaRenderer::DENSITY_LEVELS;
+    auto mix = [alpha](uint8_t fg, uint8_t bg) {
+        return static_cast<uint8_t>((fg * alpha + bg * (256 - alpha)) >> 8);
+    };
+    return {mix(color.r, BACKGROUND.r), mix(color.g, BACKGROUND.g), mix(color.b, BACKGROUND.b)};
+}
+
+void append_utf8(std::string& out, char32_t glyph) {
+    if (glyph < 0x80) {
+        out += static_cast<char>(glyph);
+    } else if (glyph < 0x800) {
+        out += static_cast<char>(0xC0 | (glyph >> 6));
+        out += static_cast<char>(0x80 | (glyph & 0x3F));
+    } else {
+        out += static_cast<char>(0xE0 | (glyph >> 12));
+        out += static_cast<char>(0x80 | ((glyph >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (glyph & 0x3F));
+    }
+}
+
+}  // namespace
+
+std::optional<SnapshotWriter::Size> SnapshotWriter::parse_size(const std::string& spec) {
+    size_t sep = spec.find_first_of("xX");
+    if (sep == std::string::npos || sep == 0 || sep + 1 >= spec.size()) {
+        return std::nullopt;
+    }
+    auto parse_side = [](const char* begin, const char* end, int& value) {
+        if (!std::isdigit(static_cast<unsigned char>(*begin))) {
+            return false;
+        }
+        auto result = std::from_chars(begin, end, value);
+        return result.ec == std::errc() && result.ptr == end && value >= 1 && value <= MAX_SIDE;
+    };
+    Size size;
+    const char* text = spec.data();
+    if (!parse_side(text, text + sep, size.width) ||
+        !parse_side(text + sep + 1, text + spec.size(), size.height)) {
+        return std::nullopt;
+    }
+    if (static_cast<long>(size.width) * size.height > MAX_CELLS) {
+        return std::nullopt;
+    }
+    return size;
+}
+
+SnapshotWriter::Format SnapshotWriter::format_for_path(const std::string& path) {
+    const std::string ext = ".ppm";
+    if (path.size() >= ext.size()) {
+        std::string tail = path.substr(path.size() - ext.size());
+        for (char& c : tail) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        if (tail == ext) {
+            return Format::PPM;
+        }
+    }
+    return Format::TEXT;
+}
+
+SnapshotWriter::SnapshotWriter(DataTable& table, ClassPalette& palette)
+    : table_(table), palette_(palette) {}
+
+bool SnapshotWriter::write(std::ostream& out, const Viewport& viewport,
+                           const std::vector<ChangeRecord>& unsaved_changes, Format format) {
+    AllocScope allocs("SnapshotWriter::write");
+    TraceSpan span("SnapshotWriter::write");
+    error_.clear();
+
+    const CellGrid& grid = renderer_.bin(viewport, table_, unsaved_changes,
+                                         viewport.screen_height(), viewport.screen_width(), palette_);
+    if (format == Format::PPM) {
+        write_ppm(out, grid);
+    } else {
+        write_text(out, grid);
+    }
+
+    out.flush();
+    if (out.fail()) {
+        error_ = "Failed to write snapshot";
+        return false;
+    }
+    return true;
+}
+
+void SnapshotWriter::write_text(std::ostream& out, const CellGrid& grid) {
+    EditAreaRenderer::Mode mode = renderer_.mode();
+    EditAreaRenderer::DensityScale scale(grid.max_count());
+    const DotGrid& dots = renderer_.dots();
+
+    // One row at a time so memory stays at the grid plus a line
+    std::string line;
+    for (int row = 0; row < grid.rows() && !out.fail(); ++row) {
+        line.clear();
+        for (int col = 0; col < grid.cols(); ++col) {
+            const CellGrid::Cell& cell = grid.at(row, col);
+            if (cell.empty()) {
+                line += ' ';
+            } else if (mode == EditAreaRenderer::Mode::DENSITY) {
+                append_utf8(line, EditAreaRenderer::density_glyph(scale.level(cell.count)));
+            } else if (mode == EditAreaRenderer::Mode::BRAILLE) {
+                append_utf8(line, DotGrid::glyph(dots.at(row, col)));
+            } else {
+                line += EditAreaRenderer::cell_char(cell, palette_);
+            }
+        }
+        line += '\n';
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
+
+void SnapshotWriter::write_ppm(std::ostream& out, const CellGrid& grid) {
+    EditAreaRenderer::Mode mode = renderer_.mode();
+    bool braille = mode == EditAreaRenderer::Mode::BRAILLE;
+    int sub_rows = braille ? DotGrid::DOTS_PER_ROW : 1;
+    int sub_cols = braille ? DotGrid::DOTS_PER_COL : 1;
+    EditAreaRenderer::DensityScale scale(grid.max_count());
+    const DotGrid& dots = renderer_.dots();
+
+    int width = grid.cols() * sub_cols;
+    int height = grid.rows() * sub_rows;
+    out << "P6\n" << width << " " << height << "\n255\n";
+
+    // Pixel colours for one cell row, reused for each of its pixel rows
+    std::vector<Rgb> cell_colors(static_cast<size_t>(grid.cols()));
+    std::string pixels(static_cast<size_t>(width) * 3, '\0');
+    for (int row = 0; row < grid.rows() && !out.fail(); ++row) {
+        for (int col = 0; col < grid.cols(); ++col) {
+            const CellGrid::Cell& cell = grid.at(row, col);
+            if (cell.empty()) {
+                cell_colors[static_cast<size_t>(col)] = BACKGROUND;
+                continue;
+            }
+            Rgb color = to_rgb(EditAreaRenderer::blend_color(cell, palette_));
+            if (mode == EditAreaRenderer::Mode::DENSITY) {
+                color = shade(color, scale.level(cell.count));
+            }
+            cell_colors[static_cast<size_t>(col)] = color;
+        }
+
+        for (int sub_row = 0; sub_row < sub_rows; ++sub_row) {
+            size_t offset = 0;
+            for (int col = 0; col < grid.cols(); ++col) {
+                Rgb color = cell_colors[static_cast<size_t>(col)];
+                uint8_t cell_dots = braille ? dots.at(row, col) : 0;
+                for (int sub_col = 0; sub_col < sub_cols; ++sub_col) {
+                    Rgb pixel = color;
+                    if (braille && (cell_dots & DotGrid::bit(sub_row, sub_col)) == 0) {
+                        pixel = BACKGROUND;
+                    }
+                    pixels[offset++] = static_cast<char>(pixel.r);
+                    pixels[offset++] = static_cast<char>(pixel.g);
+                    pixels[offset++] = static_cast<char>(pixel.b);
+                }
+            }
+            out.write(pixels.data(), static_cast<std::streamsize>(pixels.size()));
+        }
+    }
+}
+
+}  // namespace datapainter
@@ -0,0 +1,321 @@
+#include "sql_profiler.h"
+#include "database.h"
+#include "json_value.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+namespace datapainter {
+
+SqlProfiler::SqlProfiler(Database& db) : db_(db), attached_(false) {}
+
+SqlProfiler::~SqlProfiler() {
+    detach();
+    if (!report_path_.empty() && !write_report(report_path_)) {
+        std::cerr << "Error: Failed to write SQL profile: " << report_path_ << std::endl;
+    }
+}
+
+bool SqlProfiler::attach() {
+    if (!db_.is_open()) {
+        return false;
+    }
+    int rc = sqlite3_trace_v2(db_.connection(), SQLITE_TRACE_STMT | SQLITE_TRACE_ROW | SQLITE_TRACE_PROFILE,
+                              &SqlProfiler::trace_callback, this);
+    attached_ = (rc == SQLITE_OK);
+    return attached_;
+}
+
+void SqlProfiler::detach() {
+    if (attached_) {
+        sqlite3_trace_v2(db_.connection(), 0, nullptr, nullptr);
+        attached_ = false;
+    }
+    running_.clear();
+}
+
+int SqlProfiler::trace_callback(unsigned type, void* context, void* p, void* x) {
+    auto* profiler = static_cast<SqlProfiler*>(context);
+    auto* stmt = static_cast<sqlite3_stmt*>(p);
+    if (type == SQLITE_TRACE_STMT) {
+        // Trigger subprograms report "-- ..." text and belong to the outer run
+        const char* text = static_cast<const char*>(x);
+        if (text == nullptr || std::strncmp(text, "--", 2) != 0) {
+            profiler->running_[stmt] = Running{std::chrono::steady_clock::now(), 0};
+        }
+    } else if (type == SQLITE_TRACE_ROW) {
+        auto running = profiler->running_.find(stmt);
+        if (running == profiler->running_.end()) {
+            // SQLite's own schema queries produce rows without a STMT event
+            running = profiler->running_.emplace(stmt, Running{std::chrono::steady_clock::now(), 0}).first;
+        }
+        running->second.rows++;
+    } else if (type == SQLITE_TRACE_PROFILE) {
+        profiler->on_profile(stmt, *static_cast<sqlite3_uint64*>(x));
+    }
+    return 0;
+}
+
+void SqlProfiler::on_profile(sqlite3_stmt* stmt, uint64_t nanoseconds) {
+    const char* raw = sqlite3_sql(stmt);
+    if (raw == nullptr) {
+        return;
+    }
+
+    std::string key = normalize(raw);
+    Entry& entry = entries_[key];
+    if (entry.count == 0) {
+        entry.sql = key;
+        entry.sample_sql = raw;
+    }
+
+    double ms = static_cast<double>(nanoseconds) / 1e6;
+    auto running = running_.find(stmt);
+    if (running != running_.end()) {
+        ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - running->second.start).count();
+        entry.rows += running->second.rows;
+        running_.erase(running);
+    }
+    entry.count++;
+    entry.total_ms += ms;
+    entry.max_ms = std::max(entry.max_ms, ms);
+
+    // Reset the counters so a reused statement reports per-execution deltas
+    entry.fullscan_steps += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+    entry.sorts += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+    entry.autoindexes += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+    entry.vm_steps += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+}
+
+std::string SqlProfiler::normalize(const std::string& sql) {
+    std::string result;
+    result.reserve(sql.size());
+
+    auto is_ident = [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    };
+
+    size_t i = 0;
+    while (i < sql.size()) {
+        char c = sql[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) {
+                ++i;
+            }
+            if (!result.empty()) {
+                result += ' ';
+            }
+            continue;
+        }
+        if (c == '\'') {
+            // String literal; '' is an escaped quote
+            ++i;
+            while (i < sql.size()) {
+                if (sql[i] == '\'' && i + 1 < sql.size() && sql[i + 1] == '\'') {
+                    i += 2;
+                } else if (sql[i] == '\'') {
+                    ++i;
+                    break;
+                } else {
+                    ++i;
+                }
+            }
+            result += '?';
+            continue;
+        }
+        if (c == '"') {
+            // Quoted identifier is kept verbatim
+            size_t end = sql.find('"', i + 1);
+            end = (end == std::string::npos) ? sql.size() : end + 1;
+            result.append(sql, i, end - i);
+            i = end;
+            continue;
+        }
+        bool starts_number = std::isdigit(static_cast<unsigned char>(c)) ||
+                             (c == '.' && i + 1 < sql.size() && std::isdigit(static_cast<unsigned char>(sql[i + 1])));
+        if (starts_number && (result.empty() || !is_ident(result.back()))) {
+            while (i < sql.size() && (is_ident(sql[i]) || sql[i] == '.')) {
+                // Exponent sign, e.g. 1e-5
+                if ((sql[i] == 'e' || sql[i] == 'E') && i + 1 < sql.size() &&
+                    (sql[i + 1] == '-' || sql[i + 1] == '+')) {
+                    ++i;
+                }
+                ++i;
+            }
+            result += '?';
+            continue;
+        }
+        result += c;
+        ++i;
+    }
+
+    while (!result.empty() && (result.back() == ' ' || result.back() == ';')) {
+        result.pop_back();
+    }
+    return result;
+}
+
+std::vector<const SqlProfiler::Entry*> SqlProfiler::sorted_entries() const {
+    std::vector<const Entry*> sorted;
+    sorted.reserve(entries_.size());
+    for (const auto& [sql, entry] : entries_) {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Entry* a, const Entry* b) {
+        if (a->total_ms != b->total_ms) {
+            return a->total_ms > b->total_ms;
+        }
+        return a->sql < b->sql;
+    });
+    return sorted;
+}
+
+std::vector<const SqlProfiler::Entry*> SqlProfiler::plan_candidates() const {
+    auto candidates = sorted_entries();
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Entry* a, const Entry* b) {
+        bool a_flagged = a->fullscan_steps > 0 || a->sorts > 0 || a->autoindexes > 0;
+        bool b_flagged = b->fullscan_steps > 0 || b->sorts > 0 || b->autoindexes > 0;
+        return a_flagged && !b_flagged;
+    });
+    return candidates;
+}
+
+std::vector<std::string> SqlProfiler::query_plan(const std::string& sql) {
+    std::vector<std::string> lines;
+    if (!db_.is_open()) {
+        return lines;
+    }
+
+    // Planning statements must not show up in the profile themselves
+    bool was_attached = attached_;
+    detach();
+
+    sqlite3_stmt* stmt = nullptr;
+    std::string explain = "EXPLAIN QUERY PLAN " + sql;
+    if (sqlite3_prepare_v2(db_.connection(), explain.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+        std::map<int, int> depth;  // Plan node id -> nesting depth
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            int id = sqlite3_column_int(stmt, 0);
+            int parent = sqlite3_column_int(stmt, 1);
+            const char* detail = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+            auto it = depth.find(parent);
+            int level = (it == depth.end()) ? 0 : it->second + 1;
+            depth[id] = level;
+            lines.push_back(std::string(static_cast<size_t>(level) * 2, ' ') + (detail ? detail : ""));
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    if (was_attached) {
+        attach();
+    }
+    return lines;
+}
+
+bool SqlProfiler::write_report(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json) {
+        write_json(out);
+    } else {
+        write_table(out);
+    }
+    out.flush();
+    return !out.fail();
+}
+
+void SqlProfiler::write_table(std::ostream& out) {
+    auto sorted = sorted_entries();
+    int64_t executions = 0;
+    double total_ms = 0.0;
+    for (const Entry* entry : sorted) {
+        executions += entry->count;
+        total_ms += entry->total_ms;
+    }
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "SQL profile: %zu statements, %lld executions, %.3f ms\n\n",
+                  sorted.size(), static_cast<long long>(executions), total_ms);
+    out << line;
+    std::snprintf(line, sizeof(line), "%8s %11s %9s %9s %9s %6s %7s  %s\n",
+                  "count", "total_ms", "max_ms", "rows", "fullscan", "sorts", "autoidx", "sql");
+    out << line;
+    for (const Entry* entry : sorted) {
+        std::snprintf(line, sizeof(line), "%8lld %11.3f %9.3f %9lld %9lld %6lld %7lld  ",
+                      static_cast<long long>(entry->count), entry->total_ms, entry->max_ms,
+                      static_cast<long long>(entry->rows), static_cast<long long>(entry->fullscan_steps),
+                      static_cast<long long>(entry->sorts), static_cast<long long>(entry->autoindexes));
+        out << line << entry->sql << "\n";
+    }
+
+    out << "\nQuery plans (full scans, sorts and automatic indexes first, then by total time)\n";
+    size_t planned = 0;
+    for (const Entry* entry : plan_candidates()) {
+        if (planned == PLAN_COUNT) {
+            break;
+        }
+        auto plan = query_plan(entry->sample_sql);
+        if (plan.empty()) {
+            continue;  // DDL and transaction control have no plan
+        }
+        out << "\n" << entry->sql << "\n";
+        for (const auto& plan_line : plan) {
+            out << "  " << plan_line << "\n";
+        }
+        ++planned;
+    }
+}
+
+void SqlProfiler::write_json(std::ostream& out) {
+    auto sorted = sorted_entries();
+
+    // Plans for the same entries the text report explains
+    std::unordered_map<const Entry*, std::vector<std::string>> plans;
+    for (const Entry* entry : plan_candidates()) {
+        if (plans.size() == PLAN_COUNT) {
+            break;
+        }
+        auto plan = query_plan(entry->sample_sql);
+        if (!plan.empty()) {
+            plans.emplace(entry, std::move(plan));
+        }
+    }
+
+    JsonValue statements = JsonValue::array();
+    for (const Entry* entry : sorted) {
+        JsonValue obj = JsonValue::object();
+        obj.set("sql", entry->sql);
+        obj.set("count", static_cast<double>(entry->count));
+        obj.set("total_ms", entry->total_ms);
+        obj.set("max_ms", entry->max_ms);
+        obj.set("rows", static_cast<double>(entry->rows));
+        obj.set("fullscan_steps", static_cast<double>(entry->fullscan_steps));
+        obj.set("sorts", static_cast<double>(entry->sorts));
+        obj.set("autoindexes", static_cast<double>(entry->autoindexes));
+        obj.set("vm_steps", static_cast<double>(entry->vm_steps));
+        auto plan_it = plans.find(entry);
+        if (plan_it != plans.end()) {
+            JsonValue plan = JsonValue::array();
+            for (const auto& plan_line : plan_it->second) {
+                plan.push_back(plan_line);
+            }
+            obj.set("plan", plan);
+        }
+        statements.push_back(obj);
+    }
+
+    JsonValue report = JsonValue::object();
+    report.set("statements", statements);
+    out << report.dump() << "\n";
+}
+
+}  // namespace datapainter
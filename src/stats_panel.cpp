@@ -0,0 +1,283 @@
+#include "stats_panel.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace datapainter {
+
+namespace {
+
+bool overlaps(const DataRegion& a, const DataRegion& b) {
+    return a.x_min <= b.x_max && b.x_min <= a.x_max && a.y_min <= b.y_max && b.y_min <= a.y_max;
+}
+
+// Part of closed rectangle a outside closed rectangle b, as at most four
+// disjoint regions; the rectangles must overlap
+std::vector<DataRegion> difference(const DataRegion& a, const DataRegion& b) {
+    std::vector<DataRegion> parts;
+    if (a.x_min < b.x_min) {  // Left of b, full height
+        parts.push_back({a.x_min, b.x_min, a.y_min, a.y_max, false, true, false, false});
+    }
+    if (a.x_max > b.x_max) {  // Right of b, full height
+        parts.push_back({b.x_max, a.x_max, a.y_min, a.y_max, true, false, false, false});
+    }
+    double x_min = std::max(a.x_min, b.x_min);
+    double x_max = std::min(a.x_max, b.x_max);
+    if (a.y_min < b.y_min) {  // Below b, within its columns
+        parts.push_back({x_min, x_max, a.y_min, b.y_min, false, false, false, true});
+    }
+    if (a.y_max > b.y_max) {  // Above b, within its columns
+        parts.push_back({x_min, x_max, b.y_max, a.y_max, false, false, true, false});
+    }
+    return parts;
+}
+
+}  // namespace
+
+void StatsPanel::set_origin(double x, double y) {
+    if (x == origin_x_ && y == origin_y_) {
+        return;
+    }
+    origin_x_ = x;
+    origin_y_ = y;
+    invalidate();
+}
+
+void StatsPanel::invalidate() {
+    viewport_set_ = false;
+    table_loaded_ = false;
+}
+
+int StatsPanel::slot_of(ClassPalette& palette, const std::string& target) {
+    int cls = palette.classify(target);
+    return cls == ClassPalette::NO_CLASS ? OTHER : cls;
+}
+
+void StatsPanel::query(DataTable& table, ClassPalette& palette, const std::optional<DataRegion>& region,
+                       int sign, std::vector<Moments>& sums) {
+    ++queries_;
+    for (const TargetSums& target : table.sum_by_target(origin_x_, origin_y_, region)) {
+        Moments& moments = sums[static_cast<size_t>(slot_of(palette, target.target))];
+        moments.add(target, sign);
+        if (moments.count == 0) {
+            moments = Moments{};  // Drop the rounding left by adding and removing
+        }
+    }
+}
+
+void StatsPanel::set_viewport(DataTable& table, ClassPalette& palette,
+                              double x_min, double x_max, double y_min, double y_max) {
+    DataRegion next{x_min, x_max, y_min, y_max};
+    if (viewport_set_ && next.x_min == rect_.x_min && next.x_max == rect_.x_max &&
+        next.y_min == rect_.y_min && next.y_max == rect_.y_max) {
+        return;
+    }
+    TraceSpan span("StatsPanel::set_viewport");
+    if (viewport_set_ && overlaps(rect_, next)) {
+        for (const DataRegion& lost : difference(rect_, next)) {
+            query(table, palette, lost, -1, saved_viewport_);
+        }
+        for (const DataRegion& gained : difference(next, rect_)) {
+            query(table, palette, gained, +1, saved_viewport_);
+        }
+    } else {
+        std::fill(saved_viewport_.begin(), saved_viewport_.end(), Moments{});
+        query(table, palette, next, +1, saved_viewport_);
+    }
+    rect_ = next;
+    viewport_set_ = true;
+    rebuild_viewport();
+}
+
+void StatsPanel::ensure_table_loaded(DataTable& table, ClassPalette& palette) {
+    if (table_loaded_) {
+        return;
+    }
+    TraceSpan span("StatsPanel::load_table");
+    std::fill(saved_table_.begin(), saved_table_.end(), Moments{});
+    query(table, palette, std::nullopt, +1, saved_table_);
+    table_loaded_ = true;
+    rebuild_table();
+}
+
+bool StatsPanel::in_viewport(double x, double y) const {
+    return viewport_set_ && x >= rect_.x_min && x <= rect_.x_max && y >= rect_.y_min && y <= rect_.y_max;
+}
+
+void StatsPanel::apply(const JournalDiff::Effect& change, int sign, std::vector<Moments>* view,
+                       std::vector<Moments>* table) {
+    double dx = change.x - origin_x_;
+    double dy = change.y - origin_y_;
+    if (view != nullptr && !in_viewport(change.x, change.y)) {
+        view = nullptr;
+    }
+    if (!table_loaded_) {
+        table = nullptr;
+    }
+    for (int cls : {change.removed, change.added}) {
+        if (cls == ClassPalette::NO_CLASS) {
+            continue;
+        }
+        int direction = cls == change.removed ? -sign : sign;
+        if (view != nullptr) {
+            (*view)[static_cast<size_t>(cls)].add(dx, dy, direction);
+        }
+        if (table != nullptr) {
+            (*table)[static_cast<size_t>(cls)].add(dx, dy, direction);
+        }
+    }
+}
+
+void StatsPanel::rebuild_viewport() {
+    viewport_ = saved_viewport_;
+    journal_.for_each([&](const JournalDiff::Effect& effect) { apply(effect, +1, &viewport_, nullptr); });
+}
+
+void StatsPanel::rebuild_table() {
+    table_ = saved_table_;
+    journal_.for_each([&](const JournalDiff::Effect& effect) { apply(effect, +1, nullptr, &table_); });
+}
+
+void StatsPanel::sync(DataTable& table, const std::vector<ChangeRecord>& changes, ClassPalette& palette) {
+    journal_.sync(
+        table, changes, [&](const std::string& target) { return slot_of(palette, target); },
+        [&](const JournalDiff::Effect& effect, int sign) { apply(effect, sign, &viewport_, &table_); },
+        [&](const JournalDiff::Effect& effect) { apply(effect, +1, &saved_viewport_, &saved_table_); });
+}
+
+int64_t StatsPanel::viewport_count() const {
+    int64_t total = 0;
+    for (const Moments& moments : viewport_) {
+        total += moments.count;
+    }
+    return total;
+}
+
+int64_t StatsPanel::saved_viewport_count() const {
+    int64_t total = 0;
+    for (const Moments& moments : saved_viewport_) {
+        total += moments.count;
+    }
+    return total;
+}
+
+int64_t StatsPanel::table_count() const {
+    int64_t total = 0;
+    for (const Moments& moments : table_) {
+        total += moments.count;
+    }
+    return total;
+}
+
+std::vector<std::string> StatsPanel::get_lines(const ClassPalette& palette) const {
+    return build_lines(palette, nullptr);
+}
+
+std::vector<std::string> StatsPanel::build_lines(const ClassPalette& palette, std::vector<int>* classes) const {
+    std::vector<std::string> lines;
+    char line[WIDTH + 64];
+
+    auto add = [&](const char* text) {
+        std::string padded = std::string("| ") + text;
+        padded.resize(WIDTH - 1, ' ');
+        padded += '|';
+        lines.push_back(padded);
+        if (classes != nullptr) {
+            classes->push_back(ClassPalette::NO_CLASS);
+        }
+    };
+    auto title = [&](const char* text) {
+        std::string padded = std::string("+- ") + text + " ";
+        padded.resize(WIDTH - 1, '-');
+        padded += '+';
+        lines.push_back(padded);
+        if (classes != nullptr) {
+            classes->push_back(ClassPalette::NO_CLASS);
+        }
+    };
+
+    auto section = [&](const char* name, const std::vector<Moments>& sums, int64_t total) {
+        // Class balance of the first two classes (x and o) in the title
+        int64_t first = sums[0].count;
+        int64_t second = sums[1].count;
+        char ratio[32];
+        if (second > 0) {
+            std::snprintf(ratio, sizeof(ratio), "%.2f", static_cast<double>(first) / static_cast<double>(second));
+        } else {
+            std::snprintf(ratio, sizeof(ratio), "-");
+        }
+        char x_glyph = palette.size() > 0 ? palette.style(0).glyph : 'x';
+        char o_glyph = palette.size() > 1 ? palette.style(1).glyph : 'o';
+        std::snprintf(line, sizeof(line), "%s: %lld points, %c:%c %s", name, static_cast<long long>(total),
+                      x_glyph, o_glyph, ratio);
+        title(line);
+        if (total == 0) {
+            add("no points");
+            return;
+        }
+        std::snprintf(line, sizeof(line), "%-8s%9s %7s%9s%9s%9s%9s%9s", "class", "n", "share", "mean x",
+                      "mean y", "var x", "var y", "cov xy");
+        add(line);
+
+        int listed = 0;
+        int hidden = 0;
+        for (size_t cls = 0; cls < SLOTS; ++cls) {
+            const Moments& moments = sums[cls];
+            if (moments.count <= 0) {
+                continue;
+            }
+            if (listed == ROWS_PER_SECTION) {
+                ++hidden;
+                continue;
+            }
+            ++listed;
+            bool other = static_cast<int>(cls) == OTHER || static_cast<int>(cls) >= palette.size();
+            const char* target = other ? "(other)" : palette.style(static_cast<int>(cls)).target.c_str();
+            char glyph = other ? '?' : palette.style(static_cast<int>(cls)).glyph;
+            std::snprintf(line, sizeof(line), "%c %-6.6s%9lld %6.1f%%%9.3g%9.3g%9.3g%9.3g%9.3g", glyph, target,
+                          static_cast<long long>(moments.count),
+                          100.0 * static_cast<double>(moments.count) / static_cast<double>(total),
+                          origin_x_ + moments.mean_x(), origin_y_ + moments.mean_y(), moments.var_x(),
+                          moments.var_y(), moments.cov_xy());
+            add(line);
+            if (classes != nullptr && !other) {
+                classes->back() = static_cast<int>(cls);
+            }
+        }
+        if (hidden > 0) {
+            std::snprintf(line, sizeof(line), "+ %d more classes", hidden);
+            add(line);
+        }
+    };
+
+    section("viewport", viewport_, viewport_count());
+    if (table_loaded_) {
+        section("table", table_, table_count());
+    }
+    lines.push_back("+" + std::string(WIDTH - 2, '-') + "+");
+    if (classes != nullptr) {
+        classes->push_back(ClassPalette::NO_CLASS);
+    }
+    return lines;
+}
+
+void StatsPanel::render(Terminal& terminal, const ClassPalette& palette, int top_row, int left_col) const {
+    std::vector<int> classes;
+    auto lines = build_lines(palette, &classes);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        int row = top_row + static_cast<int>(i);
+        if (row >= terminal.rows()) {
+            break;
+        }
+        for (int col = 0; col < WIDTH && left_col + col < terminal.cols(); ++col) {
+            terminal.write_char(row, left_col + col, lines[i][static_cast<size_t>(col)]);
+        }
+        // Class rows start with the class glyph, drawn in its colour
+        if (classes[i] != ClassPalette::NO_CLASS && left_col + 2 < terminal.cols()) {
+            const ClassPalette::Style& style = palette.style(classes[i]);
+            terminal.write_char(row, left_col + 2, style.glyph, style.color);
+        }
+    }
+}
+
+}  // namespace datapainter
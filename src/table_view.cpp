@@ -1,6 +1,7 @@
 #include "table_view.h"
 #include "unsaved_changes.h"
 #include "data_table.h"
+#include "tracer.h"
 #include <sqlite3.h>
 #include <sstream>
 #include <cmath>
@@ -36,6 +37,7 @@ std::string TableView::build_query() const {
 }
 
 void TableView::refresh_row_count() {
+    TraceSpan span("TableView::refresh_row_count");
     std::ostringstream oss;
     oss << "SELECT COUNT(*) FROM " << table_name_;
     if (!filter_.empty()) {
@@ -59,6 +61,7 @@ void TableView::refresh_row_count() {
 }
 
 std::vector<TableRow> TableView::get_visible_rows() const {
+    TraceSpan span("TableView::get_visible_rows");
     std::vector<TableRow> rows;
 
     // First get all rows from database
@@ -208,6 +211,7 @@ std::optional<ViewportBounds> TableView::get_filter_bounds() const {
 }
 
 bool TableView::add_row(double x, double y, const std::string& target) {
+    TraceSpan span("TableView::add_row");
     // Use UnsavedChanges to record the insert (doesn't go to DB yet)
     UnsavedChanges uc(db_);
     auto change_id = uc.record_insert(table_name_, x, y, target);
@@ -221,6 +225,7 @@ bool TableView::add_row(double x, double y, const std::string& target) {
 }
 
 bool TableView::delete_row(int row_id) {
+    TraceSpan span("TableView::delete_row");
     // First get the row data we're about to delete
     DataTable dt(db_, table_name_);
 
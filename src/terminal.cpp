@@ -1,4 +1,8 @@
 #include "terminal.h"
+#include "ansi_renderer.h"
+#include "event_loop.h"
+#include "frame_stats.h"
+#include "tracer.h"
 #include <iostream>
 #include <algorithm>
 
@@ -7,27 +11,128 @@
 #include <windows.h>
 #include <conio.h>
 #else
+#ifdef DATAPAINTER_WIDE_CURSES
+#define NCURSES_WIDECHAR 1
+#include <clocale>
+#include <cstdlib>
+#endif
 #include <ncurses.h>
+#include <cerrno>
+#include <poll.h>
 #include <sys/ioctl.h>
+#include <termios.h>
 #include <unistd.h>
 #endif
 
 namespace datapainter {
 
+Terminal::Backend Terminal::backend_ = Terminal::Backend::NCURSES;
+
 // Track whether ncurses is initialized
 static bool ncurses_initialized = false;
 
-Terminal::Terminal() : rows_(24), cols_(80), actual_rows_(24), actual_cols_(80) {
+#ifndef _WIN32
+static bool ncurses_colors = false;  // Colour pairs 1-7 are set up
+
+// ANSI backend state (the screen is shared by every Terminal instance)
+static bool ansi_raw_mode = false;
+static struct termios ansi_saved_termios;
+static int ansi_pushback = -1;  // Byte read while decoding an escape sequence
+
+static AnsiRenderer& ansi_screen() {
+    static AnsiRenderer renderer;
+    return renderer;
+}
+
+// Attribute for a colour cell; plain when the terminal has no colours
+static chtype ncurses_color_attr(Terminal::Color color) {
+    if (!ncurses_colors || color == Terminal::Color::DEFAULT) {
+        return 0;
+    }
+    return COLOR_PAIR(static_cast<int>(color));
+}
+
+// Draw a Unicode glyph cell; narrow curses, or a locale that cannot encode
+// it, draws the ASCII fallback
+static void ncurses_put_glyph(int row, int col, char32_t glyph, char fallback,
+                              Terminal::Color color, attr_t extra) {
+#ifdef DATAPAINTER_WIDE_CURSES
+    if (MB_CUR_MAX > 1) {
+        wchar_t wide[2] = {static_cast<wchar_t>(glyph), L'\0'};
+        short pair = (ncurses_colors && color != Terminal::Color::DEFAULT) ? static_cast<short>(color) : 0;
+        cchar_t cell;
+        setcchar(&cell, wide, extra, pair, nullptr);
+        mvadd_wch(row, col, &cell);
+        return;
+    }
+#else
+    (void)glyph;
+#endif
+    mvaddch(row, col, static_cast<chtype>(fallback) | ncurses_color_attr(color) | extra);
+}
+
+// Wait up to timeout_ms for a byte on stdin; -1 on timeout or error
+static int ansi_read_byte(int timeout_ms) {
+    if (ansi_pushback >= 0) {
+        int byte = ansi_pushback;
+        ansi_pushback = -1;
+        return byte;
+    }
+    struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+    if (poll(&pfd, 1, timeout_ms) <= 0) {
+        return -1;
+    }
+    unsigned char byte;
+    return ::read(STDIN_FILENO, &byte, 1) == 1 ? byte : -1;
+}
+
+// Decode the rest of an escape sequence (ESC already read) into a key code
+static int ansi_decode_escape() {
+    // A lone ESC is followed by nothing within the escape delay
+    int next = ansi_read_byte(25);
+    if (next < 0) {
+        return 27;
+    }
+    if (next != '[' && next != 'O') {
+        ansi_pushback = next;
+        return 27;
+    }
+
+    // CSI / SS3: parameters then a final byte in 0x40-0x7E
+    int param = 0;
+    int final_byte = -1;
+    while ((final_byte = ansi_read_byte(25)) >= 0) {
+        if (final_byte >= '0' && final_byte <= '9') {
+            param = param * 10 + (final_byte - '0');
+        } else if (final_byte >= 0x40 && final_byte <= 0x7E) {
+            break;
+        }
+    }
+    switch (final_byte) {
+        case 'A': return Terminal::KEY_UP_ARROW;
+        case 'B': return Terminal::KEY_DOWN_ARROW;
+        case 'C': return Terminal::KEY_RIGHT_ARROW;
+        case 'D': return Terminal::KEY_LEFT_ARROW;
+        case '~': return param == 3 ? 127 : 0;  // Delete key -> DEL
+        default:  return 0;                      // Unsupported sequence
+    }
+}
+#endif
+
+Terminal::Terminal()
+    : rows_(24), cols_(80), actual_rows_(24), actual_cols_(80), headless_(false),
+      event_loop_(nullptr) {
     resize_buffer();
 }
 
 Terminal::~Terminal() {
-    // Clean up ncurses if we initialized it
+    // Clean up ncurses (or the ANSI backend's raw mode) if we initialized it
 #ifndef _WIN32
     if (ncurses_initialized) {
         endwin();
         ncurses_initialized = false;
     }
+    exit_raw_mode();
 #endif
 }
 
@@ -105,6 +210,12 @@ void Terminal::clear_buffer() {
     for (auto& row : acs_buffer_) {
         std::fill(row.begin(), row.end(), AcsChar::NONE);
     }
+    for (auto& row : color_buffer_) {
+        std::fill(row.begin(), row.end(), Color::DEFAULT);
+    }
+    for (auto& row : glyph_buffer_) {
+        std::fill(row.begin(), row.end(), U'\0');
+    }
 }
 
 void Terminal::write_char(int row, int col, char ch) {
@@ -120,12 +231,30 @@ void Terminal::write_char(int row, int col, char ch) {
             buffer_[row][col] = ch;
         }
         acs_buffer_[row][col] = AcsChar::NONE;  // Clear any ACS marker
+        color_buffer_[row][col] = Color::DEFAULT;
+        glyph_buffer_[row][col] = U'\0';
+    }
+}
+
+void Terminal::write_char(int row, int col, char ch, Color color) {
+    write_char(row, col, ch);
+    if (row >= 0 && row < rows_ && col >= 0 && col < cols_) {
+        color_buffer_[row][col] = color;
+    }
+}
+
+void Terminal::write_glyph(int row, int col, char32_t glyph, char fallback, Color color) {
+    write_char(row, col, fallback, color);
+    if (row >= 0 && row < rows_ && col >= 0 && col < cols_) {
+        glyph_buffer_[row][col] = glyph;
     }
 }
 
 void Terminal::write_acs(int row, int col, Terminal::AcsChar acs_type) {
     if (row >= 0 && row < rows_ && col >= 0 && col < cols_) {
         acs_buffer_[row][col] = acs_type;
+        color_buffer_[row][col] = Color::DEFAULT;
+        glyph_buffer_[row][col] = U'\0';
         // Store ASCII fallback in buffer for read_char() and tests
         switch (acs_type) {
             case AcsChar::ULCORNER:
@@ -153,6 +282,38 @@ char Terminal::read_char(int row, int col) const {
     return ' ';
 }
 
+Terminal::AcsChar Terminal::read_acs(int row, int col) const {
+    if (row >= 0 && row < rows_ && col >= 0 && col < cols_) {
+        return acs_buffer_[row][col];
+    }
+    return AcsChar::NONE;
+}
+
+Terminal::Color Terminal::read_color(int row, int col) const {
+    if (row >= 0 && row < rows_ && col >= 0 && col < cols_) {
+        return color_buffer_[row][col];
+    }
+    return Color::DEFAULT;
+}
+
+char32_t Terminal::read_glyph(int row, int col) const {
+    if (row >= 0 && row < rows_ && col >= 0 && col < cols_) {
+        return glyph_buffer_[row][col];
+    }
+    return U'\0';
+}
+
+std::optional<Terminal::Color> Terminal::parse_color(const std::string& name) {
+    static const char* const names[] = {"default", "red", "green", "yellow",
+                                        "blue", "magenta", "cyan", "white"};
+    for (int i = 0; i < 8; ++i) {
+        if (name == names[i]) {
+            return static_cast<Color>(i);
+        }
+    }
+    return std::nullopt;
+}
+
 std::string Terminal::get_row(int row) const {
     if (row >= 0 && row < rows_) {
         return std::string(buffer_[row].begin(), buffer_[row].end());
@@ -161,7 +322,22 @@ std::string Terminal::get_row(int row) const {
 }
 
 void Terminal::render() {
+    if (headless_) {
+        return;
+    }
+
+    TraceSpan span("Terminal::render");
+    PhaseTimer timer(Phase::TERMINAL);
+
 #ifndef _WIN32
+    if (backend_ == Backend::ANSI) {
+        AnsiRenderer& screen = ansi_screen();
+        AnsiRenderer::write_all(STDOUT_FILENO, screen.compose(*this, -1, -1));
+        if (FrameStats::enabled()) {
+            FrameStats::instance().add_cells_written(screen.cells_written());
+        }
+        return;
+    }
     if (ncurses_initialized) {
         // Use ncurses for rendering
         clear();
@@ -180,13 +356,20 @@ void Terminal::render() {
                         default:                acs_ch = buffer_[row][col]; break;
                     }
                     mvaddch(row, col, acs_ch);
+                } else if (glyph_buffer_[row][col] != U'\0') {
+                    ncurses_put_glyph(row, col, glyph_buffer_[row][col], buffer_[row][col],
+                                      color_buffer_[row][col], A_NORMAL);
                 } else {
                     // Regular character
-                    mvaddch(row, col, buffer_[row][col]);
+                    mvaddch(row, col, static_cast<chtype>(buffer_[row][col]) | ncurses_color_attr(color_buffer_[row][col]));
                 }
             }
         }
         refresh();
+        if (FrameStats::enabled()) {
+            FrameStats::instance().add_cells_written(
+                static_cast<size_t>(std::min(rows_, LINES)) * static_cast<size_t>(std::min(cols_, COLS)));
+        }
         return;
     }
 #endif
@@ -200,10 +383,28 @@ void Terminal::render() {
         }
     }
     std::cout << std::flush;
+    if (FrameStats::enabled()) {
+        FrameStats::instance().add_cells_written(static_cast<size_t>(rows_) * static_cast<size_t>(cols_));
+    }
 }
 
 void Terminal::render_with_cursor(int cursor_row, int cursor_col) {
+    if (headless_) {
+        return;
+    }
+
+    TraceSpan span("Terminal::render_with_cursor");
+    PhaseTimer timer(Phase::TERMINAL);
+
 #ifndef _WIN32
+    if (backend_ == Backend::ANSI) {
+        AnsiRenderer& screen = ansi_screen();
+        AnsiRenderer::write_all(STDOUT_FILENO, screen.compose(*this, cursor_row, cursor_col));
+        if (FrameStats::enabled()) {
+            FrameStats::instance().add_cells_written(screen.cells_written());
+        }
+        return;
+    }
     if (ncurses_initialized) {
         // Use ncurses for rendering with cursor
         clear();
@@ -211,6 +412,12 @@ void Terminal::render_with_cursor(int cursor_row, int cursor_col) {
             for (int col = 0; col < cols_ && col < COLS; ++col) {
                 bool is_cursor = (row == cursor_row && col == cursor_col);
 
+                if (acs_buffer_[row][col] == AcsChar::NONE && glyph_buffer_[row][col] != U'\0') {
+                    ncurses_put_glyph(row, col, glyph_buffer_[row][col], buffer_[row][col],
+                                      color_buffer_[row][col], is_cursor ? A_REVERSE : A_NORMAL);
+                    continue;
+                }
+
                 // Get the character to display
                 chtype ch;
                 if (acs_buffer_[row][col] != AcsChar::NONE) {
@@ -225,7 +432,7 @@ void Terminal::render_with_cursor(int cursor_row, int cursor_col) {
                         default:                ch = buffer_[row][col]; break;
                     }
                 } else {
-                    ch = buffer_[row][col];
+                    ch = static_cast<chtype>(buffer_[row][col]) | ncurses_color_attr(color_buffer_[row][col]);
                 }
 
                 // Render with or without cursor highlighting
@@ -239,6 +446,10 @@ void Terminal::render_with_cursor(int cursor_row, int cursor_col) {
             }
         }
         refresh();
+        if (FrameStats::enabled()) {
+            FrameStats::instance().add_cells_written(
+                static_cast<size_t>(std::min(rows_, LINES)) * static_cast<size_t>(std::min(cols_, COLS)));
+        }
         return;
     }
 #endif
@@ -261,43 +472,37 @@ void Terminal::render_with_cursor(int cursor_row, int cursor_col) {
         }
     }
     std::cout << std::flush;
+    if (FrameStats::enabled()) {
+        FrameStats::instance().add_cells_written(static_cast<size_t>(rows_) * static_cast<size_t>(cols_));
+    }
 }
 
 void Terminal::resize_buffer() {
-    // Save old buffers
-    auto old_buffer = buffer_;
-    auto old_acs_buffer = acs_buffer_;
-    int old_rows = static_cast<int>(old_buffer.size());
-    int old_cols = old_rows > 0 ? static_cast<int>(old_buffer[0].size()) : 0;
-
-    // Create new char buffer
-    buffer_.clear();
+    // Resize in place: rows and columns that still fit keep their contents,
+    // and nothing is copied or reallocated when the size is unchanged
     buffer_.resize(rows_);
     for (auto& row : buffer_) {
         row.resize(cols_, ' ');
     }
-
-    // Create new ACS buffer
-    acs_buffer_.clear();
     acs_buffer_.resize(rows_);
     for (auto& row : acs_buffer_) {
         row.resize(cols_, AcsChar::NONE);
     }
-
-    // Copy old content that fits
-    int copy_rows = std::min(old_rows, rows_);
-    int copy_cols = std::min(old_cols, cols_);
-    for (int r = 0; r < copy_rows; ++r) {
-        for (int c = 0; c < copy_cols; ++c) {
-            buffer_[r][c] = old_buffer[r][c];
-            if (!old_acs_buffer.empty()) {
-                acs_buffer_[r][c] = old_acs_buffer[r][c];
-            }
-        }
+    color_buffer_.resize(rows_);
+    for (auto& row : color_buffer_) {
+        row.resize(cols_, Color::DEFAULT);
+    }
+    glyph_buffer_.resize(rows_);
+    for (auto& row : glyph_buffer_) {
+        row.resize(cols_, U'\0');
     }
 }
 
 bool Terminal::enter_raw_mode() {
+    if (headless_) {
+        return true;
+    }
+
 #ifdef _WIN32
     // Windows: set console mode
     HANDLE hStdin = GetStdHandle(STD_INPUT_HANDLE);
@@ -309,23 +514,69 @@ bool Terminal::enter_raw_mode() {
     SetConsoleMode(hStdin, mode & ~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT));
     return true;
 #else
+    if (backend_ == Backend::ANSI) {
+        if (!ansi_raw_mode) {
+            if (tcgetattr(STDIN_FILENO, &ansi_saved_termios) != 0) {
+                return false;
+            }
+            // Like ncurses raw(): no echo, no line buffering, no signals;
+            // ICRNL stays on so Enter reads as '\n' in both backends
+            struct termios raw = ansi_saved_termios;
+            raw.c_iflag &= ~(IXON | ISTRIP | INLCR | IGNCR | BRKINT);
+            raw.c_lflag &= ~(ECHO | ICANON | ISIG | IEXTEN);
+            raw.c_cflag |= CS8;
+            raw.c_cc[VMIN] = 1;
+            raw.c_cc[VTIME] = 0;
+            if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) {
+                return false;
+            }
+
+            // Resizes reach read_key() through the event loop's self-pipe
+            EventLoop::watch_resize();
+
+            // Alternate screen, hidden cursor
+            AnsiRenderer::write_all(STDOUT_FILENO, "\033[?1049h\033[?25l");
+            ansi_raw_mode = true;
+            ansi_screen().invalidate();
+            detect_size();
+        }
+        return true;
+    }
+
     // Unix: use ncurses
     if (!ncurses_initialized) {
         // Unset LINES and COLUMNS environment variables if they exist
         // These can interfere with ncurses's ability to detect terminal resizes
         unsetenv("LINES");
         unsetenv("COLUMNS");
+#ifdef DATAPAINTER_WIDE_CURSES
+        // Wide curses needs the user's character encoding to draw glyphs;
+        // only LC_CTYPE, so number parsing and formatting stay in "C"
+        setlocale(LC_CTYPE, "");
+#endif
 
         initscr();              // Initialize ncurses
         raw();                  // Disable line buffering
         noecho();               // Don't echo typed characters
         keypad(stdscr, TRUE);   // Enable function keys, arrow keys, etc.
-        timeout(50);            // 50ms timeout for getch() (non-blocking with timeout)
+        timeout(0);             // Non-blocking getch(); read_key() sleeps in poll()
         set_escdelay(25);       // Make ESC detection snappy for UI tests
         curs_set(0);            // Hide the default cursor (we'll draw our own)
+        if (has_colors()) {
+            // One pair per Terminal::Color on the default background
+            start_color();
+            use_default_colors();
+            for (short color = 1; color <= 7; ++color) {
+                init_pair(color, color, -1);
+            }
+            ncurses_colors = true;
+        }
 
         ncurses_initialized = true;
 
+        // Chains to ncurses' handler, so getch() still reports KEY_RESIZE
+        EventLoop::watch_resize();
+
         // Update dimensions from ncurses
         detect_size();
     }
@@ -334,6 +585,10 @@ bool Terminal::enter_raw_mode() {
 }
 
 bool Terminal::exit_raw_mode() {
+    if (headless_) {
+        return true;
+    }
+
 #ifdef _WIN32
     // Windows: restore original console mode
     HANDLE hStdin = GetStdHandle(STD_INPUT_HANDLE);
@@ -344,6 +599,14 @@ bool Terminal::exit_raw_mode() {
     SetConsoleMode(hStdin, mode | ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT);
     return true;
 #else
+    if (ansi_raw_mode) {
+        AnsiRenderer::write_all(STDOUT_FILENO, "\033[0m\033(B\033[?25h\033[?1049l");
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &ansi_saved_termios);
+        ansi_raw_mode = false;
+        ansi_screen().invalidate();
+        return true;
+    }
+
     // Unix: cleanup ncurses
     if (ncurses_initialized) {
         endwin();
@@ -354,6 +617,10 @@ bool Terminal::exit_raw_mode() {
 }
 
 int Terminal::read_key() {
+    if (headless_) {
+        return -1;
+    }
+
 #ifdef _WIN32
     // Windows: use _kbhit() and _getch()
     if (_kbhit()) {
@@ -361,15 +628,60 @@ int Terminal::read_key() {
     }
     return -1;  // No key available
 #else
+    static EventLoop default_loop;
+    EventLoop& loop = event_loop_ != nullptr ? *event_loop_ : default_loop;
+
+    if (ansi_raw_mode) {
+        for (;;) {
+            int byte = ansi_pushback;
+            ansi_pushback = -1;
+            if (byte < 0) {
+                switch (loop.wait(STDIN_FILENO)) {
+                    case EventLoop::Wake::RESIZE:
+                        ansi_screen().invalidate();
+                        return 1004;  // Terminal::KEY_RESIZE (avoid macro expansion issue)
+                    case EventLoop::Wake::TASKS:
+                        return KEY_WAKE;
+                    case EventLoop::Wake::ERROR:
+                        return -1;
+                    case EventLoop::Wake::READABLE:
+                        break;
+                }
+                unsigned char ch;
+                ssize_t n = ::read(STDIN_FILENO, &ch, 1);
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n != 1) {
+                    return -1;  // EOF or error on stdin
+                }
+                byte = ch;
+            }
+            if (byte != 27) {
+                return byte;
+            }
+            int key = ansi_decode_escape();
+            if (key != 0) {
+                return key;
+            }
+        }
+    }
+
     // Unix: use ncurses getch()
     if (ncurses_initialized) {
-        int ch;
-        // Loop until we get an actual key (not timeout)
-        // This makes read_key() truly blocking, which is correct for terminal input
+        // getch() never blocks; sleep in poll() until stdin has input. After
+        // SIGWINCH the chained ncurses handler makes getch() return KEY_RESIZE.
         // Only FileInputSource should return -1 at EOF
-        do {
-            ch = getch();
-        } while (ch == ERR);
+        int ch;
+        while ((ch = getch()) == ERR) {
+            EventLoop::Wake wake = loop.wait(STDIN_FILENO);
+            if (wake == EventLoop::Wake::TASKS) {
+                return KEY_WAKE;
+            }
+            if (wake == EventLoop::Wake::ERROR) {
+                return -1;
+            }
+        }
 
         // ncurses translates arrow keys and special events to codes
         // Map them to our public key codes
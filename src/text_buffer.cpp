@@ -0,0 +1,90 @@
+#include "text_buffer.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace datapainter {
+
+TextBuffer& TextBuffer::append(std::string_view text) {
+    size_t count = std::min(text.size(), CAPACITY - size_);
+    std::memcpy(data_ + size_, text.data(), count);
+    size_ += count;
+    return *this;
+}
+
+TextBuffer& TextBuffer::append(char c) {
+    if (size_ < CAPACITY) {
+        data_[size_++] = c;
+    }
+    return *this;
+}
+
+TextBuffer& TextBuffer::append_int(long long value) {
+    auto result = std::to_chars(data_ + size_, data_ + CAPACITY, value);
+    if (result.ec == std::errc()) {
+        size_ = static_cast<size_t>(result.ptr - data_);
+    }
+    return *this;
+}
+
+TextBuffer& TextBuffer::append_fixed(double value, int precision) {
+    auto result = std::to_chars(data_ + size_, data_ + CAPACITY, value,
+                                std::chars_format::fixed, precision);
+    if (result.ec == std::errc()) {
+        size_ = static_cast<size_t>(result.ptr - data_);
+    }
+    return *this;
+}
+
+TextBuffer& TextBuffer::append_scientific(double value, int precision) {
+    auto result = std::to_chars(data_ + size_, data_ + CAPACITY, value,
+                                std::chars_format::scientific, precision);
+    if (result.ec == std::errc()) {
+        size_ = static_cast<size_t>(result.ptr - data_);
+    }
+    return *this;
+}
+
+void TextBuffer::trim_fraction_zeros(size_t start) {
+    std::string_view number = view().substr(std::min(start, size_));
+    if (number.find('.') == std::string_view::npos) {
+        return;
+    }
+    while (size_ > start && data_[size_ - 1] == '0') {
+        --size_;
+    }
+    if (size_ > start && data_[size_ - 1] == '.') {
+        --size_;
+    }
+}
+
+void TextBuffer::resize(size_t count, char fill) {
+    count = std::min(count, CAPACITY);
+    if (count > size_) {
+        std::memset(data_ + size_, fill, count - size_);
+    }
+    size_ = count;
+}
+
+void TextBuffer::erase(size_t pos, size_t count) {
+    if (pos >= size_) {
+        return;
+    }
+    count = std::min(count, size_ - pos);
+    std::memmove(data_ + pos, data_ + pos + count, size_ - pos - count);
+    size_ -= count;
+}
+
+void TextBuffer::overwrite(size_t pos, std::string_view text) {
+    if (pos >= CAPACITY) {
+        return;
+    }
+    size_t count = std::min(text.size(), CAPACITY - pos);
+    if (pos > size_) {
+        std::memset(data_ + size_, ' ', pos - size_);
+    }
+    std::memcpy(data_ + pos, text.data(), count);
+    size_ = std::max(size_, pos + count);
+}
+
+}  // namespace datapainter
@@ -0,0 +1,147 @@
+#include "thread_pool.h"
+#include "tracer.h"
+#include <algorithm>
+#include <string>
+
+namespace datapainter {
+
+namespace {
+
+// Chunks per worker: enough slack for stealing to even out skewed chunks
+constexpr size_t CHUNKS_PER_WORKER = 4;
+
+std::atomic<int> shared_thread_setting{0};
+
+}  // namespace
+
+ThreadPool::ThreadPool(int threads) {
+    int count = threads > 0 ? threads : hardware_threads();
+    for (int i = 0; i < count; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 1; i < count; ++i) {
+        workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, size_t min_chunk, const Task& fn) {
+    if (count == 0) {
+        return;
+    }
+    min_chunk = std::max<size_t>(min_chunk, 1);
+    size_t workers = static_cast<size_t>(size());
+    if (workers == 1 || count < 2 * min_chunk) {
+        fn(0, count, 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    size_t chunks = std::min(count / min_chunk, workers * CHUNKS_PER_WORKER);
+    size_t step = count / chunks;
+    size_t extra = count % chunks;
+    pending_.store(chunks, std::memory_order_relaxed);
+
+    size_t begin = 0;
+    for (size_t i = 0; i < chunks; ++i) {
+        size_t end = begin + step + (i < extra ? 1 : 0);
+        Queue& queue = *queues_[i % workers];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.chunks.push_back(Chunk{begin, end, &fn});
+        begin = end;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(0);
+
+    // Stolen chunks may still be running on other workers
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    done_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+void ThreadPool::worker_loop(int worker) {
+    Tracer::instance().set_thread_name("pool-" + std::to_string(worker));
+    size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+        }
+        drain(worker);
+    }
+}
+
+void ThreadPool::drain(int worker) {
+    Chunk chunk{};
+    while (take(worker, chunk)) {
+        (*chunk.fn)(chunk.begin, chunk.end, worker);
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            done_.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::take(int worker, Chunk& chunk) {
+    // Own chunks newest first, then steal the oldest from the others
+    {
+        Queue& own = *queues_[static_cast<size_t>(worker)];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.chunks.empty()) {
+            chunk = own.chunks.back();
+            own.chunks.pop_back();
+            return true;
+        }
+    }
+    int workers = size();
+    for (int offset = 1; offset < workers; ++offset) {
+        Queue& victim = *queues_[static_cast<size_t>((worker + offset) % workers)];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.front();
+            victim.chunks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(shared_thread_setting.load());
+    return pool;
+}
+
+void ThreadPool::set_shared_threads(int threads) {
+    shared_thread_setting.store(threads);
+}
+
+int ThreadPool::shared_threads() {
+    int threads = shared_thread_setting.load();
+    return threads > 0 ? threads : hardware_threads();
+}
+
+int ThreadPool::hardware_threads() {
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads > 0 ? static_cast<int>(threads) : 1;
+}
+
+}  // namespace datapainter
@@ -0,0 +1,174 @@
+#include "tracer.h"
+#include "json_value.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace datapainter {
+
+std::atomic<bool> Tracer::enabled_{false};
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer() : epoch_(std::chrono::steady_clock::now()) {}
+
+int64_t Tracer::now_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch_).count();
+}
+
+std::shared_ptr<Tracer::Ring>& Tracer::this_thread_ring() {
+    thread_local std::shared_ptr<Ring> ring;
+    return ring;
+}
+
+std::string& Tracer::pending_thread_name() {
+    thread_local std::string name;
+    return name;
+}
+
+Tracer::Ring& Tracer::ring_for_this_thread() {
+    std::shared_ptr<Ring>& ring = this_thread_ring();
+    if (!ring) {
+        ring = std::make_shared<Ring>();
+        ring->spans = std::make_unique<Slot[]>(RING_CAPACITY);
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        ring->tid = static_cast<int>(rings_.size()) + 1;
+        ring->thread_name = pending_thread_name();
+        rings_.push_back(ring);
+    }
+    return *ring;
+}
+
+void Tracer::record(const char* name, int64_t start_ns, int64_t end_ns) {
+    Ring& ring = ring_for_this_thread();
+    uint64_t index = ring.written.load(std::memory_order_relaxed);
+    // A reader that sees this overwrite of span index - RING_CAPACITY must
+    // also see `written` at index, so it knows to drop that span
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot = ring.spans[index % RING_CAPACITY];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.end_ns.store(end_ns, std::memory_order_relaxed);
+    // Publish the slot for a reader on another thread
+    ring.written.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::set_thread_name(const std::string& name) {
+    pending_thread_name() = name;
+    std::shared_ptr<Ring>& ring = this_thread_ring();
+    if (ring) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        ring->thread_name = name;
+    }
+}
+
+void Tracer::clear() {
+    // Move the readers' start rather than the owners' counters, which
+    // only their threads store
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (auto& ring : rings_) {
+        ring->cleared = ring->written.load(std::memory_order_acquire);
+    }
+}
+
+size_t Tracer::span_count() const {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    size_t count = 0;
+    for (const auto& ring : rings_) {
+        uint64_t written = ring->written.load(std::memory_order_acquire);
+        uint64_t first = std::max(ring->cleared, written > RING_CAPACITY ? written - RING_CAPACITY : 0);
+        count += static_cast<size_t>(written - first);
+    }
+    return count;
+}
+
+std::vector<Tracer::Span> Tracer::snapshot(const Ring& ring) {
+    uint64_t written = ring.written.load(std::memory_order_acquire);
+    uint64_t first = std::max(ring.cleared, written > RING_CAPACITY ? written - RING_CAPACITY : 0);
+    std::vector<Span> spans;
+    spans.reserve(static_cast<size_t>(written - first));
+    for (uint64_t i = first; i < written; ++i) {
+        const Slot& slot = ring.spans[i % RING_CAPACITY];
+        spans.push_back(Span{slot.name.load(std::memory_order_relaxed),
+                             slot.start_ns.load(std::memory_order_relaxed),
+                             slot.end_ns.load(std::memory_order_relaxed)});
+    }
+
+    // The owner may have lapped the oldest spans while they were copied:
+    // writing span n overwrites span n - RING_CAPACITY, so only spans after
+    // written_now - RING_CAPACITY are intact
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t written_now = ring.written.load(std::memory_order_relaxed);
+    if (written_now >= RING_CAPACITY) {
+        uint64_t intact = written_now - RING_CAPACITY + 1;
+        if (intact > first) {
+            size_t lost = static_cast<size_t>(std::min<uint64_t>(intact - first, spans.size()));
+            spans.erase(spans.begin(), spans.begin() + static_cast<std::ptrdiff_t>(lost));
+        }
+    }
+    return spans;
+}
+
+void Tracer::write_json(std::ostream& out) const {
+    JsonValue events = JsonValue::array();
+
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (const auto& ring : rings_) {
+        if (!ring->thread_name.empty()) {
+            JsonValue args = JsonValue::object();
+            args.set("name", ring->thread_name);
+            JsonValue meta = JsonValue::object();
+            meta.set("name", "thread_name");
+            meta.set("ph", "M");
+            meta.set("pid", 1);
+            meta.set("tid", ring->tid);
+            meta.set("args", args);
+            events.push_back(meta);
+        }
+
+        for (const Span& span : snapshot(*ring)) {
+            JsonValue event = JsonValue::object();
+            event.set("name", span.name);
+            event.set("ph", "X");
+            event.set("pid", 1);
+            event.set("tid", ring->tid);
+            // Trace-event timestamps are microseconds
+            event.set("ts", static_cast<double>(span.start_ns) / 1000.0);
+            event.set("dur", static_cast<double>(span.end_ns - span.start_ns) / 1000.0);
+            events.push_back(event);
+        }
+    }
+
+    JsonValue trace = JsonValue::object();
+    trace.set("traceEvents", events);
+    trace.set("displayTimeUnit", "ms");
+    out << trace.dump() << "\n";
+}
+
+bool Tracer::write_json(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+    write_json(out);
+    out.flush();
+    return !out.fail();
+}
+
+TraceSession::TraceSession(const std::string& path) : path_(path) {
+    Tracer::instance().set_thread_name("main");
+    Tracer::set_enabled(true);
+}
+
+TraceSession::~TraceSession() {
+    Tracer::set_enabled(false);
+    if (!Tracer::instance().write_json(path_)) {
+        std::cerr << "Error: Failed to write trace: " << path_ << std::endl;
+    }
+}
+
+}  // namespace datapainter
@@ -1,5 +1,7 @@
 #include "undo_manager.h"
 #include "unsaved_changes.h"
+#include "alloc_stats.h"
+#include "tracer.h"
 #include <sqlite3.h>
 
 namespace datapainter {
@@ -10,6 +12,7 @@ UndoManager::UndoManager(Database& db, const std::string& table_name)
 }
 
 void UndoManager::refresh(bool clear_inactive) {
+    TraceSpan span("UndoManager::refresh");
     // If clear_inactive is true, remove all inactive changes (clears redo stack)
     if (clear_inactive) {
         const char* delete_sql = "DELETE FROM unsaved_changes WHERE table_name = ? AND is_active = 0";
@@ -56,6 +59,8 @@ void UndoManager::refresh(bool clear_inactive) {
 }
 
 bool UndoManager::undo() {
+    TraceSpan span("UndoManager::undo");
+    AllocScope allocs("UndoManager::undo");
     if (!can_undo()) {
         return false;
     }
@@ -91,6 +96,8 @@ bool UndoManager::undo() {
 }
 
 bool UndoManager::redo() {
+    TraceSpan span("UndoManager::redo");
+    AllocScope allocs("UndoManager::redo");
     if (!can_redo()) {
         return false;
     }
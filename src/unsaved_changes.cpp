@@ -1,5 +1,7 @@
 #include "unsaved_changes.h"
 #include "database.h"
+#include "frame_stats.h"
+#include "tracer.h"
 #include <sqlite3.h>
 
 namespace datapainter {
@@ -123,6 +125,8 @@ std::optional<int> UnsavedChanges::record_metadata_change(const std::string& tab
 }
 
 std::vector<ChangeRecord> UnsavedChanges::get_changes(const std::string& table_name) {
+    TraceSpan span("UnsavedChanges::get_changes");
+    PhaseTimer timer(Phase::JOURNAL);
     std::vector<ChangeRecord> records;
 
     sqlite3_stmt* stmt = nullptr;
@@ -189,6 +193,8 @@ std::vector<ChangeRecord> UnsavedChanges::get_changes(const std::string& table_n
 }
 
 std::vector<ChangeRecord> UnsavedChanges::get_all_changes() {
+    TraceSpan span("UnsavedChanges::get_all_changes");
+    PhaseTimer timer(Phase::JOURNAL);
     std::vector<ChangeRecord> records;
 
     sqlite3_stmt* stmt = nullptr;
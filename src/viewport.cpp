@@ -204,6 +204,11 @@ void Viewport::zoom_out(const DataCoord& center) {
     clamp_to_valid_ranges();
 }
 
+void Viewport::set_screen_size(int screen_height, int screen_width) {
+    screen_height_ = screen_height;
+    screen_width_ = screen_width;
+}
+
 void Viewport::pan_right() {
     // Pan right by 1/4 of viewport width
     double pan_amount = (data_x_max_ - data_x_min_) * 0.25;
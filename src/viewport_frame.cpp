@@ -0,0 +1,72 @@
+#include "viewport_frame.h"
+#include "frame_stats.h"
+#include <algorithm>
+#include <utility>
+
+namespace datapainter {
+
+namespace {
+
+// Saved points of one target in the viewport, for the header
+int saved_class_count(const StatsPanel& stats, const ClassPalette& palette, const std::string& target) {
+    int cls = palette.find(target);
+    return cls == ClassPalette::NO_CLASS ? 0 : static_cast<int>(stats.saved_viewport(cls).count);
+}
+
+int active_count(const std::vector<ChangeRecord>& changes) {
+    return static_cast<int>(std::count_if(changes.begin(), changes.end(),
+                                          [](const ChangeRecord& change) { return change.is_active; }));
+}
+
+}  // namespace
+
+ViewportFrame::ViewportFrame(Terminal& terminal, DataTable& table, UnsavedChanges& journal, std::string db_path)
+    : terminal_(terminal), table_(table), journal_(journal), db_path_(std::move(db_path)) {}
+
+void ViewportFrame::draw_top(const Metadata& meta, ClassPalette& palette, const Viewport& viewport,
+                             int edit_area_start_row, int edit_area_height,
+                             int cursor_row, int cursor_col, int focused_field) {
+    changes_ = journal_.get_changes(meta.table_name);
+
+    // Count saved points from the running sums: a viewport move queries
+    // only the strips it gained and lost
+    stats_.set_origin(0.5 * (viewport.valid_x_min() + viewport.valid_x_max()),
+                      0.5 * (viewport.valid_y_min() + viewport.valid_y_max()));
+    stats_.set_viewport(table_, palette, viewport.data_x_min(), viewport.data_x_max(),
+                        viewport.data_y_min(), viewport.data_y_max());
+    stats_.sync(table_, changes_, palette);
+    int total_count = static_cast<int>(stats_.saved_viewport_count());
+    int x_count = saved_class_count(stats_, palette, meta.x_meaning);
+    int o_count = saved_class_count(stats_, palette, meta.o_meaning);
+
+    // Active unsaved changes across all tables (header) and for this table
+    // only (footer)
+    int total_active_changes = active_count(journal_.get_all_changes());
+    table_active_changes_ = active_count(changes_);
+    if (FrameStats::enabled()) {
+        FrameStats::instance().set_journal_length(static_cast<size_t>(total_active_changes));
+    }
+
+    header_.render(terminal_, db_path_, meta.table_name,
+                   meta.target_col_name, meta.x_meaning, meta.o_meaning,
+                   total_count, x_count, o_count,
+                   viewport.valid_x_min(), viewport.valid_x_max(),
+                   viewport.valid_y_min(), viewport.valid_y_max(),
+                   viewport.data_x_min(), viewport.data_x_max(),
+                   viewport.data_y_min(), viewport.data_y_max(), focused_field, total_active_changes);
+
+    edit_area_.render(terminal_, viewport, table_, changes_,
+                      edit_area_start_row, edit_area_height, terminal_.cols(),
+                      cursor_row, cursor_col, palette);
+    footer_.clear_fit();
+}
+
+void ViewportFrame::draw_footer(const Viewport& viewport, double cursor_x, double cursor_y, int focused_button) {
+    footer_.render(terminal_, cursor_x, cursor_y,
+                   viewport.valid_x_min(), viewport.valid_x_max(),
+                   viewport.valid_y_min(), viewport.valid_y_max(),
+                   viewport.data_x_min(), viewport.data_x_max(),
+                   viewport.data_y_min(), viewport.data_y_max(), focused_button, table_active_changes_);
+}
+
+}  // namespace datapainter
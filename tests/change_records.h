@@ -0,0 +1,47 @@
+#pragma once
+
+#include "unsaved_changes.h"
+#include <string>
+
+namespace datapainter {
+
+// Journal records of "test_table" as UnsavedChanges::get_changes() would
+// return them, for tests that feed a journal without recording one
+
+inline ChangeRecord journal_change(int id, const std::string& action, bool active = true) {
+    ChangeRecord record{};
+    record.id = id;
+    record.table_name = "test_table";
+    record.action = action;
+    record.is_active = active;
+    return record;
+}
+
+inline ChangeRecord journal_insert(int id, double x, double y, const std::string& target, bool active = true) {
+    ChangeRecord record = journal_change(id, "insert", active);
+    record.x = x;
+    record.y = y;
+    record.new_target = target;
+    return record;
+}
+
+inline ChangeRecord journal_update(int id, int data_id, const std::string& old_target,
+                                   const std::string& new_target, bool active = true) {
+    ChangeRecord record = journal_change(id, "update", active);
+    record.data_id = data_id;
+    record.old_target = old_target;
+    record.new_target = new_target;
+    return record;
+}
+
+inline ChangeRecord journal_delete(int id, int data_id, double x, double y, const std::string& old_target,
+                                   bool active = true) {
+    ChangeRecord record = journal_change(id, "delete", active);
+    record.data_id = data_id;
+    record.x = x;
+    record.y = y;
+    record.old_target = old_target;
+    return record;
+}
+
+}  // namespace datapainter
@@ -0,0 +1,276 @@
+// Performance regression budgets (ctest -L perf)
+//
+// Built only with -DBUILD_PERF_TESTS=ON. Each test builds a fixed-seed
+// fixture, measures one operation and compares it with a budget. Budgets
+// come from the environment (set by CMake from the PERF_* cache variables)
+// and are multiplied by a machine scale: the time of a fixed calibration
+// workload divided by its time on the reference machine the defaults were
+// set on. DATAPAINTER_PERF_SCALE overrides the calibration.
+
+#include <gtest/gtest.h>
+#include "csv_exporter.h"
+#include "data_table.h"
+#include "database.h"
+#include "class_palette.h"
+#include "metadata.h"
+#include "save_manager.h"
+#include "terminal.h"
+#include "unsaved_changes.h"
+#include "viewport.h"
+#include "viewport_frame.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace datapainter;
+
+namespace {
+
+const char* const TABLE = "perf";
+constexpr double RANGE = 10.0;
+
+// Calibration workload time on the reference machine (Release build)
+constexpr double REFERENCE_CALIBRATION_MS = 325.0;
+
+// Frame at 1M points on the reference machine: about 1600 ms measured
+// (runs spread from 1300 to 2000 ms), plus 50% so that spread passes and a
+// real slowdown does not
+constexpr double FRAME_BUDGET_MS = 2400.0;
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double env_double(const char* name, double fallback) {
+    const char* value = std::getenv(name);
+    if (value == nullptr || *value == '\0') {
+        return fallback;
+    }
+    return std::atof(value);
+}
+
+std::string fixture_path(const std::string& name) {
+    auto dir = std::filesystem::temp_directory_path() /
+               ("datapainter_perf_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+    return (dir / name).string();
+}
+
+void remove_fixtures() {
+    std::filesystem::remove_all(std::filesystem::temp_directory_path() /
+                                ("datapainter_perf_" + std::to_string(::getpid())));
+}
+
+// Start peak-RSS tracking afresh so earlier fixtures do not count
+// (Linux only; elsewhere the peak covers the whole process)
+void reset_peak_rss() {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (clear_refs.is_open()) {
+        clear_refs << "5";
+    }
+}
+
+// Peak resident set size of this process in MB
+double peak_rss_mb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::atof(line.c_str() + 6) / 1024.0;  // kB
+        }
+    }
+
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);  // bytes
+#else
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;  // kilobytes
+#endif
+}
+
+void create_table(Database& db) {
+    db.ensure_metadata_table();
+    db.ensure_unsaved_changes_table();
+    MetadataManager mgr(db);
+    mgr.create_data_table(TABLE);
+    Metadata meta;
+    meta.table_name = TABLE;
+    meta.target_col_name = "target";
+    meta.x_axis_name = "x";
+    meta.y_axis_name = "y";
+    meta.x_meaning = "x";
+    meta.o_meaning = "o";
+    meta.valid_x_min = -RANGE;
+    meta.valid_x_max = RANGE;
+    meta.valid_y_min = -RANGE;
+    meta.valid_y_max = RANGE;
+    meta.show_zero_bars = false;
+    mgr.insert(meta);
+}
+
+void fill_points(Database& db, int64_t count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coord(-RANGE, RANGE);
+    db.execute("BEGIN TRANSACTION");
+    sqlite3_stmt* stmt = nullptr;
+    std::string sql = std::string("INSERT INTO ") + TABLE + " (x, y, target) VALUES (?, ?, ?)";
+    sqlite3_prepare_v2(db.connection(), sql.c_str(), -1, &stmt, nullptr);
+    for (int64_t i = 0; i < count; ++i) {
+        sqlite3_bind_double(stmt, 1, coord(rng));
+        sqlite3_bind_double(stmt, 2, coord(rng));
+        sqlite3_bind_text(stmt, 3, (i % 2 == 0) ? "x" : "o", -1, SQLITE_STATIC);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    db.execute("COMMIT");
+}
+
+// Fixed CPU + SQLite workload used to scale budgets to this machine
+double calibration_ms() {
+    auto start = Clock::now();
+    Database db(":memory:");
+    create_table(db);
+    fill_points(db, 100000);
+    DataTable table(db, TABLE);
+    auto points = table.query_viewport(-RANGE, RANGE, -RANGE, RANGE);
+    double sum = 0.0;
+    for (const auto& point : points) {
+        sum += point.x * point.y;
+    }
+    EXPECT_EQ(points.size(), 100000u) << sum;
+    return elapsed_ms(start);
+}
+
+double machine_scale() {
+    static double scale = [] {
+        double forced = env_double("DATAPAINTER_PERF_SCALE", 0.0);
+        if (forced > 0.0) {
+            return forced;
+        }
+        // Best of three so a single hiccup does not loosen every budget
+        double best = calibration_ms();
+        best = std::min(best, calibration_ms());
+        best = std::min(best, calibration_ms());
+        return best / REFERENCE_CALIBRATION_MS;
+    }();
+    return scale;
+}
+
+// Budget from the environment, scaled to this machine
+double budget(const char* name, double fallback) {
+    double value = env_double(name, fallback) * machine_scale();
+    ::testing::Test::RecordProperty(name, std::to_string(value));
+    return value;
+}
+
+}  // namespace
+
+class PerfBudgetTest : public ::testing::Test {
+protected:
+    void TearDown() override { remove_fixtures(); }
+};
+
+// One viewport frame at 1M points, drawn through the ViewportFrame that
+// the interactive loop uses: header counts, edit area (query + binning +
+// glyphs) and footer. The frame lives across iterations as it does in the
+// app, so this is the cost of a redraw after a cursor move.
+TEST_F(PerfBudgetTest, FullFrameAtOneMillionPoints) {
+    Database db(":memory:");
+    create_table(db);
+    fill_points(db, 1000000);
+    MetadataManager mgr(db);
+    Metadata meta = mgr.read(TABLE).value();
+
+    const int rows = 50;
+    const int cols = 200;
+    const int edit_area_start_row = 3;
+    const int edit_area_height = rows - 4;
+    Terminal terminal;
+    terminal.set_dimensions(rows, cols);
+    Viewport viewport(-RANGE, RANGE, -RANGE, RANGE, -RANGE, RANGE, -RANGE, RANGE, rows, cols);
+    DataTable table(db, TABLE);
+    UnsavedChanges journal(db);
+    ClassPalette palette(meta.x_meaning, meta.o_meaning);
+    ViewportFrame view(terminal, table, journal, "perf.db");
+
+    int cursor_col = cols / 2;
+    auto frame = [&] {
+        terminal.clear_buffer();
+        view.draw_top(meta, palette, viewport, edit_area_start_row, edit_area_height,
+                      rows / 2, cursor_col, -1);
+        view.draw_footer(viewport, 0.0, 0.0, 0);
+        cursor_col = (cursor_col == cols / 2) ? cols / 2 + 1 : cols / 2;
+    };
+
+    frame();  // Warm the page cache and the viewport counts
+    std::vector<double> times;
+    for (int i = 0; i < 5; ++i) {
+        auto start = Clock::now();
+        frame();
+        times.push_back(elapsed_ms(start));
+    }
+    std::sort(times.begin(), times.end());
+    double median = times[2];
+
+    double limit = budget("DATAPAINTER_PERF_FRAME_MS", FRAME_BUDGET_MS);
+    RecordProperty("frame_ms", std::to_string(median));
+    EXPECT_LT(median, limit) << "full frame at 1M points took " << median << " ms";
+}
+
+// Applying 100k journalled inserts to an on-disk table
+TEST_F(PerfBudgetTest, SaveOneHundredThousandChanges) {
+    Database db(fixture_path("save.db"));
+    create_table(db);
+
+    UnsavedChanges journal(db);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-RANGE, RANGE);
+    db.execute("BEGIN TRANSACTION");
+    for (int i = 0; i < 100000; ++i) {
+        journal.record_insert(TABLE, coord(rng), coord(rng), (i % 2 == 0) ? "x" : "o");
+    }
+    db.execute("COMMIT");
+
+    SaveManager saver(db, TABLE);
+    auto start = Clock::now();
+    ASSERT_TRUE(saver.save());
+    double ms = elapsed_ms(start);
+
+    double limit = budget("DATAPAINTER_PERF_SAVE_MS", 2000.0);
+    RecordProperty("save_ms", std::to_string(ms));
+    EXPECT_LT(ms, limit) << "saving 100k changes took " << ms << " ms";
+}
+
+// --to-csv streams rows, so memory must not grow with the table
+TEST_F(PerfBudgetTest, CsvExportPeakRssAtTenMillionRows) {
+    {
+        Database db(fixture_path("csv.db"));
+        create_table(db);
+        fill_points(db, 10000000);
+    }
+
+    reset_peak_rss();
+    Database db(fixture_path("csv.db"));
+    std::ofstream out(fixture_path("export.csv"));
+    CsvExporter exporter(db, TABLE);
+    ASSERT_TRUE(exporter.write(out)) << exporter.last_error();
+    out.close();
+
+    // Memory budgets are not scaled by the CPU calibration
+    double limit = env_double("DATAPAINTER_PERF_CSV_RSS_MB", 64.0);
+    double rss = peak_rss_mb();
+    RecordProperty("peak_rss_mb", std::to_string(rss));
+    EXPECT_LT(rss, limit) << "peak RSS during a 10M-row export was " << rss << " MB";
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "alloc_stats.h"
+#include "axis_renderer.h"
+#include "data_table.h"
+#include "database.h"
+#include "footer_renderer.h"
+#include "header_renderer.h"
+#include "metadata.h"
+#include "terminal.h"
+#include "viewport.h"
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace datapainter;
+
+namespace {
+
+// Keep the optimiser from eliding an allocation whose result is unused: a
+// store to a volatile must happen, so the pointer has to exist
+void* volatile escaped = nullptr;
+
+void escape(void* ptr) {
+    escaped = ptr;
+}
+
+}  // namespace
+
+class AllocStatsTest : public ::testing::Test {
+protected:
+    void SetUp() override { AllocStats::reset(); }
+    void TearDown() override { AllocStats::reset(); }
+};
+
+// Test: Scopes see every allocation made inside them
+TEST_F(AllocStatsTest, ScopeCountsAllocations) {
+    if (!AllocStats::available()) {
+        GTEST_SKIP() << "Configure with -DDATAPAINTER_ALLOC_STATS=ON";
+    }
+    AllocCounters delta;
+    {
+        AllocScope scope("test");
+        for (int i = 0; i < 3; ++i) {
+            auto block = std::make_unique<char[]>(100);
+            escape(block.get());
+        }
+        delta = scope.delta();
+    }
+    EXPECT_EQ(delta.allocations, 3u);
+    EXPECT_EQ(delta.frees, 3u);
+    EXPECT_EQ(delta.bytes, 300u);
+
+    AllocStats::Operation op = AllocStats::operation("test");
+    EXPECT_EQ(op.count, 1u);
+    EXPECT_GE(op.allocations, 3u);
+}
+
+// Test: Without the build option counts stay at zero
+TEST_F(AllocStatsTest, UnavailableCountsNothing) {
+    if (AllocStats::available()) {
+        GTEST_SKIP() << "Only meaningful without DATAPAINTER_ALLOC_STATS";
+    }
+    AllocScope scope("test");
+    auto block = std::make_unique<char[]>(100);
+    escape(block.get());
+    EXPECT_EQ(scope.delta().allocations, 0u);
+}
+
+// Test: Operations aggregate count, total and maximum
+TEST_F(AllocStatsTest, RecordAggregatesByName) {
+    AllocCounters small;
+    small.allocations = 2;
+    small.bytes = 64;
+    AllocCounters large;
+    large.allocations = 10;
+    large.bytes = 1000;
+
+    AllocStats::record("frame", small);
+    AllocStats::record("frame", large);
+    AllocStats::record("save", small);
+
+    AllocStats::Operation frame = AllocStats::operation("frame");
+    EXPECT_EQ(frame.count, 2u);
+    EXPECT_EQ(frame.allocations, 12u);
+    EXPECT_EQ(frame.bytes, 1064u);
+    EXPECT_EQ(frame.max_allocations, 10u);
+    EXPECT_EQ(AllocStats::operation("save").count, 1u);
+    EXPECT_EQ(AllocStats::operation("missing").count, 0u);
+
+    std::ostringstream out;
+    AllocStats::write_report(out);
+    EXPECT_NE(out.str().find("frame"), std::string::npos);
+    EXPECT_NE(out.str().find("save"), std::string::npos);
+}
+
+// Allocation budgets: these fail when a change adds heap traffic to a hot
+// path. They only run in DATAPAINTER_ALLOC_STATS builds.
+class AllocBudgetTest : public AllocStatsTest {
+protected:
+    void SetUp() override {
+        if (!AllocStats::available()) {
+            GTEST_SKIP() << "Configure with -DDATAPAINTER_ALLOC_STATS=ON";
+        }
+        AllocStatsTest::SetUp();
+    }
+
+    static uint64_t allocations_of(const std::function<void()>& body) {
+        AllocScope scope("budget");
+        body();
+        return scope.delta().allocations;
+    }
+};
+
+// Test: Coordinate transforms never allocate
+TEST_F(AllocBudgetTest, ViewportTransformsAllocateNothing) {
+    Viewport viewport(-10.0, 10.0, -10.0, 10.0, 40, 120);
+    uint64_t allocs = allocations_of([&]() {
+        for (int i = 0; i < 1000; ++i) {
+            auto screen = viewport.data_to_screen({i * 0.01, -i * 0.01});
+            if (screen.has_value()) {
+                viewport.screen_to_data(screen.value());
+            }
+        }
+    });
+    EXPECT_EQ(allocs, 0u);
+}
+
+// Test: Viewport queries allocate per query, not per point
+TEST_F(AllocBudgetTest, ViewportQueryIsNotPerPoint) {
+    Database db(":memory:");
+    ASSERT_TRUE(db.ensure_metadata_table());
+    MetadataManager mgr(db);
+    ASSERT_TRUE(mgr.create_data_table("budget"));
+    DataTable table(db, "budget");
+    for (int i = 0; i < 2000; ++i) {
+        ASSERT_TRUE(table.insert_point(i % 20 - 10.0, i / 100 - 10.0, i % 2 ? "x" : "o").has_value());
+    }
+
+    table.query_viewport(-10.0, 10.0, -10.0, 10.0);  // Warm SQLite's caches
+    uint64_t allocs = allocations_of([&]() {
+        auto points = table.query_viewport(-10.0, 10.0, -10.0, 10.0);
+        ASSERT_EQ(points.size(), 2000u);
+    });
+    EXPECT_LE(allocs, 64u);
+}
+
+// Test: Steady-state header, footer and axis rendering does not allocate
+TEST_F(AllocBudgetTest, ChromeRenderingAllocatesNothing) {
+    Terminal terminal;
+    terminal.set_dimensions(40, 120);
+    Viewport viewport(-10.0, 10.0, -10.0, 10.0, 36, 118);
+    HeaderRenderer header;
+    FooterRenderer footer;
+    AxisRenderer axes;
+    const std::string db_path = "/tmp/data.db";
+    const std::string table = "budget";
+    const std::string target = "target";
+    const std::string x_meaning = "positive";
+    const std::string o_meaning = "negative";
+    const std::string axis_name = "x";
+    double cursor_x = 1.25;
+    auto draw = [&]() {
+        header.render(terminal, db_path, table, target, x_meaning, o_meaning, 100, 60, 40,
+                      -10.0, 10.0, -10.0, 10.0, -10.0, 10.0, -10.0, 10.0, 1, 3);
+        footer.render(terminal, cursor_x, -2.5, -10.0, 10.0, -10.0, 10.0,
+                      -10.0, 10.0, -10.0, 10.0, 3, 3);
+        axes.render_x_axis(terminal, viewport, 38, 1, 118, axis_name);
+        axes.render_y_axis(terminal, viewport, 0, 3, 35, axis_name);
+        axes.render_zero_bars(terminal, viewport, 3, 1, 35, 118, true);
+    };
+    draw();
+    EXPECT_EQ(allocations_of(draw), 0u);
+
+    // Moving the cursor changes the footer text but still reuses its buffer
+    cursor_x = -7.8125;
+    EXPECT_EQ(allocations_of(draw), 0u);
+}
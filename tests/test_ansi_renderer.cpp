@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include "ansi_renderer.h"
+#include "terminal.h"
+#include <string>
+#include <unistd.h>
+
+using namespace datapainter;
+
+namespace {
+
+size_t count_of(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+}  // namespace
+
+class AnsiRendererTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        terminal_.set_dimensions(5, 20);
+        terminal_.clear_buffer();
+    }
+
+    Terminal terminal_;
+    AnsiRenderer renderer_;
+};
+
+// Test: The first frame clears the screen inside synchronized-update markers
+TEST_F(AnsiRendererTest, FirstFrameClearsAndSynchronizes) {
+    terminal_.write_char(0, 0, 'h');
+    terminal_.write_char(0, 1, 'i');
+    std::string out = renderer_.compose(terminal_, -1, -1);
+
+    EXPECT_EQ(out.rfind(AnsiRenderer::SYNC_BEGIN, 0), 0u);
+    EXPECT_NE(out.find("\033[2J"), std::string::npos);
+    EXPECT_NE(out.find("\033[1;1Hhi"), std::string::npos);
+    EXPECT_EQ(out.substr(out.size() - std::string(AnsiRenderer::SYNC_END).size()), AnsiRenderer::SYNC_END);
+    // Blank cells are covered by the clear
+    EXPECT_EQ(renderer_.cells_written(), 2u);
+}
+
+// Test: An unchanged frame produces no output at all
+TEST_F(AnsiRendererTest, UnchangedFrameIsEmpty) {
+    terminal_.write_char(1, 1, 'x');
+    renderer_.compose(terminal_, 2, 2);
+    EXPECT_TRUE(renderer_.compose(terminal_, 2, 2).empty());
+    EXPECT_EQ(renderer_.cells_written(), 0u);
+}
+
+// Test: Only changed cells are sent, addressed by a cursor move
+TEST_F(AnsiRendererTest, SendsOnlyChangedRuns) {
+    renderer_.compose(terminal_, -1, -1);
+
+    terminal_.write_char(2, 4, 'o');
+    terminal_.write_char(2, 5, 'k');
+    std::string out = renderer_.compose(terminal_, -1, -1);
+    EXPECT_EQ(out.find("\033[2J"), std::string::npos);
+    EXPECT_NE(out.find("\033[3;5Hok"), std::string::npos);
+    EXPECT_EQ(renderer_.cells_written(), 2u);
+}
+
+// Test: Short unchanged gaps are rewritten instead of re-addressed
+TEST_F(AnsiRendererTest, ShortGapsAreRewritten) {
+    renderer_.compose(terminal_, -1, -1);
+
+    terminal_.write_char(1, 2, 'a');
+    terminal_.write_char(1, 5, 'b');
+    terminal_.write_char(1, 18, 'c');
+    std::string out = renderer_.compose(terminal_, -1, -1);
+    EXPECT_NE(out.find("\033[2;3Ha  b"), std::string::npos);
+    EXPECT_NE(out.find("\033[2;19Hc"), std::string::npos);
+    EXPECT_EQ(count_of(out, "H"), 2u);
+}
+
+// Test: SGR reverse video is switched on and off once for the cursor
+TEST_F(AnsiRendererTest, CursorUsesReverseVideo) {
+    terminal_.write_char(3, 7, 'x');
+    std::string out = renderer_.compose(terminal_, 3, 7);
+    EXPECT_NE(out.find("\033[4;8H\033[7mx"), std::string::npos);
+    EXPECT_EQ(count_of(out, "\033[7m"), 1u);
+    EXPECT_EQ(count_of(out, "\033[27m"), 1u);
+
+    // Moving the cursor repaints just the two affected cells
+    out = renderer_.compose(terminal_, 3, 8);
+    EXPECT_EQ(renderer_.cells_written(), 2u);
+    EXPECT_NE(out.find("x\033[7m "), std::string::npos);
+}
+
+// Test: Box-drawing cells use the DEC line-drawing charset
+TEST_F(AnsiRendererTest, AcsUsesLineDrawingCharset) {
+    terminal_.write_acs(0, 0, Terminal::AcsChar::ULCORNER);
+    terminal_.write_acs(0, 1, Terminal::AcsChar::HLINE);
+    terminal_.write_acs(0, 2, Terminal::AcsChar::URCORNER);
+    terminal_.write_char(0, 3, 'T');
+    std::string out = renderer_.compose(terminal_, -1, -1);
+    EXPECT_NE(out.find("\033(0lqk\033(BT"), std::string::npos);
+}
+
+// Test: Foreground colour is switched only when it changes and reset at the end
+TEST_F(AnsiRendererTest, ColourChangesAreTracked) {
+    terminal_.write_char(2, 0, 'a', Terminal::Color::RED);
+    terminal_.write_char(2, 1, 'b', Terminal::Color::RED);
+    terminal_.write_char(2, 2, 'c', Terminal::Color::BLUE);
+    terminal_.write_char(2, 3, 'd');
+    std::string out = renderer_.compose(terminal_, -1, -1);
+    EXPECT_NE(out.find("\033[31mab\033[34mc\033[39md"), std::string::npos);
+
+    // A colour-only change is still a changed cell
+    terminal_.write_char(2, 3, 'd', Terminal::Color::GREEN);
+    out = renderer_.compose(terminal_, -1, -1);
+    EXPECT_EQ(renderer_.cells_written(), 1u);
+    EXPECT_NE(out.find("\033[32md\033[39m"), std::string::npos);
+}
+
+// Test: Unicode glyphs are sent as UTF-8 and diffed like characters
+TEST_F(AnsiRendererTest, GlyphsAreUtf8) {
+    terminal_.write_glyph(1, 0, U'\u2593', '%', Terminal::Color::DEFAULT);
+    std::string out = renderer_.compose(terminal_, -1, -1);
+    EXPECT_NE(out.find("\xE2\x96\x93"), std::string::npos);
+    EXPECT_EQ(out.find('%'), std::string::npos);
+
+    // Same fallback, different glyph: still a change
+    terminal_.write_glyph(1, 0, U'\u2588', '%', Terminal::Color::DEFAULT);
+    out = renderer_.compose(terminal_, -1, -1);
+    EXPECT_EQ(renderer_.cells_written(), 1u);
+    EXPECT_NE(out.find("\xE2\x96\x88"), std::string::npos);
+}
+
+// Test: Invalidating or resizing forces a full repaint
+TEST_F(AnsiRendererTest, InvalidateAndResizeRepaint) {
+    terminal_.write_char(0, 0, 'z');
+    renderer_.compose(terminal_, -1, -1);
+
+    renderer_.invalidate();
+    std::string out = renderer_.compose(terminal_, -1, -1);
+    EXPECT_NE(out.find("\033[2J"), std::string::npos);
+    EXPECT_NE(out.find('z'), std::string::npos);
+
+    terminal_.set_dimensions(6, 30);
+    out = renderer_.compose(terminal_, -1, -1);
+    EXPECT_NE(out.find("\033[2J"), std::string::npos);
+}
+
+// Test: write_all delivers the whole buffer
+TEST_F(AnsiRendererTest, WriteAllDeliversBuffer) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::string bytes(1000, 'q');
+    EXPECT_TRUE(AnsiRenderer::write_all(fds[1], bytes));
+    close(fds[1]);
+
+    std::string received;
+    char chunk[256];
+    ssize_t n;
+    while ((n = read(fds[0], chunk, sizeof(chunk))) > 0) {
+        received.append(chunk, static_cast<size_t>(n));
+    }
+    close(fds[0]);
+    EXPECT_EQ(received, bytes);
+    EXPECT_FALSE(AnsiRenderer::write_all(-1, bytes));
+}
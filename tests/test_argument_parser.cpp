@@ -238,6 +238,18 @@ TEST(ArgumentParserTest, ValidateValidRanges) {
     EXPECT_TRUE(errors.empty());
 }
 
+// Test validation: table names must be identifiers, as they reach SQL
+TEST(ArgumentParserTest, ValidateTableName) {
+    Arguments args;
+    args.table = "bad name";
+    auto errors = ArgumentParser::validate(args);
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_EQ(errors[0], "Invalid table name: bad name");
+
+    args.table = "Good_1";
+    EXPECT_TRUE(ArgumentParser::validate(args).empty());
+}
+
 // Test validation: --study requires --database and --table
 TEST(ArgumentParserTest, ValidateStudyRequiresDatabaseAndTable) {
     Arguments args;
@@ -263,6 +275,32 @@ TEST(ArgumentParserTest, ValidateStudyWithDatabaseAndTable) {
     EXPECT_TRUE(errors.empty());
 }
 
+// Test parsing replay options
+TEST(ArgumentParserTest, ParseReplayOptions) {
+    ArgvHelper args({"datapainter", "--keystroke-file", "keys.txt", "--headless", "--fast-replay"});
+    auto parsed = ArgumentParser::parse(args.argc(), args.argv());
+
+    EXPECT_EQ(parsed.keystroke_file, "keys.txt");
+    EXPECT_TRUE(parsed.headless);
+    EXPECT_TRUE(parsed.fast_replay);
+}
+
+// Test validation: --headless and --fast-replay need a keystroke file
+TEST(ArgumentParserTest, ValidateReplayOptionsRequireKeystrokeFile) {
+    Arguments args;
+    args.fast_replay = true;
+    args.headless = true;
+    args.table = "test_table";
+
+    auto errors = ArgumentParser::validate(args);
+    EXPECT_EQ(std::count_if(errors.begin(), errors.end(),
+                            [](const std::string& e) { return e.find("--keystroke-file") != std::string::npos; }),
+              2);
+
+    args.keystroke_file = "keys.txt";
+    EXPECT_TRUE(ArgumentParser::validate(args).empty());
+}
+
 // Test parsing with no arguments
 TEST(ArgumentParserTest, ParseNoArguments) {
     ArgvHelper args({"datapainter"});
@@ -716,3 +754,138 @@ TEST(ArgumentParserTest, ConflictMessageSuggestsResolution) {
                 msg.find("remove") != std::string::npos);
     EXPECT_TRUE(msg.find("different table") != std::string::npos);
 }
+
+// Test parsing --profile-sql
+TEST(ArgumentParserTest, ParseProfileSql) {
+    ArgvHelper args({"datapainter", "--database", "test.db", "--list-tables", "--profile-sql", "sql.txt"});
+    auto parsed = ArgumentParser::parse(args.argc(), args.argv());
+
+    EXPECT_EQ(parsed.profile_sql, "sql.txt");
+    EXPECT_TRUE(parsed.list_tables);
+}
+
+// Test: --backend accepts ncurses and ansi only
+TEST(ArgumentParserTest, ParseBackend) {
+    ArgvHelper ansi({"datapainter", "--database", "test.db", "--table", "t", "--backend", "ansi"});
+    auto parsed = ArgumentParser::parse(ansi.argc(), ansi.argv());
+    EXPECT_EQ(parsed.terminal_backend, "ansi");
+    EXPECT_TRUE(parsed.error_messages.empty());
+
+    ArgvHelper bad({"datapainter", "--database", "test.db", "--backend", "vt52"});
+    parsed = ArgumentParser::parse(bad.argc(), bad.argv());
+    ASSERT_EQ(parsed.error_messages.size(), 1u);
+    EXPECT_NE(parsed.error_messages[0].find("--backend"), std::string::npos);
+}
+
+// Test: --class-style is repeatable and validated
+TEST(ArgumentParserTest, ParseClassStyle) {
+    ArgvHelper ok({"datapainter", "--database", "test.db", "--class-style", "cat=c:red",
+                   "--class-style", "dog=d"});
+    auto parsed = ArgumentParser::parse(ok.argc(), ok.argv());
+    EXPECT_EQ(parsed.class_styles, (std::vector<std::string>{"cat=c:red", "dog=d"}));
+    EXPECT_TRUE(parsed.error_messages.empty());
+
+    ArgvHelper bad({"datapainter", "--database", "test.db", "--class-style", "cat=c:mauve",
+                    "--class-style", "dog=#"});
+    parsed = ArgumentParser::parse(bad.argc(), bad.argv());
+    ASSERT_EQ(parsed.error_messages.size(), 2u);
+    EXPECT_NE(parsed.error_messages[0].find("mauve"), std::string::npos);
+}
+
+// Test: --render-mode accepts points, density and braille only
+TEST(ArgumentParserTest, ParseRenderMode) {
+    ArgvHelper density({"datapainter", "--database", "test.db", "--table", "t", "--render-mode", "density"});
+    auto parsed = ArgumentParser::parse(density.argc(), density.argv());
+    EXPECT_EQ(parsed.render_mode, "density");
+    EXPECT_TRUE(parsed.error_messages.empty());
+
+    ArgvHelper braille({"datapainter", "--database", "test.db", "--table", "t", "--render-mode", "braille"});
+    parsed = ArgumentParser::parse(braille.argc(), braille.argv());
+    EXPECT_EQ(parsed.render_mode, "braille");
+    EXPECT_TRUE(parsed.error_messages.empty());
+
+    ArgvHelper bad({"datapainter", "--database", "test.db", "--render-mode", "sparkles"});
+    parsed = ArgumentParser::parse(bad.argc(), bad.argv());
+    ASSERT_EQ(parsed.error_messages.size(), 1u);
+    EXPECT_NE(parsed.error_messages[0].find("--render-mode"), std::string::npos);
+}
+
+// Test: --threads takes a worker count from 1 to 256
+TEST(ArgumentParserTest, ParseThreads) {
+    ArgvHelper four({"datapainter", "--database", "test.db", "--threads", "4"});
+    auto parsed = ArgumentParser::parse(four.argc(), four.argv());
+    EXPECT_EQ(parsed.threads, 4);
+    EXPECT_TRUE(parsed.error_messages.empty());
+
+    ArgvHelper zero({"datapainter", "--database", "test.db", "--threads", "0"});
+    parsed = ArgumentParser::parse(zero.argc(), zero.argv());
+    EXPECT_FALSE(parsed.threads.has_value());
+    ASSERT_EQ(parsed.error_messages.size(), 1u);
+    EXPECT_NE(parsed.error_messages[0].find("--threads"), std::string::npos);
+}
+
+// Test: --knn takes a neighbour count from 1 to 32
+TEST(ArgumentParserTest, ParseKnn) {
+    ArgvHelper seven({"datapainter", "--database", "test.db", "--knn", "7"});
+    auto parsed = ArgumentParser::parse(seven.argc(), seven.argv());
+    EXPECT_EQ(parsed.knn, 7);
+    EXPECT_TRUE(parsed.error_messages.empty());
+
+    ArgvHelper none({"datapainter", "--database", "test.db"});
+    parsed = ArgumentParser::parse(none.argc(), none.argv());
+    EXPECT_FALSE(parsed.knn.has_value());
+
+    ArgvHelper big({"datapainter", "--database", "test.db", "--knn", "33"});
+    parsed = ArgumentParser::parse(big.argc(), big.argv());
+    EXPECT_FALSE(parsed.knn.has_value());
+    ASSERT_EQ(parsed.error_messages.size(), 1u);
+    EXPECT_NE(parsed.error_messages[0].find("--knn"), std::string::npos);
+}
+
+// Test: --logistic starts with the regression overlay shown
+TEST(ArgumentParserTest, ParseLogistic) {
+    ArgvHelper on({"datapainter", "--database", "test.db", "--logistic"});
+    EXPECT_TRUE(ArgumentParser::parse(on.argc(), on.argv()).show_logistic);
+    ArgvHelper off({"datapainter", "--database", "test.db"});
+    EXPECT_FALSE(ArgumentParser::parse(off.argc(), off.argv()).show_logistic);
+}
+
+// Test: --kde shows the contours; --kde-bandwidth takes a width or scott
+TEST(ArgumentParserTest, ParseKde) {
+    ArgvHelper on({"datapainter", "--database", "test.db", "--kde", "--kde-bandwidth", "0.25"});
+    auto parsed = ArgumentParser::parse(on.argc(), on.argv());
+    EXPECT_TRUE(parsed.show_kde);
+    EXPECT_EQ(parsed.kde_bandwidth, 0.25);
+
+    ArgvHelper scott({"datapainter", "--database", "test.db", "--kde-bandwidth", "scott"});
+    parsed = ArgumentParser::parse(scott.argc(), scott.argv());
+    EXPECT_FALSE(parsed.show_kde);
+    EXPECT_FALSE(parsed.kde_bandwidth.has_value());
+    EXPECT_TRUE(parsed.error_messages.empty());
+
+    ArgvHelper bad({"datapainter", "--database", "test.db", "--kde-bandwidth", "-1"});
+    parsed = ArgumentParser::parse(bad.argc(), bad.argv());
+    EXPECT_FALSE(parsed.kde_bandwidth.has_value());
+    ASSERT_EQ(parsed.error_messages.size(), 1u);
+    EXPECT_NE(parsed.error_messages[0].find("--kde-bandwidth"), std::string::npos);
+}
+
+// Test: --stats shows the statistics panel
+TEST(ArgumentParserTest, ParseStats) {
+    ArgvHelper on({"datapainter", "--database", "test.db", "--stats"});
+    EXPECT_TRUE(ArgumentParser::parse(on.argc(), on.argv()).show_stats);
+    ArgvHelper off({"datapainter", "--database", "test.db"});
+    EXPECT_FALSE(ArgumentParser::parse(off.argc(), off.argv()).show_stats);
+}
+
+// Test: --kmeans takes a cluster count from 1 to 16
+TEST(ArgumentParserTest, ParseKmeans) {
+    ArgvHelper three({"datapainter", "--database", "test.db", "--kmeans", "3"});
+    EXPECT_EQ(ArgumentParser::parse(three.argc(), three.argv()).kmeans, 3);
+
+    ArgvHelper big({"datapainter", "--database", "test.db", "--kmeans", "17"});
+    auto parsed = ArgumentParser::parse(big.argc(), big.argv());
+    EXPECT_FALSE(parsed.kmeans.has_value());
+    ASSERT_EQ(parsed.error_messages.size(), 1u);
+    EXPECT_NE(parsed.error_messages[0].find("--kmeans"), std::string::npos);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "cell_grid.h"
+#include <vector>
+
+using namespace datapainter;
+
+// Test: Cells track class presence, point count and the majority class
+TEST(CellGridTest, BinsClassesAndDominant) {
+    CellGrid grid;
+    grid.reset(4, 5);
+    grid.add(1, 2, 0);
+    grid.add(1, 2, 3);
+    grid.add(1, 2, 3);
+    grid.add(3, 4, 63);
+
+    const auto& mixed = grid.at(1, 2);
+    EXPECT_EQ(mixed.count, 3u);
+    EXPECT_EQ(mixed.classes, (uint64_t{1} << 0) | (uint64_t{1} << 3));
+    EXPECT_TRUE(mixed.mixed());
+    EXPECT_EQ(mixed.dominant, 3);
+
+    const auto& single = grid.at(3, 4);
+    EXPECT_FALSE(single.mixed());
+    EXPECT_EQ(single.dominant, 63);
+    EXPECT_TRUE(grid.at(0, 0).empty());
+}
+
+// Test: Out-of-range points are ignored
+TEST(CellGridTest, IgnoresOutOfRange) {
+    CellGrid grid;
+    grid.reset(2, 2);
+    grid.add(-1, 0, 0);
+    grid.add(0, 2, 0);
+    grid.add(2, 0, 0);
+    EXPECT_EQ(grid.occupied_count(), 0u);
+}
+
+// Test: Occupied cells are visited once and cleared by the next reset
+TEST(CellGridTest, OccupiedCellsAndReset) {
+    CellGrid grid;
+    grid.reset(3, 3);
+    grid.add(2, 1, 1);
+    grid.add(0, 0, 0);
+    grid.add(2, 1, 1);
+
+    std::vector<std::pair<int, int>> visited;
+    grid.for_each_occupied([&](int row, int col, const CellGrid::Cell& cell) {
+        visited.emplace_back(row, col);
+        EXPECT_FALSE(cell.empty());
+    });
+    EXPECT_EQ(visited, (std::vector<std::pair<int, int>>{{2, 1}, {0, 0}}));
+
+    grid.reset(3, 3);
+    EXPECT_TRUE(grid.at(2, 1).empty());
+    EXPECT_EQ(grid.occupied_count(), 0u);
+
+    grid.reset(4, 2);
+    EXPECT_EQ(grid.rows(), 4);
+    EXPECT_EQ(grid.cols(), 2);
+    EXPECT_TRUE(grid.at(3, 1).empty());
+}
+
+// Test: x/o counts and the frame's busiest cell are tracked
+TEST(CellGridTest, BinaryCountsAndMaxCount) {
+    CellGrid grid;
+    grid.reset(2, 2);
+    grid.add(0, 0, 0);
+    grid.add(0, 0, 1);
+    grid.add(0, 0, 1);
+    grid.add(1, 1, 5);
+    EXPECT_EQ(grid.at(0, 0).binary[0], 1u);
+    EXPECT_EQ(grid.at(0, 0).binary[1], 2u);
+    EXPECT_EQ(grid.at(1, 1).binary[0] + grid.at(1, 1).binary[1], 0u);
+    EXPECT_EQ(grid.max_count(), 3u);
+
+    grid.reset(2, 2);
+    EXPECT_EQ(grid.max_count(), 0u);
+}
+
+// Test: Merging worker grids sums counts and keeps a strict majority dominant
+TEST(CellGridTest, MergeCombinesWorkerGrids) {
+    CellGrid grid;
+    CellGrid worker;
+    grid.reset(2, 2);
+    worker.reset(2, 2);
+    grid.add(0, 0, 0);
+    grid.add(0, 0, 2);
+    worker.add(0, 0, 2);
+    worker.add(0, 0, 2);
+    worker.add(1, 1, 1);
+
+    grid.merge(worker);
+    const auto& cell = grid.at(0, 0);
+    EXPECT_EQ(cell.count, 4u);
+    EXPECT_EQ(cell.classes, (uint64_t{1} << 0) | (uint64_t{1} << 2));
+    EXPECT_EQ(cell.binary[0], 1u);
+    EXPECT_EQ(cell.dominant, 2);  // Three of four points
+    EXPECT_EQ(grid.at(1, 1).binary[1], 1u);
+    EXPECT_EQ(grid.occupied_count(), 2u);
+    EXPECT_EQ(grid.max_count(), 4u);
+}
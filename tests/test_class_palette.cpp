@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "class_palette.h"
+#include <set>
+#include <string>
+
+using namespace datapainter;
+
+// Test: x/o meanings are classes 0 and 1 with the classic glyphs
+TEST(ClassPaletteTest, BinaryClassesFirst) {
+    ClassPalette palette("pos", "neg");
+    ASSERT_EQ(palette.size(), 2);
+    EXPECT_EQ(palette.classify("pos"), 0);
+    EXPECT_EQ(palette.classify("neg"), 1);
+    EXPECT_EQ(palette.style(0).glyph, 'x');
+    EXPECT_EQ(palette.style(0).multi_glyph, 'X');
+    EXPECT_EQ(palette.style(1).glyph, 'o');
+    EXPECT_EQ(palette.style(1).multi_glyph, 'O');
+}
+
+// Test: Unseen targets are registered with distinct default glyphs up to 64
+TEST(ClassPaletteTest, RegistersUpToSixtyFourClasses) {
+    ClassPalette palette("x", "o");
+    EXPECT_EQ(palette.find("a-target"), ClassPalette::NO_CLASS);
+    EXPECT_EQ(palette.classify("a-target"), 2);
+    EXPECT_EQ(palette.find("a-target"), 2);
+    EXPECT_EQ(palette.style(2).glyph, 'a');
+    EXPECT_EQ(palette.style(2).multi_glyph, 'A');
+
+    for (int i = 3; i < ClassPalette::MAX_CLASSES; ++i) {
+        EXPECT_EQ(palette.classify("t" + std::to_string(i)), i);
+    }
+    EXPECT_EQ(palette.classify("one-too-many"), ClassPalette::NO_CLASS);
+
+    std::set<char> glyphs;
+    for (int i = 0; i < palette.size(); ++i) {
+        char glyph = palette.style(i).glyph;
+        EXPECT_NE(glyph, '#');
+        EXPECT_NE(glyph, '!');
+        glyphs.insert(glyph);
+    }
+    EXPECT_EQ(glyphs.size(), static_cast<size_t>(ClassPalette::MAX_CLASSES));
+}
+
+// Test: Specs set glyph and colour; invalid specs are rejected
+TEST(ClassPaletteTest, ApplySpec) {
+    ClassPalette palette("x", "o");
+    std::string error;
+    ASSERT_TRUE(palette.apply_spec("x=+:green", error)) << error;
+    EXPECT_EQ(palette.style(0).glyph, '+');
+    EXPECT_EQ(palette.style(0).multi_glyph, '+');
+    EXPECT_EQ(palette.style(0).color, Terminal::Color::GREEN);
+
+    ASSERT_TRUE(palette.apply_spec("cat==", error)) << error;
+    EXPECT_EQ(palette.style(palette.find("cat")).glyph, '=');
+
+    EXPECT_FALSE(ClassPalette::validate_spec("nothing", error));
+    EXPECT_FALSE(ClassPalette::validate_spec("=c", error));
+    EXPECT_FALSE(ClassPalette::validate_spec("cat=cc", error));
+    EXPECT_FALSE(ClassPalette::validate_spec("cat=!", error));
+    EXPECT_FALSE(ClassPalette::validate_spec("cat=c:mauve", error));
+    EXPECT_NE(error.find("mauve"), std::string::npos);
+}
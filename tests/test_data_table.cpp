@@ -188,3 +188,83 @@ TEST_F(DataTableTest, CountByTargetNonExistent) {
     data_table->insert_point(1.0, 2.0, "x");
     EXPECT_EQ(data_table->count_by_target("nonexistent"), 0);
 }
+
+// Test aggregate bin counts over a coarse grid
+TEST_F(DataTableTest, CountInBins) {
+    data_table->insert_point(0.5, 3.5, "x");   // Top-left of a 4x4 grid over [0, 4]
+    data_table->insert_point(0.2, 3.9, "o");
+    data_table->insert_point(4.0, 0.0, "x");   // Max corner clamps to (3, 3)
+    data_table->insert_point(2.5, 1.5, "x");
+    data_table->insert_point(9.0, 9.0, "x");   // Outside
+
+    auto bins = data_table->count_in_bins(0.0, 4.0, 0.0, 4.0, 4, 4);
+    ASSERT_EQ(bins.size(), 3u);
+    int total = 0;
+    for (const auto& bin : bins) {
+        total += bin.count;
+        if (bin.row == 0 && bin.col == 0) {
+            EXPECT_EQ(bin.count, 2);
+        } else {
+            EXPECT_TRUE((bin.row == 3 && bin.col == 3) || (bin.row == 2 && bin.col == 2))
+                << bin.row << "," << bin.col;
+        }
+    }
+    EXPECT_EQ(total, 4);
+    EXPECT_TRUE(data_table->count_in_bins(0.0, 0.0, 0.0, 4.0, 4, 4).empty());
+}
+
+// Test aggregate bin counts restricted to one target
+TEST_F(DataTableTest, CountInBinsForTarget) {
+    data_table->insert_point(0.5, 3.5, "x");
+    data_table->insert_point(0.2, 3.9, "o");
+    data_table->insert_point(2.5, 1.5, "x");
+
+    auto bins = data_table->count_in_bins(0.0, 4.0, 0.0, 4.0, 4, 4, std::string("o"));
+    ASSERT_EQ(bins.size(), 1u);
+    EXPECT_EQ(bins[0].row, 0);
+    EXPECT_EQ(bins[0].col, 0);
+    EXPECT_EQ(bins[0].count, 1);
+    EXPECT_EQ(data_table->count_in_bins(0.0, 4.0, 0.0, 4.0, 4, 4, std::string("x")).size(), 2u);
+    EXPECT_TRUE(data_table->count_in_bins(0.0, 4.0, 0.0, 4.0, 4, 4, std::string("z")).empty());
+}
+
+// Test looking up a single point by id
+TEST_F(DataTableTest, GetPoint) {
+    int id = data_table->insert_point(1.5, -2.5, "o").value();
+    auto point = data_table->get_point(id);
+    ASSERT_TRUE(point.has_value());
+    EXPECT_EQ(point->id, id);
+    EXPECT_DOUBLE_EQ(point->x, 1.5);
+    EXPECT_DOUBLE_EQ(point->y, -2.5);
+    EXPECT_EQ(point->target, "o");
+    EXPECT_FALSE(data_table->get_point(id + 1).has_value());
+}
+
+// Test per-target coordinate sums about an origin, with open and closed bounds
+TEST_F(DataTableTest, SumByTarget) {
+    data_table->insert_point(1.0, 2.0, "x");
+    data_table->insert_point(3.0, 4.0, "x");
+    data_table->insert_point(2.0, 2.0, "o");
+
+    auto sums = data_table->sum_by_target(1.0, 1.0);
+    ASSERT_EQ(sums.size(), 2u);
+    const TargetSums& o = sums[0].target == "o" ? sums[0] : sums[1];
+    const TargetSums& x = sums[0].target == "x" ? sums[0] : sums[1];
+    EXPECT_EQ(x.count, 2);
+    EXPECT_DOUBLE_EQ(x.sum_x, 2.0);   // 0 + 2
+    EXPECT_DOUBLE_EQ(x.sum_y, 4.0);   // 1 + 3
+    EXPECT_DOUBLE_EQ(x.sum_xx, 4.0);
+    EXPECT_DOUBLE_EQ(x.sum_yy, 10.0);
+    EXPECT_DOUBLE_EQ(x.sum_xy, 6.0);
+    EXPECT_EQ(o.count, 1);
+    EXPECT_DOUBLE_EQ(o.sum_xy, 1.0);
+
+    // The point at x = 3 lies on the edge: counted only while it is closed
+    DataRegion region{0.0, 3.0, 0.0, 5.0};
+    EXPECT_EQ(data_table->sum_by_target(0.0, 0.0, region).size(), 2u);
+    region.open_x_max = true;
+    region.open_y_min = true;
+    for (const auto& target : data_table->sum_by_target(0.0, 0.0, region)) {
+        EXPECT_EQ(target.count, 1) << target.target;
+    }
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include "dot_grid.h"
+
+using namespace datapainter;
+
+// Test: Dots refine the viewport's cells, so every dot's cell matches data_to_screen
+TEST(DotGridTest, DotsLieInViewportCells) {
+    Viewport viewport(-4.0, 4.0, -4.0, 4.0, 8, 8);
+    DotGrid dots;
+    dots.reset(viewport, 8, 8);
+
+    for (double x = -4.0; x <= 4.0; x += 0.37) {
+        for (double y = -4.0; y <= 4.0; y += 0.41) {
+            int dot_row = -1;
+            int dot_col = -1;
+            ASSERT_TRUE(dots.locate(x, y, dot_row, dot_col));
+            auto screen = viewport.data_to_screen(DataCoord{x, y});
+            ASSERT_TRUE(screen.has_value());
+            EXPECT_EQ(dot_row / DotGrid::DOTS_PER_ROW, screen->row) << x << "," << y;
+            EXPECT_EQ(dot_col / DotGrid::DOTS_PER_COL, screen->col) << x << "," << y;
+        }
+    }
+
+    int dot_row = 0;
+    int dot_col = 0;
+    EXPECT_FALSE(dots.locate(4.5, 0.0, dot_row, dot_col));
+}
+
+// Test: Dots pack into braille bit order and glyphs
+TEST(DotGridTest, BrailleBits) {
+    Viewport viewport(0.0, 1.0, 0.0, 1.0, 2, 2);
+    DotGrid dots;
+    dots.reset(viewport, 2, 2);
+    dots.set(0, 0);  // Dot 1
+    dots.set(3, 1);  // Dot 8
+    dots.set(1, 2);  // Dot 2 of cell (0, 1)
+    dots.set(8, 0);  // Outside the grid
+    EXPECT_EQ(dots.at(0, 0), 0x81);
+    EXPECT_EQ(dots.at(0, 1), 0x02);
+    EXPECT_EQ(DotGrid::glyph(dots.at(0, 0)), U'⢁');
+    EXPECT_EQ(DotGrid::glyph(0), U'⠀');
+
+    dots.reset(viewport, 2, 2);
+    EXPECT_EQ(dots.at(0, 0), 0);
+}
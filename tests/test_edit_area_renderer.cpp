@@ -566,3 +566,171 @@ TEST_F(EditAreaRendererTest, InactiveUnsavedChangesIgnored) {
     EXPECT_EQ(terminal.read_char(screen.row + 1, screen.col + 1), ' ')
         << "Inactive change should not render";
 }
+
+// Test: Targets other than x/o get their own glyphs instead of being dropped
+TEST_F(EditAreaRendererTest, RendersAdditionalClasses) {
+    Terminal terminal;
+    terminal.set_dimensions(10, 10);
+    Viewport viewport(-4.0, 4.0, -4.0, 4.0, 8, 8);
+    EditAreaRenderer renderer;
+
+    table_->insert_point(-2.0, 2.0, "2");
+    table_->insert_point(2.0, -2.0, "3");
+    table_->insert_point(2.0, -2.0, "3");
+
+    renderer.render(terminal, viewport, *table_, {}, 0, 10, 10, 0, 0, "0", "1");
+
+    auto single = viewport.data_to_screen(DataCoord{-2.0, 2.0});
+    auto multiple = viewport.data_to_screen(DataCoord{2.0, -2.0});
+    ASSERT_TRUE(single.has_value() && multiple.has_value());
+    EXPECT_EQ(terminal.read_char(single->row + 1, single->col + 1), 'a');
+    EXPECT_EQ(terminal.read_char(multiple->row + 1, multiple->col + 1), 'B');
+}
+
+// Test: Palette glyphs and colours are used, and mixed classes render '#'
+TEST_F(EditAreaRendererTest, PaletteGlyphsAndColours) {
+    Terminal terminal;
+    terminal.set_dimensions(10, 10);
+    Viewport viewport(-4.0, 4.0, -4.0, 4.0, 8, 8);
+    EditAreaRenderer renderer;
+
+    ClassPalette palette("0", "1");
+    std::string error;
+    ASSERT_TRUE(palette.apply_spec("cat=c:red", error)) << error;
+
+    table_->insert_point(-2.0, 2.0, "cat");
+    table_->insert_point(2.0, -2.0, "cat");
+    table_->insert_point(2.0, -2.0, "cat");
+    table_->insert_point(2.0, -2.0, "0");
+
+    renderer.render(terminal, viewport, *table_, {}, 0, 10, 10, 0, 0, palette);
+
+    auto single = viewport.data_to_screen(DataCoord{-2.0, 2.0});
+    auto mixed = viewport.data_to_screen(DataCoord{2.0, -2.0});
+    ASSERT_TRUE(single.has_value() && mixed.has_value());
+    EXPECT_EQ(terminal.read_char(single->row + 1, single->col + 1), 'c');
+    EXPECT_EQ(terminal.read_color(single->row + 1, single->col + 1), Terminal::Color::RED);
+    EXPECT_EQ(terminal.read_char(mixed->row + 1, mixed->col + 1), '#');
+    // Two of three points are "cat", so the mixed cell takes its colour
+    EXPECT_EQ(terminal.read_color(mixed->row + 1, mixed->col + 1), Terminal::Color::RED);
+}
+
+// Test: Density mode shades by log count and colours by x/o share
+TEST_F(EditAreaRendererTest, DensityModeShadesByCount) {
+    Terminal terminal;
+    terminal.set_dimensions(10, 10);
+    Viewport viewport(-4.0, 4.0, -4.0, 4.0, 8, 8);
+    EditAreaRenderer renderer;
+    renderer.set_mode(EditAreaRenderer::Mode::DENSITY);
+
+    table_->insert_point(-2.0, 2.0, "0");  // 1 x point
+    for (int i = 0; i < 15; ++i) {
+        table_->insert_point(2.0, -2.0, i < 5 ? "0" : "1");  // 5 x, 10 o
+    }
+
+    renderer.render(terminal, viewport, *table_, {}, 0, 10, 10, 0, 0, "0", "1");
+
+    auto sparse = viewport.data_to_screen(DataCoord{-2.0, 2.0});
+    auto dense = viewport.data_to_screen(DataCoord{2.0, -2.0});
+    ASSERT_TRUE(sparse.has_value() && dense.has_value());
+
+    // log(2)/log(16) = 1/4: lightest shade; the busiest cell is solid
+    EXPECT_EQ(terminal.read_glyph(sparse->row + 1, sparse->col + 1), U'\u2591');
+    EXPECT_EQ(terminal.read_char(sparse->row + 1, sparse->col + 1), '.');
+    EXPECT_EQ(terminal.read_color(sparse->row + 1, sparse->col + 1), Terminal::Color::RED);
+    EXPECT_EQ(terminal.read_glyph(dense->row + 1, dense->col + 1), U'\u2588');
+    EXPECT_EQ(terminal.read_char(dense->row + 1, dense->col + 1), '@');
+    // One third x leans towards o
+    EXPECT_EQ(terminal.read_color(dense->row + 1, dense->col + 1), Terminal::Color::CYAN);
+
+    // Back to points mode: plain glyphs again
+    renderer.set_mode(EditAreaRenderer::Mode::POINTS);
+    renderer.render(terminal, viewport, *table_, {}, 0, 10, 10, 0, 0, "0", "1");
+    EXPECT_EQ(terminal.read_glyph(dense->row + 1, dense->col + 1), U'\0');
+    EXPECT_EQ(terminal.read_char(dense->row + 1, dense->col + 1), '#');
+}
+
+// Test: Mode names round-trip
+TEST_F(EditAreaRendererTest, ModeNames) {
+    EXPECT_EQ(EditAreaRenderer::parse_mode("density"), EditAreaRenderer::Mode::DENSITY);
+    EXPECT_EQ(EditAreaRenderer::parse_mode("points"), EditAreaRenderer::Mode::POINTS);
+    EXPECT_EQ(EditAreaRenderer::parse_mode("braille"), EditAreaRenderer::Mode::BRAILLE);
+    EXPECT_FALSE(EditAreaRenderer::parse_mode("heat").has_value());
+    EXPECT_STREQ(EditAreaRenderer::mode_name(EditAreaRenderer::Mode::DENSITY), "density");
+    EXPECT_EQ(EditAreaRenderer::next_mode(EditAreaRenderer::Mode::BRAILLE), EditAreaRenderer::Mode::POINTS);
+}
+
+// Test: Braille mode places each point's dot inside its cell
+TEST_F(EditAreaRendererTest, BrailleModeDrawsSubCellDots) {
+    Terminal terminal;
+    terminal.set_dimensions(10, 10);
+    // 8x8 cells over [0, 7]: cell centres on integers, dots every 0.5 x / 0.25 y
+    Viewport viewport(0.0, 7.0, 0.0, 7.0, 8, 8);
+    EditAreaRenderer renderer;
+    renderer.set_mode(EditAreaRenderer::Mode::BRAILLE);
+
+    table_->insert_point(2.8, 5.1, "0");  // Left half, second dot row of cell (2, 3)
+    table_->insert_point(3.2, 4.8, "0");  // Right half, third dot row of the same cell
+
+    renderer.render(terminal, viewport, *table_, {}, 0, 10, 10, 0, 0, "0", "1");
+
+    auto screen = viewport.data_to_screen(DataCoord{3.0, 5.0});
+    ASSERT_TRUE(screen.has_value());
+    int row = screen->row + 1;
+    int col = screen->col + 1;
+    // Dots 2 (0x02) and 6 (0x20)
+    EXPECT_EQ(terminal.read_glyph(row, col), U'\u2822');
+    EXPECT_EQ(terminal.read_char(row, col), 'X');  // Dumps fall back to the points glyph
+    EXPECT_EQ(terminal.read_color(row, col), Terminal::Color::RED);
+}
+
+// Test: Binning split across workers matches a single-threaded pass,
+// including class numbering for targets seen for the first time
+TEST_F(EditAreaRendererTest, ParallelBinningMatchesSerial) {
+    std::vector<DataPoint> points;
+    for (int i = 0; i < 100000; ++i) {
+        double x = (i * 37 % 1000) * 0.01;
+        double y = (i * 91 % 1000) * 0.01;
+        const char* target = i % 5 == 0 ? "x" : (i % 5 == 1 ? "o" : (i < 70000 ? "b" : "a"));
+        points.push_back(DataPoint{i, x, y, target});
+    }
+    Viewport viewport(0.0, 10.0, 0.0, 10.0, 20, 60);
+    ChangeRecord removed{};
+    removed.action = "delete";
+    removed.data_id = 3;
+    removed.is_active = true;
+
+    for (auto mode : {EditAreaRenderer::Mode::POINTS, EditAreaRenderer::Mode::BRAILLE}) {
+        ThreadPool single(1);
+        ThreadPool pool(4);
+        ClassPalette serial_palette("x", "o");
+        ClassPalette parallel_palette("x", "o");
+        EditAreaRenderer serial;
+        EditAreaRenderer parallel;
+        serial.set_mode(mode);
+        parallel.set_mode(mode);
+        serial.set_thread_pool(single);
+        parallel.set_thread_pool(pool);
+
+        const CellGrid& expected = serial.bin_points(viewport, points, {removed}, 20, 60, serial_palette);
+        const CellGrid& actual = parallel.bin_points(viewport, points, {removed}, 20, 60, parallel_palette);
+
+        ASSERT_EQ(parallel_palette.size(), serial_palette.size());
+        EXPECT_EQ(parallel_palette.find("b"), serial_palette.find("b"));
+        EXPECT_EQ(actual.occupied_count(), expected.occupied_count());
+        EXPECT_EQ(actual.max_count(), expected.max_count());
+        for (int row = 0; row < 20; ++row) {
+            for (int col = 0; col < 60; ++col) {
+                const auto& a = actual.at(row, col);
+                const auto& e = expected.at(row, col);
+                ASSERT_EQ(a.count, e.count);
+                ASSERT_EQ(a.classes, e.classes);
+                ASSERT_EQ(a.binary[0], e.binary[0]);
+                ASSERT_EQ(a.binary[1], e.binary[1]);
+                if (mode == EditAreaRenderer::Mode::BRAILLE) {
+                    ASSERT_EQ(parallel.dots().at(row, col), serial.dots().at(row, col));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "event_loop.h"
+#include <csignal>
+#include <unistd.h>
+#include <vector>
+
+using namespace datapainter;
+using std::chrono::milliseconds;
+
+// Test: No timers means poll() may sleep indefinitely
+TEST(EventLoopTest, NoTimersMeansInfiniteTimeout) {
+    EventLoop loop;
+    EXPECT_EQ(loop.next_timeout_ms(), -1);
+
+    loop.add_timer(milliseconds(500), [] {});
+    int timeout = loop.next_timeout_ms();
+    EXPECT_GT(timeout, 0);
+    EXPECT_LE(timeout, 500);
+}
+
+// Test: Timers fire in deadline order and one-shot timers are removed
+TEST(EventLoopTest, TimersFireInOrder) {
+    EventLoop loop;
+    std::vector<int> fired;
+    loop.add_timer(milliseconds(20), [&] { fired.push_back(2); });
+    loop.add_timer(milliseconds(1), [&] { fired.push_back(1); });
+
+    while (fired.size() < 2) {
+        EXPECT_EQ(loop.wait(-1), EventLoop::Wake::TASKS);
+    }
+    EXPECT_EQ(fired, (std::vector<int>{1, 2}));
+    EXPECT_EQ(loop.timer_count(), 0u);
+}
+
+// Test: Repeating timers stay armed until cancelled
+TEST(EventLoopTest, RepeatingTimerAndCancel) {
+    EventLoop loop;
+    int count = 0;
+    int id = loop.add_timer(milliseconds(1), [&] { ++count; }, true);
+
+    while (count < 3) {
+        loop.wait(-1);
+    }
+    EXPECT_EQ(loop.timer_count(), 1u);
+    EXPECT_TRUE(loop.cancel_timer(id));
+    EXPECT_FALSE(loop.cancel_timer(id));
+    EXPECT_EQ(loop.next_timeout_ms(), -1);
+}
+
+// Test: A callback cancelling an earlier timer does not skip a later one
+TEST(EventLoopTest, CancelInCallbackSkipsNothing) {
+    EventLoop loop;
+    std::vector<int> fired;
+    int first = loop.add_timer(milliseconds(0), [&] { fired.push_back(1); }, true);
+    loop.add_timer(milliseconds(0), [&] {
+        fired.push_back(2);
+        loop.cancel_timer(first);
+    }, true);
+    loop.add_timer(milliseconds(0), [&] { fired.push_back(3); }, true);
+
+    EXPECT_EQ(loop.wait(-1), EventLoop::Wake::TASKS);
+    EXPECT_EQ(fired, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(loop.timer_count(), 2u);
+}
+
+// Test: Input on the watched fd is reported as READABLE
+TEST(EventLoopTest, ReadableFd) {
+    EventLoop loop;
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+
+    EXPECT_EQ(loop.wait(fds[0]), EventLoop::Wake::READABLE);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// Test: SIGWINCH interrupts wait() through the self-pipe
+TEST(EventLoopTest, SigwinchReportsResize) {
+    ASSERT_TRUE(EventLoop::watch_resize());
+    ASSERT_TRUE(EventLoop::watch_resize());  // Idempotent
+
+    EventLoop loop;
+    raise(SIGWINCH);
+    EXPECT_EQ(loop.wait(-1), EventLoop::Wake::RESIZE);
+
+    // The pipe is drained, so the next wake comes from elsewhere
+    loop.add_timer(milliseconds(1), [] {});
+    EXPECT_EQ(loop.wait(-1), EventLoop::Wake::TASKS);
+}
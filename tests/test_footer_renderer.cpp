@@ -313,3 +313,20 @@ TEST_F(FooterRendererTest, NormalZoomShowsReasonablePrecision) {
             << "Footer: " << footer;
     }
 }
+
+// Test: A fitted model's accuracy and loss lead the footer until cleared
+TEST_F(FooterRendererTest, ShowsModelFit) {
+    FooterRenderer renderer;
+    terminal_.set_dimensions(10, 120);
+
+    renderer.set_fit(0.9321, 0.21449);
+    renderer.render(terminal_, 0.0, 0.0, -10.0, 10.0, -10.0, 10.0,
+                    -10.0, 10.0, -10.0, 10.0, 0, 3);
+    std::string footer = terminal_.get_row(9);
+    EXPECT_EQ(footer.find("[Unsaved: 3] [LR acc 93.2% loss 0.214] ("), 0u) << footer;
+
+    renderer.clear_fit();
+    renderer.render(terminal_, 0.0, 0.0, -10.0, 10.0, -10.0, 10.0,
+                    -10.0, 10.0, -10.0, 10.0, 0);
+    EXPECT_EQ(terminal_.get_row(9).find("LR"), std::string::npos);
+}
@@ -106,6 +106,17 @@ TEST_F(InputSourceTest, ParseCommonSpecialKeys) {
     EXPECT_EQ(source.read_key(), 27);  // ESC
 }
 
+// Test: Parse <dump> and <dump-edit-area> checkpoints
+TEST_F(InputSourceTest, ParseDumpCheckpoints) {
+    std::string content = "x\n<dump>\n<DUMP-EDIT-AREA>\n";
+    std::string filename = create_temp_file(content);
+
+    FileInputSource source(filename);
+    EXPECT_EQ(source.read_key(), 'x');
+    EXPECT_EQ(source.read_key(), Terminal::KEY_DUMP_SCREEN);
+    EXPECT_EQ(source.read_key(), Terminal::KEY_DUMP_EDIT_AREA);
+}
+
 // Test: Ignore comment lines starting with #
 TEST_F(InputSourceTest, IgnoreCommentLines) {
     std::string content = "# This is a comment\nx\n# Another comment\no\n";
@@ -11,6 +11,7 @@
 #include "data_table.h"
 #include "unsaved_changes.h"
 #include "undo_manager.h"
+#include "json_value.h"
 
 #ifdef _WIN32
 #define popen _popen
@@ -927,3 +928,206 @@ TEST_F(IntegrationTest, KeyStrokeAtPointNoPointsAtCursor) {
     // Should output 0 (no points deleted)
     EXPECT_NE(output.find("0"), std::string::npos);
 }
+
+// Test: --headless replays a script and prints every checkpoint from one process
+TEST_F(IntegrationTest, HeadlessSessionDumpsCheckpoints) {
+    exec_command(exe_ + " --database " + test_db_ +
+                 " --create-table --table test_table" +
+                 " --target-column-name target" +
+                 " --x-axis-name x --y-axis-name y" +
+                 " --x-meaning x_val --o-meaning o_val" +
+                 " --min-x -10.0 --max-x 10.0" +
+                 " --min-y -10.0 --max-y 10.0");
+
+    std::string script = "test_headless_keys.txt";
+    {
+        std::ofstream out(script);
+        out << "x\n<dump-edit-area>\n<right>\no\n<dump>\nq\nn\n";
+    }
+
+    std::string cmd = exe_ + " --database " + test_db_ + " --table test_table" +
+                      " --headless --keystroke-file " + script +
+                      " --override-screen-height 20 --override-screen-width 60";
+    std::string output = exec_command(cmd);
+    fs::remove(script);
+
+    // One edit area dump, then one full screen dump showing both points
+    size_t edit_dump = output.find("=== EDIT AREA DUMP ===");
+    size_t full_dump = output.find("=== FULL SCREEN DUMP ===");
+    ASSERT_NE(edit_dump, std::string::npos) << output;
+    ASSERT_NE(full_dump, std::string::npos) << output;
+    EXPECT_LT(edit_dump, full_dump);
+    EXPECT_NE(output.find("xo", full_dump), std::string::npos) << output;
+
+    // No terminal control sequences in headless output
+    EXPECT_EQ(output.find('\033'), std::string::npos);
+
+    // The scripted 'n' answered the quit prompt and discarded the changes
+    datapainter::Database db(test_db_);
+    ASSERT_TRUE(db.is_open());
+    datapainter::UnsavedChanges changes(db);
+    EXPECT_TRUE(changes.get_changes("test_table").empty());
+}
+
+// Test: --fast-replay skips intermediate frames but produces identical checkpoints
+TEST_F(IntegrationTest, FastReplayMatchesFullReplay) {
+    exec_command(exe_ + " --database " + test_db_ +
+                 " --create-table --table test_table" +
+                 " --target-column-name target" +
+                 " --x-axis-name x --y-axis-name y" +
+                 " --x-meaning x_val --o-meaning o_val" +
+                 " --min-x -10.0 --max-x 10.0" +
+                 " --min-y -10.0 --max-y 10.0");
+
+    // Edit, pan and zoom with checkpoints in between; 'n' discards on quit so
+    // both runs start from the same database
+    std::string script = "test_fast_replay_keys.txt";
+    {
+        std::ofstream out(script);
+        out << "x\n<right>\n<right>\no\n<dump>\n";
+        for (int i = 0; i < 40; ++i) {
+            out << "<left>\n";
+        }
+        out << "x\n+\n<down>\ng\n<dump-edit-area>\n-\n<up>\no\n<dump>\nq\nn\n";
+    }
+
+    std::string base_cmd = exe_ + " --database " + test_db_ + " --table test_table" +
+                           " --headless --keystroke-file " + script +
+                           " --override-screen-height 20 --override-screen-width 60";
+    std::string full_output = exec_command(base_cmd);
+    std::string fast_output = exec_command(base_cmd + " --fast-replay");
+    fs::remove(script);
+
+    EXPECT_NE(full_output.find("=== FULL SCREEN DUMP ==="), std::string::npos) << full_output;
+    EXPECT_EQ(full_output, fast_output);
+}
+
+TEST_F(IntegrationTest, ProfileKeystrokesWritesReport) {
+    exec_command(exe_ + " --database " + test_db_ +
+                 " --create-table --table test_table" +
+                 " --target-column-name target" +
+                 " --x-axis-name x --y-axis-name y" +
+                 " --x-meaning x_val --o-meaning o_val" +
+                 " --min-x -10.0 --max-x 10.0" +
+                 " --min-y -10.0 --max-y 10.0");
+
+    std::string script = "test_profile_keys.txt";
+    std::string report_path = "test_profile_report.json";
+    {
+        std::ofstream out(script);
+        out << "x\n<right>\no\n<right>\nx\nq\nn\n";
+    }
+
+    std::string output = exec_command(exe_ + " --database " + test_db_ + " --table test_table" +
+                                      " --headless --keystroke-file " + script +
+                                      " --profile-keystrokes " + report_path);
+    std::ifstream in(report_path);
+    std::string report((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    fs::remove(script);
+    fs::remove(report_path);
+
+    auto json = datapainter::JsonValue::parse(report);
+    ASSERT_TRUE(json.has_value()) << output << report;
+    EXPECT_EQ(json->get_int("keys"), 6);  // "n" answers the quit prompt
+    const datapainter::JsonValue* by_key = json->find("by_key");
+    ASSERT_NE(by_key, nullptr);
+    const datapainter::JsonValue* x_entry = by_key->find("x");
+    ASSERT_NE(x_entry, nullptr);
+    EXPECT_EQ(x_entry->find("total")->get_int("count"), 2);
+    EXPECT_NE(by_key->find("<right>"), nullptr);
+}
+
+TEST_F(IntegrationTest, PerfHudToggle) {
+    exec_command(exe_ + " --database " + test_db_ +
+                 " --create-table --table test_table" +
+                 " --target-column-name target" +
+                 " --x-axis-name x --y-axis-name y" +
+                 " --x-meaning x_val --o-meaning o_val" +
+                 " --min-x -10.0 --max-x 10.0" +
+                 " --min-y -10.0 --max-y 10.0");
+
+    std::string script = "test_perf_hud_keys.txt";
+    {
+        std::ofstream out(script);
+        out << "p\nx\n<dump>\np\n<dump>\nq\nn\n";
+    }
+
+    std::string output = exec_command(exe_ + " --database " + test_db_ + " --table test_table" +
+                                      " --headless --keystroke-file " + script +
+                                      " --override-screen-height 30 --override-screen-width 80");
+    fs::remove(script);
+
+    size_t hud = output.find("perf (last frame)");
+    ASSERT_NE(hud, std::string::npos) << output;
+    EXPECT_NE(output.find("journal", hud), std::string::npos);
+
+    // The second dump is taken after 'p' hid the HUD again
+    size_t second_dump = output.rfind("=== FULL SCREEN DUMP ===");
+    ASSERT_NE(second_dump, std::string::npos);
+    EXPECT_GT(second_dump, hud);
+    EXPECT_EQ(output.find("perf (last frame)", second_dump), std::string::npos);
+}
+
+TEST_F(IntegrationTest, TraceWritesChromeTraceEvents) {
+    exec_command(exe_ + " --database " + test_db_ +
+                 " --create-table --table test_table" +
+                 " --target-column-name target" +
+                 " --x-axis-name x --y-axis-name y" +
+                 " --x-meaning x_val --o-meaning o_val" +
+                 " --min-x -10.0 --max-x 10.0" +
+                 " --min-y -10.0 --max-y 10.0");
+
+    std::string script = "test_trace_keys.txt";
+    std::string trace_path = "test_trace.json";
+    {
+        std::ofstream out(script);
+        out << "x\n<right>\no\ns\nq\n";
+    }
+
+    exec_command(exe_ + " --database " + test_db_ + " --table test_table" +
+                 " --headless --keystroke-file " + script + " --trace " + trace_path);
+    std::ifstream in(trace_path);
+    std::string trace((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    fs::remove(script);
+    fs::remove(trace_path);
+
+    auto json = datapainter::JsonValue::parse(trace);
+    ASSERT_TRUE(json.has_value()) << trace;
+    ASSERT_NE(json->find("traceEvents"), nullptr);
+    for (const char* span : {"EventLoop::draw_frame", "EventLoop::handle_key",
+                             "DataTable::query_viewport", "SaveManager::save",
+                             "HeaderRenderer::render"}) {
+        EXPECT_NE(trace.find(std::string("\"") + span + "\""), std::string::npos) << span;
+    }
+}
+
+// Test: 'A' reports how many points the k-means suggestions converted
+TEST_F(IntegrationTest, KmeansApplyReportsConversions) {
+    exec_command(exe_ + " --database " + test_db_ +
+                 " --create-table --table test_table" +
+                 " --target-column-name target" +
+                 " --x-axis-name x --y-axis-name y" +
+                 " --x-meaning x_val --o-meaning o_val" +
+                 " --min-x -10.0 --max-x 10.0" +
+                 " --min-y -10.0 --max-y 10.0");
+    // One o among a cluster of x
+    for (const char* point : {"--x 5 --y 5 --target x_val", "--x 5 --y 6 --target x_val",
+                              "--x 6 --y 5 --target x_val", "--x 6 --y 6 --target o_val"}) {
+        exec_command(exe_ + " --database " + test_db_ + " --table test_table --add-point " + point);
+    }
+
+    std::string script = "test_kmeans_keys.txt";
+    {
+        std::ofstream out(script);
+        out << "A\n<dump>\n<right>\n<dump>\nq\nn\n";
+    }
+    std::string output = exec_command(exe_ + " --database " + test_db_ + " --table test_table" +
+                                      " --headless --keystroke-file " + script +
+                                      " --kmeans 1 --override-screen-height 20 --override-screen-width 60");
+    fs::remove(script);
+
+    size_t notice = output.find("k-means converted 1 point ");
+    ASSERT_NE(notice, std::string::npos) << output;
+    // Gone after the next key
+    EXPECT_EQ(output.find("k-means converted", notice + 1), std::string::npos) << output;
+}
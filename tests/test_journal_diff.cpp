@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "journal_diff.h"
+#include "change_records.h"
+#include "class_palette.h"
+#include "database.h"
+#include "metadata.h"
+#include <map>
+
+using namespace datapainter;
+
+namespace {
+
+// Class 0 for "x", 1 for "o"
+int classify(const std::string& target) {
+    return target == "x" ? 0 : target == "o" ? 1 : ClassPalette::NO_CLASS;
+}
+
+}  // namespace
+
+class JournalDiffTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        mgr_ = std::make_unique<MetadataManager>(*db_);
+        ASSERT_TRUE(mgr_->create_data_table("test_table"));
+        table_ = std::make_unique<DataTable>(*db_, "test_table");
+    }
+
+    // Sync, keeping per-class counts of the reported effects
+    void sync(JournalDiff& diff, const std::vector<ChangeRecord>& changes) {
+        diff.sync(
+            *table_, changes, classify,
+            [&](const JournalDiff::Effect& effect, int sign) {
+                ++applies_;
+                counts_[effect.added] += sign;
+                counts_[effect.removed] -= sign;
+            },
+            [&](const JournalDiff::Effect& effect) {
+                saved_[effect.added] += 1;
+                saved_[effect.removed] -= 1;
+            });
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<MetadataManager> mgr_;
+    std::unique_ptr<DataTable> table_;
+    std::map<int, int> counts_;
+    std::map<int, int> saved_;
+    int applies_ = 0;
+};
+
+// Test: Only changes whose effect moved are reported
+TEST_F(JournalDiffTest, ReportsOnlyChanges) {
+    JournalDiff diff;
+    std::vector<ChangeRecord> changes = {journal_insert(1, 1.0, 2.0, "x")};
+    sync(diff, changes);
+    EXPECT_EQ(counts_[0], 1);
+    EXPECT_EQ(applies_, 2);  // Took back nothing, then added
+    sync(diff, changes);
+    EXPECT_EQ(applies_, 2);
+
+    changes[0].new_target = "o";  // Flipped in place
+    sync(diff, changes);
+    EXPECT_EQ(counts_[0], 0);
+    EXPECT_EQ(counts_[1], 1);
+
+    changes[0].is_active = false;  // Undone
+    sync(diff, changes);
+    EXPECT_EQ(counts_[1], 0);
+}
+
+// Test: Updates are placed at their saved point; same-class ones do nothing
+TEST_F(JournalDiffTest, UpdatesLookUpTheirPoint) {
+    int id = table_->insert_point(3.0, 4.0, "x").value();
+    JournalDiff diff;
+    std::vector<ChangeRecord> changes = {journal_update(1, id, "x", "o"), journal_update(2, id, "o", "o")};
+    sync(diff, changes);
+    EXPECT_EQ(counts_[0], -1);
+    EXPECT_EQ(counts_[1], 1);
+    EXPECT_EQ(applies_, 2);
+
+    int located = 0;
+    diff.for_each([&](const JournalDiff::Effect& effect) {
+        if (effect.added != ClassPalette::NO_CLASS) {
+            EXPECT_EQ(effect.x, 3.0);
+            EXPECT_EQ(effect.y, 4.0);
+            ++located;
+        }
+    });
+    EXPECT_EQ(located, 1);
+}
+
+// Test: Changes that leave the journal are reported as saved once
+TEST_F(JournalDiffTest, ReportsSavedChanges) {
+    JournalDiff diff;
+    std::vector<ChangeRecord> changes = {journal_insert(1, 1.0, 1.0, "o"), journal_delete(2, 9, 2.0, 2.0, "x")};
+    sync(diff, changes);
+
+    sync(diff, {});
+    EXPECT_EQ(saved_[1], 1);
+    EXPECT_EQ(saved_[0], -1);
+    sync(diff, {});
+    EXPECT_EQ(saved_[1], 1);
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include "journal_point_sync.h"
+#include "change_records.h"
+#include "database.h"
+#include "metadata.h"
+#include <map>
+
+using namespace datapainter;
+
+namespace {
+
+// Counts the edits a sync pushes
+class RecordingSink : public JournalPointSync::Sink {
+public:
+    int resets = 0;
+    int adds = 0;
+    int removes = 0;
+    int relabels = 0;
+    size_t loaded = 0;
+    std::map<uint32_t, int> labels;  // Live points by slot
+
+    void reset(const std::vector<double>& xs, const std::vector<double>&,
+               const std::vector<uint8_t>& new_labels) override {
+        ++resets;
+        loaded = xs.size();
+        next_slot_ = static_cast<uint32_t>(xs.size());
+        labels.clear();
+        for (size_t i = 0; i < new_labels.size(); ++i) {
+            labels[static_cast<uint32_t>(i)] = new_labels[i];
+        }
+    }
+    uint32_t add(double, double, int label) override {
+        ++adds;
+        labels[next_slot_] = label;
+        return next_slot_++;
+    }
+    void remove(uint32_t slot) override {
+        ++removes;
+        labels.erase(slot);
+    }
+    void relabel(uint32_t slot, int label) override {
+        ++relabels;
+        labels[slot] = label;
+    }
+
+private:
+    uint32_t next_slot_ = 0;
+};
+
+}  // namespace
+
+class JournalPointSyncTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        mgr_ = std::make_unique<MetadataManager>(*db_);
+        ASSERT_TRUE(mgr_->create_data_table("test_table"));
+        table_ = std::make_unique<DataTable>(*db_, "test_table");
+        x_id_ = table_->insert_point(1.0, 1.0, "x").value();
+        table_->insert_point(2.0, 2.0, "o");
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<MetadataManager> mgr_;
+    std::unique_ptr<DataTable> table_;
+    ClassPalette palette_{"x", "o"};
+    int x_id_ = 0;
+};
+
+// Test: Only journal entries whose state changed reach the sink
+TEST_F(JournalPointSyncTest, PushesOnlyChanges) {
+    JournalPointSync sync;
+    RecordingSink sink;
+    std::vector<ChangeRecord> changes = {journal_insert(1, 0.0, 0.0, "x")};
+    EXPECT_TRUE(sync.sync(*table_, changes, palette_, sink));
+    EXPECT_EQ(sink.resets, 1);
+    EXPECT_EQ(sink.loaded, 2u);
+    EXPECT_EQ(sink.adds, 1);
+
+    EXPECT_FALSE(sync.sync(*table_, changes, palette_, sink));
+    EXPECT_EQ(sink.adds, 1);
+
+    changes[0].new_target = "o";  // Flipped in place
+    EXPECT_TRUE(sync.sync(*table_, changes, palette_, sink));
+    EXPECT_EQ(sink.relabels, 1);
+    changes[0].is_active = false;  // Undone
+    EXPECT_TRUE(sync.sync(*table_, changes, palette_, sink));
+    EXPECT_EQ(sink.removes, 1);
+
+    // Metadata changes are ignored
+    ChangeRecord meta{};
+    meta.id = 2;
+    meta.action = "meta";
+    meta.is_active = true;
+    changes.push_back(meta);
+    EXPECT_FALSE(sync.sync(*table_, changes, palette_, sink));
+    EXPECT_EQ(sink.resets, 1);
+}
+
+// Test: A save keeps the sink; an edit of a newly saved point reloads it
+TEST_F(JournalPointSyncTest, SaveAndReload) {
+    JournalPointSync sync;
+    RecordingSink sink;
+    sync.sync(*table_, {journal_insert(1, 3.0, 3.0, "o")}, palette_, sink);
+
+    int saved_id = table_->insert_point(3.0, 3.0, "o").value();
+    EXPECT_FALSE(sync.sync(*table_, {}, palette_, sink));
+    EXPECT_EQ(sink.resets, 1);
+    EXPECT_EQ(sink.removes, 0);
+
+    ChangeRecord update{};
+    update.id = 2;
+    update.action = "update";
+    update.data_id = saved_id;
+    update.old_target = "o";
+    update.new_target = "x";
+    update.is_active = true;
+    EXPECT_TRUE(sync.sync(*table_, {update}, palette_, sink));
+    EXPECT_EQ(sink.resets, 2);
+    EXPECT_EQ(sink.loaded, 3u);
+    EXPECT_EQ(sink.relabels, 1);
+}
+
+// Test: Points report their data id, or minus the change id while unsaved
+TEST_F(JournalPointSyncTest, PointIds) {
+    JournalPointSync sync;
+    RecordingSink sink;
+    sync.sync(*table_, {journal_insert(7, 3.0, 3.0, "o")}, palette_, sink);
+    std::map<uint32_t, int> ids;
+    sync.for_each_point([&](uint32_t slot, int id) { ids[slot] = id; });
+    ASSERT_EQ(ids.size(), 3u);
+    EXPECT_EQ(ids[2], -7);
+    EXPECT_GT(ids[0], 0);
+    EXPECT_EQ(sync.unidentified(), 0u);
+
+    // Saved: still in the sink, but its new data id is unknown until a reload
+    sync.sync(*table_, {}, palette_, sink);
+    EXPECT_EQ(sync.unidentified(), 1u);
+    ids.clear();
+    sync.for_each_point([&](uint32_t slot, int id) { ids[slot] = id; });
+    EXPECT_EQ(ids.size(), 2u);
+
+    table_->insert_point(3.0, 3.0, "o");
+    sync.invalidate();
+    EXPECT_TRUE(sync.sync(*table_, {}, palette_, sink));
+    EXPECT_EQ(sink.resets, 2);
+    EXPECT_EQ(sync.unidentified(), 0u);
+}
+
+// Test: A saved conversion is the point's class when a later one is undone
+TEST_F(JournalPointSyncTest, SavedUpdateThenUndo) {
+    JournalPointSync sync;
+    RecordingSink sink;
+    std::vector<ChangeRecord> changes = {journal_update(1, x_id_, "x", "o")};
+    sync.sync(*table_, changes, palette_, sink);
+    EXPECT_EQ(sink.labels[0], 1);
+
+    table_->update_point_target(x_id_, "o");  // Saved
+    changes.clear();
+    EXPECT_FALSE(sync.sync(*table_, changes, palette_, sink));
+
+    changes = {journal_update(2, x_id_, "o", "x")};
+    sync.sync(*table_, changes, palette_, sink);
+    EXPECT_EQ(sink.labels[0], 0);
+    changes[0].is_active = false;  // Undone: back to the saved class
+    EXPECT_TRUE(sync.sync(*table_, changes, palette_, sink));
+    EXPECT_EQ(sink.labels[0], 1);
+    EXPECT_EQ(sink.resets, 1);
+}
+
+// Test: A saved delete keeps the point out of the sink
+TEST_F(JournalPointSyncTest, SavedDelete) {
+    JournalPointSync sync;
+    RecordingSink sink;
+    ChangeRecord remove{};
+    remove.id = 1;
+    remove.table_name = "test_table";
+    remove.action = "delete";
+    remove.data_id = x_id_;
+    remove.old_target = "x";
+    remove.is_active = true;
+    sync.sync(*table_, {remove}, palette_, sink);
+    EXPECT_EQ(sink.labels.count(0), 0u);
+
+    table_->delete_point(x_id_);  // Saved
+    EXPECT_FALSE(sync.sync(*table_, {}, palette_, sink));
+    size_t points = 0;
+    sync.for_each_point([&](uint32_t, int id) {
+        EXPECT_NE(id, x_id_);
+        ++points;
+    });
+    EXPECT_EQ(points, 1u);
+    EXPECT_EQ(sink.labels.size(), 1u);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "json_value.h"
+
+using namespace datapainter;
+
+// Test: Scalars serialize to compact JSON
+TEST(JsonValueTest, DumpScalars) {
+    EXPECT_EQ(JsonValue().dump(), "null");
+    EXPECT_EQ(JsonValue(true).dump(), "true");
+    EXPECT_EQ(JsonValue(false).dump(), "false");
+    EXPECT_EQ(JsonValue(42).dump(), "42");
+    EXPECT_EQ(JsonValue(-1.5).dump(), "-1.5");
+    EXPECT_EQ(JsonValue("hi").dump(), "\"hi\"");
+}
+
+// Test: Doubles round-trip exactly
+TEST(JsonValueTest, DoublesRoundTrip) {
+    double value = 0.1 + 0.2;
+    auto parsed = JsonValue::parse(JsonValue(value).dump());
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->as_number(), value);
+}
+
+// Test: Strings are escaped on output and unescaped on input
+TEST(JsonValueTest, StringEscaping) {
+    JsonValue value(std::string("a\"b\\c\nd\te\x01"));
+    EXPECT_EQ(value.dump(), "\"a\\\"b\\\\c\\nd\\te\\u0001\"");
+
+    auto parsed = JsonValue::parse(value.dump());
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->as_string(), value.as_string());
+}
+
+// Test: Unicode escapes including surrogate pairs decode to UTF-8
+TEST(JsonValueTest, UnicodeEscapes) {
+    auto parsed = JsonValue::parse("\"\\u00e9\\ud83d\\ude00\"");
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->as_string(), "\xC3\xA9\xF0\x9F\x98\x80");
+}
+
+// Test: Objects keep insertion order and set replaces existing keys
+TEST(JsonValueTest, ObjectOrderAndReplace) {
+    JsonValue obj = JsonValue::object();
+    obj.set("b", 1);
+    obj.set("a", 2);
+    obj.set("b", 3);
+    EXPECT_EQ(obj.dump(), "{\"b\":3,\"a\":2}");
+    EXPECT_EQ(obj.size(), 2u);
+}
+
+// Test: Nested documents parse and typed lookups work
+TEST(JsonValueTest, ParseNestedDocument) {
+    auto parsed = JsonValue::parse(
+        " {\"id\": 7, \"method\": \"add_point\", \"params\": {\"x\": 1.5, \"ok\": true,"
+        " \"list\": [1, 2, null]}} ");
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->get_int("id"), 7);
+    EXPECT_EQ(parsed->get_string("method"), "add_point");
+
+    const JsonValue* params = parsed->find("params");
+    ASSERT_NE(params, nullptr);
+    EXPECT_EQ(params->get_number("x"), 1.5);
+    EXPECT_EQ(params->get_bool("ok"), true);
+    EXPECT_FALSE(params->get_string("x").has_value());
+    EXPECT_FALSE(params->get_number("missing").has_value());
+
+    const JsonValue* list = params->find("list");
+    ASSERT_NE(list, nullptr);
+    ASSERT_TRUE(list->is_array());
+    EXPECT_EQ(list->size(), 3u);
+    EXPECT_TRUE(list->as_array()[2].is_null());
+}
+
+// Test: get_int rejects non-integral numbers
+TEST(JsonValueTest, GetIntRejectsFractions) {
+    auto parsed = JsonValue::parse("{\"a\": 1.5, \"b\": 3}");
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_FALSE(parsed->get_int("a").has_value());
+    EXPECT_EQ(parsed->get_int("b"), 3);
+}
+
+// Test: Malformed input is rejected with an error message
+TEST(JsonValueTest, MalformedInputRejected) {
+    const char* bad_inputs[] = {"", "{", "[1,]", "{\"a\" 1}", "tru", "\"unterminated",
+                                "1 2", "{\"a\":1,}", "01x"};
+    for (const char* input : bad_inputs) {
+        std::string error;
+        EXPECT_FALSE(JsonValue::parse(input, &error).has_value()) << input;
+        EXPECT_FALSE(error.empty()) << input;
+    }
+}
+
+// Test: Deeply nested input is rejected instead of overflowing the stack
+TEST(JsonValueTest, NestingDepthLimited) {
+    std::string deep(1000, '[');
+    deep += std::string(1000, ']');
+    EXPECT_FALSE(JsonValue::parse(deep).has_value());
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "kd_tree.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace datapainter;
+
+namespace {
+
+// Squared distances of the k nearest live points, found by brute force
+std::vector<double> brute_force(const KdTree& tree, const std::vector<bool>& live, double x, double y, int k) {
+    std::vector<double> distances;
+    for (uint32_t slot = 0; slot < live.size(); ++slot) {
+        if (live[slot]) {
+            double dx = tree.x(slot) - x;
+            double dy = tree.y(slot) - y;
+            distances.push_back(dx * dx + dy * dy);
+        }
+    }
+    std::sort(distances.begin(), distances.end());
+    distances.resize(std::min(distances.size(), static_cast<size_t>(k)));
+    return distances;
+}
+
+void expect_matches_brute_force(const KdTree& tree, const std::vector<bool>& live, std::mt19937& rng) {
+    std::uniform_real_distribution<double> coord(-12.0, 12.0);
+    KdTree::Neighbour found[KdTree::MAX_K];
+    for (int query = 0; query < 200; ++query) {
+        double x = coord(rng);
+        double y = coord(rng);
+        for (int k : {1, 5, KdTree::MAX_K}) {
+            std::vector<double> expected = brute_force(tree, live, x, y, k);
+            ASSERT_EQ(tree.nearest(x, y, k, found), static_cast<int>(expected.size()));
+            for (size_t i = 0; i < expected.size(); ++i) {
+                ASSERT_DOUBLE_EQ(found[i].distance2, expected[i]);
+                ASSERT_TRUE(live[found[i].slot]);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+// Test: A built tree returns the same neighbours as a linear scan
+TEST(KdTreeTest, BuildMatchesBruteForce) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> coord(0.0, 4.0);
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<uint8_t> labels;
+    for (int i = 0; i < 5000; ++i) {
+        xs.push_back(coord(rng));
+        ys.push_back(i % 10 == 0 ? 1.0 : coord(rng));  // Some ties on y
+        labels.push_back(static_cast<uint8_t>(i % 3));
+    }
+
+    KdTree tree;
+    tree.build(xs, ys, labels);
+    EXPECT_EQ(tree.size(), 5000u);
+    EXPECT_EQ(tree.label(4), 1);
+    expect_matches_brute_force(tree, std::vector<bool>(5000, true), rng);
+}
+
+// Test: Inserts split leaves and removes drop points, without a rebuild
+TEST(KdTreeTest, InsertAndRemoveMatchBruteForce) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coord(-10.0, 10.0);
+    KdTree tree;
+    std::vector<bool> live;
+
+    // Start from an empty tree and a small built one
+    for (int i = 0; i < 3000; ++i) {
+        uint32_t slot = tree.insert(coord(rng), coord(rng), 0);
+        ASSERT_EQ(slot, live.size());
+        live.push_back(true);
+    }
+    for (uint32_t slot = 0; slot < live.size(); slot += 3) {
+        ASSERT_TRUE(tree.remove(slot));
+        live[slot] = false;
+    }
+    EXPECT_FALSE(tree.remove(0));  // Already gone
+    EXPECT_EQ(tree.size(), 2000u);
+    expect_matches_brute_force(tree, live, rng);
+
+    KdTree built;
+    built.build({0.0, 1.0}, {0.0, 1.0}, {0, 1});
+    std::vector<bool> built_live = {true, true};
+    for (int i = 0; i < 500; ++i) {
+        built.insert(coord(rng), coord(rng), 1);
+        built_live.push_back(true);
+    }
+    expect_matches_brute_force(built, built_live, rng);
+}
+
+// Test: Points painted on one spot share a leaf however many there are
+TEST(KdTreeTest, StackedPoints) {
+    KdTree tree;
+    for (int i = 0; i < 10 * KdTree::LEAF_SIZE; ++i) {
+        tree.insert(2.0, 3.0, static_cast<uint8_t>(i % 2));
+    }
+    tree.insert(5.0, 3.0, 1);
+
+    KdTree::Neighbour found[KdTree::MAX_K];
+    ASSERT_EQ(tree.nearest(4.9, 3.0, 1, found), 1);
+    EXPECT_EQ(tree.x(found[0].slot), 5.0);
+    ASSERT_EQ(tree.nearest(0.0, 0.0, 4, found), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_DOUBLE_EQ(found[i].distance2, 13.0);
+    }
+
+    tree.relabel(0, 7);
+    EXPECT_EQ(tree.label(0), 7);
+}
+
+// Test: Empty trees and k of zero find nothing
+TEST(KdTreeTest, EmptyQueries) {
+    KdTree tree;
+    KdTree::Neighbour found[KdTree::MAX_K];
+    EXPECT_EQ(tree.nearest(0.0, 0.0, 5, found), 0);
+    tree.build({}, {}, {});
+    EXPECT_EQ(tree.nearest(0.0, 0.0, 5, found), 0);
+    tree.insert(1.0, 1.0, 0);
+    EXPECT_EQ(tree.nearest(0.0, 0.0, 0, found), 0);
+    EXPECT_EQ(tree.nearest(0.0, 0.0, 5, found), 1);
+    ASSERT_TRUE(tree.remove(0));
+    EXPECT_EQ(tree.nearest(0.0, 0.0, 5, found), 0);
+}
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include "kde_overlay.h"
+#include "change_records.h"
+#include "database.h"
+#include "metadata.h"
+#include <cmath>
+#include <random>
+
+using namespace datapainter;
+
+namespace {
+
+// Truncated, normalised Gaussian weights as KdeOverlay builds them
+std::vector<double> weights(double sigma) {
+    int radius = static_cast<int>(std::ceil(KdeOverlay::KERNEL_SIGMAS * sigma));
+    std::vector<double> kernel;
+    double sum = 0.0;
+    for (int t = -radius; t <= radius; ++t) {
+        kernel.push_back(std::exp(-0.5 * t * t / (sigma * sigma)));
+        sum += kernel.back();
+    }
+    for (double& w : kernel) {
+        w /= sum;
+    }
+    return kernel;
+}
+
+std::vector<float> random_grid(int rows, int cols, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<float> grid(static_cast<size_t>(rows) * cols);
+    for (float& value : grid) {
+        value = unit(rng) < 0.2f ? std::floor(10.0f * unit(rng)) : 0.0f;
+    }
+    return grid;
+}
+
+}  // namespace
+
+class KdeOverlayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->is_open());
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        mgr_ = std::make_unique<MetadataManager>(*db_);
+        ASSERT_TRUE(mgr_->create_data_table("test_table"));
+        table_ = std::make_unique<DataTable>(*db_, "test_table");
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<MetadataManager> mgr_;
+    std::unique_ptr<DataTable> table_;
+    ClassPalette palette_{"x", "o"};
+};
+
+// Test: The separable blur equals the 2-D sum of the product kernel
+TEST_F(KdeOverlayTest, BlurMatchesBruteForce) {
+    const int rows = 20;
+    const int cols = 31;
+    std::vector<float> grid = random_grid(rows, cols, 1);
+    std::vector<float> blurred = grid;
+    ThreadPool pool(3);
+    KdeOverlay::blur(blurred, rows, cols, 1.3, 2.1, KdeOverlay::Method::DIRECT, pool);
+
+    std::vector<double> down = weights(1.3);
+    std::vector<double> across = weights(2.1);
+    int rr = static_cast<int>(down.size() / 2);
+    int rc = static_cast<int>(across.size() / 2);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            double expected = 0.0;
+            for (int dr = -rr; dr <= rr; ++dr) {
+                for (int dc = -rc; dc <= rc; ++dc) {
+                    int r = row + dr;
+                    int c = col + dc;
+                    if (r >= 0 && r < rows && c >= 0 && c < cols) {
+                        expected += down[static_cast<size_t>(dr + rr)] * across[static_cast<size_t>(dc + rc)] *
+                                    grid[static_cast<size_t>(r) * cols + c];
+                    }
+                }
+            }
+            EXPECT_NEAR(blurred[static_cast<size_t>(row) * cols + col], expected, 1e-4)
+                << row << "," << col;
+        }
+    }
+}
+
+// Test: The FFT path agrees with direct convolution, odd line counts included
+TEST_F(KdeOverlayTest, FftMatchesDirect) {
+    const int rows = 63;
+    const int cols = 100;
+    for (double sigma : {0.7, 4.0, 11.0}) {
+        std::vector<float> direct = random_grid(rows, cols, 2);
+        std::vector<float> fft = direct;
+        double total = 0.0;
+        for (float value : direct) {
+            total += value;
+        }
+        KdeOverlay::blur(direct, rows, cols, sigma * 1.5, sigma, KdeOverlay::Method::DIRECT, ThreadPool::shared());
+        KdeOverlay::blur(fft, rows, cols, sigma * 1.5, sigma, KdeOverlay::Method::FFT, ThreadPool::shared());
+        double blurred_total = 0.0;
+        for (size_t i = 0; i < direct.size(); ++i) {
+            ASSERT_NEAR(fft[i], direct[i], 1e-4) << "sigma " << sigma << " at " << i;
+            blurred_total += direct[i];
+        }
+        // Mass is lost only over the edges
+        EXPECT_LE(blurred_total, total + 1e-2);
+        EXPECT_GT(blurred_total, 0.5 * total);
+    }
+}
+
+// Test: Contours enclose each class's cluster, drawn in the class colour
+TEST_F(KdeOverlayTest, ContoursAroundClusters) {
+    std::mt19937 rng(3);
+    std::normal_distribution<double> spread(0.0, 1.0);
+    for (int i = 0; i < 2000; ++i) {
+        table_->insert_point(-5.0 + spread(rng), spread(rng), "x");
+        table_->insert_point(5.0 + spread(rng), spread(rng), "o");
+    }
+    KdeOverlay overlay;
+    overlay.ensure_loaded(*table_, palette_, -10.0, 10.0, -10.0, 10.0);
+    overlay.update();
+    EXPECT_EQ(overlay.count(0), 2000);
+    EXPECT_EQ(overlay.count(1), 2000);
+
+    // Scott's rule: sigma * n^(-1/6)
+    EXPECT_NEAR(overlay.bandwidth(0, 0), std::pow(2000.0, -1.0 / 6.0), 0.05);
+    EXPECT_GT(overlay.level(0, 0), overlay.level(0, 1));
+    EXPECT_GT(overlay.level(0, 1), overlay.level(0, 2));
+    EXPECT_GT(overlay.density(0, -5.0, 0.0), overlay.level(0, 0));
+    EXPECT_LT(overlay.density(0, -5.0, 3.0), overlay.level(0, 2));
+    EXPECT_LT(overlay.density(0, 5.0, 0.0), overlay.level(0, 2));
+    EXPECT_GT(overlay.density(1, 5.0, 0.0), overlay.level(1, 0));
+
+    Terminal terminal;
+    terminal.set_dimensions(22, 42);
+    for (int row = 1; row < 21; ++row) {
+        for (int col = 1; col < 41; ++col) {
+            terminal.write_char(row, col, ' ');
+        }
+    }
+    terminal.write_char(10, 10, 'x');
+    Viewport viewport(-10.0, 10.0, -10.0, 10.0, 20, 40);
+    overlay.render(terminal, viewport, palette_, 0, 22, 42);
+
+    int red = 0;
+    int blue = 0;
+    for (int row = 1; row < 21; ++row) {
+        for (int col = 1; col < 41; ++col) {
+            if (terminal.read_char(row, col) == ' ') {
+                continue;
+            }
+            Terminal::Color color = terminal.read_color(row, col);
+            if (color == Terminal::Color::RED) {
+                EXPECT_LT(col, 21) << row << "," << col;
+                ++red;
+            } else if (color == Terminal::Color::BLUE) {
+                EXPECT_GT(col, 20) << row << "," << col;
+                ++blue;
+            }
+        }
+    }
+    EXPECT_GT(red, 10);
+    EXPECT_GT(blue, 10);
+    EXPECT_EQ(terminal.read_char(10, 10), 'x');  // Points show through
+    EXPECT_NE(terminal.get_row(0).find("kde scott"), std::string::npos);
+}
+
+// Test: Journal inserts, flips, undos, deletes and updates move the counts
+TEST_F(KdeOverlayTest, SyncFollowsJournal) {
+    int saved = table_->insert_point(1.0, 1.0, "x").value();
+    KdeOverlay overlay;
+    overlay.ensure_loaded(*table_, palette_, -10.0, 10.0, -10.0, 10.0);
+    ASSERT_EQ(overlay.count(0), 1);
+
+    std::vector<ChangeRecord> changes;
+    changes.push_back(journal_insert(1, 2.0, 2.0, "x"));
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.count(0), 2);
+
+    changes[0].new_target = "o";  // Flipped in place
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.count(0), 1);
+    EXPECT_EQ(overlay.count(1), 1);
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.count(1), 1);
+
+    changes[0].is_active = false;  // Undone
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.count(1), 0);
+
+    // An update has no coordinates: the point is looked up
+    changes.push_back(journal_update(2, saved, "x", "o"));
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.count(0), 0);
+    EXPECT_EQ(overlay.count(1), 1);
+    overlay.update();
+    EXPECT_GT(overlay.density(1, 1.0, 1.0), 0.0);
+    EXPECT_EQ(overlay.density(0, 1.0, 1.0), 0.0);
+
+    // Saving it keeps the counts; the table now agrees
+    ASSERT_TRUE(table_->update_point_target(saved, "o"));
+    overlay.sync(*table_, {}, palette_);
+    EXPECT_EQ(overlay.count(1), 1);
+
+    overlay.sync(*table_, {journal_delete(3, saved, 1.0, 1.0, "o")}, palette_);
+    EXPECT_EQ(overlay.count(1), 0);
+}
+
+// Test: A fixed bandwidth and the '[' / ']' multiplier
+TEST_F(KdeOverlayTest, Bandwidth) {
+    table_->insert_point(0.0, 0.0, "x");
+    KdeOverlay overlay;
+    overlay.ensure_loaded(*table_, palette_, -10.0, 10.0, -10.0, 10.0);
+    overlay.set_bandwidth(0.5);
+    overlay.update();
+    EXPECT_DOUBLE_EQ(overlay.bandwidth(0, 0), 0.5);
+    EXPECT_DOUBLE_EQ(overlay.bandwidth(1, 1), 0.5);
+    double peak = overlay.density(0, 0.0, 0.0);
+
+    overlay.scale_bandwidth(2.0);
+    overlay.update();
+    EXPECT_DOUBLE_EQ(overlay.bandwidth(0, 0), 1.0);
+    // Twice as wide in both axes: about a quarter of the peak
+    EXPECT_NEAR(overlay.density(0, 0.0, 0.0) / peak, 0.25, 0.05);
+
+    overlay.set_bandwidth(std::nullopt);
+    overlay.update();
+    EXPECT_NEAR(overlay.bandwidth(0, 0), 2.0 * 20.0 / KdeOverlay::GRID, 1e-9);  // One bin, doubled
+}
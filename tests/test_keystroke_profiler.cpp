@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "keystroke_profiler.h"
+#include "frame_stats.h"
+#include "json_value.h"
+#include "terminal.h"
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+using namespace datapainter;
+
+class KeystrokeProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        FrameStats::set_enabled(true);
+        FrameStats::instance().reset();
+    }
+
+    void TearDown() override {
+        FrameStats::instance().reset();
+        FrameStats::set_enabled(false);
+    }
+};
+
+// Test: Nested timers pause the enclosing phase
+TEST_F(KeystrokeProfilerTest, NestedPhasesAreExclusive) {
+    {
+        PhaseTimer outer(Phase::EDIT_AREA);
+        {
+            PhaseTimer inner(Phase::QUERY);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    const FrameStats& stats = FrameStats::instance();
+    EXPECT_GE(stats.phase_ms(Phase::QUERY), 15.0);
+    EXPECT_LT(stats.phase_ms(Phase::EDIT_AREA), 15.0);
+    EXPECT_DOUBLE_EQ(stats.total_ms(), stats.phase_ms(Phase::QUERY) + stats.phase_ms(Phase::EDIT_AREA));
+}
+
+// Test: Disabled timers record nothing
+TEST_F(KeystrokeProfilerTest, DisabledTimersRecordNothing) {
+    FrameStats::set_enabled(false);
+    {
+        PhaseTimer timer(Phase::HEADER);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_EQ(FrameStats::instance().phase_ms(Phase::HEADER), 0.0);
+}
+
+// Test: Nearest-rank percentiles
+TEST_F(KeystrokeProfilerTest, Percentiles) {
+    std::vector<double> values;
+    for (int i = 100; i >= 1; --i) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(KeystrokeProfiler::percentile(values, 50), 50);
+    EXPECT_EQ(KeystrokeProfiler::percentile(values, 95), 95);
+    EXPECT_EQ(KeystrokeProfiler::percentile(values, 99), 99);
+    EXPECT_EQ(KeystrokeProfiler::percentile(values, 100), 100);
+    EXPECT_EQ(KeystrokeProfiler::percentile({}, 50), 0.0);
+}
+
+// Test: Key labels match the keystroke file syntax
+TEST_F(KeystrokeProfilerTest, KeyLabels) {
+    EXPECT_EQ(KeystrokeProfiler::key_label('x'), "x");
+    EXPECT_EQ(KeystrokeProfiler::key_label(Terminal::KEY_LEFT_ARROW), "<left>");
+    EXPECT_EQ(KeystrokeProfiler::key_label(Terminal::KEY_DUMP_SCREEN), "<dump>");
+    EXPECT_EQ(KeystrokeProfiler::key_label(' '), "<space>");
+    EXPECT_EQ(KeystrokeProfiler::key_label(127), "<delete>");
+    EXPECT_EQ(KeystrokeProfiler::key_label(-1), "<end>");
+}
+
+// Test: JSON report groups samples by key and by phase
+TEST_F(KeystrokeProfilerTest, JsonReport) {
+    KeystrokeProfiler profiler;
+    for (int i = 0; i < 3; ++i) {
+        FrameStats::instance().reset();
+        {
+            PhaseTimer timer(Phase::INPUT);
+        }
+        profiler.record(i < 2 ? 'x' : Terminal::KEY_UP_ARROW, FrameStats::instance());
+    }
+    EXPECT_EQ(profiler.sample_count(), 3u);
+
+    std::ostringstream out;
+    profiler.write_json(out);
+    auto report = JsonValue::parse(out.str());
+    ASSERT_TRUE(report.has_value()) << out.str();
+    EXPECT_EQ(report->get_int("keys"), 3);
+
+    const JsonValue* by_key = report->find("by_key");
+    ASSERT_NE(by_key, nullptr);
+    const JsonValue* x_entry = by_key->find("x");
+    ASSERT_NE(x_entry, nullptr);
+    const JsonValue* x_total = x_entry->find("total");
+    ASSERT_NE(x_total, nullptr);
+    EXPECT_EQ(x_total->get_int("count"), 2);
+    EXPECT_NE(by_key->find("<up>"), nullptr);
+
+    const JsonValue* by_phase = report->find("by_phase");
+    ASSERT_NE(by_phase, nullptr);
+    EXPECT_NE(by_phase->find("input"), nullptr);
+    EXPECT_NE(by_phase->find("terminal"), nullptr);
+}
+
+// Test: Table report lists every key type and phase
+TEST_F(KeystrokeProfilerTest, TableReport) {
+    KeystrokeProfiler profiler;
+    profiler.record('o', FrameStats::instance());
+    profiler.record('+', FrameStats::instance());
+
+    std::ostringstream out;
+    profiler.write_table(out);
+    std::string text = out.str();
+    EXPECT_NE(text.find("over 2 keys"), std::string::npos);
+    EXPECT_NE(text.find("\no "), std::string::npos);
+    EXPECT_NE(text.find("\n+ "), std::string::npos);
+    EXPECT_NE(text.find("\nall "), std::string::npos);
+    EXPECT_NE(text.find("\nedit_area "), std::string::npos);
+}
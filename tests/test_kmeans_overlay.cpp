@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include "kmeans_overlay.h"
+#include "database.h"
+#include "metadata.h"
+#include <algorithm>
+#include <random>
+
+using namespace datapainter;
+
+class KmeansOverlayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->is_open());
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        ASSERT_TRUE(db_->ensure_unsaved_changes_table());
+        mgr_ = std::make_unique<MetadataManager>(*db_);
+        ASSERT_TRUE(mgr_->create_data_table("test_table"));
+        table_ = std::make_unique<DataTable>(*db_, "test_table");
+        journal_ = std::make_unique<UnsavedChanges>(*db_);
+    }
+
+    // count points scattered around (cx, cy), the first x_count of them x
+    void blob(double cx, double cy, int count, int x_count) {
+        std::normal_distribution<double> spread(0.0, 0.5);
+        for (int i = 0; i < count; ++i) {
+            table_->insert_point(cx + spread(rng_), cy + spread(rng_), i < x_count ? "x" : "o");
+        }
+    }
+
+    std::vector<ChangeRecord> changes() { return journal_->get_changes("test_table"); }
+
+    void run(KmeansOverlay& overlay) {
+        overlay.run(*table_, changes(), palette_, -10.0, 10.0, -10.0, 10.0);
+    }
+
+    std::mt19937 rng_{7};
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<MetadataManager> mgr_;
+    std::unique_ptr<DataTable> table_;
+    std::unique_ptr<UnsavedChanges> journal_;
+    ClassPalette palette_{"x", "o"};
+};
+
+// Test: The distance kernel agrees with a scalar scan, ties to the lower index
+TEST_F(KmeansOverlayTest, NearestCentresMatchesScan) {
+    std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+    std::vector<float> xs(1003);
+    std::vector<float> ys(1003);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = coord(rng_);
+        ys[i] = coord(rng_);
+    }
+    std::vector<float> cx = {0.5f, -0.5f, 0.0f, 0.5f, 0.9f, -0.9f, 0.0f};
+    std::vector<float> cy = {0.5f, 0.5f, -0.5f, 0.5f, -0.9f, 0.9f, 0.0f};  // 3 duplicates 0
+    xs[5] = 0.5f;
+    ys[5] = 0.5f;
+    std::vector<uint8_t> cluster(xs.size());
+    std::vector<float> distance2(xs.size());
+    std::vector<float> second2(xs.size());
+    KmeansOverlay::nearest_centres(xs.data(), ys.data(), xs.size(), cx.data(), cy.data(),
+                                   static_cast<int>(cx.size()), cluster.data(), distance2.data(), second2.data());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        int best = 0;
+        float best_d = 1e30f;
+        float second_d = 1e30f;
+        for (size_t c = 0; c < cx.size(); ++c) {
+            float d = (xs[i] - cx[c]) * (xs[i] - cx[c]) + (ys[i] - cy[c]) * (ys[i] - cy[c]);
+            if (d < best_d) {
+                second_d = best_d;
+                best_d = d;
+                best = static_cast<int>(c);
+            } else {
+                second_d = std::min(second_d, d);
+            }
+        }
+        ASSERT_EQ(cluster[i], best) << i;
+        ASSERT_FLOAT_EQ(distance2[i], best_d) << i;
+        ASSERT_FLOAT_EQ(second2[i], second_d) << i;
+    }
+    EXPECT_EQ(cluster[5], 0);
+}
+
+// Test: Well separated blobs come back as the clusters, each with its majority class
+TEST_F(KmeansOverlayTest, FindsSeparatedClusters) {
+    blob(-6.0, -6.0, 300, 300);
+    blob(6.0, -6.0, 200, 0);
+    blob(0.0, 6.0, 250, 200);
+    KmeansOverlay overlay;
+    overlay.set_k(3);
+    run(overlay);
+    ASSERT_TRUE(overlay.has_result());
+    ASSERT_EQ(overlay.clusters(), 3);
+
+    int found = 0;
+    for (int c = 0; c < 3; ++c) {
+        double x = overlay.centre_x(c);
+        double y = overlay.centre_y(c);
+        if (std::abs(x + 6.0) < 0.2 && std::abs(y + 6.0) < 0.2) {
+            EXPECT_EQ(overlay.cluster_size(c), 300);
+            EXPECT_EQ(overlay.majority(c), 0);
+            ++found;
+        } else if (std::abs(x - 6.0) < 0.2 && std::abs(y + 6.0) < 0.2) {
+            EXPECT_EQ(overlay.cluster_size(c), 200);
+            EXPECT_EQ(overlay.majority(c), 1);
+            ++found;
+        } else if (std::abs(x) < 0.2 && std::abs(y - 6.0) < 0.2) {
+            EXPECT_EQ(overlay.cluster_size(c), 250);
+            EXPECT_EQ(overlay.majority(c), 0);
+            ++found;
+        }
+    }
+    EXPECT_EQ(found, 3);
+    EXPECT_EQ(overlay.suggested_changes(), 50);
+    EXPECT_LT(overlay.inertia(), 0.01);  // Scaled units: spread 0.5 / 10
+    EXPECT_LE(overlay.iterations(), 10);
+}
+
+// Test: k is capped by the number of points
+TEST_F(KmeansOverlayTest, FewerPointsThanClusters) {
+    table_->insert_point(1.0, 1.0, "x");
+    table_->insert_point(2.0, 2.0, "o");
+    KmeansOverlay overlay;
+    overlay.set_k(16);
+    run(overlay);
+    ASSERT_TRUE(overlay.has_result());
+    EXPECT_EQ(overlay.clusters(), 2);
+    EXPECT_EQ(overlay.suggested_changes(), 0);
+    EXPECT_DOUBLE_EQ(overlay.inertia(), 0.0);
+}
+
+// Test: Applying converts minority points through the journal in one batch
+TEST_F(KmeansOverlayTest, ApplyRelabelsThroughJournal) {
+    blob(-6.0, 0.0, 100, 95);  // 5 saved o among x
+    blob(6.0, 0.0, 100, 0);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(journal_->record_insert("test_table", 6.0 + 0.1 * i, 0.2, "x").has_value());
+    }
+    KmeansOverlay overlay;
+    overlay.set_k(2);
+    run(overlay);
+    ASSERT_TRUE(overlay.has_result());
+    EXPECT_EQ(overlay.suggested_changes(), 8);
+
+    auto converted = overlay.apply(*db_, "test_table", palette_);
+    ASSERT_TRUE(converted.has_value());
+    EXPECT_EQ(*converted, 8);
+    EXPECT_FALSE(overlay.has_result());
+
+    int updates = 0;
+    for (const auto& change : changes()) {
+        if (change.action == "update") {
+            EXPECT_EQ(change.old_target, "o");
+            EXPECT_EQ(change.new_target, "x");
+            ++updates;
+        } else {
+            EXPECT_EQ(change.new_target, "o");  // Inserts retargeted in place
+        }
+    }
+    EXPECT_EQ(updates, 5);
+
+    // The journal now agrees with the clusters
+    run(overlay);
+    EXPECT_EQ(overlay.suggested_changes(), 0);
+}
+
+// Test: An edit hides the result; a save is followed by a reload at the next run
+TEST_F(KmeansOverlayTest, EditsDropResult) {
+    blob(-6.0, 0.0, 50, 50);
+    blob(6.0, 0.0, 50, 0);
+    KmeansOverlay overlay;
+    overlay.set_k(2);
+    run(overlay);
+    ASSERT_TRUE(overlay.has_result());
+    overlay.sync(*table_, changes(), palette_);
+    EXPECT_TRUE(overlay.has_result());
+
+    ASSERT_TRUE(journal_->record_insert("test_table", 6.0, 0.0, "x").has_value());
+    overlay.sync(*table_, changes(), palette_);
+    EXPECT_FALSE(overlay.has_result());
+
+    // Save the insert: the next run reloads so the point can be converted
+    table_->insert_point(6.0, 0.0, "x");
+    ASSERT_TRUE(journal_->clear_changes("test_table"));
+    overlay.sync(*table_, changes(), palette_);
+    run(overlay);
+    EXPECT_EQ(overlay.suggested_changes(), 1);
+    EXPECT_EQ(overlay.apply(*db_, "test_table", palette_), 1);
+}
+
+// Test: Boundaries, numbered centres and the summary line
+TEST_F(KmeansOverlayTest, RendersClusters) {
+    blob(-5.0, 0.0, 100, 100);
+    blob(5.0, 0.0, 100, 0);
+    KmeansOverlay overlay;
+    overlay.set_k(2);
+    run(overlay);
+
+    Terminal terminal;
+    terminal.set_dimensions(22, 62);
+    for (int row = 1; row < 21; ++row) {
+        for (int col = 1; col < 61; ++col) {
+            terminal.write_char(row, col, ' ');
+        }
+    }
+    Viewport viewport(-10.0, 10.0, -10.0, 10.0, 20, 60);
+    overlay.render(terminal, viewport, 0, 22, 62);
+
+    std::string middle = terminal.get_row(10);
+    size_t boundary = middle.find(':');
+    ASSERT_NE(boundary, std::string::npos) << middle;
+    EXPECT_NEAR(static_cast<double>(boundary), 30.5, 1.5);
+    EXPECT_NE((terminal.get_row(10) + terminal.get_row(11)).find_first_of("12"), std::string::npos);
+    std::string bottom = terminal.get_row(21);
+    EXPECT_NE(bottom.find("k-means k=2"), std::string::npos) << bottom;
+    EXPECT_NE(bottom.find("A converts 0"), std::string::npos) << bottom;
+}
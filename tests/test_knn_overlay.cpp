@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "knn_overlay.h"
+#include "change_records.h"
+#include "database.h"
+#include "metadata.h"
+
+using namespace datapainter;
+
+class KnnOverlayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->is_open());
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        mgr_ = std::make_unique<MetadataManager>(*db_);
+        ASSERT_TRUE(mgr_->create_data_table("test_table"));
+        table_ = std::make_unique<DataTable>(*db_, "test_table");
+
+        // x points on the left half, o points on the right
+        for (int i = 0; i < 10; ++i) {
+            table_->insert_point(-5.0 + 0.1 * i, 0.0, "x");
+            table_->insert_point(5.0 + 0.1 * i, 0.0, "o");
+        }
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<MetadataManager> mgr_;
+    std::unique_ptr<DataTable> table_;
+    ClassPalette palette_{"x", "o"};
+};
+
+// Test: Each side of the table predicts the class painted there
+TEST_F(KnnOverlayTest, PredictsMajorityClass) {
+    KnnOverlay overlay;
+    EXPECT_EQ(overlay.predict(0.0, 0.0), ClassPalette::NO_CLASS);  // Nothing loaded
+
+    overlay.sync(*table_, {}, palette_);
+    ASSERT_TRUE(overlay.loaded());
+    EXPECT_EQ(overlay.size(), 20u);
+    EXPECT_EQ(overlay.predict(-3.0, 2.0), 0);
+    EXPECT_EQ(overlay.predict(8.0, -1.0), 1);
+
+    // k = 2 at an x/o tie: the nearer point wins
+    overlay.set_k(2);
+    EXPECT_EQ(overlay.predict(0.5, 0.0), 1);
+    EXPECT_EQ(overlay.predict(-0.5, 0.0), 0);
+}
+
+// Test: Journal inserts, conversions, deletes and their undos reach the tree
+TEST_F(KnnOverlayTest, SyncFollowsJournal) {
+    KnnOverlay overlay;
+    overlay.set_k(1);
+    overlay.sync(*table_, {}, palette_);
+    EXPECT_EQ(overlay.predict(-5.0, 3.0), 0);
+
+    // A painted o point next to the query takes it over
+    std::vector<ChangeRecord> changes = {journal_insert(1, -5.0, 2.9, "o")};
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.size(), 21u);
+    EXPECT_EQ(overlay.predict(-5.0, 3.0), 1);
+
+    // Converted in place, then undone
+    changes[0].new_target = "x";
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.size(), 21u);
+    EXPECT_EQ(overlay.predict(-5.0, 2.5), 0);
+    changes[0].new_target = "o";
+    changes[0].is_active = false;
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.size(), 20u);
+
+    // Deleting and updating saved points, by data id
+    auto points = table_->query_viewport(-10.0, 10.0, -10.0, 10.0);
+    int first_x = -1;
+    for (const auto& point : points) {
+        if (point.x == -5.0) {
+            first_x = point.id;
+        }
+    }
+    ASSERT_NE(first_x, -1);
+    changes.push_back(journal_update(2, first_x, "x", "o"));
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.predict(-5.1, 0.0), 1);
+
+    changes.push_back(journal_delete(3, first_x, -5.0, 0.0, "x"));
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.size(), 19u);
+    EXPECT_EQ(overlay.predict(-5.1, 0.0), 0);  // Next x point along
+
+    changes[2].is_active = false;  // Undo the delete: the update still applies
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.size(), 20u);
+    EXPECT_EQ(overlay.predict(-5.1, 0.0), 1);
+    changes[1].is_active = false;
+    overlay.sync(*table_, changes, palette_);
+    EXPECT_EQ(overlay.predict(-5.1, 0.0), 0);
+}
+
+// Test: Saved changes stay in the tree; edits of newly saved points reload it
+TEST_F(KnnOverlayTest, SaveKeepsTreeAndReloadsOnUnknownIds) {
+    KnnOverlay overlay;
+    overlay.set_k(1);
+    overlay.sync(*table_, {journal_insert(1, 0.0, 5.0, "o")}, palette_);
+    EXPECT_EQ(overlay.size(), 21u);
+
+    // Saved: the journal empties and the table gains the point
+    int saved_id = table_->insert_point(0.0, 5.0, "o").value();
+    overlay.sync(*table_, {}, palette_);
+    EXPECT_EQ(overlay.size(), 21u);
+    EXPECT_EQ(overlay.predict(0.0, 4.0), 1);
+
+    overlay.sync(*table_, {journal_delete(2, saved_id, 0.0, 5.0, "o")}, palette_);
+    EXPECT_EQ(overlay.size(), 20u);
+}
+
+// Test: Blank cells are shaded by region, boundaries marked, points kept
+TEST_F(KnnOverlayTest, RendersRegionsInBlankCells) {
+    KnnOverlay overlay;
+    overlay.sync(*table_, {}, palette_);
+
+    // 10 x 20 edit area with its border, over x in [-10, 10]
+    Terminal terminal;
+    terminal.set_dimensions(10, 20);
+    for (int row = 1; row < 9; ++row) {
+        for (int col = 1; col < 19; ++col) {
+            terminal.write_char(row, col, ' ');
+        }
+    }
+    terminal.write_char(4, 2, 'x');
+    Viewport viewport(-10.0, 10.0, -4.0, 4.0, 8, 18);
+    overlay.render(terminal, viewport, palette_, 0, 10, 20);
+
+    EXPECT_EQ(overlay.cell_class(0, 0), 0);
+    EXPECT_EQ(overlay.cell_class(0, 17), 1);
+    EXPECT_EQ(terminal.read_char(1, 1), '.');
+    EXPECT_EQ(terminal.read_glyph(1, 1), U'·');
+    EXPECT_EQ(terminal.read_color(1, 1), Terminal::Color::RED);
+    EXPECT_EQ(terminal.read_color(1, 18), Terminal::Color::BLUE);
+    EXPECT_EQ(terminal.read_char(4, 2), 'x');  // Points show through
+
+    // Column 8 is the last x cell (x < 0) and column 9 the first o cell
+    EXPECT_EQ(overlay.cell_class(2, 8), 0);
+    EXPECT_EQ(overlay.cell_class(2, 9), 1);
+    EXPECT_EQ(terminal.read_char(3, 9), ':');
+    EXPECT_EQ(terminal.read_char(3, 10), ':');
+    EXPECT_EQ(terminal.read_char(3, 11), '.');
+}
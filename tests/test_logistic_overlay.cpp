@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "logistic_overlay.h"
+#include "change_records.h"
+#include "database.h"
+#include "metadata.h"
+#include <cmath>
+#include <random>
+
+using namespace datapainter;
+
+class LogisticOverlayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->is_open());
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        mgr_ = std::make_unique<MetadataManager>(*db_);
+        ASSERT_TRUE(mgr_->create_data_table("test_table"));
+        table_ = std::make_unique<DataTable>(*db_, "test_table");
+    }
+
+    // Points drawn from P(o) = sigmoid(0.5 + 3x/10 - 2y/10) over [-10, 10]^2
+    static std::vector<ChangeRecord> noisy_points(int count, int first_id) {
+        std::mt19937 rng(static_cast<unsigned>(first_id));
+        std::uniform_real_distribution<double> coord(-10.0, 10.0);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::vector<ChangeRecord> changes;
+        for (int i = 0; i < count; ++i) {
+            double x = coord(rng);
+            double y = coord(rng);
+            double p = 1.0 / (1.0 + std::exp(-(0.5 + 0.3 * x - 0.2 * y)));
+            changes.push_back(journal_insert(first_id + i, x, y, unit(rng) < p ? "o" : "x"));
+        }
+        return changes;
+    }
+
+    LogisticOverlay make_overlay() {
+        LogisticOverlay overlay;
+        overlay.set_range(-10.0, 10.0, -10.0, 10.0);
+        return overlay;
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<MetadataManager> mgr_;
+    std::unique_ptr<DataTable> table_;
+    ClassPalette palette_{"x", "o"};
+};
+
+// Test: The fit recovers the model the points were drawn from
+TEST_F(LogisticOverlayTest, RecoversGeneratingModel) {
+    LogisticOverlay overlay = make_overlay();
+    overlay.sync(*table_, noisy_points(20000, 1), palette_);
+    ASSERT_TRUE(overlay.fitted());
+    EXPECT_EQ(overlay.count(0) + overlay.count(1), 20000u);
+
+    EXPECT_NEAR(overlay.logit(0.0, 0.0), 0.5, 0.1);
+    EXPECT_NEAR(overlay.logit(10.0, 0.0) - overlay.logit(0.0, 0.0), 3.0, 0.3);
+    EXPECT_NEAR(overlay.logit(0.0, 10.0) - overlay.logit(0.0, 0.0), -2.0, 0.3);
+    EXPECT_GT(overlay.accuracy(), 0.75);
+    EXPECT_GT(overlay.loss(), 0.3);
+    EXPECT_LT(overlay.loss(), std::log(2.0));
+    EXPECT_LE(overlay.iterations(), 10);
+}
+
+// Test: Warm-started refits after edits land on the from-scratch fit
+TEST_F(LogisticOverlayTest, IncrementalMatchesFreshFit) {
+    std::vector<ChangeRecord> changes = noisy_points(5000, 1);
+    LogisticOverlay incremental = make_overlay();
+    incremental.sync(*table_, changes, palette_);
+
+    // Paint a cluster of o points, convert one and undo another
+    for (int i = 0; i < 50; ++i) {
+        changes.push_back(journal_insert(10000 + i, -8.0 + 0.01 * i, 8.0, "o"));
+        incremental.sync(*table_, changes, palette_);
+        EXPECT_LE(incremental.iterations(), 4);
+    }
+    changes[10].new_target = changes[10].new_target == "x" ? "o" : "x";
+    changes[20].is_active = false;
+    incremental.sync(*table_, changes, palette_);
+
+    LogisticOverlay fresh = make_overlay();
+    fresh.sync(*table_, changes, palette_);
+    for (double x : {-10.0, 0.0, 7.0}) {
+        for (double y : {-5.0, 3.0}) {
+            EXPECT_NEAR(incremental.logit(x, y), fresh.logit(x, y), 1e-5);
+        }
+    }
+    EXPECT_DOUBLE_EQ(incremental.accuracy(), fresh.accuracy());
+    EXPECT_NEAR(incremental.loss(), fresh.loss(), 1e-6);
+    EXPECT_EQ(incremental.count(1), fresh.count(1));
+}
+
+// Test: Separable classes give a finite, perfect fit; one class gives none
+TEST_F(LogisticOverlayTest, SeparableAndSingleClass) {
+    for (int i = 0; i < 10; ++i) {
+        table_->insert_point(-5.0, i - 5.0, "x");
+    }
+    table_->insert_point(3.0, 0.0, "other");  // Not part of the model
+
+    LogisticOverlay overlay = make_overlay();
+    overlay.sync(*table_, {}, palette_);
+    EXPECT_FALSE(overlay.fitted());
+    EXPECT_DOUBLE_EQ(overlay.probability(0.0, 0.0), 0.5);
+
+    std::vector<ChangeRecord> changes;
+    for (int i = 0; i < 10; ++i) {
+        changes.push_back(journal_insert(i + 1, 5.0, i - 5.0, "o"));
+    }
+    overlay.sync(*table_, changes, palette_);
+    ASSERT_TRUE(overlay.fitted());
+    EXPECT_EQ(overlay.count(0), 10u);
+    EXPECT_EQ(overlay.count(1), 10u);
+    EXPECT_DOUBLE_EQ(overlay.accuracy(), 1.0);
+    EXPECT_TRUE(std::isfinite(overlay.logit(10.0, 0.0)));
+    EXPECT_GT(overlay.probability(5.0, 0.0), 0.8);
+    EXPECT_LT(overlay.probability(-5.0, 0.0), 0.2);
+    EXPECT_NEAR(overlay.probability(0.0, 3.0), 0.5, 0.01);
+}
+
+// Test: A vertical boundary is drawn as '|' with coloured bands either side
+TEST_F(LogisticOverlayTest, RendersLineAndBands) {
+    std::vector<ChangeRecord> changes;
+    for (int i = 0; i < 40; ++i) {
+        // Overlapping near x = 0, so the bands are wide
+        changes.push_back(journal_insert(2 * i + 1, -6.0 + 0.2 * i, 0.1 * i - 2.0, "x"));
+        changes.push_back(journal_insert(2 * i + 2, -1.8 + 0.2 * i, 2.0 - 0.1 * i, "o"));
+    }
+    LogisticOverlay overlay = make_overlay();
+    overlay.sync(*table_, changes, palette_);
+    ASSERT_TRUE(overlay.fitted());
+
+    Terminal terminal;
+    terminal.set_dimensions(12, 42);
+    for (int row = 1; row < 11; ++row) {
+        for (int col = 1; col < 41; ++col) {
+            terminal.write_char(row, col, ' ');
+        }
+    }
+    terminal.write_char(5, 5, 'x');
+    Viewport viewport(-10.0, 10.0, -10.0, 10.0, 10, 40);
+    overlay.render(terminal, viewport, palette_, 0, 12, 42);
+
+    // Find the line on the middle row
+    std::string row = terminal.get_row(5);
+    size_t line = row.find('|', 1);
+    ASSERT_NE(line, std::string::npos) << row;
+    EXPECT_EQ(terminal.read_color(5, static_cast<int>(line)), Terminal::Color::YELLOW);
+    EXPECT_EQ(terminal.read_char(5, 5), 'x');  // Points show through
+    EXPECT_EQ(terminal.read_char(5, static_cast<int>(line) - 2), ':');
+    EXPECT_EQ(terminal.read_color(5, static_cast<int>(line) - 2), Terminal::Color::RED);
+    EXPECT_EQ(terminal.read_color(5, static_cast<int>(line) + 2), Terminal::Color::BLUE);
+    EXPECT_EQ(terminal.read_char(5, 40), ' ');  // Far from the line: P(o) > 0.9
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "minimap.h"
+#include "change_records.h"
+#include "database.h"
+#include "metadata.h"
+
+using namespace datapainter;
+
+class MinimapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->is_open());
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        mgr_ = std::make_unique<MetadataManager>(*db_);
+        ASSERT_TRUE(mgr_->create_data_table("test_table"));
+        table_ = std::make_unique<DataTable>(*db_, "test_table");
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<MetadataManager> mgr_;
+    std::unique_ptr<DataTable> table_;
+};
+
+// Test: Counts come from the aggregate query over the valid range
+TEST_F(MinimapTest, LoadsCountsFromTable) {
+    // Valid range [0, 24] x [0, 8]: one data unit per minimap cell
+    table_->insert_point(0.5, 7.5, "x");   // Top-left cell
+    table_->insert_point(0.7, 7.2, "o");
+    table_->insert_point(24.0, 0.0, "x");  // Max corner clamps into the last cell
+    table_->insert_point(30.0, 0.0, "x");  // Outside the valid range
+
+    Minimap minimap;
+    minimap.ensure_loaded(*table_, 0.0, 24.0, 0.0, 8.0);
+    ASSERT_TRUE(minimap.loaded());
+    EXPECT_EQ(minimap.count_at(0, 0), 2);
+    EXPECT_EQ(minimap.count_at(Minimap::ROWS - 1, Minimap::COLS - 1), 1);
+
+    int total = 0;
+    for (int row = 0; row < Minimap::ROWS; ++row) {
+        for (int col = 0; col < Minimap::COLS; ++col) {
+            total += minimap.count_at(row, col);
+        }
+    }
+    EXPECT_EQ(total, 3);
+}
+
+// Test: Journal inserts and deletes adjust counts as they activate and deactivate
+TEST_F(MinimapTest, SyncFollowsJournal) {
+    int saved = table_->insert_point(3.5, 4.5, "x").value();
+    Minimap minimap;
+    minimap.ensure_loaded(*table_, 0.0, 24.0, 0.0, 8.0);
+    EXPECT_EQ(minimap.count_at(3, 3), 1);
+
+    std::vector<ChangeRecord> journal = {journal_insert(1, 3.2, 4.1, "x"),
+                                         journal_delete(2, saved, 3.5, 4.5, "x")};
+    minimap.sync(*table_, journal);
+    EXPECT_EQ(minimap.count_at(3, 3), 1);  // +1 -1
+
+    // Syncing the same journal again changes nothing
+    minimap.sync(*table_, journal);
+    EXPECT_EQ(minimap.count_at(3, 3), 1);
+
+    // Undo the delete
+    journal[1].is_active = false;
+    minimap.sync(*table_, journal);
+    EXPECT_EQ(minimap.count_at(3, 3), 2);
+
+    // A conversion moves no point
+    journal.push_back(journal_update(3, saved, "x", "o"));
+    minimap.sync(*table_, journal);
+    EXPECT_EQ(minimap.count_at(3, 3), 2);
+
+    // Saved: the journal empties, the counts stay
+    minimap.sync(*table_, {});
+    EXPECT_EQ(minimap.count_at(3, 3), 2);
+}
+
+// Test: The box shows density glyphs and outlines the viewport
+TEST_F(MinimapTest, RendersDensityAndViewportOutline) {
+    for (int i = 0; i < 20; ++i) {
+        table_->insert_point(20.5, 1.5, "x");
+    }
+    table_->insert_point(1.5, 6.5, "o");
+
+    Minimap minimap;
+    minimap.ensure_loaded(*table_, 0.0, 24.0, 0.0, 8.0);
+
+    Terminal terminal;
+    terminal.set_dimensions(Minimap::HEIGHT, Minimap::WIDTH);
+    Viewport viewport(4.0, 8.0, 2.0, 4.0, 10, 10);
+    minimap.render(terminal, viewport, 0, 0);
+
+    EXPECT_EQ(terminal.get_row(0).substr(0, 7), "+- map ");
+    EXPECT_EQ(terminal.read_char(Minimap::HEIGHT - 1, Minimap::WIDTH - 1), '+');
+
+    // Busiest cell is the darkest shade; a single point the lightest
+    EXPECT_EQ(terminal.read_char(1 + 6, 1 + 20), '@');
+    EXPECT_EQ(terminal.read_char(1 + 1, 1 + 1), '.');
+
+    // Viewport x in [4, 8], y in [2, 4]: rows 4-6 (y = 4 is the start of row 4), cols 4-8
+    EXPECT_EQ(terminal.read_char(1 + 4, 1 + 4), '+');
+    EXPECT_EQ(terminal.read_char(1 + 4, 1 + 6), '-');
+    EXPECT_EQ(terminal.read_char(1 + 5, 1 + 4), '|');
+    EXPECT_EQ(terminal.read_char(1 + 6, 1 + 8), '+');
+    EXPECT_EQ(terminal.read_color(1 + 6, 1 + 8), Terminal::Color::YELLOW);
+    EXPECT_EQ(terminal.read_char(1 + 5, 1 + 6), ' ');
+
+    // An occupied cell on the outline keeps its shade
+    table_->insert_point(6.5, 2.0, "x");
+    Minimap reloaded;
+    reloaded.ensure_loaded(*table_, 0.0, 24.0, 0.0, 8.0);
+    reloaded.render(terminal, viewport, 0, 0);
+    EXPECT_EQ(terminal.read_char(1 + 5, 1 + 6), ' ');
+    EXPECT_EQ(terminal.read_char(1 + 6, 1 + 6), '.');
+    EXPECT_EQ(terminal.read_color(1 + 6, 1 + 6), Terminal::Color::YELLOW);
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include "moments.h"
+
+using namespace datapainter;
+
+// Test: Sums of a known set give its centroid and sample covariance
+TEST(MomentsTest, GiveCentroidAndCovariance) {
+    Moments moments;
+    moments.add(1.0, 2.0, +1);
+    moments.add(3.0, 6.0, +1);
+    moments.add(5.0, 4.0, +1);
+    moments.add(9.0, 9.0, +1);
+    moments.add(9.0, 9.0, -1);
+    EXPECT_EQ(moments.count, 3);
+    EXPECT_DOUBLE_EQ(moments.mean_x(), 3.0);
+    EXPECT_DOUBLE_EQ(moments.mean_y(), 4.0);
+    EXPECT_DOUBLE_EQ(moments.var_x(), 4.0);
+    EXPECT_DOUBLE_EQ(moments.var_y(), 4.0);
+    EXPECT_DOUBLE_EQ(moments.cov_xy(), 2.0);
+
+    Moments single;
+    single.add(1.0, 1.0, +1);
+    EXPECT_EQ(single.var_x(), 0.0);
+    EXPECT_EQ(single.cov_xy(), 0.0);
+}
+
+// Test: Removing what was added, in any grouping, leaves nothing
+TEST(MomentsTest, AddAndRemoveSets) {
+    Moments a;
+    a.add(1.0, 2.0, +1);
+    a.add(-3.0, 0.5, +1);
+    Moments total;
+    total.add(a, +1);
+    total.add(4.0, 4.0, +1);
+    EXPECT_EQ(total.count, 3);
+    EXPECT_DOUBLE_EQ(total.sum_x, 2.0);
+    EXPECT_DOUBLE_EQ(total.sum_xy, 16.5);
+
+    TargetSums sums{"x", 1, 4.0, 4.0, 16.0, 16.0, 16.0};
+    total.add(sums, -1);
+    total.add(a, -1);
+    EXPECT_EQ(total.count, 0);
+    EXPECT_DOUBLE_EQ(total.sum_xx, 0.0);
+    EXPECT_EQ(total.mean_x(), 0.0);
+}
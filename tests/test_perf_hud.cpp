@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "perf_hud.h"
+#include "frame_stats.h"
+#include "database.h"
+#include "terminal.h"
+
+using namespace datapainter;
+
+class PerfHudTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        FrameStats::set_enabled(true);
+        FrameStats::instance().reset();
+    }
+
+    void TearDown() override {
+        FrameStats::instance().reset();
+        FrameStats::set_enabled(false);
+    }
+};
+
+// Test: Every HUD line has the same width and every phase is listed
+TEST_F(PerfHudTest, LinesHaveFixedWidth) {
+    PerfHud hud;
+    auto lines = hud.get_lines(FrameStats::instance());
+    ASSERT_FALSE(lines.empty());
+    for (const auto& line : lines) {
+        EXPECT_EQ(static_cast<int>(line.size()), PerfHud::WIDTH) << line;
+    }
+    std::string text;
+    for (const auto& line : lines) {
+        text += line + "\n";
+    }
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        EXPECT_NE(text.find(phase_name(static_cast<Phase>(i))), std::string::npos);
+    }
+}
+
+// Test: Counters and cache hit rate are shown
+TEST_F(PerfHudTest, ShowsCounters) {
+    FrameStats& stats = FrameStats::instance();
+    stats.add_points_fetched(1234);
+    stats.add_cells_written(1920);
+    stats.set_journal_length(7);
+
+    PerfHud hud;
+    auto lines = hud.get_lines(stats);
+    std::string text;
+    for (const auto& line : lines) {
+        text += line + "\n";
+    }
+    EXPECT_NE(text.find("1234"), std::string::npos);
+    EXPECT_NE(text.find("1920"), std::string::npos);
+    EXPECT_NE(text.find("n/a"), std::string::npos);
+
+    stats.add_cache_usage(3, 1);
+    EXPECT_DOUBLE_EQ(stats.cache_hit_rate(), 0.75);
+    lines = hud.get_lines(stats);
+    text.clear();
+    for (const auto& line : lines) {
+        text += line + "\n";
+    }
+    EXPECT_NE(text.find("75.0%"), std::string::npos);
+}
+
+// Test: HUD is drawn in the top-right corner and clipped at the bottom
+TEST_F(PerfHudTest, RendersTopRight) {
+    Terminal terminal;
+    terminal.set_dimensions(10, 60);
+    terminal.clear_buffer();
+
+    PerfHud hud;
+    hud.render(terminal, FrameStats::instance(), 3);
+
+    EXPECT_EQ(terminal.get_row(2), std::string(60, ' '));
+    std::string row3 = terminal.get_row(3);
+    EXPECT_EQ(row3.substr(0, 60 - PerfHud::WIDTH), std::string(60 - PerfHud::WIDTH, ' '));
+    EXPECT_EQ(row3.substr(60 - PerfHud::WIDTH, 2), "+-");
+    EXPECT_EQ(row3.back(), '+');
+    EXPECT_EQ(terminal.get_row(9).back(), '|');
+}
+
+// Test: Page-cache counters are readable from a connection
+TEST_F(PerfHudTest, DatabaseCacheUsage) {
+    Database db(":memory:");
+    ASSERT_TRUE(db.execute("CREATE TABLE t (v INTEGER)"));
+    ASSERT_TRUE(db.execute("INSERT INTO t VALUES (1)"));
+
+    int hits = -1;
+    int misses = -1;
+    ASSERT_TRUE(db.page_cache_usage(hits, misses, true));
+    EXPECT_GE(hits, 0);
+    EXPECT_GE(misses, 0);
+
+    ASSERT_TRUE(db.page_cache_usage(hits, misses, false));
+    EXPECT_EQ(hits, 0);
+    EXPECT_EQ(misses, 0);
+}
@@ -3,6 +3,12 @@
 #include "metadata.h"
 #include "data_table.h"
 #include "random_initializer.h"
+#include "kde_overlay.h"
+#include "kmeans_overlay.h"
+#include "knn_overlay.h"
+#include "logistic_overlay.h"
+#include "minimap.h"
+#include "stats_panel.h"
 #include <cmath>
 #include <algorithm>
 
@@ -60,6 +66,66 @@ TEST_F(RandomInitializerTest, GenerateNPoints) {
     EXPECT_EQ(points.size(), 100);
 }
 
+// Test: Generated points bypass the journal, so the cached views show
+// them only once invalidated, as the 'r' key does
+TEST_F(RandomInitializerTest, InvalidatedViewsPickUpGeneratedPoints) {
+    DataTable table(db_, "test_table");
+    ClassPalette palette("x_val", "o_val");
+    StatsPanel stats;
+    Minimap minimap;
+    KdeOverlay kde;
+    KnnOverlay knn;
+    LogisticOverlay logistic;
+    KmeansOverlay kmeans;
+    logistic.set_range(-10.0, 10.0, -10.0, 10.0);
+    kmeans.set_k(2);
+    auto refresh = [&] {
+        stats.set_viewport(table, palette, -10.0, 10.0, -10.0, 10.0);
+        minimap.ensure_loaded(table, -10.0, 10.0, -10.0, 10.0);
+        minimap.sync(table, {});
+        kde.ensure_loaded(table, palette, -10.0, 10.0, -10.0, 10.0);
+        kde.sync(table, {}, palette);
+        knn.sync(table, {}, palette);
+        logistic.sync(table, {}, palette);
+        kmeans.run(table, {}, palette, -10.0, 10.0, -10.0, 10.0);
+    };
+    refresh();
+    EXPECT_EQ(knn.size(), 0u);
+
+    RandomInitializer ri(db_, "test_table");
+    RandomConfig config;
+    config.count = 100;
+    config.target = "x_val";
+    config.uniform_x = true;
+    config.uniform_y = true;
+    config.range_x = 5.0;
+    config.range_y = 5.0;
+    ASSERT_TRUE(ri.generate(config));
+    refresh();
+    EXPECT_EQ(knn.size(), 0u);  // Nothing in the journal says to reload
+
+    stats.invalidate();
+    minimap.invalidate();
+    kde.invalidate();
+    knn.invalidate();
+    logistic.invalidate();
+    kmeans.invalidate();
+    refresh();
+    EXPECT_EQ(stats.viewport_count(), 100);
+    int minimap_total = 0;
+    for (int row = 0; row < Minimap::ROWS; ++row) {
+        for (int col = 0; col < Minimap::COLS; ++col) {
+            minimap_total += minimap.count_at(row, col);
+        }
+    }
+    EXPECT_EQ(minimap_total, 100);
+    EXPECT_EQ(kde.count(0), 100);
+    EXPECT_EQ(knn.size(), 100u);
+    EXPECT_EQ(logistic.count(0), 100u);
+    ASSERT_TRUE(kmeans.has_result());
+    EXPECT_EQ(kmeans.cluster_size(0) + kmeans.cluster_size(1), 100);
+}
+
 // Test: Set target value
 TEST_F(RandomInitializerTest, SetTargetValue) {
     RandomInitializer ri(db_, "test_table");
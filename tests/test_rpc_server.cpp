@@ -0,0 +1,382 @@
+#include <gtest/gtest.h>
+#include "rpc_server.h"
+#include "rpc_client.h"
+#include "database.h"
+#include "data_table.h"
+#include "table_manager.h"
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace datapainter;
+
+class RpcServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->is_open());
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        ASSERT_TRUE(db_->ensure_unsaved_changes_table());
+
+        TableManager mgr(*db_);
+        ASSERT_TRUE(mgr.create_table("pts", "label", "x", "y", "cat", "dog",
+                                     -10, 10, -10, 10, false));
+    }
+
+    // Send a request and parse the response
+    JsonValue call(RpcServer& server, const std::string& method, JsonValue params) {
+        JsonValue request = JsonValue::object();
+        request.set("id", 1);
+        request.set("method", method);
+        request.set("params", std::move(params));
+        auto response = JsonValue::parse(server.handle_request(request.dump()));
+        EXPECT_TRUE(response.has_value());
+        return response.value_or(JsonValue());
+    }
+
+    std::string request_text(int id, const std::string& method, JsonValue params) {
+        JsonValue request = JsonValue::object();
+        request.set("id", id);
+        request.set("method", method);
+        request.set("params", std::move(params));
+        return request.dump();
+    }
+
+    std::unique_ptr<Database> db_;
+};
+
+// Test: Frames are 4-byte big-endian length prefixed
+TEST_F(RpcServerTest, FrameEncodingRoundTrip) {
+    std::string frame = RpcServer::encode_frame("hello");
+    ASSERT_EQ(frame.size(), 9u);
+    EXPECT_EQ(frame[3], 5);
+
+    std::string buffer = frame.substr(0, 6);
+    std::string payload;
+    EXPECT_FALSE(RpcServer::extract_frame(buffer, payload));
+    buffer += frame.substr(6) + RpcServer::encode_frame("");
+    EXPECT_TRUE(RpcServer::extract_frame(buffer, payload));
+    EXPECT_EQ(payload, "hello");
+    EXPECT_TRUE(RpcServer::extract_frame(buffer, payload));
+    EXPECT_EQ(payload, "");
+    EXPECT_TRUE(buffer.empty());
+}
+
+// Test: Add point returns the new ID and CLI-style output
+TEST_F(RpcServerTest, AddPointReturnsId) {
+    RpcServer server(*db_);
+    JsonValue params = JsonValue::object();
+    params.set("table", "pts");
+    params.set("x", 1.5);
+    params.set("y", -2.0);
+    params.set("target", "cat");
+
+    JsonValue response = call(server, "add_point", params);
+    const JsonValue* result = response.find("result");
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->get_int("id"), 1);
+    EXPECT_EQ(result->get_string("output"), "Point added with ID 1\n");
+    EXPECT_EQ(response.get_int("id"), 1);
+
+    DataTable dt(*db_, "pts");
+    EXPECT_EQ(dt.count_by_target("cat"), 1);
+}
+
+// Test: Errors carry the CLI exit code
+TEST_F(RpcServerTest, ErrorsCarryExitCodes) {
+    RpcServer server(*db_);
+
+    JsonValue params = JsonValue::object();
+    params.set("table", "pts");
+    params.set("point_id", 99);
+    JsonValue response = call(server, "delete_point", params);
+    const JsonValue* error = response.find("error");
+    ASSERT_NE(error, nullptr);
+    EXPECT_EQ(error->get_int("code"), 66);
+    EXPECT_EQ(error->get_string("message"), "Point not found: 99");
+
+    response = call(server, "no_such_method", JsonValue::object());
+    error = response.find("error");
+    ASSERT_NE(error, nullptr);
+    EXPECT_EQ(error->get_int("code"), 2);
+
+    auto malformed = JsonValue::parse(server.handle_request("{not json"));
+    ASSERT_TRUE(malformed.has_value());
+    EXPECT_NE(malformed->find("error"), nullptr);
+}
+
+// Test: Table names are validated before reaching SQL
+TEST_F(RpcServerTest, RejectsInvalidTableName) {
+    RpcServer server(*db_);
+    JsonValue params = JsonValue::object();
+    params.set("table", "pts; DROP TABLE metadata");
+    JsonValue response = call(server, "to_csv", params);
+    const JsonValue* error = response.find("error");
+    ASSERT_NE(error, nullptr);
+    EXPECT_EQ(error->get_int("code"), 2);
+    EXPECT_EQ(error->get_string("message"), "Invalid table name: pts; DROP TABLE metadata");
+    EXPECT_TRUE(db_->table_exists("metadata"));
+}
+
+// Test: Errors read as the local CLI's do
+TEST_F(RpcServerTest, ErrorsMatchCliMessages) {
+    RpcServer server(*db_);
+    JsonValue response = call(server, "add_point", JsonValue::object());
+    const JsonValue* error = response.find("error");
+    ASSERT_NE(error, nullptr);
+    EXPECT_EQ(error->get_string("message"), "--table is required for --add-point");
+
+    JsonValue params = JsonValue::object();
+    params.set("table", "ranges");
+    for (const char* name : {"target_column_name", "x_axis_name", "y_axis_name", "x_meaning", "o_meaning"}) {
+        params.set(name, "v");
+    }
+    params.set("min_x", 5.0);
+    params.set("max_x", -5.0);
+    response = call(server, "create_table", params);
+    error = response.find("error");
+    ASSERT_NE(error, nullptr);
+    EXPECT_EQ(error->get_int("code"), 2);
+    EXPECT_EQ(error->get_string("message"), "Invalid range: min_x (5.000000) must be <= max_x (-5.000000)");
+}
+
+// Test: Viewport query returns compact rows
+TEST_F(RpcServerTest, QueryViewport) {
+    DataTable dt(*db_, "pts");
+    dt.insert_point(1.0, 1.0, "cat");
+    dt.insert_point(5.0, 5.0, "dog");
+
+    RpcServer server(*db_);
+    JsonValue params = JsonValue::object();
+    params.set("table", "pts");
+    params.set("x_min", 0.0);
+    params.set("x_max", 2.0);
+    params.set("y_min", 0.0);
+    params.set("y_max", 2.0);
+
+    JsonValue response = call(server, "query_viewport", params);
+    const JsonValue* result = response.find("result");
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->get_int("count"), 1);
+    const JsonValue* points = result->find("points");
+    ASSERT_NE(points, nullptr);
+    ASSERT_EQ(points->size(), 1u);
+    EXPECT_EQ(points->as_array()[0].as_array()[3].as_string(), "cat");
+}
+
+// Test: CSV export matches the --to-csv format
+TEST_F(RpcServerTest, ToCsv) {
+    DataTable dt(*db_, "pts");
+    dt.insert_point(1.5, 2.5, "a,b");
+
+    RpcServer server(*db_);
+    JsonValue params = JsonValue::object();
+    params.set("table", "pts");
+    JsonValue response = call(server, "to_csv", params);
+    const JsonValue* result = response.find("result");
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->get_string("output"), "x,y,target\n1.5,2.5,\"a,b\"\n");
+}
+
+// Test: An export larger than the limit is refused rather than buffered
+TEST_F(RpcServerTest, ToCsvOverLimit) {
+    DataTable dt(*db_, "pts");
+    std::string target(1000, 'a');
+    for (int i = 0; i < 1100; ++i) {
+        dt.insert_point(0.0, 0.0, target);
+    }
+
+    RpcServer server(*db_);
+    server.set_max_csv_size(1 << 20);
+    JsonValue params = JsonValue::object();
+    params.set("table", "pts");
+    JsonValue response = call(server, "to_csv", params);
+    const JsonValue* error = response.find("error");
+    ASSERT_NE(error, nullptr) << response.dump();
+    EXPECT_EQ(error->get_int("code"), 66);
+    EXPECT_EQ(error->get_string("message"),
+              std::optional<std::string>("CSV output exceeds 1 MiB; run --to-csv without --connect"));
+}
+
+// Test: A batch of writes is applied and answered in order
+TEST_F(RpcServerTest, BatchedWritesAnsweredInOrder) {
+    EXPECT_TRUE(RpcServer::is_batchable_write("add_point"));
+    EXPECT_FALSE(RpcServer::is_batchable_write("commit_unsaved_changes"));
+
+    std::vector<std::string> payloads;
+    for (int i = 0; i < 5; ++i) {
+        JsonValue params = JsonValue::object();
+        params.set("table", "pts");
+        params.set("x", static_cast<double>(i));
+        params.set("y", 0.0);
+        params.set("target", "dog");
+        payloads.push_back(request_text(i + 10, "add_point", params));
+    }
+    payloads.push_back(request_text(99, "list_tables", JsonValue::object()));
+
+    RpcServer server(*db_);
+    auto responses = server.handle_batch(payloads);
+    ASSERT_EQ(responses.size(), payloads.size());
+    for (int i = 0; i < 5; ++i) {
+        auto response = JsonValue::parse(responses[i]);
+        ASSERT_TRUE(response.has_value());
+        EXPECT_EQ(response->get_int("id"), i + 10);
+        EXPECT_NE(response->find("result"), nullptr);
+    }
+
+    DataTable dt(*db_, "pts");
+    EXPECT_EQ(dt.count_by_target("dog"), 5);
+}
+
+// Test: Shutdown request stops the server
+TEST_F(RpcServerTest, ShutdownRequest) {
+    RpcServer server(*db_);
+    EXPECT_FALSE(server.stop_requested());
+    call(server, "shutdown", JsonValue::object());
+    EXPECT_TRUE(server.stop_requested());
+}
+
+#ifndef _WIN32
+// Test: Client and server talk over a real Unix socket
+TEST_F(RpcServerTest, SocketRoundTrip) {
+    std::string socket_path = "/tmp/datapainter_rpc_test_" + std::to_string(getpid()) + ".sock";
+
+    RpcServer server(*db_);
+    std::ostringstream log;
+    bool served = false;
+    std::thread server_thread([&]() { served = server.serve(socket_path, log); });
+
+    // Wait for the socket to appear
+    RpcClient client(socket_path);
+    bool connected = false;
+    for (int attempt = 0; attempt < 200 && !connected; ++attempt) {
+        connected = client.connect();
+        if (!connected) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_TRUE(connected) << client.last_error();
+
+    JsonValue params = JsonValue::object();
+    params.set("table", "pts");
+    params.set("x", 0.5);
+    params.set("y", 0.5);
+    params.set("target", "cat");
+    auto response = client.call(request_text(1, "add_point", params));
+    ASSERT_TRUE(response.has_value()) << client.last_error();
+    EXPECT_NE(response->find("Point added with ID 1"), std::string::npos);
+
+    response = client.call(request_text(2, "shutdown", JsonValue::object()));
+    ASSERT_TRUE(response.has_value()) << client.last_error();
+
+    server_thread.join();
+    EXPECT_TRUE(served) << server.last_error();
+    EXPECT_NE(access(socket_path.c_str(), F_OK), 0);  // socket removed
+}
+
+// Test: A client that half-closes after its request still gets the answer
+TEST_F(RpcServerTest, HalfClosedClientGetsResponse) {
+    std::string socket_path = "/tmp/datapainter_rpc_half_" + std::to_string(getpid()) + ".sock";
+    RpcServer server(*db_);
+    std::ostringstream log;
+    std::thread server_thread([&]() { server.serve(socket_path, log); });
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path.c_str());
+    int fd = -1;
+    for (int attempt = 0; attempt < 200 && fd < 0; ++attempt) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close(fd);
+            fd = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_GE(fd, 0);
+
+    std::string frame = RpcServer::encode_frame(request_text(1, "list_tables", JsonValue::object()));
+    ASSERT_EQ(write(fd, frame.data(), frame.size()), static_cast<ssize_t>(frame.size()));
+    ASSERT_EQ(shutdown(fd, SHUT_WR), 0);
+    std::string buffer;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        buffer.append(buf, static_cast<size_t>(n));
+    }
+    close(fd);
+    std::string response;
+    ASSERT_TRUE(RpcServer::extract_frame(buffer, response));
+    EXPECT_NE(response.find("pts"), std::string::npos) << response;
+
+    RpcClient client(socket_path);
+    ASSERT_TRUE(client.connect()) << client.last_error();
+    ASSERT_TRUE(client.call(request_text(2, "shutdown", JsonValue::object())).has_value());
+    server_thread.join();
+}
+
+// Test: A server that hangs up before reading is an error, not SIGPIPE
+TEST_F(RpcServerTest, ClientSurvivesServerHangup) {
+    std::string socket_path = "/tmp/datapainter_rpc_hangup_" + std::to_string(getpid()) + ".sock";
+    unlink(socket_path.c_str());
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(listen_fd, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path.c_str());
+    ASSERT_EQ(bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(listen(listen_fd, 1), 0);
+
+    signal(SIGPIPE, SIG_DFL);  // As in a fresh client process
+    RpcClient client(socket_path);
+    ASSERT_TRUE(client.connect()) << client.last_error();
+    close(accept(listen_fd, nullptr, nullptr));
+
+    EXPECT_FALSE(client.call(std::string(1 << 20, ' ')).has_value());
+    close(listen_fd);
+    unlink(socket_path.c_str());
+}
+#endif
+
+// Test: CLI arguments map onto RPC requests
+TEST_F(RpcServerTest, ClientBuildsRequestFromArguments) {
+    Arguments args;
+    args.add_point = true;
+    args.table = "pts";
+    args.point_x = 1.0;
+    args.point_y = 2.0;
+    args.point_target = "cat";
+
+    std::string error;
+    auto request = RpcClient::build_request(args, error);
+    ASSERT_TRUE(request.has_value());
+    EXPECT_EQ(request->get_string("method"), "add_point");
+    const JsonValue* params = request->find("params");
+    ASSERT_NE(params, nullptr);
+    EXPECT_EQ(params->get_string("table"), "pts");
+    EXPECT_EQ(params->get_number("y"), 2.0);
+
+    Arguments interactive;
+    interactive.table = "pts";
+    EXPECT_FALSE(RpcClient::build_request(interactive, error).has_value());
+    EXPECT_FALSE(error.empty());
+
+    // Unimplemented commands fail as they do locally
+    Arguments rename;
+    rename.rename_table = true;
+    EXPECT_FALSE(RpcClient::build_request(rename, error).has_value());
+    EXPECT_EQ(error, "--rename-table not yet implemented");
+    Arguments copy;
+    copy.copy_table = true;
+    EXPECT_FALSE(RpcClient::build_request(copy, error).has_value());
+    EXPECT_EQ(error, "--copy-table not yet implemented");
+}
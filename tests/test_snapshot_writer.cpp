@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include "snapshot_writer.h"
+#include "database.h"
+#include "metadata.h"
+#include <sstream>
+
+using namespace datapainter;
+
+class SnapshotWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->is_open());
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        mgr_ = std::make_unique<MetadataManager>(*db_);
+        ASSERT_TRUE(mgr_->create_data_table("test_table"));
+        table_ = std::make_unique<DataTable>(*db_, "test_table");
+    }
+
+    // Canvas of height x width cells over [0, 8] x [0, 4]
+    static Viewport canvas(int height, int width) {
+        return Viewport(0.0, 8.0, 0.0, 4.0, 0.0, 8.0, 0.0, 4.0, height, width);
+    }
+
+    static std::vector<std::string> lines(const std::string& text) {
+        std::vector<std::string> result;
+        std::istringstream in(text);
+        std::string line;
+        while (std::getline(in, line)) {
+            result.push_back(line);
+        }
+        return result;
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<MetadataManager> mgr_;
+    std::unique_ptr<DataTable> table_;
+    ClassPalette palette_{"x", "o"};
+};
+
+// Test: Sizes parse as <width>x<height> within the limits
+TEST_F(SnapshotWriterTest, ParsesSize) {
+    auto size = SnapshotWriter::parse_size("2000x1000");
+    ASSERT_TRUE(size.has_value());
+    EXPECT_EQ(size->width, 2000);
+    EXPECT_EQ(size->height, 1000);
+
+    EXPECT_FALSE(SnapshotWriter::parse_size("2000").has_value());
+    EXPECT_FALSE(SnapshotWriter::parse_size("x100").has_value());
+    EXPECT_FALSE(SnapshotWriter::parse_size("100x").has_value());
+    EXPECT_FALSE(SnapshotWriter::parse_size("0x100").has_value());
+    EXPECT_FALSE(SnapshotWriter::parse_size("-5x100").has_value());
+    EXPECT_FALSE(SnapshotWriter::parse_size("10x10x10").has_value());
+    EXPECT_FALSE(SnapshotWriter::parse_size("9000x10").has_value());   // Side limit
+    EXPECT_FALSE(SnapshotWriter::parse_size("8000x8000").has_value()); // Cell limit
+}
+
+// Test: Output format follows the file extension
+TEST_F(SnapshotWriterTest, FormatFromPath) {
+    EXPECT_EQ(SnapshotWriter::format_for_path("out.ppm"), SnapshotWriter::Format::PPM);
+    EXPECT_EQ(SnapshotWriter::format_for_path("OUT.PPM"), SnapshotWriter::Format::PPM);
+    EXPECT_EQ(SnapshotWriter::format_for_path("out.txt"), SnapshotWriter::Format::TEXT);
+    EXPECT_EQ(SnapshotWriter::format_for_path("ppm"), SnapshotWriter::Format::TEXT);
+}
+
+// Test: Text snapshots are one full-width line per cell row, with unsaved
+// inserts drawn
+TEST_F(SnapshotWriterTest, WritesTextCanvas) {
+    table_->insert_point(0.0, 4.0, "x");  // Top-left cell
+    ChangeRecord insert{};
+    insert.action = "insert";
+    insert.x = 8.0;
+    insert.y = 0.0;
+    insert.new_target = "o";
+    insert.is_active = true;
+
+    SnapshotWriter writer(*table_, palette_);
+    std::ostringstream out;
+    ASSERT_TRUE(writer.write(out, canvas(5, 9), {insert}, SnapshotWriter::Format::TEXT));
+
+    auto rows = lines(out.str());
+    ASSERT_EQ(rows.size(), 5u);
+    for (const auto& row : rows) {
+        EXPECT_EQ(row.size(), 9u);
+    }
+    EXPECT_EQ(rows[0][0], 'x');
+    EXPECT_EQ(rows[4][8], 'o');
+    EXPECT_EQ(rows[2][4], ' ');
+}
+
+// Test: Braille text snapshots hold one UTF-8 braille glyph per occupied cell
+TEST_F(SnapshotWriterTest, WritesBrailleText) {
+    table_->insert_point(0.0, 4.0, "x");
+
+    SnapshotWriter writer(*table_, palette_);
+    writer.set_mode(EditAreaRenderer::Mode::BRAILLE);
+    std::ostringstream out;
+    ASSERT_TRUE(writer.write(out, canvas(5, 9), {}, SnapshotWriter::Format::TEXT));
+
+    auto rows = lines(out.str());
+    ASSERT_EQ(rows.size(), 5u);
+    // Cells are centred on their data positions, so the top-left corner
+    // lights dot 6 (row 2, column 1): U+2820 is E2 A0 A0 in UTF-8
+    EXPECT_EQ(rows[0], std::string("\xE2\xA0\xA0") + std::string(8, ' '));
+}
+
+// Test: PPM snapshots have one pixel per cell on a white background
+TEST_F(SnapshotWriterTest, WritesPpmCanvas) {
+    table_->insert_point(0.0, 4.0, "x");
+
+    SnapshotWriter writer(*table_, palette_);
+    std::ostringstream out;
+    ASSERT_TRUE(writer.write(out, canvas(5, 9), {}, SnapshotWriter::Format::PPM));
+
+    std::string image = out.str();
+    std::string header = "P6\n9 5\n255\n";
+    ASSERT_EQ(image.substr(0, header.size()), header);
+    ASSERT_EQ(image.size(), header.size() + 9 * 5 * 3);
+
+    // An all-x cell is red; the next pixel is background
+    const unsigned char* pixels = reinterpret_cast<const unsigned char*>(image.data() + header.size());
+    EXPECT_GT(pixels[0], pixels[2]);
+    EXPECT_EQ(pixels[3], 255);
+    EXPECT_EQ(pixels[4], 255);
+    EXPECT_EQ(pixels[5], 255);
+}
+
+// Test: Braille PPM snapshots draw each dot as a pixel
+TEST_F(SnapshotWriterTest, WritesBraillePpmAtDotResolution) {
+    table_->insert_point(0.0, 4.0, "x");
+
+    SnapshotWriter writer(*table_, palette_);
+    writer.set_mode(EditAreaRenderer::Mode::BRAILLE);
+    std::ostringstream out;
+    ASSERT_TRUE(writer.write(out, canvas(5, 9), {}, SnapshotWriter::Format::PPM));
+
+    std::string image = out.str();
+    std::string header = "P6\n18 20\n255\n";
+    ASSERT_EQ(image.substr(0, header.size()), header);
+    ASSERT_EQ(image.size(), header.size() + 18 * 20 * 3);
+
+    // The corner point's dot is pixel (2, 1); its left-hand neighbour is unset
+    const unsigned char* pixels = reinterpret_cast<const unsigned char*>(image.data() + header.size());
+    size_t dot = (2 * 18 + 1) * 3;
+    EXPECT_NE(pixels[dot], 255);
+    EXPECT_EQ(pixels[dot - 3], 255);
+}
+
+// Test: Megapixel canvases bin and write without a terminal
+TEST_F(SnapshotWriterTest, WritesLargeCanvas) {
+    for (int i = 0; i < 1000; ++i) {
+        table_->insert_point((i % 100) * 0.08, (i / 100) * 0.4, i % 2 == 0 ? "x" : "o");
+    }
+
+    SnapshotWriter writer(*table_, palette_);
+    writer.set_mode(EditAreaRenderer::Mode::DENSITY);
+    std::ostringstream out;
+    ASSERT_TRUE(writer.write(out, canvas(1000, 2000), {}, SnapshotWriter::Format::PPM));
+    EXPECT_EQ(out.str().size(), std::string("P6\n2000 1000\n255\n").size() + 2000u * 1000u * 3u);
+}
+
+// Test: Write failures are reported
+TEST_F(SnapshotWriterTest, ReportsWriteFailure) {
+    table_->insert_point(1.0, 1.0, "x");
+
+    SnapshotWriter writer(*table_, palette_);
+    std::ostringstream out;
+    out.setstate(std::ios::badbit);
+    EXPECT_FALSE(writer.write(out, canvas(5, 9), {}, SnapshotWriter::Format::TEXT));
+    EXPECT_FALSE(writer.last_error().empty());
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "sql_profiler.h"
+#include "database.h"
+#include "data_table.h"
+#include "json_value.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace datapainter;
+
+class SqlProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->execute(
+            "CREATE TABLE points (id INTEGER PRIMARY KEY, x REAL, y REAL, target TEXT)"));
+    }
+
+    std::unique_ptr<Database> db_;
+};
+
+// Test: Literals and whitespace are normalised away
+TEST_F(SqlProfilerTest, Normalize) {
+    EXPECT_EQ(SqlProfiler::normalize("SELECT  *\n FROM t WHERE id = 42;"),
+              "SELECT * FROM t WHERE id = ?");
+    EXPECT_EQ(SqlProfiler::normalize("INSERT INTO t2 VALUES ('it''s', -1.5e-3, .5)"),
+              "INSERT INTO t2 VALUES (?, -?, ?)");
+    EXPECT_EQ(SqlProfiler::normalize("SELECT \"col 1\" FROM table_2 WHERE x >= ?"),
+              "SELECT \"col 1\" FROM table_2 WHERE x >= ?");
+}
+
+// Test: Executions, rows and full scans are aggregated per statement
+TEST_F(SqlProfilerTest, AggregatesExecutions) {
+    SqlProfiler profiler(*db_);
+    ASSERT_TRUE(profiler.attach());
+
+    DataTable table(*db_, "points");
+    for (int i = 0; i < 10; ++i) {
+        table.insert_point(i, i, i % 2 == 0 ? "x" : "o");
+    }
+    table.query_viewport(0, 4, 0, 4);
+    table.query_viewport(0, 9, 0, 9);
+    profiler.detach();
+
+    const SqlProfiler::Entry* insert = nullptr;
+    const SqlProfiler::Entry* viewport = nullptr;
+    for (const auto* entry : profiler.sorted_entries()) {
+        if (entry->sql.rfind("INSERT INTO points", 0) == 0) {
+            insert = entry;
+        } else if (entry->sql.find("WHERE x >= ?") != std::string::npos) {
+            viewport = entry;
+        }
+    }
+    ASSERT_NE(insert, nullptr);
+    ASSERT_NE(viewport, nullptr);
+    EXPECT_EQ(insert->count, 10);
+    EXPECT_EQ(viewport->count, 2);
+    EXPECT_EQ(viewport->rows, 15);
+    // No index on x, so each execution walks the whole table
+    EXPECT_GT(viewport->fullscan_steps, 0);
+    EXPECT_GE(viewport->max_ms, 0.0);
+}
+
+// Test: Query plans show full scans
+TEST_F(SqlProfilerTest, QueryPlan) {
+    SqlProfiler profiler(*db_);
+    auto plan = profiler.query_plan("SELECT id FROM points WHERE x >= ?");
+    ASSERT_FALSE(plan.empty());
+    EXPECT_NE(plan[0].find("SCAN"), std::string::npos) << plan[0];
+}
+
+// Test: JSON report lists statements with plans for the top offenders
+TEST_F(SqlProfilerTest, JsonReport) {
+    SqlProfiler profiler(*db_);
+    ASSERT_TRUE(profiler.attach());
+    db_->execute("SELECT COUNT(*) FROM points");
+    profiler.detach();
+
+    std::ostringstream out;
+    profiler.write_json(out);
+    auto report = JsonValue::parse(out.str());
+    ASSERT_TRUE(report.has_value()) << out.str();
+    const JsonValue* statements = report->find("statements");
+    ASSERT_NE(statements, nullptr);
+    ASSERT_EQ(statements->size(), 1u);
+    EXPECT_EQ(statements->as_array()[0].get_string("sql"), "SELECT COUNT(*) FROM points");
+    EXPECT_NE(statements->as_array()[0].find("plan"), nullptr);
+}
+
+// Test: Report is written when the profiler goes away
+TEST_F(SqlProfilerTest, WritesReportOnDestruction) {
+    std::string path = "test_sql_profile.txt";
+    {
+        SqlProfiler profiler(*db_);
+        ASSERT_TRUE(profiler.attach());
+        profiler.set_report_path(path);
+        db_->execute("SELECT COUNT(*) FROM points WHERE target = 'x'");
+    }
+
+    std::ifstream in(path);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::filesystem::remove(path);
+    EXPECT_NE(text.find("SELECT COUNT(*) FROM points WHERE target = ?"), std::string::npos) << text;
+    EXPECT_NE(text.find("Query plans"), std::string::npos);
+}
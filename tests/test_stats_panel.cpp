@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include "stats_panel.h"
+#include "database.h"
+#include "metadata.h"
+#include <map>
+#include <random>
+
+using namespace datapainter;
+
+class StatsPanelTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->is_open());
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        ASSERT_TRUE(db_->ensure_unsaved_changes_table());
+        mgr_ = std::make_unique<MetadataManager>(*db_);
+        ASSERT_TRUE(mgr_->create_data_table("test_table"));
+        table_ = std::make_unique<DataTable>(*db_, "test_table");
+        journal_ = std::make_unique<UnsavedChanges>(*db_);
+    }
+
+    std::vector<ChangeRecord> changes() { return journal_->get_changes("test_table"); }
+
+    // Moments of the effective points of one target inside a rectangle, by
+    // brute force over the table and the journal
+    Moments expected(const std::string& target, double x_min, double x_max, double y_min, double y_max,
+                     double origin_x, double origin_y) {
+        std::map<int, DataPoint> points;
+        for (const auto& point : table_->query_viewport(-1e9, 1e9, -1e9, 1e9)) {
+            points[point.id] = point;
+        }
+        int next_insert = -1;
+        for (const auto& change : changes()) {
+            if (!change.is_active) {
+                continue;
+            }
+            if (change.action == "insert") {
+                points[next_insert--] = DataPoint{0, *change.x, *change.y, *change.new_target};
+            } else if (change.action == "delete") {
+                points.erase(*change.data_id);
+            } else if (change.action == "update") {
+                points[*change.data_id].target = *change.new_target;
+            }
+        }
+        Moments moments;
+        for (const auto& entry : points) {
+            const DataPoint& point = entry.second;
+            if (point.target == target && point.x >= x_min && point.x <= x_max && point.y >= y_min &&
+                point.y <= y_max) {
+                moments.add(point.x - origin_x, point.y - origin_y, +1);
+            }
+        }
+        return moments;
+    }
+
+    void expect_moments(const Moments& actual, const Moments& wanted) {
+        EXPECT_EQ(actual.count, wanted.count);
+        EXPECT_NEAR(actual.mean_x(), wanted.mean_x(), 1e-9);
+        EXPECT_NEAR(actual.mean_y(), wanted.mean_y(), 1e-9);
+        EXPECT_NEAR(actual.var_x(), wanted.var_x(), 1e-9);
+        EXPECT_NEAR(actual.var_y(), wanted.var_y(), 1e-9);
+        EXPECT_NEAR(actual.cov_xy(), wanted.cov_xy(), 1e-9);
+    }
+
+    std::mt19937 rng_{11};
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<MetadataManager> mgr_;
+    std::unique_ptr<DataTable> table_;
+    std::unique_ptr<UnsavedChanges> journal_;
+    ClassPalette palette_{"x", "o"};
+};
+
+// Test: Panning and zooming query only the strips that changed, and the
+// sums always equal a fresh count of the rectangle
+TEST_F(StatsPanelTest, ViewportMovesMatchBruteForce) {
+    std::uniform_real_distribution<double> coord(-10.0, 10.0);
+    for (int i = 0; i < 2000; ++i) {
+        table_->insert_point(coord(rng_), coord(rng_), i % 3 == 0 ? "o" : "x");
+    }
+    // Points on the edges the moves pass through
+    table_->insert_point(-5.0, 0.0, "x");
+    table_->insert_point(0.0, 5.0, "o");
+    table_->insert_point(-4.0, -4.0, "x");
+
+    StatsPanel panel;
+    panel.set_origin(0.0, 0.0);
+    struct Rect {
+        double x_min, x_max, y_min, y_max;
+    };
+    std::vector<Rect> moves = {
+        {-5.0, 5.0, -5.0, 5.0},  // Initial
+        {-4.0, 6.0, -5.0, 5.0},  // Pan right: -5 edge leaves
+        {-4.0, 6.0, -4.0, 6.0},  // Pan up
+        {-2.0, 4.0, -1.0, 5.0},  // Zoom in
+        {-8.0, 8.0, -8.0, 8.0},  // Zoom out past every edge
+        {7.0, 9.0, 7.0, 9.0},    // Overlapping one corner
+        {-9.0, -8.0, -9.0, -8.0},  // Disjoint: one full query
+    };
+    int queries = 0;
+    for (const Rect& rect : moves) {
+        panel.set_viewport(*table_, palette_, rect.x_min, rect.x_max, rect.y_min, rect.y_max);
+        expect_moments(panel.viewport(0), expected("x", rect.x_min, rect.x_max, rect.y_min, rect.y_max, 0.0, 0.0));
+        expect_moments(panel.viewport(1), expected("o", rect.x_min, rect.x_max, rect.y_min, rect.y_max, 0.0, 0.0));
+        EXPECT_EQ(panel.saved_viewport_count(),
+                  static_cast<int64_t>(table_->query_viewport(rect.x_min, rect.x_max, rect.y_min, rect.y_max).size()));
+        queries = panel.queries();
+    }
+    EXPECT_EQ(queries, 1 + 2 + 2 + 4 + 4 + 4 + 1);
+
+    // An unchanged viewport runs no query
+    panel.set_viewport(*table_, palette_, -9.0, -8.0, -9.0, -8.0);
+    EXPECT_EQ(panel.queries(), queries);
+}
+
+// Test: Journal inserts, conversions, deletes and undos adjust the viewport
+// and table sums without querying, and a save folds them into the saved sums
+TEST_F(StatsPanelTest, JournalEditsAdjustSums) {
+    int a = table_->insert_point(1.0, 1.0, "x").value();
+    int b = table_->insert_point(2.0, 3.0, "x").value();
+    table_->insert_point(8.0, 8.0, "o");
+    StatsPanel panel;
+    panel.set_origin(0.0, 0.0);
+    panel.set_viewport(*table_, palette_, 0.0, 5.0, 0.0, 5.0);
+    panel.ensure_table_loaded(*table_, palette_);
+    int queries = panel.queries();
+    EXPECT_EQ(panel.viewport_count(), 2);
+    EXPECT_EQ(panel.table_count(), 3);
+
+    ASSERT_TRUE(journal_->record_insert("test_table", 4.0, 4.0, "o").has_value());
+    ASSERT_TRUE(journal_->record_insert("test_table", 9.0, 9.0, "x").has_value());
+    ASSERT_TRUE(journal_->record_update("test_table", b, "x", "o").has_value());
+    ASSERT_TRUE(journal_->record_delete("test_table", a, 1.0, 1.0, "x").has_value());
+    panel.sync(*table_, changes(), palette_);
+    expect_moments(panel.viewport(0), expected("x", 0.0, 5.0, 0.0, 5.0, 0.0, 0.0));
+    expect_moments(panel.viewport(1), expected("o", 0.0, 5.0, 0.0, 5.0, 0.0, 0.0));
+    expect_moments(panel.table(0), expected("x", -1e9, 1e9, -1e9, 1e9, 0.0, 0.0));
+    expect_moments(panel.table(1), expected("o", -1e9, 1e9, -1e9, 1e9, 0.0, 0.0));
+    EXPECT_EQ(panel.viewport_count(), 2);
+    EXPECT_EQ(panel.saved_viewport_count(), 2);
+    EXPECT_EQ(panel.table_count(), 4);
+
+    // Undo the delete, then move: journal points follow the viewport
+    auto journal = changes();
+    ASSERT_TRUE(journal_->mark_change_inactive(journal.back().id));
+    panel.sync(*table_, changes(), palette_);
+    EXPECT_EQ(panel.viewport(0).count, 1);
+    panel.set_viewport(*table_, palette_, 0.0, 10.0, 0.0, 10.0);
+    expect_moments(panel.viewport(0), expected("x", 0.0, 10.0, 0.0, 10.0, 0.0, 0.0));
+    expect_moments(panel.viewport(1), expected("o", 0.0, 10.0, 0.0, 10.0, 0.0, 0.0));
+    EXPECT_EQ(panel.queries(), queries + 2);
+
+    // Save: the journal empties and the table now holds its effect
+    for (const auto& change : changes()) {
+        if (!change.is_active) {
+            continue;
+        }
+        if (change.action == "insert") {
+            table_->insert_point(*change.x, *change.y, *change.new_target);
+        } else if (change.action == "update") {
+            table_->update_point_target(*change.data_id, *change.new_target);
+        }
+    }
+    ASSERT_TRUE(journal_->clear_changes("test_table"));
+    panel.sync(*table_, changes(), palette_);
+    EXPECT_EQ(panel.saved_viewport_count(), 5);
+    EXPECT_EQ(panel.saved_viewport(1).count, 3);
+    expect_moments(panel.table(1), expected("o", -1e9, 1e9, -1e9, 1e9, 0.0, 0.0));
+
+    // A fresh panel over the saved table agrees
+    StatsPanel fresh;
+    fresh.set_viewport(*table_, palette_, 0.0, 10.0, 0.0, 10.0);
+    for (int cls = 0; cls < 2; ++cls) {
+        expect_moments(panel.viewport(cls), fresh.viewport(cls));
+    }
+}
+
+// Test: Offsets from a far origin keep the covariance exact
+TEST_F(StatsPanelTest, OriginKeepsPrecision) {
+    for (int i = 0; i < 100; ++i) {
+        table_->insert_point(1e8 + (i % 10), 1e8 - (i % 10), "x");
+    }
+    StatsPanel panel;
+    panel.set_origin(1e8, 1e8);
+    panel.set_viewport(*table_, palette_, 1e8 - 20.0, 1e8 + 20.0, 1e8 - 20.0, 1e8 + 20.0);
+    const Moments& moments = panel.viewport(0);
+    EXPECT_EQ(moments.count, 100);
+    EXPECT_NEAR(panel.origin_x() + moments.mean_x(), 1e8 + 4.5, 1e-9);
+    EXPECT_NEAR(moments.var_x(), 8.25 * 100.0 / 99.0, 1e-9);
+    EXPECT_NEAR(moments.cov_xy(), -8.25 * 100.0 / 99.0, 1e-9);
+}
+
+// Test: Lines list each class with its share, and unknown targets get a slot
+TEST_F(StatsPanelTest, LinesAndRender) {
+    for (int i = 0; i < 6; ++i) {
+        table_->insert_point(1.0 + i, 1.0, "x");
+    }
+    table_->insert_point(2.0, 2.0, "o");
+    table_->insert_point(3.0, 3.0, "o");
+    table_->insert_point(4.0, 4.0, "z");
+    StatsPanel panel;
+    panel.set_viewport(*table_, palette_, 0.0, 10.0, 0.0, 10.0);
+
+    auto lines = panel.get_lines(palette_);
+    for (const auto& line : lines) {
+        EXPECT_EQ(static_cast<int>(line.size()), StatsPanel::WIDTH) << line;
+    }
+    EXPECT_NE(lines[0].find("viewport: 9 points, x:o 3.00"), std::string::npos) << lines[0];
+    EXPECT_NE(lines[2].find("66.7%"), std::string::npos) << lines[2];
+    EXPECT_EQ(lines[2].substr(0, 5), "| x x");
+    EXPECT_NE(lines[3].find("22.2%"), std::string::npos) << lines[3];
+    EXPECT_EQ(lines[4].substr(0, 5), "| a z");
+    EXPECT_EQ(lines.size(), 6u);  // No table section until loaded
+
+    panel.ensure_table_loaded(*table_, palette_);
+    lines = panel.get_lines(palette_);
+    EXPECT_NE(lines[5].find("table: 9 points"), std::string::npos) << lines[5];
+
+    Terminal terminal;
+    terminal.set_dimensions(24, 80);
+    panel.render(terminal, palette_, 4, 1);
+    EXPECT_NE(terminal.get_row(4).find("viewport"), std::string::npos);
+    EXPECT_EQ(terminal.read_char(6, 3), 'x');
+    EXPECT_EQ(terminal.read_color(6, 3), palette_.style(0).color);
+}
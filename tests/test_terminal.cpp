@@ -107,6 +107,55 @@ TEST_F(TerminalTest, Resize) {
     EXPECT_EQ(term->read_char(5, 10), 'X');
 }
 
+// Test: Shrinking then growing keeps what still fits and blanks new cells
+TEST_F(TerminalTest, ResizeShrinkAndGrow) {
+    term->clear_buffer();
+    term->write_char(2, 3, 'A');
+    term->write_acs(4, 30, Terminal::AcsChar::VLINE);
+    term->write_char(18, 35, 'Z');
+
+    term->set_dimensions(10, 32);
+    EXPECT_EQ(term->read_char(2, 3), 'A');
+    EXPECT_EQ(term->read_acs(4, 30), Terminal::AcsChar::VLINE);
+
+    term->set_dimensions(20, 40);
+    EXPECT_EQ(term->read_char(2, 3), 'A');
+    EXPECT_EQ(term->read_char(18, 35), ' ');
+    EXPECT_EQ(term->read_acs(4, 35), Terminal::AcsChar::NONE);
+}
+
+// Test: Colours are stored per cell and reset by plain writes and clears
+TEST_F(TerminalTest, CellColours) {
+    term->write_char(1, 1, 'c', Terminal::Color::CYAN);
+    EXPECT_EQ(term->read_char(1, 1), 'c');
+    EXPECT_EQ(term->read_color(1, 1), Terminal::Color::CYAN);
+
+    term->write_char(1, 1, 'p');
+    EXPECT_EQ(term->read_color(1, 1), Terminal::Color::DEFAULT);
+
+    term->write_char(2, 2, 'r', Terminal::Color::RED);
+    term->clear_buffer();
+    EXPECT_EQ(term->read_color(2, 2), Terminal::Color::DEFAULT);
+
+    EXPECT_EQ(Terminal::parse_color("magenta"), Terminal::Color::MAGENTA);
+    EXPECT_FALSE(Terminal::parse_color("mauve").has_value());
+}
+
+// Test: Glyph cells read back their ASCII fallback and are cleared by plain writes
+TEST_F(TerminalTest, GlyphCells) {
+    term->write_glyph(3, 3, U'\u2592', ':', Terminal::Color::BLUE);
+    EXPECT_EQ(term->read_glyph(3, 3), U'\u2592');
+    EXPECT_EQ(term->read_char(3, 3), ':');
+    EXPECT_EQ(term->read_color(3, 3), Terminal::Color::BLUE);
+
+    term->write_char(3, 3, 'x');
+    EXPECT_EQ(term->read_glyph(3, 3), U'\0');
+
+    term->write_glyph(4, 4, U'\u2588', '@', Terminal::Color::DEFAULT);
+    term->clear_buffer();
+    EXPECT_EQ(term->read_glyph(4, 4), U'\0');
+}
+
 // Test size adequacy check (minimum size)
 TEST_F(TerminalTest, SizeAdequacy) {
     // Normal size should be adequate
@@ -218,3 +267,16 @@ TEST_F(TerminalTest, BlockWideCharacters) {
     term->write_char(2, 0, static_cast<char>(200));  // > 127
     EXPECT_EQ(term->read_char(2, 0), '?');
 }
+
+// Test headless terminal keeps the buffer but never blocks on input
+TEST_F(TerminalTest, HeadlessModeKeepsBuffer) {
+    term->set_headless(true);
+    EXPECT_TRUE(term->is_headless());
+    EXPECT_TRUE(term->enter_raw_mode());
+
+    term->write_char(1, 2, 'Z');
+    term->render_with_cursor(1, 2);
+    EXPECT_EQ(term->read_char(1, 2), 'Z');
+    EXPECT_EQ(term->read_key(), -1);
+    EXPECT_TRUE(term->exit_raw_mode());
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "text_buffer.h"
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+using namespace datapainter;
+
+// Test: Appends concatenate and report their size
+TEST(TextBufferTest, AppendText) {
+    TextBuffer buffer;
+    EXPECT_TRUE(buffer.empty());
+    buffer.append("Total: ").append_int(-42).append(' ').append(std::string("rows"));
+    EXPECT_EQ(buffer.view(), "Total: -42 rows");
+    EXPECT_EQ(buffer.size(), 15u);
+
+    buffer.clear();
+    EXPECT_TRUE(buffer.empty());
+}
+
+// Test: Number formatting matches the iostream output it replaces
+TEST(TextBufferTest, NumbersMatchIostream) {
+    const double values[] = {0.0, -0.0, 1.0, -2.5, 3.14159, 0.05, 123.456, 9999.95,
+                             1e-5, -1.5e7, 1234567.0, 0.000123};
+    for (double value : values) {
+        for (int precision = 0; precision <= 8; ++precision) {
+            std::ostringstream fixed;
+            fixed << std::fixed << std::setprecision(precision) << value;
+            TextBuffer buffer;
+            buffer.append_fixed(value, precision);
+            EXPECT_EQ(buffer.view(), fixed.str()) << value << " fixed " << precision;
+
+            std::ostringstream scientific;
+            scientific << std::scientific << std::setprecision(precision) << value;
+            buffer.clear();
+            buffer.append_scientific(value, precision);
+            EXPECT_EQ(buffer.view(), scientific.str()) << value << " scientific " << precision;
+        }
+    }
+}
+
+// Test: Trailing fraction zeros are trimmed only in the appended number
+TEST(TextBufferTest, TrimFractionZeros) {
+    TextBuffer buffer;
+    buffer.append("x=100 ");
+    size_t start = buffer.size();
+    buffer.append_fixed(2.5, 3);
+    buffer.trim_fraction_zeros(start);
+    EXPECT_EQ(buffer.view(), "x=100 2.5");
+
+    start = buffer.size();
+    buffer.append(' ');
+    buffer.append_fixed(3.0, 1);
+    buffer.trim_fraction_zeros(start);
+    EXPECT_EQ(buffer.view(), "x=100 2.5 3");
+
+    start = buffer.size();
+    buffer.append_int(200);
+    buffer.trim_fraction_zeros(start);
+    EXPECT_EQ(buffer.view(), "x=100 2.5 3200");
+}
+
+// Test: Editing operations behave like their std::string counterparts
+TEST(TextBufferTest, Editing) {
+    TextBuffer buffer;
+    buffer.append("abc ?:Help");
+    size_t help = buffer.rfind(" ?:Help");
+    ASSERT_EQ(help, 3u);
+    buffer.erase(help, 7);
+    EXPECT_EQ(buffer.view(), "abc");
+
+    buffer.resize(6, ' ');
+    EXPECT_EQ(buffer.view(), "abc   ");
+    buffer.overwrite(4, "[q]");
+    EXPECT_EQ(buffer.view(), "abc [q]");
+    EXPECT_EQ(buffer.find("[q]"), 4u);
+    EXPECT_EQ(buffer.find("zz"), TextBuffer::npos);
+
+    buffer.resize(2, ' ');
+    EXPECT_EQ(buffer.view(), "ab");
+}
+
+// Test: Text past the capacity is dropped
+TEST(TextBufferTest, ClipsAtCapacity) {
+    TextBuffer buffer;
+    std::string long_text(TextBuffer::CAPACITY + 10, 'a');
+    buffer.append(long_text);
+    EXPECT_EQ(buffer.size(), TextBuffer::CAPACITY);
+    buffer.append('b').append_int(7).append_fixed(1.5, 2);
+    EXPECT_EQ(buffer.size(), TextBuffer::CAPACITY);
+    EXPECT_EQ(buffer[TextBuffer::CAPACITY - 1], 'a');
+}
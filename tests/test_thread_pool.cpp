@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "thread_pool.h"
+#include "csv_exporter.h"
+#include "database.h"
+#include "json_value.h"
+#include "metadata.h"
+#include "tracer.h"
+#include <atomic>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace datapainter;
+
+// Test: Every index runs exactly once, on a valid worker
+TEST(ThreadPoolTest, CoversRangeOnce) {
+    ThreadPool pool(4);
+    ASSERT_EQ(pool.size(), 4);
+
+    std::vector<std::atomic<int>> hits(100000);
+    std::atomic<bool> bad_worker{false};
+    pool.parallel_for(hits.size(), 1000, [&](size_t begin, size_t end, int worker) {
+        if (worker < 0 || worker >= 4) {
+            bad_worker = true;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            hits[i].fetch_add(1);
+        }
+    });
+
+    EXPECT_FALSE(bad_worker);
+    for (const auto& hit : hits) {
+        ASSERT_EQ(hit.load(), 1);
+    }
+}
+
+// Test: Workers that record spans are named pool-N in the trace
+TEST(ThreadPoolTest, WorkersNamedInTrace) {
+    Tracer::instance().clear();
+    Tracer::set_enabled(true);
+    ThreadPool pool(4);
+    std::vector<std::atomic<bool>> ran(4);
+    std::atomic<int> others{0};
+    pool.parallel_for(8, 1, [&](size_t, size_t, int worker) {
+        TraceSpan span("pool_chunk");
+        if (worker == 0) {
+            // Hold the calling thread until a worker has taken a chunk
+            while (others.load() == 0) {
+                std::this_thread::yield();
+            }
+        } else {
+            ran[static_cast<size_t>(worker)] = true;
+            ++others;
+        }
+    });
+    Tracer::set_enabled(false);
+
+    std::ostringstream out;
+    Tracer::instance().write_json(out);
+    Tracer::instance().clear();
+    auto trace = JsonValue::parse(out.str());
+    ASSERT_TRUE(trace.has_value()) << out.str();
+    std::set<std::string> names;
+    for (const auto& event : trace->find("traceEvents")->as_array()) {
+        const JsonValue* args = event.find("args");
+        if (event.get_string("name") == std::optional<std::string>("thread_name") && args) {
+            names.insert(args->get_string("name").value_or(""));
+        }
+    }
+    for (int worker = 1; worker < 4; ++worker) {
+        if (ran[static_cast<size_t>(worker)]) {
+            EXPECT_EQ(names.count("pool-" + std::to_string(worker)), 1u) << worker;
+        }
+    }
+}
+
+// Test: Small ranges and one-thread pools run inline as one chunk
+TEST(ThreadPoolTest, SmallRangesRunInline) {
+    ThreadPool single(1);
+    int calls = 0;
+    single.parallel_for(1000000, 1, [&](size_t begin, size_t end, int worker) {
+        ++calls;
+        EXPECT_EQ(begin, 0u);
+        EXPECT_EQ(end, 1000000u);
+        EXPECT_EQ(worker, 0);
+    });
+    EXPECT_EQ(calls, 1);
+
+    ThreadPool pool(4);
+    calls = 0;
+    pool.parallel_for(10, 100, [&](size_t, size_t, int worker) {
+        ++calls;
+        EXPECT_EQ(worker, 0);
+    });
+    EXPECT_EQ(calls, 1);
+
+    pool.parallel_for(0, 1, [&](size_t, size_t, int) { ++calls; });
+    EXPECT_EQ(calls, 1);
+}
+
+// Test: Per-worker partial sums add up across many back-to-back loops
+TEST(ThreadPoolTest, RepeatedLoopsWithWorkerScratch) {
+    ThreadPool pool(3);
+    for (int round = 0; round < 200; ++round) {
+        std::vector<long> partial(static_cast<size_t>(pool.size()), 0);
+        size_t count = 5000 + static_cast<size_t>(round);
+        pool.parallel_for(count, 64, [&](size_t begin, size_t end, int worker) {
+            for (size_t i = begin; i < end; ++i) {
+                partial[static_cast<size_t>(worker)] += static_cast<long>(i);
+            }
+        });
+        long total = 0;
+        for (long value : partial) {
+            total += value;
+        }
+        ASSERT_EQ(total, static_cast<long>(count * (count - 1) / 2));
+    }
+}
+
+// Test: CSV export formatted across workers is byte-identical and in id order
+TEST(ThreadPoolTest, CsvExportMatchesSerial) {
+    Database db(":memory:");
+    ASSERT_TRUE(db.ensure_metadata_table());
+    MetadataManager mgr(db);
+    ASSERT_TRUE(mgr.create_data_table("t"));
+    DataTable table(db, "t");
+    db.execute("BEGIN TRANSACTION");
+    for (int i = 0; i < 40000; ++i) {
+        table.insert_point(i * 0.001, -i * 0.5, i % 7 == 0 ? "a,b" : (i % 2 == 0 ? "x" : "o"));
+    }
+    db.execute("COMMIT");
+
+    ThreadPool single(1);
+    ThreadPool pool(4);
+    std::ostringstream serial_out;
+    std::ostringstream parallel_out;
+    CsvExporter serial(db, "t");
+    serial.set_thread_pool(single);
+    CsvExporter parallel(db, "t");
+    parallel.set_thread_pool(pool);
+    ASSERT_TRUE(serial.write(serial_out));
+    ASSERT_TRUE(parallel.write(parallel_out));
+
+    EXPECT_EQ(parallel_out.str(), serial_out.str());
+    EXPECT_EQ(serial_out.str().substr(0, 21), "x,y,target\n0,0,\"a,b\"\n");
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "tracer.h"
+#include "json_value.h"
+#include <atomic>
+#include <set>
+#include <sstream>
+#include <thread>
+
+using namespace datapainter;
+
+class TracerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Tracer::instance().clear();
+        Tracer::set_enabled(true);
+    }
+
+    void TearDown() override {
+        Tracer::set_enabled(false);
+        Tracer::instance().clear();
+    }
+
+    JsonValue dump() {
+        std::ostringstream out;
+        Tracer::instance().write_json(out);
+        auto trace = JsonValue::parse(out.str());
+        EXPECT_TRUE(trace.has_value()) << out.str();
+        return trace.value_or(JsonValue::object());
+    }
+};
+
+// Test: Spans become complete events with microsecond timestamps
+TEST_F(TracerTest, RecordsCompleteEvents) {
+    {
+        TraceSpan outer("outer");
+        TraceSpan inner("inner");
+    }
+    EXPECT_EQ(Tracer::instance().span_count(), 2u);
+
+    JsonValue trace = dump();
+    const JsonValue* events = trace.find("traceEvents");
+    ASSERT_NE(events, nullptr);
+
+    std::set<std::string> names;
+    for (const auto& event : events->as_array()) {
+        if (event.get_string("ph") == std::optional<std::string>("X")) {
+            names.insert(event.get_string("name").value_or(""));
+            EXPECT_GE(event.get_number("dur").value_or(-1.0), 0.0);
+            EXPECT_TRUE(event.get_number("ts").has_value());
+        }
+    }
+    EXPECT_EQ(names, (std::set<std::string>{"outer", "inner"}));
+}
+
+// Test: Nothing is recorded while tracing is disabled
+TEST_F(TracerTest, DisabledSpansRecordNothing) {
+    Tracer::set_enabled(false);
+    {
+        TraceSpan span("ignored");
+    }
+    EXPECT_EQ(Tracer::instance().span_count(), 0u);
+}
+
+// Test: Each thread gets its own track and name
+TEST_F(TracerTest, ThreadsGetSeparateTracks) {
+    std::thread worker([] {
+        Tracer::instance().set_thread_name("worker");
+        TraceSpan span("worker_span");
+    });
+    worker.join();
+    {
+        TraceSpan span("main_span");
+    }
+
+    JsonValue trace = dump();
+    int worker_tid = -1;
+    int main_tid = -1;
+    bool named = false;
+    for (const auto& event : trace.find("traceEvents")->as_array()) {
+        std::string name = event.get_string("name").value_or("");
+        if (name == "worker_span") {
+            worker_tid = event.get_int("tid").value_or(-1);
+        } else if (name == "main_span") {
+            main_tid = event.get_int("tid").value_or(-1);
+        } else if (name == "thread_name") {
+            const JsonValue* args = event.find("args");
+            named = named || (args && args->get_string("name") == std::optional<std::string>("worker"));
+        }
+    }
+    EXPECT_NE(worker_tid, -1);
+    EXPECT_NE(main_tid, -1);
+    EXPECT_NE(worker_tid, main_tid);
+    EXPECT_TRUE(named);
+}
+
+// Test: A full ring keeps only the newest spans
+TEST_F(TracerTest, RingOverwritesOldest) {
+    for (size_t i = 0; i < Tracer::RING_CAPACITY + 10; ++i) {
+        TraceSpan span(i < 10 ? "old" : "new");
+    }
+    EXPECT_EQ(Tracer::instance().span_count(), Tracer::RING_CAPACITY);
+
+    std::ostringstream out;
+    Tracer::instance().write_json(out);
+    EXPECT_EQ(out.str().find("\"old\""), std::string::npos);
+}
+
+// Test: Clearing moves past a thread's spans without touching its counter
+TEST_F(TracerTest, ClearKeepsRecordingThreadsIntact) {
+    std::thread worker([] {
+        for (int i = 0; i < 5; ++i) {
+            TraceSpan span("before");
+        }
+    });
+    worker.join();
+    Tracer::instance().clear();
+    EXPECT_EQ(Tracer::instance().span_count(), 0u);
+
+    std::thread again([] {
+        TraceSpan first("after");
+        TraceSpan second("after");
+    });
+    again.join();
+    EXPECT_EQ(Tracer::instance().span_count(), 2u);
+    std::ostringstream out;
+    Tracer::instance().write_json(out);
+    EXPECT_EQ(out.str().find("\"before\""), std::string::npos);
+}
+
+// Test: Dumping while another thread laps its ring yields only whole spans
+TEST_F(TracerTest, DumpWhileRecording) {
+    std::atomic<bool> done{false};
+    std::thread worker([&] {
+        for (size_t i = 0; i < 3 * Tracer::RING_CAPACITY; ++i) {
+            int64_t start = static_cast<int64_t>(i) * 1000;
+            Tracer::instance().record("lap", start, start + 1000);
+        }
+        done.store(true);
+    });
+    int dumps = 0;
+    while (!done.load() || dumps == 0) {
+        JsonValue trace = dump();
+        for (const auto& event : trace.find("traceEvents")->as_array()) {
+            if (event.get_string("name") == std::optional<std::string>("lap")) {
+                ASSERT_EQ(event.get_number("dur"), 1.0);
+            }
+        }
+        if (++dumps % 4 == 0) {
+            Tracer::instance().clear();
+        }
+    }
+    worker.join();
+}
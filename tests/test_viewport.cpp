@@ -569,3 +569,23 @@ TEST(ViewportSmartZoomTest, AsymmetricValidRanges) {
 
     EXPECT_TRUE(vp.is_visible(cursor));
 }
+
+// Test: A resize keeps the data window and rescales the screen mapping
+TEST(ViewportResizeTest, SetScreenSizeKeepsDataWindow) {
+    Viewport vp(-10.0, 10.0, -10.0, 10.0, 21, 41);
+    vp.zoom_in(DataCoord{2.0, 2.0});
+    double x_min = vp.data_x_min();
+    double x_max = vp.data_x_max();
+
+    vp.set_screen_size(41, 81);
+    EXPECT_EQ(vp.screen_height(), 41);
+    EXPECT_EQ(vp.screen_width(), 81);
+    EXPECT_DOUBLE_EQ(vp.data_x_min(), x_min);
+    EXPECT_DOUBLE_EQ(vp.data_x_max(), x_max);
+
+    // The right edge of the data window maps to the new last column
+    auto screen = vp.data_to_screen(DataCoord{x_max, vp.data_y_max()});
+    ASSERT_TRUE(screen.has_value());
+    EXPECT_EQ(screen->col, 80);
+    EXPECT_EQ(screen->row, 0);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "viewport_frame.h"
+#include "database.h"
+
+using namespace datapainter;
+
+class ViewportFrameTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        ASSERT_TRUE(db_->is_open());
+        ASSERT_TRUE(db_->ensure_metadata_table());
+        ASSERT_TRUE(db_->ensure_unsaved_changes_table());
+        mgr_ = std::make_unique<MetadataManager>(*db_);
+        ASSERT_TRUE(mgr_->create_data_table("test_table"));
+        table_ = std::make_unique<DataTable>(*db_, "test_table");
+        journal_ = std::make_unique<UnsavedChanges>(*db_);
+
+        meta_.table_name = "test_table";
+        meta_.target_col_name = "target";
+        meta_.x_meaning = "x";
+        meta_.o_meaning = "o";
+        terminal_.set_dimensions(24, 80);
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<MetadataManager> mgr_;
+    std::unique_ptr<DataTable> table_;
+    std::unique_ptr<UnsavedChanges> journal_;
+    Metadata meta_;
+    Terminal terminal_;
+    ClassPalette palette_{"x", "o"};
+};
+
+// Test: The header counts saved points in the viewport and the journal of
+// every table; the footer counts this table's journal only
+TEST_F(ViewportFrameTest, HeaderAndFooterCounts) {
+    table_->insert_point(1.0, 1.0, "x");
+    table_->insert_point(2.0, 2.0, "x");
+    table_->insert_point(-1.0, -1.0, "o");
+    table_->insert_point(50.0, 50.0, "x");  // Outside the viewport
+    journal_->record_insert("test_table", 3.0, 3.0, "o");
+    journal_->record_insert("other_table", 3.0, 3.0, "o");
+
+    Viewport viewport(-10.0, 10.0, -10.0, 10.0, -10.0, 10.0, -10.0, 10.0, 24, 80);
+    ViewportFrame frame(terminal_, *table_, *journal_, "test.db");
+    terminal_.clear_buffer();
+    frame.draw_top(meta_, palette_, viewport, 3, 20, 13, 40, -1);
+    frame.draw_footer(viewport, 0.0, 0.0, 0);
+
+    EXPECT_NE(terminal_.get_row(0).find("[Unsaved: 2]"), std::string::npos);
+    EXPECT_NE(terminal_.get_row(2).find("Total: 3 (x: 2, o: 1)"), std::string::npos);
+    EXPECT_NE(terminal_.get_row(23).find("[Unsaved: 1]"), std::string::npos);
+    ASSERT_EQ(frame.changes().size(), 1u);
+    EXPECT_EQ(frame.changes()[0].new_target, "o");
+}
+
+// Test: Panning between frames moves the header counts with the viewport
+TEST_F(ViewportFrameTest, CountsFollowViewport) {
+    table_->insert_point(-5.0, 0.0, "x");
+    table_->insert_point(5.0, 0.0, "o");
+
+    Viewport viewport(-10.0, 0.0, -10.0, 10.0, -10.0, 10.0, -10.0, 10.0, 24, 80);
+    ViewportFrame frame(terminal_, *table_, *journal_, "test.db");
+    terminal_.clear_buffer();
+    frame.draw_top(meta_, palette_, viewport, 3, 20, 13, 40, -1);
+    EXPECT_NE(terminal_.get_row(2).find("Total: 1 (x: 1, o: 0)"), std::string::npos);
+
+    for (int i = 0; i < 4; ++i) {
+        viewport.pan_right();  // A quarter width each
+    }
+    terminal_.clear_buffer();
+    frame.draw_top(meta_, palette_, viewport, 3, 20, 13, 40, -1);
+    EXPECT_NE(terminal_.get_row(2).find("Total: 1 (x: 0, o: 1)"), std::string::npos);
+}